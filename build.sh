@@ -65,6 +65,11 @@ build_board() {
         "$SKETCH_PATH"
     
     echo ""
+    # Compressed copy for OTA uploads (inflated on the device)
+    if [[ -f "$board_build_path/app.ino.bin" ]]; then
+        gzip -9 -n -k -f "$board_build_path/app.ino.bin"
+    fi
+
     echo -e "${GREEN}✓ Build complete for $board_name${NC}"
     ls -lh "$board_build_path"/*.bin 2>/dev/null || echo "Binary files generated"
     echo ""
@@ -80,6 +85,16 @@ if [[ -d "$SCRIPT_DIR/assets/icons" ]] && [[ -f "$SCRIPT_DIR/tools/png2icons.py"
     echo ""
 fi
 
+# Generate benchmark image assets (only compiled in with ENABLE_BENCHMARK)
+if [[ -f "$SCRIPT_DIR/tools/bench_assets.py" ]]; then
+    echo "Generating benchmark assets..."
+    python3 "$SCRIPT_DIR/tools/bench_assets.py" \
+        "$SCRIPT_DIR/tools/test240x280.jpg" \
+        "$SCRIPT_DIR/src/app/bench_assets.h" \
+        16 32 64
+    echo ""
+fi
+
 # Generate web assets (once for all builds)
 echo "Generating web assets..."
 "$SCRIPT_DIR/tools/minify-web-assets.sh" "$PROJECT_NAME" "$PROJECT_DISPLAY_NAME"
@@ -4,6 +4,13 @@
 #include "web_portal.h"
 #include "log_manager.h"
 #include "mqtt_manager.h"
+#include "energy_history.h"
+#include "wifi_manager.h"
+#include "boot_timing.h"
+#include "health_sampler.h"
+#include "idle_pacer.h"
+#include "power_ingest.h"
+#include "image_multicast.h"
 #include <WiFi.h>
 #include <ESPmDNS.h>
 #include <lwip/netif.h>
@@ -17,21 +24,27 @@
 DeviceConfig device_config;
 bool config_loaded = false;
 
-// WiFi retry settings
-const unsigned long WIFI_BACKOFF_BASE = 3000; // 3 seconds base (DHCP typically needs 2-3s)
-
 // Heartbeat interval
 const unsigned long HEARTBEAT_INTERVAL = 60000; // 60 seconds
 unsigned long lastHeartbeat = 0;
 
-// WiFi watchdog for connection monitoring
-const unsigned long WIFI_CHECK_INTERVAL = 10000; // 10 seconds
-unsigned long lastWiFiCheck = 0;
-
 // MQTT and display update interval
 const unsigned long DISPLAY_UPDATE_INTERVAL = 1000; // 1 second
 unsigned long lastDisplayUpdate = 0;
 
+// Task layout. Dual-core ESP32: render (and the image decode task, see image_api)
+// on the app core, network next to the WiFi/TCP stack on the protocol core.
+// Single-core ESP32-C3: same priority everywhere, tasks take turns as each one
+// blocks at the end of its iteration.
+#if CONFIG_FREERTOS_UNICORE
+const UBaseType_t RENDER_TASK_PRIORITY = 1;
+#else
+const UBaseType_t RENDER_TASK_PRIORITY = 2;
+#endif
+const UBaseType_t NETWORK_TASK_PRIORITY = 1;
+TaskHandle_t renderTaskHandle = nullptr;
+TaskHandle_t networkTaskHandle = nullptr;
+
 // WiFi event handlers for connection lifecycle monitoring
 void onWiFiConnected(WiFiEvent_t event, WiFiEventInfo_t info) {
   Logger.logMessage("WiFi", "Connected to AP - waiting for IP");
@@ -39,11 +52,13 @@ void onWiFiConnected(WiFiEvent_t event, WiFiEventInfo_t info) {
 
 void onWiFiGotIP(WiFiEvent_t event, WiFiEventInfo_t info) {
   Logger.logMessagef("WiFi", "Got IP: %s", WiFi.localIP().toString().c_str());
+  wifi_manager_on_got_ip();
 }
 
 void onWiFiDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
   uint8_t reason = info.wifi_sta_disconnected.reason;
   Logger.logMessagef("WiFi", "Disconnected - reason: %d", reason);
+  wifi_manager_on_disconnected(reason);
   
   // Common disconnect reasons:
   // 2 = AUTH_EXPIRE, 3 = AUTH_LEAVE, 4 = ASSOC_EXPIRE
@@ -53,9 +68,11 @@ void onWiFiDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
 
 void setup()
 {
-  // Initialize log manager (wraps Serial for web streaming)
+  // Initialize log manager (ring-buffered, drained to Serial by the log task)
   Logger.begin(115200);
-  delay(1000);
+  #if !FAST_BOOT
+  delay(1000);  // Give a serial monitor time to attach
+  #endif
   
   // Register WiFi event handlers for connection lifecycle
   WiFi.onEvent(onWiFiConnected, ARDUINO_EVENT_WIFI_STA_CONNECTED);
@@ -77,6 +94,7 @@ void setup()
   Logger.logMessage("Main", "Initializing 1.69\" LCD display");
   display_init();
   display_set_boot_progress(0, "Display initialized");
+  boot_timing_mark(BOOT_PHASE_DISPLAY);
 
   Logger.logMessage("Main", "Display initialized - Splash shown");
   #endif
@@ -97,6 +115,7 @@ void setup()
   
   // Try to load saved configuration (defaults always applied)
   config_loaded = config_manager_load(&device_config);
+  boot_timing_mark(BOOT_PHASE_CONFIG);
   
   #if HAS_DISPLAY
   display_set_boot_progress(20, "Config loaded");
@@ -118,249 +137,278 @@ void setup()
     #if HAS_DISPLAY
     display_set_boot_progress(40, "Connecting to WiFi...");
     #endif
-    if (connect_wifi()) {
+    wifi_manager_begin(&device_config);
+
+    #if FAST_BOOT
+    // Connection completes in the background: the network task starts mDNS and
+    // MQTT the moment the IP is up, and falls back to AP mode if it never comes
+    #else
+    // Boot waits for the first connection: two rounds of attempts (with a radio
+    // reset in between), then fall back to AP mode
+    bool retryShown = false;
+    while (!wifi_manager_is_connected() && wifi_manager_failures() < 2 * WIFI_MAX_ATTEMPTS) {
+      wifi_manager_loop();
+      #if HAS_DISPLAY
+      if (!retryShown && wifi_manager_get_state() == WIFI_STATE_RADIO_OFF) {
+        display_set_boot_progress(50, "WiFi retry...");
+        retryShown = true;
+      }
+      #endif
+      delay(50);
+    }
+
+    if (wifi_manager_is_connected()) {
+      wifi_manager_take_connected_event();
       start_mdns();
+      image_multicast_begin();
       #if HAS_DISPLAY
       display_set_boot_progress(60, "WiFi connected");
       #endif
     } else {
-      // Hard reset retry - WiFi hardware may be in bad state
-      Logger.logMessage("Main", "WiFi failed - attempting hard reset");
+      Logger.logMessage("Main", "WiFi failed after reset - fallback to AP");
       #if HAS_DISPLAY
-      display_set_boot_progress(50, "WiFi retry...");
+      display_set_boot_progress(60, "AP mode fallback");
       #endif
-      Logger.logBegin("WiFi Hard Reset");
-      WiFi.mode(WIFI_OFF);
-      delay(1000);  // Longer delay to fully reset hardware
-      WiFi.mode(WIFI_STA);
-      delay(500);
-      Logger.logEnd("Reset complete");
-      
-      // One more attempt after hard reset
-      if (connect_wifi()) {
-        start_mdns();
-        #if HAS_DISPLAY
-        display_set_boot_progress(60, "WiFi connected");
-        #endif
-      } else {
-        Logger.logMessage("Main", "WiFi failed after reset - fallback to AP");
-        #if HAS_DISPLAY
-        display_set_boot_progress(60, "AP mode fallback");
-        #endif
-        web_portal_start_ap();
-      }
+      wifi_manager_stop();
+      web_portal_start_ap();
     }
+    #endif
   }
   
+  // Wall-clock time for the energy history (SNTP retries in the background)
+  if (config_loaded) {
+    configTime(0, 0, "pool.ntp.org", "time.nist.gov");
+  }
+  energy_history_init();
+
   // Initialize web portal AFTER WiFi is started
   web_portal_init(&device_config);
+  // Direct power ingest (UDP binds to any address, so it works before the link is up)
+  power_ingest_begin();
   #if HAS_DISPLAY
   display_set_boot_progress(80, "Web portal ready");
   #endif
   
-  // Initialize MQTT if WiFi connected and broker configured
-  if (config_loaded && WiFi.status() == WL_CONNECTED) {
+  // Initialize MQTT if WiFi connected and broker configured (fast boot: on the
+  // connected event in the network task)
+  if (!FAST_BOOT && config_loaded && WiFi.status() == WL_CONNECTED) {
     #if HAS_DISPLAY
     display_set_boot_progress(90, "Connecting to MQTT...");
     #endif
     mqtt_manager_init(&device_config);
   }
   
-  #if HAS_DISPLAY
+  #if HAS_DISPLAY && FAST_BOOT
+  // The render task replaces the splash once the first value arrives
+  display_set_boot_progress(config_loaded ? 80 : 100, config_loaded ? "Connecting to WiFi..." : "Boot complete");
+  #elif HAS_DISPLAY
   display_set_boot_progress(100, "Boot complete");
-  delay(2000);  // Wait 2 seconds for FPS to stabilize
+  delay(2000);  // Keep the splash visible for 2 seconds
   display_show_power_screen();
+  boot_timing_mark(BOOT_PHASE_POWER_SCREEN);
   #endif
   
   lastHeartbeat = millis();
+  boot_timing_mark(BOOT_PHASE_SETUP);
+  start_tasks();
   Logger.logMessage("Main", "Setup complete");
 }
 
+// Main loop: captive portal DNS and deferred web portal work (image decode
+// requests, screen switches). Long decodes here no longer stall rendering or MQTT.
 void loop()
 {
-  unsigned long currentMillis = millis();
-  
   // Handle web portal (DNS for captive portal)
   web_portal_handle();
   
-  // Process pending image operations from web portal (deferred to avoid LVGL race conditions)
+  // Process pending operations from web portal (deferred off the AsyncTCP task,
+  // which must never wait for the display lock)
   web_portal_process_pending();
+
+  // Multicast frames: strips the ring had no room for, NACK/ACK timers
+  image_multicast_loop();
+
+  // Write coalesced config changes once they stop arriving
+  config_manager_loop();
   
-  // Handle MQTT messages
-  mqtt_manager_loop();
+  idle_pacer_task_delay(10);
+}
+
+// Create a task pinned to a core on dual-core parts (unpinned on single-core)
+static void start_task(TaskFunction_t fn, const char* name, uint32_t stack, UBaseType_t priority,
+                       TaskHandle_t* handle, BaseType_t core) {
+#if CONFIG_FREERTOS_UNICORE
+  (void)core;
+  xTaskCreate(fn, name, stack, nullptr, priority, handle);
+#else
+  xTaskCreatePinnedToCore(fn, name, stack, nullptr, priority, handle, core);
+#endif
+}
 
+void start_tasks() {
+  idle_pacer_init();
   #if HAS_DISPLAY
-  display_update();  // FPS counting now happens inside display_update()
-  
-  // Update display with MQTT values periodically
-  if (currentMillis - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
-    float solar = mqtt_manager_get_solar_power();
-    float grid = mqtt_manager_get_grid_power();
-    display_update_energy(solar, grid);
-    lastDisplayUpdate = currentMillis;
-  }
+  start_task(render_task, "render", RENDER_TASK_STACK, RENDER_TASK_PRIORITY, &renderTaskHandle, APP_CPU_NUM);
   #endif
-  
-  // WiFi watchdog - monitor connection and reconnect if needed
-  // Only run if we're not in AP mode (AP mode is the fallback, should stay active)
-  if (config_loaded && !web_portal_is_ap_mode() && currentMillis - lastWiFiCheck >= WIFI_CHECK_INTERVAL) {
-    if (WiFi.status() != WL_CONNECTED && strlen(device_config.wifi_ssid) > 0) {
-      Logger.logMessage("WiFi Watchdog", "Connection lost - attempting reconnect");
-      if (connect_wifi()) {
-        start_mdns();
-        mqtt_manager_init(&device_config);
-      }
-    }
-    lastWiFiCheck = currentMillis;
+  start_task(network_task, "network", NETWORK_TASK_STACK, NETWORK_TASK_PRIORITY, &networkTaskHandle, PRO_CPU_NUM);
+  health_sampler_init();
+}
+
+#if HAS_DISPLAY
+#if FAST_BOOT
+// Fast boot: keep the splash (with connection progress) until the first power
+// value arrives, then show the power screen. Returns true once done.
+bool leave_boot_splash() {
+  static int stage = 0;
+
+  // Something else (an uploaded image) took over the splash already
+  if (strcmp(display_get_screen_name(), "splash") != 0) return true;
+
+  const bool ready = boot_timing_get(BOOT_PHASE_FIRST_VALUE) != 0 ||
+                     !config_loaded || web_portal_is_ap_mode() ||
+                     millis() >= BOOT_SPLASH_TIMEOUT_MS;
+  if (ready) {
+    display_set_boot_progress(100, "Boot complete");
+    display_show_power_screen();
+    boot_timing_mark(BOOT_PHASE_POWER_SCREEN);
+    return true;
   }
-  
-  // Check if it's time for heartbeat
-  if (currentMillis - lastHeartbeat >= HEARTBEAT_INTERVAL) {
-    if (WiFi.status() == WL_CONNECTED) {
-      Logger.logQuickf("Heartbeat", "Up: %ds | Heap: %d | WiFi: %s (%s)", 
-        currentMillis / 1000, ESP.getFreeHeap(), 
-        WiFi.localIP().toString().c_str(), WiFi.getHostname());
-    } else {
-      Logger.logQuickf("Heartbeat", "Up: %ds | Heap: %d | WiFi: Disconnected", 
-        currentMillis / 1000, ESP.getFreeHeap());
-    }
-    
-    lastHeartbeat = currentMillis;
+
+  if (stage < 2 && boot_timing_get(BOOT_PHASE_MQTT) != 0) {
+    display_set_boot_progress(95, "Waiting for data...");
+    stage = 2;
+  } else if (stage < 1 && boot_timing_get(BOOT_PHASE_WIFI) != 0) {
+    display_set_boot_progress(90, "WiFi connected");
+    stage = 1;
   }
-  
-  delay(10);
+  return false;
 }
+#endif
 
-// Connect to WiFi with exponential backoff
-bool connect_wifi() {
-  Logger.logBegin("WiFi Connection");
-  Logger.logLinef("SSID: %s", device_config.wifi_ssid);
-  
-  // === WiFi Hardware Reset Sequence ===
-  // Disable persistent WiFi config (we manage our own via NVS)
-  WiFi.persistent(false);
-  
-  // Full WiFi reset to clear stale state and prevent hardware corruption
-  WiFi.disconnect(true);  // Disconnect + erase stored credentials
-  delay(100);
-  WiFi.mode(WIFI_OFF);    // Turn off WiFi hardware
-  delay(500);             // Wait for hardware to settle
-  WiFi.mode(WIFI_STA);    // Back to station mode
-  delay(100);
-  
-  // Enable auto-reconnect at WiFi stack level
-  WiFi.setAutoReconnect(true);
-  
-  // Prepare sanitized hostname
-  char sanitized[CONFIG_DEVICE_NAME_MAX_LEN];
-  config_manager_sanitize_device_name(device_config.device_name, sanitized, CONFIG_DEVICE_NAME_MAX_LEN);
-  
-  // Set WiFi hostname for mDNS and internal use
-  // NOTE: ESP32's lwIP stack has limited DHCP Option 12 (hostname) support
-  // The hostname may not always appear in router DHCP tables due to ESP-IDF/lwIP limitations
-  // Use mDNS (.local) or NetBIOS for reliable device discovery instead
-  if (strlen(sanitized) > 0) {
-    // Set via WiFi library
-    WiFi.setHostname(sanitized);
-    Logger.logLinef("Hostname: %s", sanitized);
-    
-    // Also set via esp_netif API (for compatibility)
-    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
-    if (netif != NULL) {
-      esp_netif_set_hostname(netif, sanitized);
+// Render task: LVGL timer handler, screen updates and MQTT values -> power screen
+void render_task(void* arg) {
+  (void)arg;
+  const uint32_t powerBits = MQTT_CHANNEL_BIT(MQTT_CHANNEL_SOLAR) | MQTT_CHANNEL_BIT(MQTT_CHANNEL_GRID);
+  #if FAST_BOOT
+  bool splashDone = false;
+  #endif
+
+  for (;;) {
+    unsigned long currentMillis = millis();
+
+    // Firmware update: no LVGL work, the panel keeps its last frame
+    if (web_portal_ota_in_progress()) {
+      vTaskDelay(pdMS_TO_TICKS(100));
+      continue;
     }
-  }
-  
-  // Configure fixed IP if provided
-  if (strlen(device_config.fixed_ip) > 0) {
-    Logger.logBegin("Fixed IP Config");
-    
-    IPAddress local_ip, gateway, subnet, dns1, dns2;
-    
-    if (!local_ip.fromString(device_config.fixed_ip)) {
-      Logger.logEnd("Invalid IP address");
-      Logger.logEnd("Connection failed");
-      return false;
+
+    #if FAST_BOOT
+    if (!splashDone) {
+      splashDone = leave_boot_splash();
     }
-    
-    if (!subnet.fromString(device_config.subnet_mask)) {
-      Logger.logEnd("Invalid subnet mask");
-      Logger.logEnd("Connection failed");
-      return false;
+    #endif
+
+    // Show changed MQTT values on the next frame (after the coalescing window)
+    unsigned long changedSince = 0;
+    if ((mqtt_manager_get_changes(&changedSince) & powerBits) &&
+        currentMillis - changedSince >= DISPLAY_COALESCE_MS) {
+      mqtt_manager_clear_changes(powerBits);
+      display_show_energy_values(mqtt_manager_get_value(MQTT_CHANNEL_SOLAR),
+                                 mqtt_manager_get_value(MQTT_CHANNEL_GRID));
     }
+
+    uint32_t waitMs = display_update();  // LVGL timers + perf counters
     
-    if (!gateway.fromString(device_config.gateway)) {
-      Logger.logEnd("Invalid gateway");
-      Logger.logEnd("Connection failed");
-      return false;
+    // Sample power statistics once per second (min/max window runs at 1 Hz)
+    if (currentMillis - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
+      float solar = mqtt_manager_get_value(MQTT_CHANNEL_SOLAR);
+      float grid = mqtt_manager_get_value(MQTT_CHANNEL_GRID);
+      display_update_energy(solar, grid);
+      lastDisplayUpdate = currentMillis;
     }
-    
-    // DNS1: use provided, or default to gateway
-    if (strlen(device_config.dns1) > 0) {
-      dns1.fromString(device_config.dns1);
-    } else {
-      dns1 = gateway;
+
+    // Idle-paced sleeps still end on time for the next statistics sample and
+    // for values that are waiting out the coalescing window
+    const unsigned long sinceSample = millis() - lastDisplayUpdate;
+    const uint32_t sampleLeft = sinceSample < DISPLAY_UPDATE_INTERVAL ? DISPLAY_UPDATE_INTERVAL - sinceSample : 0;
+    if (sampleLeft < waitMs) waitMs = sampleLeft;
+    if (mqtt_manager_get_changes(&changedSince) & powerBits) {
+      const unsigned long sinceChange = millis() - changedSince;
+      const uint32_t coalesceLeft = sinceChange < DISPLAY_COALESCE_MS ? DISPLAY_COALESCE_MS - sinceChange : 0;
+      if (coalesceLeft < waitMs) waitMs = coalesceLeft;
     }
-    
-    // DNS2: optional
-    if (strlen(device_config.dns2) > 0) {
-      dns2.fromString(device_config.dns2);
-    } else {
-      dns2 = IPAddress(0, 0, 0, 0);
+
+    idle_pacer_render_wait(waitMs);
+  }
+}
+#endif
+
+// Network task: WiFi state machine, MQTT client, energy history and heartbeat.
+// Nothing here blocks for long; reconnects run as deadlines in wifi_manager.
+void network_task(void* arg) {
+  (void)arg;
+  #if HAS_DISPLAY
+  const uint32_t powerBits = MQTT_CHANNEL_BIT(MQTT_CHANNEL_SOLAR) | MQTT_CHANNEL_BIT(MQTT_CHANNEL_GRID);
+  bool renderWoken = false;
+  #endif
+
+  for (;;) {
+    unsigned long currentMillis = millis();
+
+    // Handle MQTT messages (only with a link: a broker connect attempt blocks;
+    // paused during a firmware update)
+    if (wifi_manager_is_connected() && !web_portal_ota_in_progress()) {
+      mqtt_manager_loop();
     }
-    
-    if (!WiFi.config(local_ip, gateway, subnet, dns1, dns2)) {
-      Logger.logEnd("Configuration failed");
-      Logger.logEnd("Connection failed");
-      return false;
+
+    #if HAS_DISPLAY
+    // New power values: wake the render task instead of letting it sleep out
+    // an idle-paced period (once per batch of changes)
+    unsigned long changedSince = 0;
+    const bool powerChanged = (mqtt_manager_get_changes(&changedSince) & powerBits) != 0;
+    if (powerChanged && !renderWoken) {
+      idle_pacer_wake();
     }
-    
-    Logger.logLinef("IP: %s", device_config.fixed_ip);
-    Logger.logEnd();
-  }
-  
-  WiFi.begin(device_config.wifi_ssid, device_config.wifi_password);
-  
-  // Try to connect with exponential backoff
-  for (int attempt = 0; attempt < WIFI_MAX_ATTEMPTS; attempt++) {
-    unsigned long backoff = WIFI_BACKOFF_BASE * (attempt + 1);
-    unsigned long start = millis();
-    
-    Logger.logLinef("Attempt %d/%d (timeout %ds)", attempt + 1, WIFI_MAX_ATTEMPTS, backoff / 1000);
-    
-    while (millis() - start < backoff) {
-      wl_status_t status = WiFi.status();
-      if (status == WL_CONNECTED) {
-        Logger.logLinef("IP: %s", WiFi.localIP().toString().c_str());
-        Logger.logLinef("Hostname: %s", WiFi.getHostname());
-        Logger.logLinef("MAC: %s", WiFi.macAddress().c_str());
-        Logger.logLinef("Signal: %d dBm", WiFi.RSSI());
-        Logger.logLine("");
-        Logger.logLine("Access via:");
-        Logger.logLinef("  http://%s", WiFi.localIP().toString().c_str());
-        Logger.logLinef("  http://%s.local", WiFi.getHostname());
-        Logger.logEnd("Connected");
-        
-        return true;
+    renderWoken = powerChanged;
+    #endif
+
+    // Close energy history buckets (1s / 1m / 15m) and checkpoint to flash
+    energy_history_loop();
+
+    // WiFi reconnect state machine (not in AP mode: the fallback should stay active)
+    if (config_loaded && !web_portal_is_ap_mode()) {
+      wifi_manager_loop();
+      if (wifi_manager_take_connected_event()) {
+        start_mdns();
+        image_multicast_begin();
+        mqtt_manager_init(&device_config);
       }
-      delay(100);
+      #if FAST_BOOT
+      // Never connected since boot: same AP fallback as the blocking boot path
+      else if (boot_timing_get(BOOT_PHASE_WIFI) == 0 && wifi_manager_failures() >= 2 * WIFI_MAX_ATTEMPTS) {
+        Logger.logMessage("Main", "WiFi failed after reset - fallback to AP");
+        wifi_manager_stop();
+        web_portal_start_ap();
+      }
+      #endif
     }
     
-    // Log detailed failure reason for diagnostics
-    wl_status_t status = WiFi.status();
-    if (status != WL_CONNECTED) {
-      const char* reason = 
-        (status == WL_NO_SSID_AVAIL) ? "SSID not found" :
-        (status == WL_CONNECT_FAILED) ? "Connect failed (wrong password?)" :
-        (status == WL_CONNECTION_LOST) ? "Connection lost" :
-        (status == WL_DISCONNECTED) ? "Disconnected" :
-        "Unknown";
-      Logger.logLinef("Status: %s (%d)", reason, status);
+    // Check if it's time for heartbeat
+    if (currentMillis - lastHeartbeat >= HEARTBEAT_INTERVAL) {
+      if (WiFi.status() == WL_CONNECTED) {
+        Logger.logQuickf("Heartbeat", "Up: %ds | Heap: %d | WiFi: %s (%s)", 
+          currentMillis / 1000, ESP.getFreeHeap(), 
+          WiFi.localIP().toString().c_str(), WiFi.getHostname());
+      } else {
+        Logger.logQuickf("Heartbeat", "Up: %ds | Heap: %d | WiFi: Disconnected", 
+          currentMillis / 1000, ESP.getFreeHeap());
+      }
+      
+      lastHeartbeat = currentMillis;
     }
+
+    idle_pacer_task_delay(NETWORK_TASK_PERIOD_MS);
   }
-  
-  Logger.logEnd("All attempts failed");
-  return false;
 }
 
 // Start mDNS service with enhanced TXT records
@@ -0,0 +1,228 @@
+/*
+ * On-Device Benchmark Implementation
+ */
+
+#include "bench.h"
+
+#if ENABLE_BENCHMARK
+
+#include "bench_assets.h"
+#include "display_manager.h"
+#include "json_path.h"
+#include "lcd_driver.h"
+#include "log_manager.h"
+#include "screen_image.h"
+#include "strip_decoder.h"
+#include <esp_cpu.h>
+#include <esp_heap_caps.h>
+#include <lvgl.h>
+
+static volatile BenchState state = BENCH_IDLE;
+static volatile int requested_runs = 0;
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static int result_count = 0;
+static int last_runs = 0;
+
+// Time runs calls of fn (returns false on failure) and record min/median/max
+template <typename Fn>
+static void measure(const char* name, int runs, Fn fn) {
+    if (result_count >= BENCH_MAX_RESULTS) return;
+    BenchResult& r = results[result_count++];
+    strlcpy(r.name, name, sizeof(r.name));
+    r.ok = true;
+
+    uint32_t cycles[BENCH_MAX_RUNS];
+    int done = 0;
+    for (; done < runs; done++) {
+        const uint32_t start = esp_cpu_get_cycle_count();
+        const bool ok = fn(done);
+        cycles[done] = esp_cpu_get_cycle_count() - start;
+        if (!ok) {
+            r.ok = false;
+            break;
+        }
+    }
+
+    // Insertion sort: at most BENCH_MAX_RUNS entries
+    for (int i = 1; i < done; i++) {
+        const uint32_t v = cycles[i];
+        int j = i - 1;
+        while (j >= 0 && cycles[j] > v) {
+            cycles[j + 1] = cycles[j];
+            j--;
+        }
+        cycles[j + 1] = v;
+    }
+
+    r.runs = (uint16_t)done;
+    r.min_cycles = done ? cycles[0] : 0;
+    r.median_cycles = done ? cycles[done / 2] : 0;
+    r.max_cycles = done ? cycles[done - 1] : 0;
+
+    Logger.logLinef("%s: median %lu cycles (%lu us)%s", r.name, (unsigned long)r.median_cycles,
+                    (unsigned long)(r.median_cycles / ESP.getCpuFreqMHz()), r.ok ? "" : " FAILED");
+}
+
+static void bench_lcd(int runs) {
+    measure("lcd_fill_screen", runs, [](int i) {
+        lcd_fill_screen((i & 1) ? 0xFFFF : 0x001F);
+        return true;
+    });
+
+    const uint32_t count = 10000;
+    uint16_t* pixels = (uint16_t*)heap_caps_malloc(count * sizeof(uint16_t), MALLOC_CAP_DMA);
+    if (!pixels) return;
+    for (uint32_t i = 0; i < count; i++) {
+        pixels[i] = lcd_swap16((uint16_t)(i * 37));
+    }
+    measure("lcd_push_colors_10k", runs, [pixels, count](int) {
+        lcd_lock();
+        lcd_set_window(0, 0, LCD_LOGICAL_WIDTH - 1, (count + LCD_LOGICAL_WIDTH - 1) / LCD_LOGICAL_WIDTH - 1);
+        lcd_push_colors(pixels, count);
+        lcd_unlock();
+        return true;
+    });
+    heap_caps_free(pixels);
+}
+
+static void bench_convert(int runs) {
+    uint8_t rgb[LCD_LOGICAL_WIDTH * 3];
+    uint16_t row[LCD_LOGICAL_WIDTH];
+    for (int i = 0; i < LCD_LOGICAL_WIDTH * 3; i++) {
+        rgb[i] = (uint8_t)(i * 7);
+    }
+    measure("convert_frame", runs, [&rgb, &row](int) {
+        for (int y = 0; y < LCD_LOGICAL_HEIGHT; y++) {
+            strip_convert_row(rgb, row, LCD_LOGICAL_WIDTH);
+        }
+        return row[0] != 0x1234;  // keep the result alive
+    });
+}
+
+static void bench_strips(int runs) {
+    for (int s = 0; s < BENCH_STRIP_SET_COUNT; s++) {
+        const BenchStripSet& set = bench_strip_sets[s];
+        char name[24];
+        snprintf(name, sizeof(name), "strip_decode_%u", set.strip_height);
+
+        StripDecoder decoder;
+        measure(name, runs, [&decoder, &set](int) {
+            if (!decoder.begin(BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT)) return false;
+            bool ok = true;
+            for (int i = 0; ok && i < set.count; i++) {
+                ok = decoder.decode_strip(set.strips[i].data, set.strips[i].size, i);
+            }
+            decoder.end();
+            return ok;
+        });
+    }
+}
+
+static void bench_screens(int runs) {
+    lv_obj_t* active = lv_scr_act();
+    ImageScreen* image = new ImageScreen();
+    image->create();
+    image->set_timeout(0);
+    image->show();
+    measure("image_screen_load", runs, [image](int) {
+        if (!image->load_image(bench_image_jpeg, sizeof(bench_image_jpeg))) return false;
+        lv_refr_now(NULL);
+        return true;
+    });
+    image->clear_image();
+
+    // Leave the image screen before deleting it
+    lv_scr_load(active);
+    image->destroy();
+    delete image;
+
+    display_show_power_screen();
+
+    measure("power_screen_update", runs, [](int i) {
+        // Values that change every column's text, color and bar
+        display_show_energy_values((i & 1) ? 3.2f : 0.4f, (i & 1) ? -1.5f : 2.1f);
+        lv_refr_now(NULL);
+        return true;
+    });
+}
+
+static void bench_mqtt(int runs) {
+    static const char payload[] =
+        "{\"meter\":{\"id\":\"p1\",\"voltage\":[230.1,229.8,231.0],"
+        "\"phases\":[{\"power\":0.412,\"current\":1.8},{\"power\":1.250,\"current\":5.4}],"
+        "\"total\":1.662},\"ts\":1718000000}";
+    JsonPath path;
+    if (!json_path_compile(&path, "meter.phases[1].power")) return;
+
+    measure("mqtt_json_extract_x100", runs, [&path](int) {
+        float value = 0;
+        bool ok = true;
+        for (int i = 0; i < 100; i++) {
+            ok &= json_path_extract(path, payload, sizeof(payload) - 1, &value);
+        }
+        return ok && value > 1.0f;
+    });
+}
+
+static void run_all(void* ctx) {
+    const int runs = *(const int*)ctx;
+    bench_lcd(runs);
+    bench_convert(runs);
+    bench_strips(runs);
+    bench_screens(runs);
+    bench_mqtt(runs);
+}
+
+bool bench_request(int runs) {
+    if (state == BENCH_PENDING || state == BENCH_RUNNING) return false;
+    if (runs < 1) runs = 1;
+    if (runs > BENCH_MAX_RUNS) runs = BENCH_MAX_RUNS;
+    requested_runs = runs;
+    state = BENCH_PENDING;
+    return true;
+}
+
+void bench_process_pending() {
+    if (state != BENCH_PENDING) return;
+    state = BENCH_RUNNING;
+
+    int runs = requested_runs;
+    result_count = 0;
+    last_runs = runs;
+
+    Logger.logBegin("Benchmark");
+    Logger.logLinef("Runs: %d, CPU: %lu MHz", runs, (unsigned long)ESP.getCpuFreqMHz());
+    display_run_exclusive(run_all, &runs);
+    Logger.logEnd();
+
+    state = BENCH_DONE;
+}
+
+BenchState bench_get_state() {
+    return state;
+}
+
+const char* bench_state_name() {
+    switch (state) {
+        case BENCH_PENDING: return "pending";
+        case BENCH_RUNNING: return "running";
+        case BENCH_DONE:    return "done";
+        default:            return "idle";
+    }
+}
+
+int bench_runs() {
+    return last_runs;
+}
+
+int bench_result_count() {
+    return (state == BENCH_DONE) ? result_count : 0;
+}
+
+const BenchResult* bench_get_result(int index) {
+    if (index < 0 || index >= bench_result_count()) return nullptr;
+    return &results[index];
+}
+
+#endif // ENABLE_BENCHMARK
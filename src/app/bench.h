@@ -0,0 +1,63 @@
+/*
+ * On-Device Benchmark (ENABLE_BENCHMARK)
+ *
+ * Fixed display/decode workloads timed with the CPU cycle counter, so builds
+ * and boards can be compared run for run. POST /api/bench queues a run; the
+ * loop task executes it with the display locked (the panel shows test
+ * patterns meanwhile) and GET /api/bench returns min/median/max per workload.
+ *
+ * Workloads:
+ *   lcd_fill_screen          full-screen fill
+ *   lcd_push_colors_10k      10,000 pixels in one window
+ *   convert_frame            decoder pixel pass (RGB888 -> RGB565) over LCD_LOGICAL_HEIGHT rows
+ *   strip_decode_<h>         StripDecoder, whole test image as strips of height h (same
+ *                            backend choice as the image API)
+ *   image_screen_load        ImageScreen::load_image + full LVGL render (SJPG decoder)
+ *   power_screen_update      new power values + LVGL render
+ *   mqtt_json_extract_x100   100 json_path_extract() calls on a nested payload
+ *
+ * The strip and image workloads use tools/test240x280.jpg (bench_assets.h,
+ * generated by build.sh).
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+#include "board_config.h"
+
+#define BENCH_MAX_RUNS 50
+#define BENCH_MAX_RESULTS 12
+
+enum BenchState {
+    BENCH_IDLE = 0,
+    BENCH_PENDING,
+    BENCH_RUNNING,
+    BENCH_DONE
+};
+
+struct BenchResult {
+    char name[24];
+    bool ok;                  // false if a run failed (timings then cover the runs before it)
+    uint16_t runs;
+    uint32_t min_cycles;
+    uint32_t median_cycles;
+    uint32_t max_cycles;
+};
+
+// Queue a run of every workload, runs times each (1..BENCH_MAX_RUNS).
+// False if a run is already queued or in progress.
+bool bench_request(int runs);
+
+// Execute a queued run (call from the loop task, never from AsyncTCP)
+void bench_process_pending();
+
+BenchState bench_get_state();
+const char* bench_state_name();
+
+// Results of the last completed run
+int bench_runs();
+int bench_result_count();
+const BenchResult* bench_get_result(int index);
+
+#endif // BENCH_H
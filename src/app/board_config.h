@@ -49,10 +49,37 @@
 // Default WiFi Configuration
 // ============================================================================
 
+// Consecutive failed attempts before the radio is power-cycled (boot falls back
+// to AP mode after two rounds)
 #ifndef WIFI_MAX_ATTEMPTS
 #define WIFI_MAX_ATTEMPTS 3
 #endif
 
+// One connection attempt (association + DHCP)
+#ifndef WIFI_CONNECT_TIMEOUT_MS
+#define WIFI_CONNECT_TIMEOUT_MS 6000
+#endif
+
+// Wait before retrying after a failed attempt, doubling per failure up to the max
+#ifndef WIFI_BACKOFF_BASE_MS
+#define WIFI_BACKOFF_BASE_MS 500
+#endif
+
+#ifndef WIFI_BACKOFF_MAX_MS
+#define WIFI_BACKOFF_MAX_MS 60000
+#endif
+
+// Fast boot: connect to the cached BSSID/channel of the last AP (no scan), skip
+// the serial-attach delay, and leave the splash as soon as the first power value
+// arrives (or after BOOT_SPLASH_TIMEOUT_MS) instead of after a fixed 2 s
+#ifndef FAST_BOOT
+#define FAST_BOOT true
+#endif
+
+#ifndef BOOT_SPLASH_TIMEOUT_MS
+#define BOOT_SPLASH_TIMEOUT_MS 15000
+#endif
+
 // ============================================================================
 // Additional Default Configuration Settings
 // ============================================================================
@@ -102,11 +129,32 @@
 #define LCD_HEIGHT 280
 #endif
 
-// Display orientation
+// Display orientation, applied by the panel (ST7789 MADCTL), not by LVGL.
+// LCD_WIDTH/LCD_HEIGHT stay the portrait panel size; everything that draws uses
+// LCD_LOGICAL_WIDTH/LCD_LOGICAL_HEIGHT below.
 #ifndef LCD_ROTATION
 #define LCD_ROTATION 0  // 0=portrait, 1=landscape (90°), 2=portrait (180°), 3=landscape (270°)
 #endif
 
+// Position of the visible area in the controller's 240x320 RAM, in portrait.
+// The 1.69" module shows rows 20..299.
+#ifndef LCD_X_OFFSET
+#define LCD_X_OFFSET 0
+#endif
+
+#ifndef LCD_Y_OFFSET
+#define LCD_Y_OFFSET 20
+#endif
+
+// Size seen by LVGL, the image API and direct pixel writes (derived, do not override)
+#if LCD_ROTATION == 1 || LCD_ROTATION == 3
+#define LCD_LOGICAL_WIDTH LCD_HEIGHT
+#define LCD_LOGICAL_HEIGHT LCD_WIDTH
+#else
+#define LCD_LOGICAL_WIDTH LCD_WIDTH
+#define LCD_LOGICAL_HEIGHT LCD_HEIGHT
+#endif
+
 #ifndef LCD_CS_PIN
 #define LCD_CS_PIN 5      // Chip Select
 #endif
@@ -131,5 +179,301 @@
 #define LCD_SCK_PIN 18    // SPI Clock
 #endif
 
+// SPI clock for the panel (60MHz is within ST7789 spec)
+#ifndef LCD_SPI_FREQ_HZ
+#define LCD_SPI_FREQ_HZ 60000000
+#endif
+
+// LVGL draw buffer height in lines (two buffers of LCD_LOGICAL_WIDTH * lines pixels).
+// Boards with more RAM can raise this for fewer, larger flushes.
+#ifndef LCD_DRAW_BUF_LINES
+#define LCD_DRAW_BUF_LINES 20
+#endif
+
+// Non-blocking flush: the SPI DMA completion callback signals LVGL, so the next
+// area renders into the second buffer while the first one is on the wire.
+#ifndef LCD_ASYNC_FLUSH
+#define LCD_ASYNC_FLUSH true
+#endif
+
+// Largest single DMA transaction; bigger pixel pushes are split into chunks.
+// Must cover at least one LVGL draw buffer so a flush is a single transfer.
+#ifndef LCD_SPI_MAX_TRANSFER_BYTES
+#define LCD_SPI_MAX_TRANSFER_BYTES (LCD_LOGICAL_WIDTH * LCD_DRAW_BUF_LINES * 2)
+#endif
+
+// Power screen min/max window, in samples at the 1-second display update rate
+// (600 = 10 minutes). RAM: 8 bytes per sample for each of the 3 series.
+#ifndef POWER_STATS_WINDOW_SAMPLES
+#define POWER_STATS_WINDOW_SAMPLES 600
+#endif
+
+// Decoded-frame cache: re-show repeated images by id without transfer or decode.
+// Frames live in PSRAM when present (up to IMAGE_CACHE_PSRAM_BYTES). Without
+// PSRAM the cache is off unless IMAGE_CACHE_ON_FLASH puts it on the LittleFS
+// data partition: the default 128KB partition is shared with the energy history
+// and holds less than one raw 240x280 frame.
+#ifndef HAS_IMAGE_CACHE
+#define HAS_IMAGE_CACHE true
+#endif
+
+#ifndef IMAGE_CACHE_ON_FLASH
+#define IMAGE_CACHE_ON_FLASH false
+#endif
+
+#ifndef IMAGE_CACHE_MAX_ENTRIES
+#define IMAGE_CACHE_MAX_ENTRIES 16
+#endif
+
+#ifndef IMAGE_CACHE_PSRAM_BYTES
+#define IMAGE_CACHE_PSRAM_BYTES (1024 * 1024)
+#endif
+
+// Largest whole-image upload buffered in PSRAM (boards without PSRAM buffer up
+// to 100KB in internal heap). The limit is set at boot from the largest free
+// PSRAM block, so the image cache and a strip session still fit next to it.
+#ifndef IMAGE_UPLOAD_MAX_BYTES_PSRAM
+#define IMAGE_UPLOAD_MAX_BYTES_PSRAM (1024 * 1024)
+#endif
+
+// Strip ring: IMAGE_STRIP_SLOTS buffers of IMAGE_STRIP_MAX_BYTES, carved from
+// the image arena at boot and kept. The slot size is the largest strip (or
+// batch entry) the device accepts; tiles and multicast strips use the slots too.
+#ifndef IMAGE_STRIP_SLOTS
+#define IMAGE_STRIP_SLOTS 3
+#endif
+
+#ifndef IMAGE_STRIP_MAX_BYTES
+#define IMAGE_STRIP_MAX_BYTES (20 * 1024)
+#endif
+
+// Upload/strip buffer arena reserved at boot (see image_arena.h), so image
+// pushes do not fragment the heap. By default just the strip ring plus a
+// little slack; buffers that do not fit come from the heap. With PSRAM the
+// arena also covers the largest buffered upload.
+#ifndef IMAGE_ARENA_BYTES
+#define IMAGE_ARENA_BYTES (IMAGE_STRIP_SLOTS * IMAGE_STRIP_MAX_BYTES + 1024)
+#endif
+
+// Multicast strip frames (see image_multicast.h): group joined on every WiFi
+// connect and its UDP port (0 = multicast receive off). A frame is buffered
+// whole until its strips are drawn, so it is limited to
+// IMAGE_MULTICAST_MAX_FRAME_BYTES of strip data.
+#ifndef IMAGE_MULTICAST_GROUP
+#define IMAGE_MULTICAST_GROUP "239.255.71.1"
+#endif
+
+#ifndef IMAGE_MULTICAST_PORT
+#define IMAGE_MULTICAST_PORT 4711
+#endif
+
+#ifndef IMAGE_MULTICAST_MAX_FRAME_BYTES
+#define IMAGE_MULTICAST_MAX_FRAME_BYTES (64 * 1024)
+#endif
+
+// Missing strips are requested this long after the sender's end marker (plus
+// a random share of the same again, so a fleet does not NACK in lockstep),
+// then every IMAGE_MULTICAST_NACK_RETRY_MS; a frame that is still incomplete
+// after IMAGE_MULTICAST_NACK_LIMIT requests is dropped.
+#ifndef IMAGE_MULTICAST_NACK_DELAY_MS
+#define IMAGE_MULTICAST_NACK_DELAY_MS 20
+#endif
+
+#ifndef IMAGE_MULTICAST_NACK_RETRY_MS
+#define IMAGE_MULTICAST_NACK_RETRY_MS 150
+#endif
+
+#ifndef IMAGE_MULTICAST_NACK_LIMIT
+#define IMAGE_MULTICAST_NACK_LIMIT 8
+#endif
+
+// Deferred config saves (POST /api/brightness, e.g. the portal slider) are written
+// once no further change arrived for this long.
+#ifndef CONFIG_SAVE_QUIET_MS
+#define CONFIG_SAVE_QUIET_MS 3000
+#endif
+
+// Firmware updates (POST /api/update) are aborted when the client sends nothing
+// for this long; rendering, MQTT and uploads are paused while one runs.
+#ifndef OTA_STALL_TIMEOUT_S
+#define OTA_STALL_TIMEOUT_S 15
+#endif
+
+// Decode JPEGs with the target's hardware codec (ESP32-P4) or esp_new_jpeg
+// (ESP32-S3, when the component is installed) instead of ROM TJpgDec where the
+// job allows it (see jpeg_decoder.h). No effect on targets without either.
+#ifndef JPEG_DECODER_ACCEL
+#define JPEG_DECODER_ACCEL true
+#endif
+
+// Energy history tiers (bucket counts). 1s and 1m live in RAM (6 and 24 bytes
+// per bucket), 15m in append-only LittleFS segment files (28 bytes per bucket).
+// Closed 15m buckets are written in batches of ENERGY_HISTORY_CHECKPOINT_BUCKETS
+// (4 = hourly).
+#ifndef ENERGY_HISTORY_1S_BUCKETS
+#define ENERGY_HISTORY_1S_BUCKETS 600
+#endif
+
+#ifndef ENERGY_HISTORY_1M_BUCKETS
+#define ENERGY_HISTORY_1M_BUCKETS 1440
+#endif
+
+#ifndef ENERGY_HISTORY_15M_BUCKETS
+#define ENERGY_HISTORY_15M_BUCKETS 2880
+#endif
+
+#ifndef ENERGY_HISTORY_CHECKPOINT_BUCKETS
+#define ENERGY_HISTORY_CHECKPOINT_BUCKETS 4
+#endif
+
+// 15m buckets per segment file (288 = 3 days): header plus records fill two 4KB
+// flash blocks, so the 30 retained days take 11 segments.
+#ifndef ENERGY_HISTORY_SEGMENT_BUCKETS
+#define ENERGY_HISTORY_SEGMENT_BUCKETS 288
+#endif
+
+// MQTT channel table size (solar + grid + extra channels from the config)
+#ifndef MQTT_MAX_CHANNELS
+#define MQTT_MAX_CHANNELS 12
+#endif
+
+// Direct power ingest (see power_ingest.h): UDP port for binary value
+// datagrams (0 = UDP off; POST /api/power is always available). A sender
+// silent for MQTT_PUSH_SEQ_RESET_MS may restart its sequence numbers.
+#ifndef POWER_INGEST_UDP_PORT
+#define POWER_INGEST_UDP_PORT 4710
+#endif
+
+#ifndef MQTT_PUSH_SEQ_RESET_MS
+#define MQTT_PUSH_SEQ_RESET_MS 10000
+#endif
+
+// New MQTT power values reach the screen this long after the first change, so
+// solar and grid messages published back to back cost a single refresh
+#ifndef DISPLAY_COALESCE_MS
+#define DISPLAY_COALESCE_MS 50
+#endif
+
+// Log every received MQTT message and parsed value (meters publishing twice a
+// second flood the log; parse failures are always logged, once per streak).
+// Sets the initial MQTT log level to debug; it can also be raised at runtime.
+#ifndef MQTT_LOG_MESSAGES
+#define MQTT_LOG_MESSAGES false
+#endif
+
+// Logging (see log_manager.h). Lines go into a RAM ring that a low-priority task
+// drains to Serial; the ring size must be a power of two.
+#ifndef LOG_BUFFER_BYTES
+#define LOG_BUFFER_BYTES 4096
+#endif
+
+// Levels: 0 = error, 1 = warn, 2 = info, 3 = debug. LOG_MAX_LEVEL removes
+// leveled calls above it at compile time; LOG_DEFAULT_LEVEL is every module's
+// runtime level at boot.
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL 3
+#endif
+
+#ifndef LOG_DEFAULT_LEVEL
+#define LOG_DEFAULT_LEVEL 2
+#endif
+
+#ifndef LOG_TASK_STACK
+#define LOG_TASK_STACK 3072
+#endif
+
+#ifndef LOG_TASK_PRIORITY
+#define LOG_TASK_PRIORITY 1
+#endif
+
+#ifndef LOG_DRAIN_PERIOD_MS
+#define LOG_DRAIN_PERIOD_MS 10
+#endif
+
+// GET /api/logs/stream: concurrent clients, and how much buffered history a new
+// client is sent first (capped at LOG_BUFFER_BYTES; ?backlog= overrides)
+#ifndef LOG_STREAM_MAX_CLIENTS
+#define LOG_STREAM_MAX_CLIENTS 2
+#endif
+
+#ifndef LOG_STREAM_BACKLOG_BYTES
+#define LOG_STREAM_BACKLOG_BYTES 2048
+#endif
+
+// Seconds without a new sample are filled with the last value for this long
+#ifndef ENERGY_HISTORY_HOLD_MS
+#define ENERGY_HISTORY_HOLD_MS 10000
+#endif
+
+// On-device benchmark: POST/GET /api/bench (see bench.h). Off in normal builds;
+// the run takes over the display for a few seconds.
+#ifndef ENABLE_BENCHMARK
+#define ENABLE_BENCHMARK false
+#endif
+
+// FreeRTOS tasks (see app.ino). Render: LVGL and screens. Network: WiFi
+// watchdog, MQTT, energy history, heartbeat. Periods are the sleep between
+// iterations; every task blocks once per iteration, which is what keeps the
+// single-core ESP32-C3 responsive with all tasks at the same priority.
+#ifndef RENDER_TASK_STACK
+#define RENDER_TASK_STACK 6144
+#endif
+
+#ifndef RENDER_TASK_PERIOD_MS
+#define RENDER_TASK_PERIOD_MS 5
+#endif
+
+#ifndef NETWORK_TASK_STACK
+#define NETWORK_TASK_STACK 8192
+#endif
+
+#ifndef NETWORK_TASK_PERIOD_MS
+#define NETWORK_TASK_PERIOD_MS 10
+#endif
+
+// Idle pacing (see idle_pacer.h): with nothing invalidated, no animation, no
+// image on screen and no upload for IDLE_ACTIVITY_HOLD_MS, LVGL's refresh timer
+// and the render task stretch to RENDER_IDLE_PERIOD_MS and the loop/network
+// tasks to IDLE_TASK_PERIOD_MS. Any invalidation or upload restores full rate.
+#ifndef RENDER_IDLE_PERIOD_MS
+#define RENDER_IDLE_PERIOD_MS 250
+#endif
+
+#ifndef IDLE_TASK_PERIOD_MS
+#define IDLE_TASK_PERIOD_MS 50
+#endif
+
+#ifndef IDLE_ACTIVITY_HOLD_MS
+#define IDLE_ACTIVITY_HOLD_MS 2000
+#endif
+
+// Let the SoC light-sleep while every task is blocked (esp_pm, WiFi modem sleep
+// keeps the association). Needs CONFIG_PM_ENABLE and tickless idle in the core
+// build; off by default because the LEDC backlight PWM stops in light sleep on
+// cores that clock it from APB.
+#ifndef IDLE_LIGHT_SLEEP
+#define IDLE_LIGHT_SLEEP false
+#endif
+
+// Health sampler task (see health_sampler.h): one snapshot per period serves
+// GET /api/health, the last HEALTH_HISTORY_SAMPLES feed /api/health/history
+// (60 x 5 s = 5 minutes, 24 bytes each). Per-task CPU covers up to
+// HEALTH_MAX_TASKS tasks.
+#ifndef HEALTH_SAMPLE_PERIOD_MS
+#define HEALTH_SAMPLE_PERIOD_MS 5000
+#endif
+
+#ifndef HEALTH_HISTORY_SAMPLES
+#define HEALTH_HISTORY_SAMPLES 60
+#endif
+
+#ifndef HEALTH_MAX_TASKS
+#define HEALTH_MAX_TASKS 24
+#endif
+
+#ifndef HEALTH_TASK_STACK
+#define HEALTH_TASK_STACK 4096
+#endif
+
 #endif // BOARD_CONFIG_H
 
@@ -0,0 +1,55 @@
+/*
+ * Boot Timing Implementation
+ */
+
+#include "boot_timing.h"
+#include "log_manager.h"
+#include <esp_timer.h>
+
+static volatile uint32_t phase_ms[BOOT_PHASE_COUNT];
+static volatile bool fast_wifi = false;
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "display_ms",
+    "config_ms",
+    "setup_ms",
+    "wifi_ms",
+    "mqtt_ms",
+    "first_value_ms",
+    "power_screen_ms",
+};
+
+void boot_timing_mark(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT || phase_ms[phase] != 0) return;
+
+    uint32_t now = (uint32_t)(esp_timer_get_time() / 1000);
+    phase_ms[phase] = now ? now : 1;  // 0 means "not reached"
+
+    if (phase == BOOT_PHASE_POWER_SCREEN) {
+        Logger.logBegin("Boot Timing");
+        for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+            if (phase_ms[i]) {
+                Logger.logLinef("%s: %lu", PHASE_NAMES[i], (unsigned long)phase_ms[i]);
+            } else {
+                Logger.logLinef("%s: -", PHASE_NAMES[i]);
+            }
+        }
+        Logger.logEnd(fast_wifi ? "WiFi via cached AP" : "WiFi via scan");
+    }
+}
+
+uint32_t boot_timing_get(BootPhase phase) {
+    return phase < BOOT_PHASE_COUNT ? phase_ms[phase] : 0;
+}
+
+const char* boot_timing_phase_name(BootPhase phase) {
+    return phase < BOOT_PHASE_COUNT ? PHASE_NAMES[phase] : "";
+}
+
+void boot_timing_set_fast_wifi(bool fast) {
+    fast_wifi = fast;
+}
+
+bool boot_timing_fast_wifi() {
+    return fast_wifi;
+}
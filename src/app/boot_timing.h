@@ -0,0 +1,38 @@
+/*
+ * Boot Timing
+ *
+ * Milestones of the boot sequence in ms since reset (esp_timer, so the ROM and
+ * second-stage bootloader are not included). Each phase records the first time
+ * it is reached; the summary is logged once the power screen is shown and
+ * reported by GET /api/health.
+ *
+ * USAGE:
+ *   boot_timing_mark(BOOT_PHASE_WIFI);
+ *   uint32_t ms = boot_timing_get(BOOT_PHASE_WIFI);  // 0 = not reached yet
+ */
+
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <Arduino.h>
+
+enum BootPhase {
+    BOOT_PHASE_DISPLAY = 0,   // splash on screen
+    BOOT_PHASE_CONFIG,        // NVS config loaded
+    BOOT_PHASE_SETUP,         // setup() returned, tasks running
+    BOOT_PHASE_WIFI,          // first IP address
+    BOOT_PHASE_MQTT,          // first broker connection
+    BOOT_PHASE_FIRST_VALUE,   // first solar or grid value
+    BOOT_PHASE_POWER_SCREEN,  // power screen replaced the splash
+    BOOT_PHASE_COUNT
+};
+
+void boot_timing_mark(BootPhase phase);
+uint32_t boot_timing_get(BootPhase phase);
+const char* boot_timing_phase_name(BootPhase phase);  // JSON key, e.g. "wifi_ms"
+
+// WiFi came up through the cached BSSID/channel (no scan)
+void boot_timing_set_fast_wifi(bool fast);
+bool boot_timing_fast_wifi();
+
+#endif // BOOT_TIMING_H
@@ -2,18 +2,37 @@
  * Configuration Manager Implementation
  * 
  * Uses ESP32 Preferences library (NVS wrapper) for persistent storage.
- * Stores configuration in "device_cfg" namespace.
+ * Stores configuration in "device_cfg" namespace as a single blob:
+ * ConfigBlobHeader followed by DeviceConfig, CRC-32 over the DeviceConfig bytes.
+ * Configs from older firmware (one key per field) are migrated on first load.
  */
 
 #include "config_manager.h"
+#include "board_config.h"
 #include "web_assets.h"
 #include "log_manager.h"
 #include <Preferences.h>
+#include <esp_rom_crc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 // NVS namespace
 #define CONFIG_NAMESPACE "device_cfg"
 
-// Preferences keys
+// Blob key and layout version. Fields are only ever appended to DeviceConfig:
+// a shorter blob of the same version loads over the defaults. Bump the version
+// for any other layout change (and add a migration in load_blob()).
+#define KEY_CONFIG_BLOB    "config"
+#define CONFIG_BLOB_VERSION 1
+
+struct ConfigBlobHeader {
+    uint32_t magic;     // CONFIG_MAGIC
+    uint16_t version;   // CONFIG_BLOB_VERSION
+    uint16_t size;      // DeviceConfig bytes that follow
+    uint32_t crc;       // CRC-32 of those bytes
+};
+
+// Legacy per-field keys (read once for migration, then removed)
 #define KEY_WIFI_SSID      "wifi_ssid"
 #define KEY_WIFI_PASS      "wifi_pass"
 #define KEY_DEVICE_NAME    "device_name"
@@ -30,6 +49,7 @@
 #define KEY_MQTT_GRID      "mqtt_grid"
 #define KEY_MQTT_SOLAR_PATH "mqtt_sol_p"
 #define KEY_MQTT_GRID_PATH  "mqtt_grd_p"
+#define KEY_MQTT_CHANNELS  "mqtt_chans"
 #define KEY_LCD_BRIGHTNESS "lcd_bright"
 #define KEY_GRID_T0        "grid_t0"
 #define KEY_GRID_T1        "grid_t1"
@@ -46,10 +66,41 @@
 #define KEY_COLOR_WARN     "color_warn"
 #define KEY_MAGIC          "magic"
 
+static const char* const LEGACY_KEYS[] = {
+    KEY_WIFI_SSID, KEY_WIFI_PASS, KEY_DEVICE_NAME, KEY_FIXED_IP, KEY_SUBNET_MASK, KEY_GATEWAY,
+    KEY_DNS1, KEY_DNS2, KEY_MQTT_BROKER, KEY_MQTT_PORT, KEY_MQTT_USER, KEY_MQTT_PASS,
+    KEY_MQTT_SOLAR, KEY_MQTT_GRID, KEY_MQTT_SOLAR_PATH, KEY_MQTT_GRID_PATH, KEY_MQTT_CHANNELS,
+    KEY_LCD_BRIGHTNESS, KEY_GRID_T0, KEY_GRID_T1, KEY_GRID_T2, KEY_HOME_T0, KEY_HOME_T1, KEY_HOME_T2,
+    KEY_SOLAR_T0, KEY_SOLAR_T1, KEY_SOLAR_T2, KEY_COLOR_GOOD, KEY_COLOR_OK, KEY_COLOR_ATTN,
+    KEY_COLOR_WARN, KEY_MAGIC,
+};
+
 static Preferences preferences;
 
+// CRC of the config as last read from / written to NVS (skips unchanged saves)
+static uint32_t stored_crc = 0;
+static bool stored_valid = false;
+
+// Deferred writer: latest config handed to config_manager_save_deferred(), written
+// by config_manager_loop() once no new save arrived for CONFIG_SAVE_QUIET_MS
+static SemaphoreHandle_t config_mutex = nullptr;
+static DeviceConfig deferred_config;
+static DeviceConfig flush_config;  // static: too large for the caller's stack
+static bool deferred_dirty = false;
+static unsigned long deferred_changed_ms = 0;
+
+struct ConfigLock {
+    ConfigLock() { if (config_mutex) xSemaphoreTake(config_mutex, portMAX_DELAY); }
+    ~ConfigLock() { if (config_mutex) xSemaphoreGive(config_mutex); }
+};
+
+static uint32_t config_crc(const DeviceConfig *config) {
+    return esp_rom_crc32_le(0, (const uint8_t*)config, sizeof(DeviceConfig));
+}
+
 // Initialize NVS
 void config_manager_init() {
+    if (!config_mutex) config_mutex = xSemaphoreCreateMutex();
     Logger.logMessage("Config", "NVS initialized");
 }
 
@@ -96,22 +147,15 @@ void config_manager_sanitize_device_name(const char *input, char *output, size_t
     output[j] = '\0';
 }
 
-// Load configuration from NVS
-bool config_manager_load(DeviceConfig *config) {
-    if (!config) {
-        Logger.logMessage("Config", "Load failed: NULL pointer");
-        return false;
-    }
-    
-    Logger.logBegin("Config Load");
-    
-    // Set all defaults first (used if no config exists or as fallbacks)
+// Factory defaults (used if no config exists or as fallbacks)
+static void apply_defaults(DeviceConfig *config) {
     String default_name = config_manager_get_default_device_name();
     strlcpy(config->device_name, default_name.c_str(), CONFIG_DEVICE_NAME_MAX_LEN);
     config->mqtt_port = 1883;
     config->lcd_brightness = 100;
     strlcpy(config->mqtt_solar_value_path, ".", sizeof(config->mqtt_solar_value_path));
     strlcpy(config->mqtt_grid_value_path, ".", sizeof(config->mqtt_grid_value_path));
+    config->mqtt_channels[0] = '\0';
     
     // Power threshold defaults
     config->grid_threshold[0] = 0.0f;
@@ -131,14 +175,80 @@ bool config_manager_load(DeviceConfig *config) {
     config->color_warning = 0xFF0000;
     
     config->magic = CONFIG_MAGIC;
+}
+
+// Empty string fields that have a non-empty default
+static void apply_empty_defaults(DeviceConfig *config) {
+    if (strlen(config->device_name) == 0) {
+        String fallback_name = config_manager_get_default_device_name();
+        strlcpy(config->device_name, fallback_name.c_str(), CONFIG_DEVICE_NAME_MAX_LEN);
+    }
     
-    preferences.begin(CONFIG_NAMESPACE, true); // Read-only mode
+    // Set defaults for value paths if empty (both default to "." for direct numeric values)
+    if (strlen(config->mqtt_solar_value_path) == 0) {
+        strlcpy(config->mqtt_solar_value_path, ".", sizeof(config->mqtt_solar_value_path));
+    }
+    if (strlen(config->mqtt_grid_value_path) == 0) {
+        strlcpy(config->mqtt_grid_value_path, ".", sizeof(config->mqtt_grid_value_path));
+    }
+}
+
+enum BlobResult {
+    BLOB_OK,
+    BLOB_MISSING,
+    BLOB_CORRUPT
+};
+
+// One NVS read: header + DeviceConfig (preferences open)
+static BlobResult load_blob(DeviceConfig *config) {
+    const size_t len = preferences.getBytesLength(KEY_CONFIG_BLOB);
+    if (len == 0) return BLOB_MISSING;
+    
+    static uint8_t buf[sizeof(ConfigBlobHeader) + sizeof(DeviceConfig)];
+    if (len < sizeof(ConfigBlobHeader) || len > sizeof(buf) ||
+        preferences.getBytes(KEY_CONFIG_BLOB, buf, len) != len) {
+        Logger.logLinef("Blob: bad length %u", (unsigned)len);
+        return BLOB_CORRUPT;
+    }
     
+    ConfigBlobHeader hdr;
+    memcpy(&hdr, buf, sizeof(hdr));
+    const uint8_t* payload = buf + sizeof(hdr);
+    if (hdr.magic != CONFIG_MAGIC || hdr.version != CONFIG_BLOB_VERSION ||
+        hdr.size > sizeof(DeviceConfig) || sizeof(hdr) + hdr.size != len) {
+        Logger.logLinef("Blob: unsupported (version %u, %u bytes)", hdr.version, hdr.size);
+        return BLOB_CORRUPT;
+    }
+    if (esp_rom_crc32_le(0, payload, hdr.size) != hdr.crc) {
+        Logger.logLine("Blob: CRC mismatch");
+        return BLOB_CORRUPT;
+    }
+    
+    // Older firmware wrote a shorter DeviceConfig: newer fields keep their defaults
+    memcpy(config, payload, hdr.size);
+    config->magic = CONFIG_MAGIC;
+    return BLOB_OK;
+}
+
+// preferences open read-write
+static bool write_blob(const DeviceConfig *config) {
+    static uint8_t buf[sizeof(ConfigBlobHeader) + sizeof(DeviceConfig)];
+    ConfigBlobHeader hdr = {CONFIG_MAGIC, CONFIG_BLOB_VERSION, (uint16_t)sizeof(DeviceConfig), config_crc(config)};
+    memcpy(buf, &hdr, sizeof(hdr));
+    memcpy(buf + sizeof(hdr), config, sizeof(DeviceConfig));
+    if (preferences.putBytes(KEY_CONFIG_BLOB, buf, sizeof(buf)) != sizeof(buf)) {
+        return false;
+    }
+    stored_crc = hdr.crc;
+    stored_valid = true;
+    return true;
+}
+
+// Per-field keys of firmware before the blob (preferences open)
+static bool load_legacy(DeviceConfig *config) {
     // Check magic number first
     uint32_t magic = preferences.getUInt(KEY_MAGIC, 0);
     if (magic != CONFIG_MAGIC) {
-        preferences.end();
-        Logger.logEnd("No config found - defaults applied");
         return false;
     }
     
@@ -148,10 +258,6 @@ bool config_manager_load(DeviceConfig *config) {
     
     // Load device settings (use default if empty)
     preferences.getString(KEY_DEVICE_NAME, config->device_name, CONFIG_DEVICE_NAME_MAX_LEN);
-    if (strlen(config->device_name) == 0) {
-        String fallback_name = config_manager_get_default_device_name();
-        strlcpy(config->device_name, fallback_name.c_str(), CONFIG_DEVICE_NAME_MAX_LEN);
-    }
     
     // Load fixed IP settings
     preferences.getString(KEY_FIXED_IP, config->fixed_ip, CONFIG_IP_STR_MAX_LEN);
@@ -169,14 +275,7 @@ bool config_manager_load(DeviceConfig *config) {
     preferences.getString(KEY_MQTT_GRID, config->mqtt_topic_grid, CONFIG_MQTT_TOPIC_MAX_LEN);
     preferences.getString(KEY_MQTT_SOLAR_PATH, config->mqtt_solar_value_path, sizeof(config->mqtt_solar_value_path));
     preferences.getString(KEY_MQTT_GRID_PATH, config->mqtt_grid_value_path, sizeof(config->mqtt_grid_value_path));
-    
-    // Set defaults for value paths if empty (both default to "." for direct numeric values)
-    if (strlen(config->mqtt_solar_value_path) == 0) {
-        strlcpy(config->mqtt_solar_value_path, ".", sizeof(config->mqtt_solar_value_path));
-    }
-    if (strlen(config->mqtt_grid_value_path) == 0) {
-        strlcpy(config->mqtt_grid_value_path, ".", sizeof(config->mqtt_grid_value_path));
-    }
+    preferences.getString(KEY_MQTT_CHANNELS, config->mqtt_channels, sizeof(config->mqtt_channels));
     
     // Load LCD settings
     config->lcd_brightness = preferences.getUChar(KEY_LCD_BRIGHTNESS, 100);
@@ -199,9 +298,58 @@ bool config_manager_load(DeviceConfig *config) {
     config->color_warning = preferences.getUInt(KEY_COLOR_WARN, 0xFF0000);
     
     config->magic = magic;
+    return true;
+}
+
+// Write the blob, then drop the per-field keys (the blob wins if this is cut short)
+static void migrate_legacy(const DeviceConfig *config) {
+    preferences.begin(CONFIG_NAMESPACE, false);
+    if (write_blob(config)) {
+        for (size_t i = 0; i < sizeof(LEGACY_KEYS) / sizeof(LEGACY_KEYS[0]); i++) {
+            preferences.remove(LEGACY_KEYS[i]);
+        }
+        Logger.logLine("Migrated per-field keys to blob");
+    } else {
+        Logger.logLine("ERROR: Migration write failed, keeping per-field keys");
+    }
+    preferences.end();
+}
+
+// Load configuration from NVS
+bool config_manager_load(DeviceConfig *config) {
+    if (!config) {
+        Logger.logMessage("Config", "Load failed: NULL pointer");
+        return false;
+    }
+    
+    Logger.logBegin("Config Load");
     
+    // Set all defaults first (used if no config exists or as fallbacks)
+    apply_defaults(config);
+    
+    preferences.begin(CONFIG_NAMESPACE, true); // Read-only mode
+    BlobResult blob = load_blob(config);
+    bool migrate = false;
+    if (blob != BLOB_OK) {
+        // Nothing usable in the blob: older firmware's per-field keys, if any
+        migrate = load_legacy(config);
+    }
     preferences.end();
     
+    if (blob != BLOB_OK && !migrate) {
+        Logger.logEnd(blob == BLOB_CORRUPT ? "Config blob unreadable - defaults applied"
+                                           : "No config found - defaults applied");
+        return false;
+    }
+    
+    apply_empty_defaults(config);
+    if (migrate) {
+        migrate_legacy(config);
+    } else {
+        stored_crc = config_crc(config);
+        stored_valid = true;
+    }
+    
     // Validate loaded config
     if (!config_manager_is_valid(config)) {
         Logger.logEnd("Invalid config");
@@ -213,6 +361,17 @@ bool config_manager_load(DeviceConfig *config) {
     return true;
 }
 
+// Write config to NVS (caller validated it). false on a flash write error.
+static bool write_config(const DeviceConfig *config, bool *unchanged) {
+    *unchanged = stored_valid && config_crc(config) == stored_crc;
+    if (*unchanged) return true;
+    
+    preferences.begin(CONFIG_NAMESPACE, false); // Read-write mode
+    const bool ok = write_blob(config);
+    preferences.end();
+    return ok;
+}
+
 // Save configuration to NVS
 bool config_manager_save(const DeviceConfig *config) {
     if (!config) {
@@ -227,63 +386,58 @@ bool config_manager_save(const DeviceConfig *config) {
     
     Logger.logBegin("Config Save");
     
-    preferences.begin(CONFIG_NAMESPACE, false); // Read-write mode
-    
-    // Save WiFi settings
-    preferences.putString(KEY_WIFI_SSID, config->wifi_ssid);
-    preferences.putString(KEY_WIFI_PASS, config->wifi_password);
-    
-    // Save device settings
-    preferences.putString(KEY_DEVICE_NAME, config->device_name);
-    
-    // Save fixed IP settings
-    preferences.putString(KEY_FIXED_IP, config->fixed_ip);
-    preferences.putString(KEY_SUBNET_MASK, config->subnet_mask);
-    preferences.putString(KEY_GATEWAY, config->gateway);
-    preferences.putString(KEY_DNS1, config->dns1);
-    preferences.putString(KEY_DNS2, config->dns2);
-    
-    // Save MQTT settings
-    preferences.putString(KEY_MQTT_BROKER, config->mqtt_broker);
-    preferences.putUShort(KEY_MQTT_PORT, config->mqtt_port);
-    preferences.putString(KEY_MQTT_USER, config->mqtt_username);
-    preferences.putString(KEY_MQTT_PASS, config->mqtt_password);
-    preferences.putString(KEY_MQTT_SOLAR, config->mqtt_topic_solar);
-    preferences.putString(KEY_MQTT_GRID, config->mqtt_topic_grid);
-    
     // Normalize empty value paths to "." before saving
-    const char* solar_path = (strlen(config->mqtt_solar_value_path) == 0) ? "." : config->mqtt_solar_value_path;
-    const char* grid_path = (strlen(config->mqtt_grid_value_path) == 0) ? "." : config->mqtt_grid_value_path;
-    preferences.putString(KEY_MQTT_SOLAR_PATH, solar_path);
-    preferences.putString(KEY_MQTT_GRID_PATH, grid_path);
-    
-    // Save LCD settings
-    preferences.putUChar(KEY_LCD_BRIGHTNESS, config->lcd_brightness);
-    
-    // Save power thresholds
-    preferences.putFloat(KEY_GRID_T0, config->grid_threshold[0]);
-    preferences.putFloat(KEY_GRID_T1, config->grid_threshold[1]);
-    preferences.putFloat(KEY_GRID_T2, config->grid_threshold[2]);
-    preferences.putFloat(KEY_HOME_T0, config->home_threshold[0]);
-    preferences.putFloat(KEY_HOME_T1, config->home_threshold[1]);
-    preferences.putFloat(KEY_HOME_T2, config->home_threshold[2]);
-    preferences.putFloat(KEY_SOLAR_T0, config->solar_threshold[0]);
-    preferences.putFloat(KEY_SOLAR_T1, config->solar_threshold[1]);
-    preferences.putFloat(KEY_SOLAR_T2, config->solar_threshold[2]);
-    
-    // Save color configuration
-    preferences.putUInt(KEY_COLOR_GOOD, config->color_good);
-    preferences.putUInt(KEY_COLOR_OK, config->color_ok);
-    preferences.putUInt(KEY_COLOR_ATTN, config->color_attention);
-    preferences.putUInt(KEY_COLOR_WARN, config->color_warning);
-    
-    // Save magic number last (indicates valid config)
-    preferences.putUInt(KEY_MAGIC, CONFIG_MAGIC);
+    static DeviceConfig normalized;
+    ConfigLock lock;
+    normalized = *config;
+    apply_empty_defaults(&normalized);
+    deferred_dirty = false;  // superseded by this save
+    
+    bool unchanged = false;
+    if (!write_config(&normalized, &unchanged)) {
+        Logger.logEnd("ERROR: NVS write failed");
+        return false;
+    }
     
-    preferences.end();
+    config_manager_print(&normalized);
+    Logger.logEnd(unchanged ? "Unchanged, not written" : nullptr);
+    return true;
+}
+
+void config_manager_save_deferred(const DeviceConfig *config) {
+    if (!config) return;
+    ConfigLock lock;
+    deferred_config = *config;
+    deferred_dirty = true;
+    deferred_changed_ms = millis();
+}
+
+void config_manager_loop() {
+    if (!deferred_dirty || (millis() - deferred_changed_ms) < CONFIG_SAVE_QUIET_MS) return;
+    config_manager_flush();
+}
+
+bool config_manager_flush() {
+    ConfigLock lock;
+    if (!deferred_dirty) return true;
+    deferred_dirty = false;
+    flush_config = deferred_config;
+    
+    // AP mode without WiFi credentials: nothing persistable yet
+    if (!config_manager_is_valid(&flush_config)) {
+        Logger.logMessage("Config", "Deferred save skipped: Invalid config");
+        return false;
+    }
+    apply_empty_defaults(&flush_config);
     
-    config_manager_print(config);
-    Logger.logEnd();
+    bool unchanged = false;
+    if (!write_config(&flush_config, &unchanged)) {
+        Logger.logMessage("Config", "ERROR: Deferred save failed");
+        return false;
+    }
+    if (!unchanged) {
+        Logger.logMessage("Config", "Deferred save written");
+    }
     return true;
 }
 
@@ -291,9 +445,12 @@ bool config_manager_save(const DeviceConfig *config) {
 bool config_manager_reset() {
     Logger.logBegin("Config Reset");
     
+    ConfigLock lock;
+    deferred_dirty = false;
     preferences.begin(CONFIG_NAMESPACE, false);
     bool success = preferences.clear();
     preferences.end();
+    stored_valid = false;
     
     if (success) {
         Logger.logEnd();
@@ -3,6 +3,8 @@
  * 
  * Manages persistent storage of device configuration in ESP32 NVS.
  * Provides load/save/reset functionality with validation.
+ * The whole DeviceConfig is one versioned, CRC-checked NVS blob: loading is a
+ * single read, and saving a config identical to the stored one writes nothing.
  * 
  * USAGE:
  *   config_manager_init();           // Initialize NVS
@@ -12,6 +14,8 @@
  *       // No config found, need to configure
  *   }
  *   config_manager_save();           // Save after user configures
+ *   config_manager_save_deferred();  // Save once changes stop (sliders, live tweaks)
+ *   config_manager_loop();           // From the main loop: writes deferred saves
  *   config_manager_reset();          // Erase all config
  */
 
@@ -29,6 +33,7 @@
 #define CONFIG_MQTT_USERNAME_MAX_LEN 32
 #define CONFIG_MQTT_PASSWORD_MAX_LEN 64
 #define CONFIG_MQTT_TOPIC_MAX_LEN 128
+#define CONFIG_MQTT_CHANNELS_MAX_LEN 512
 
 // Configuration structure
 struct DeviceConfig {
@@ -55,6 +60,7 @@ struct DeviceConfig {
     char mqtt_topic_grid[CONFIG_MQTT_TOPIC_MAX_LEN];
     char mqtt_solar_value_path[32];  // JSON path or "." for direct number (e.g., "value", "power")
     char mqtt_grid_value_path[32];   // JSON path or "." for direct number
+    char mqtt_channels[CONFIG_MQTT_CHANNELS_MAX_LEN];  // Extra channels, one per line: name;topic;path;scale;unit
     
     // LCD settings
     uint8_t lcd_brightness;  // 0-100%, default 100
@@ -81,7 +87,12 @@ struct DeviceConfig {
 void config_manager_init();                           // Initialize NVS
 bool config_manager_load(DeviceConfig *config);       // Load config from NVS
 bool config_manager_save(const DeviceConfig *config); // Save config to NVS
-bool config_manager_reset();                          // Erase config from NVS
+bool config_manager_reset();                          // Erase config from NVS (drops a pending deferred save)
+// Coalesced save: keeps a copy and writes it after CONFIG_SAVE_QUIET_MS without a
+// newer call, so a burst of changes costs one flash write. Safe from any task.
+void config_manager_save_deferred(const DeviceConfig *config);
+void config_manager_loop();                           // Write a deferred save once quiet (main loop)
+bool config_manager_flush();                          // Write a deferred save now (e.g. before a reboot)
 bool config_manager_is_valid(const DeviceConfig *config); // Check if config is valid
 bool config_manager_validate_thresholds(const DeviceConfig *config); // Validate threshold values and ordering
 void config_manager_print(const DeviceConfig *config); // Debug print config
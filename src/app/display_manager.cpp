@@ -3,62 +3,120 @@
 #include "log_manager.h"
 #include "screen_splash.h"
 #include "screen_power.h"
+#include "screen_trend.h"
 #include "screen_image.h"
 #include "screen_direct_image.h"
+#include "image_cache.h"
+#include "raw_image.h"
+#include "perf_counters.h"
+#include "idle_pacer.h"
+#include "mem_placement.h"
 #include <math.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf1[LCD_WIDTH * 20];  // Larger buffer for faster rendering
-static lv_color_t buf2[LCD_WIDTH * 20];  // Second buffer for double buffering
+// Flush sources: internal DMA-capable RAM (allocated in display_init, never PSRAM)
+static lv_color_t* buf1 = nullptr;
+static lv_color_t* buf2 = nullptr;  // Second buffer for double buffering
 static lv_disp_drv_t disp_drv;
+static lv_disp_t* disp = nullptr;
 
 // Screen instances
 static SplashScreen* splash_screen = nullptr;
 static PowerScreen* power_screen = nullptr;
+static TrendScreen* trend_screen = nullptr;
 static ImageScreen* image_screen = nullptr;
 static DirectImageScreen* direct_image_screen = nullptr;
 static ScreenBase* current_screen = nullptr;
 static ScreenBase* previous_screen = nullptr;  // Track previous screen for return after image timeout
 
-// FPS counter - Set to 1 to enable, 0 to disable
-#define ENABLE_FPS_COUNTER 0
-
-// FPS counter
-static lv_obj_t* fps_label = nullptr;
-static unsigned long fps_last_time = 0;
-static int fps_frame_count = 0;
-static float fps_current = 0.0f;
-
-// RGB565 to BGR565 color swap for anti-aliasing fix
-// LVGL blends colors in RGB space, but ST7789V2 display expects BGR
-// Swapping here fixes color artifacts on anti-aliased text edges
-static inline void rgb565_to_bgr565(uint16_t *pixels, uint32_t count) {
-    for (uint32_t i = 0; i < count; i++) {
-        uint16_t color = pixels[i];
-        // Extract RGB components from RGB565
-        uint16_t r = (color >> 11) & 0x1F;  // 5 bits red
-        uint16_t g = (color >> 5) & 0x3F;   // 6 bits green
-        uint16_t b = color & 0x1F;          // 5 bits blue
-        // Recombine as BGR565
-        pixels[i] = (b << 11) | (g << 5) | r;
+// Serializes LVGL and the screen state across tasks: the render task, the image
+// decode task (strip sessions, decodes) and the loop task (deferred portal work).
+// Recursive so public functions can call each other. Lock order: display, then lcd.
+static SemaphoreHandle_t display_mutex = nullptr;
+static int lock_depth = 0;  // guarded by display_mutex
+
+// Releasing the outermost lock with areas left invalidated wakes the render
+// task, which may be sleeping out an idle-paced period
+struct DisplayLock {
+    DisplayLock() {
+        if (!display_mutex) return;
+        xSemaphoreTakeRecursive(display_mutex, portMAX_DELAY);
+        lock_depth++;
+    }
+    ~DisplayLock() {
+        if (!display_mutex) return;
+        const bool wake = --lock_depth == 0 && disp && disp->inv_p > 0;
+        xSemaphoreGiveRecursive(display_mutex);
+        if (wake) idle_pacer_wake();
     }
+};
+
+// LVGL's refresh timer runs every RENDER_IDLE_PERIOD_MS while idle-paced
+static bool refr_stretched = false;
+
+static void set_refr_stretched(bool stretched) {
+    if (!disp || stretched == refr_stretched) return;
+    lv_timer_t* refr = _lv_disp_get_refr_timer(disp);
+    lv_timer_set_period(refr, stretched ? RENDER_IDLE_PERIOD_MS : LV_DISP_DEF_REFR_PERIOD);
+    if (!stretched) lv_timer_ready(refr);  // draw what is pending now
+    refr_stretched = stretched;
+}
+
+// Start of the flush in flight (LVGL waits for one flush to finish before the next)
+static int64_t flush_start_us = 0;
+
+#if LCD_ASYNC_FLUSH
+// SPI DMA completion (interrupt context): hand the buffer back to LVGL
+static void display_flush_done(void *arg) {
+    perf_record(PERF_FLUSH, (uint32_t)(esp_timer_get_time() - flush_start_us));
+    lv_disp_flush_ready((lv_disp_drv_t *)arg);
 }
+#endif
 
 static void display_flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
     const uint32_t w = (uint32_t)(area->x2 - area->x1 + 1);
     const uint32_t h = (uint32_t)(area->y2 - area->y1 + 1);
     const uint32_t pixel_count = w * h;
 
-    // Swap RGB to BGR for display hardware
-    rgb565_to_bgr565((uint16_t *)color_p, pixel_count);
+    flush_start_us = esp_timer_get_time();
+    perf_count_flush_pixels(pixel_count);
 
+    // No per-pixel pass: LVGL renders true RGB565 (the panel's native channel
+    // order with MADCTL RGB bit 0) and LV_COLOR_16_SWAP already stores each pixel
+    // high byte first, so the draw buffer goes straight to the DMA transfer.
+#if LCD_ASYNC_FLUSH
+    // Returns as soon as the transfer is queued; LVGL renders the next area into
+    // the other buffer and is released by display_flush_done() from the SPI ISR.
+    lcd_push_pixels_async(area->x1, area->y1, area->x2, area->y2,
+                          (const uint16_t *)color_p, pixel_count,
+                          display_flush_done, disp);
+#else
     lcd_set_window(area->x1, area->y1, area->x2, area->y2);
-    lcd_push_colors((uint16_t *)color_p, pixel_count);
+    lcd_push_colors((const uint16_t *)color_p, pixel_count);
 
+    perf_record(PERF_FLUSH, (uint32_t)(esp_timer_get_time() - flush_start_us));
     lv_disp_flush_ready(disp);
+#endif
+}
+
+// lv_timer_handler() with its duration recorded (PERF_LVGL_HANDLER). Pending
+// invalidations end idle pacing first so they are drawn in this pass.
+// Returns ms until LVGL's next timer is due.
+static uint32_t run_timer_handler() {
+    if (disp && disp->inv_p > 0) set_refr_stretched(false);
+    const int64_t start = esp_timer_get_time();
+    const uint32_t next = lv_timer_handler();
+    perf_record(PERF_LVGL_HANDLER, (uint32_t)(esp_timer_get_time() - start));
+    return next;
 }
 
 void display_init() {
+    display_mutex = xSemaphoreCreateRecursiveMutex();
+    DisplayLock lock;
+
     lcd_init();
 
     lv_init();
@@ -66,27 +124,28 @@ void display_init() {
     // Initialize LVGL split-JPEG decoder (if enabled in LVGL config)
     lv_split_jpeg_init();
 
-    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, LCD_WIDTH * 20);  // Double buffering
+    const size_t buf_pixels = LCD_LOGICAL_WIDTH * LCD_DRAW_BUF_LINES;
+    buf1 = (lv_color_t*)mem_alloc_dma(buf_pixels * sizeof(lv_color_t));
+    buf2 = (lv_color_t*)mem_alloc_dma(buf_pixels * sizeof(lv_color_t));
+    if (!buf1) {
+        Logger.logMessage("Display", "ERROR: Failed to allocate draw buffer");
+        return;
+    }
+    if (!buf2) {
+        Logger.logMessage("Display", "WARNING: Single draw buffer (no DMA RAM for a second one)");
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, buf_pixels);  // Double buffering
 
     lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = LCD_WIDTH;
-    disp_drv.ver_res = LCD_HEIGHT;
+    // Logical size: the panel applies LCD_ROTATION itself (MADCTL), so areas
+    // go to the flush untouched instead of through sw_rotate's temp buffer
+    disp_drv.hor_res = LCD_LOGICAL_WIDTH;
+    disp_drv.ver_res = LCD_LOGICAL_HEIGHT;
     disp_drv.flush_cb = display_flush_cb;
     disp_drv.draw_buf = &draw_buf;
     disp_drv.full_refresh = 0;
     
-#if LCD_ROTATION == 1
-    disp_drv.sw_rotate = 1;  // 90° clockwise
-    disp_drv.rotated = LV_DISP_ROT_90;
-#elif LCD_ROTATION == 2
-    disp_drv.sw_rotate = 1;
-    disp_drv.rotated = LV_DISP_ROT_180;
-#elif LCD_ROTATION == 3
-    disp_drv.sw_rotate = 1;
-    disp_drv.rotated = LV_DISP_ROT_270;
-#endif
-    
-    lv_disp_drv_register(&disp_drv);
+    disp = lv_disp_drv_register(&disp_drv);
     
     // Create and show splash screen
     splash_screen = new SplashScreen();
@@ -97,23 +156,16 @@ void display_init() {
     // Create power screen (but don't show yet)
     power_screen = new PowerScreen();
     power_screen->create();
-    
-#if ENABLE_FPS_COUNTER
-    // Create FPS counter label on splash screen (will be recreated on screen changes)
-    fps_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_color(fps_label, lv_color_hex(0x0000FF), 0);  // BGR for red
-    lv_obj_set_style_text_font(fps_label, &lv_font_montserrat_20, 0);   // Larger font
-    lv_label_set_text(fps_label, "FPS: --");
-    lv_obj_align(fps_label, LV_ALIGN_BOTTOM_RIGHT, -15, -5);  // 10px from corner
-#endif
-    fps_last_time = millis();
+
+    // Create trend screen (shown on request)
+    trend_screen = new TrendScreen();
+    trend_screen->create();
 }
 
-void display_update() {
-    lv_timer_handler();
-#if ENABLE_FPS_COUNTER
-    display_update_fps();  // Update FPS counter
-#endif
+uint32_t display_update() {
+    DisplayLock lock;
+    uint32_t next = run_timer_handler();
+    perf_counters_update();
     
     if (current_screen) {
         current_screen->update();
@@ -128,81 +180,90 @@ void display_update() {
     if (direct_image_screen && current_screen == direct_image_screen && direct_image_screen->is_timeout_expired()) {
         display_hide_strip_image();
     }
+
+    // Idle: a dashboard screen with nothing left to draw and no animation
+    // (image screens keep full rate for their uploads and timeouts)
+    const bool idle = disp && disp->inv_p == 0 && lv_anim_count_running() == 0 &&
+                      (current_screen == power_screen || current_screen == trend_screen);
+    idle_pacer_set_display_idle(idle);
+    if (!idle_pacer_is_idle()) {
+        set_refr_stretched(false);
+        return RENDER_TASK_PERIOD_MS;
+    }
+    set_refr_stretched(true);
+    return (next < RENDER_IDLE_PERIOD_MS) ? next : RENDER_IDLE_PERIOD_MS;
 }
 
 void display_set_boot_progress(int percent, const char* status) {
+    DisplayLock lock;
     if (splash_screen) {
         splash_screen->set_progress(percent);
         splash_screen->set_status(status);
         
         // Force a few LVGL updates to render immediately
         for (int i = 0; i < 3; i++) {
-            lv_timer_handler();
-#if ENABLE_FPS_COUNTER
-            display_update_fps();  // Count FPS during boot
-#endif
+            run_timer_handler();
             delay(5);
         }
     }
 }
 
 void display_show_power_screen() {
+    DisplayLock lock;
     if (power_screen && current_screen != power_screen) {
         power_screen->show();
         current_screen = power_screen;
         
-#if ENABLE_FPS_COUNTER
-        // Recreate FPS counter label on the new screen
-        if (fps_label) {
-            lv_obj_del(fps_label);  // Delete from previous screen
-        }
-        fps_label = lv_label_create(lv_scr_act());
-        lv_obj_set_style_text_color(fps_label, lv_color_hex(0x0000FF), 0);  // BGR for red
-        lv_obj_set_style_text_font(fps_label, &lv_font_montserrat_20, 0);   // Larger font
-        lv_label_set_text(fps_label, "FPS: --");
-        lv_obj_align(fps_label, LV_ALIGN_BOTTOM_RIGHT, -15, -5);  // 10px from corner
-#endif
-        
         // Force multiple render cycles to ensure complete screen redraw
         for (int i = 0; i < 3; i++) {
-            lv_timer_handler();
+            run_timer_handler();
             delay(5);
         }
     }
 }
 
+void display_show_trend_screen() {
+    DisplayLock lock;
+    if (trend_screen && current_screen != trend_screen) {
+        if (current_screen) {
+            current_screen->hide();
+        }
+        trend_screen->show();
+        current_screen = trend_screen;
+
+        // Let LVGL paint the screen; the plot follows on the next update()
+        for (int i = 0; i < 3; i++) {
+            run_timer_handler();
+            delay(5);
+        }
+    }
+}
+
+// Lock-free (pointer compare) so web handlers can call it while a decode holds the display
+const char* display_get_screen_name() {
+    if (current_screen == nullptr) return "none";
+    if (current_screen == splash_screen) return "splash";
+    if (current_screen == power_screen) return "power";
+    if (current_screen == trend_screen) return "trend";
+    return "image";
+}
+
 void display_update_energy(float solar_kw, float grid_kw) {
+    DisplayLock lock;
     if (power_screen) {
-        power_screen->set_solar_power(solar_kw);
-        power_screen->set_grid_power(grid_kw);
+        power_screen->set_power(solar_kw, grid_kw);
     }
 }
 
-void display_update_fps() {
-    fps_frame_count++;
-    
-    unsigned long current_time = millis();
-    unsigned long elapsed = current_time - fps_last_time;
-    
-    // Update FPS counter every 100ms (1/10th second)
-    if (elapsed >= 100) {
-        fps_current = (fps_frame_count * 1000.0f) / elapsed;
-        
-        char fps_text[16];
-        snprintf(fps_text, sizeof(fps_text), "FPS: %.1f", fps_current);
-        
-        // Update display label if it exists
-        if (fps_label) {
-            lv_label_set_text(fps_label, fps_text);
-        }
-        
-        fps_frame_count = 0;
-        fps_last_time = current_time;
+void display_show_energy_values(float solar_kw, float grid_kw) {
+    DisplayLock lock;
+    if (power_screen) {
+        power_screen->set_values(solar_kw, grid_kw);
     }
 }
 
-bool display_show_image(const uint8_t* jpeg_data, size_t jpeg_size, unsigned long timeout_ms, unsigned long start_time) {
-    // Create image screen on first use
+// Create the image screen on first use and set its timeout (display lock held)
+static void prepare_image_screen(unsigned long timeout_ms, unsigned long start_time) {
     if (!image_screen) {
         image_screen = new ImageScreen();
         image_screen->create();
@@ -213,12 +274,10 @@ bool display_show_image(const uint8_t* jpeg_data, size_t jpeg_size, unsigned lon
     if (start_time > 0) {
         image_screen->set_start_time(start_time);
     }
-    
-    // Load image data (this will decode it immediately)
-    if (!image_screen->load_image(jpeg_data, jpeg_size)) {
-        return false;
-    }
-    
+}
+
+// Switch to the loaded image screen (display lock held)
+static void switch_to_image_screen() {
     // Save current screen for return after timeout
     previous_screen = current_screen;
     
@@ -229,14 +288,39 @@ bool display_show_image(const uint8_t* jpeg_data, size_t jpeg_size, unsigned lon
     // Force multiple render cycles to ensure screen switch completes
     // Image decode/display may span multiple lv_timer_handler calls
     for (int i = 0; i < 5; i++) {
-        lv_timer_handler();
+        run_timer_handler();
         delay(5);
     }
+}
+
+bool display_show_image(const uint8_t* jpeg_data, size_t jpeg_size, unsigned long timeout_ms, unsigned long start_time) {
+    DisplayLock lock;
+    prepare_image_screen(timeout_ms, start_time);
     
+    // Load image data (this will decode it immediately)
+    if (!image_screen->load_image(jpeg_data, jpeg_size)) {
+        return false;
+    }
+    
+    switch_to_image_screen();
+    return true;
+}
+
+bool display_show_image_adopt(uint8_t* jpeg_data, size_t jpeg_size, unsigned long timeout_ms, unsigned long start_time) {
+    DisplayLock lock;
+    prepare_image_screen(timeout_ms, start_time);
+    
+    // The image screen owns the buffer from here on, also on failure
+    if (!image_screen->adopt_image(jpeg_data, jpeg_size)) {
+        return false;
+    }
+    
+    switch_to_image_screen();
     return true;
 }
 
 void display_hide_image() {
+    DisplayLock lock;
     if (image_screen) {
         image_screen->hide();
         image_screen->clear_image();
@@ -254,12 +338,14 @@ void display_hide_image() {
     // Force multiple render cycles to ensure screen switch completes
     // and power screen widgets are fully redrawn
     for (int i = 0; i < 5; i++) {
-        lv_timer_handler();
+        run_timer_handler();
         delay(5);
     }
 }
 
-bool display_start_strip_upload(uint16_t width, uint16_t height, unsigned long timeout_ms, unsigned long start_time) {
+bool display_start_strip_upload(uint16_t width, uint16_t height, unsigned long timeout_ms, unsigned long start_time,
+                                uint8_t scale) {
+    DisplayLock lock;
     // Create direct image screen on first use
     if (!direct_image_screen) {
         direct_image_screen = new DirectImageScreen();
@@ -273,7 +359,9 @@ bool display_start_strip_upload(uint16_t width, uint16_t height, unsigned long t
     }
     
     // Initialize strip decoding session
-    direct_image_screen->begin_strip_session(width, height);
+    if (!direct_image_screen->begin_strip_session(width, height, scale)) {
+        return false;
+    }
     
     // Save current screen for return after timeout
     previous_screen = current_screen;
@@ -285,18 +373,15 @@ bool display_start_strip_upload(uint16_t width, uint16_t height, unsigned long t
     
     // Force multiple render cycles to ensure screen switch completes
     for (int i = 0; i < 3; i++) {
-        lv_timer_handler();
+        run_timer_handler();
         delay(5);
     }
     
     return true;
 }
 
-bool display_decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index) {
-    return display_decode_strip_ex(jpeg_data, jpeg_size, strip_index, true);
-}
-
-bool display_decode_strip_ex(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index, bool output_bgr565) {
+bool display_decode_strip_ex(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index) {
+    DisplayLock lock;
     if (!direct_image_screen) {
         Logger.logMessage("ERROR", "display_decode_strip_ex: direct_image_screen is NULL");
         return false;
@@ -309,10 +394,143 @@ bool display_decode_strip_ex(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t
     }
 
     // Decode and render the strip directly to LCD
-    return direct_image_screen->decode_strip(jpeg_data, jpeg_size, strip_index, output_bgr565);
+    const int64_t start = esp_timer_get_time();
+    const bool ok = direct_image_screen->decode_strip(jpeg_data, jpeg_size, strip_index);
+    perf_record(PERF_STRIP_DECODE, (uint32_t)(esp_timer_get_time() - start));
+    return ok;
+}
+
+bool display_decode_stream(size_t (*read)(void* ctx, uint8_t* buf, size_t len), void* read_ctx) {
+    DisplayLock lock;
+    if (!direct_image_screen || current_screen != direct_image_screen) {
+        Logger.logMessage("ERROR", "display_decode_stream: direct image screen not active");
+        return false;
+    }
+
+    return direct_image_screen->decode_stream(read, read_ctx);
+}
+
+// Partial/raw drawing: make the direct image screen current (keeping what it
+// shows) and restart its timeout. Call with the display lock held.
+static void enter_direct_image_screen(unsigned long timeout_ms, unsigned long start_time) {
+    if (!direct_image_screen) {
+        direct_image_screen = new DirectImageScreen();
+        direct_image_screen->create();
+    }
+
+    direct_image_screen->set_timeout(timeout_ms);
+    if (start_time > 0) {
+        direct_image_screen->set_start_time(start_time);
+    }
+
+    // Another screen is showing: switch to the blank direct image screen
+    // and let LVGL paint it before drawing over it
+    if (current_screen != direct_image_screen) {
+        previous_screen = current_screen;
+        direct_image_screen->show();
+        current_screen = direct_image_screen;
+        for (int i = 0; i < 3; i++) {
+            run_timer_handler();
+            delay(5);
+        }
+        lcd_wait_idle();
+    }
+}
+
+uint32_t display_direct_image_epoch() {
+    DisplayLock lock;
+    if (!direct_image_screen || current_screen != direct_image_screen) {
+        return 0;
+    }
+    return direct_image_screen->get_content_epoch();
+}
+
+bool display_decode_tile(const uint8_t* jpeg_data, size_t jpeg_size, int x, int y, unsigned long timeout_ms, unsigned long start_time) {
+    DisplayLock lock;
+    enter_direct_image_screen(timeout_ms, start_time);
+
+    const int64_t start = esp_timer_get_time();
+    const bool ok = direct_image_screen->decode_tile(jpeg_data, jpeg_size, x, y, false);
+    perf_record(PERF_STRIP_DECODE, (uint32_t)(esp_timer_get_time() - start));
+    return ok;
+}
+
+bool display_draw_raw(bool rle, int x, int y, int width, int height,
+                      size_t (*read)(void* ctx, uint8_t* buf, size_t len), void* read_ctx,
+                      unsigned long timeout_ms, unsigned long start_time) {
+    DisplayLock lock;
+    enter_direct_image_screen(timeout_ms, start_time);
+    return raw_image_draw(rle, x, y, width, height, read, read_ctx);
+}
+
+static void cache_capture_tap(void* ctx, int y, int width, int height, const uint16_t* pixels) {
+    (void)ctx;
+    image_cache_capture_rows((uint16_t)y, (uint16_t)width, (uint16_t)height, pixels);
+}
+
+static void cache_blit_sink(void* ctx, uint16_t y, uint16_t width, uint16_t rows, const uint16_t* pixels) {
+    (void)ctx;
+    lcd_push_pixels_at(0, y, width, rows, pixels);
+}
+
+bool display_cache_capture_begin() {
+    DisplayLock lock;
+    if (!direct_image_screen || current_screen != direct_image_screen) {
+        return false;
+    }
+    if (!image_cache_capture_begin(LCD_LOGICAL_WIDTH, LCD_LOGICAL_HEIGHT)) {
+        return false;
+    }
+    direct_image_screen->get_decoder()->set_band_tap(cache_capture_tap, nullptr);
+    return true;
+}
+
+bool display_cache_capture_end(uint32_t id, bool commit) {
+    DisplayLock lock;
+    if (direct_image_screen) {
+        direct_image_screen->get_decoder()->set_band_tap(nullptr, nullptr);
+    }
+    if (!commit) {
+        image_cache_capture_abort();
+        return false;
+    }
+    return image_cache_capture_commit(id);
+}
+
+bool display_show_cached_image(uint32_t id, unsigned long timeout_ms, unsigned long start_time) {
+    DisplayLock lock;
+    if (!image_cache_contains(id)) {
+        return false;
+    }
+
+    if (!direct_image_screen) {
+        direct_image_screen = new DirectImageScreen();
+        direct_image_screen->create();
+    }
+
+    direct_image_screen->set_timeout(timeout_ms);
+    if (start_time > 0) {
+        direct_image_screen->set_start_time(start_time);
+    }
+
+    if (current_screen != direct_image_screen) {
+        previous_screen = current_screen;
+    }
+
+    // Let LVGL paint the blank screen first so it cannot overwrite the blit
+    direct_image_screen->show();
+    current_screen = direct_image_screen;
+    for (int i = 0; i < 3; i++) {
+        run_timer_handler();
+        delay(5);
+    }
+    lcd_wait_idle();
+
+    return image_cache_blit(id, cache_blit_sink, nullptr);
 }
 
 void display_hide_strip_image() {
+    DisplayLock lock;
     if (direct_image_screen) {
         direct_image_screen->hide();
     }
@@ -329,7 +547,29 @@ void display_hide_strip_image() {
     // Force multiple render cycles to ensure screen switch completes
     // and power screen widgets are fully redrawn
     for (int i = 0; i < 5; i++) {
-        lv_timer_handler();
+        run_timer_handler();
         delay(5);
     }
 }
+
+void display_run_exclusive(void (*fn)(void* ctx), void* ctx) {
+    DisplayLock lock;
+    ScreenBase* saved_screen = current_screen;
+    ScreenBase* saved_previous = previous_screen;
+
+    lcd_wait_idle();  // no LVGL flush still on the wire
+    fn(ctx);
+    lcd_wait_idle();
+
+    // fn may have switched screens or drawn over the panel: show what was active
+    if (saved_screen && current_screen != saved_screen) {
+        saved_screen->show();
+    }
+    if (direct_image_screen) {
+        direct_image_screen->invalidate();
+    }
+    current_screen = saved_screen;
+    previous_screen = saved_previous;
+    lv_obj_invalidate(lv_scr_act());
+    run_timer_handler();
+}
@@ -1,3 +1,13 @@
+/*
+ * Display Manager
+ *
+ * Owns LVGL and the screens. Every function below may be called from any task:
+ * they serialize on an internal recursive mutex (the render task, the image
+ * decode task and the loop task all use the display). Do not call them from the
+ * AsyncTCP task: a streaming decode holds the display while it waits for body
+ * data from that task. Web handlers defer display work instead.
+ */
+
 #ifndef DISPLAY_MANAGER_H
 #define DISPLAY_MANAGER_H
 
@@ -6,10 +16,10 @@
 #include "board_config.h"
 
 void display_init();
-void display_update();
-
-// FPS counter for performance testing
-void display_update_fps();
+// LVGL timers, screen updates and image timeouts. Returns how long the render
+// task may sleep: RENDER_TASK_PERIOD_MS at full rate, up to RENDER_IDLE_PERIOD_MS
+// (LVGL's next deadline) while idle-paced (see idle_pacer.h).
+uint32_t display_update();
 
 // Boot progress tracking (0-100%)
 void display_set_boot_progress(int percent, const char* status);
@@ -17,17 +27,54 @@ void display_set_boot_progress(int percent, const char* status);
 // Switch to power screen (after boot complete)
 void display_show_power_screen();
 
-// Update power values on power screen
+// Switch to the energy trend screen (live 1-second history)
+void display_show_trend_screen();
+
+// Active screen: "splash", "power", "trend" or "image" (lock-free, safe from web handlers)
+const char* display_get_screen_name();
+
+// Update power values on power screen and record a statistics sample (1 s tick)
 void display_update_energy(float solar_kw, float grid_kw);
 
+// Show new power values right away (on MQTT arrival), no statistics sample
+void display_show_energy_values(float solar_kw, float grid_kw);
+
 // Image display API (10-second timeout, auto-return to power screen)
 bool display_show_image(const uint8_t* jpeg_data, size_t jpeg_size, unsigned long timeout_ms = 10000, unsigned long start_time = 0);
+// Same without the copy: takes ownership of jpeg_data (malloc'd; freed when the
+// image is cleared, or right away on failure)
+bool display_show_image_adopt(uint8_t* jpeg_data, size_t jpeg_size, unsigned long timeout_ms = 10000, unsigned long start_time = 0);
 void display_hide_image();  // Manual dismiss (also called automatically after timeout)
 
 // Strip-based image display API (memory-efficient streaming)
-bool display_start_strip_upload(uint16_t width, uint16_t height, unsigned long timeout_ms = 10000, unsigned long start_time = 0);
-bool display_decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index);
-bool display_decode_strip_ex(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index, bool output_bgr565);
+// scale: decode strips at 1/2^scale (0..3); width/height are the on-screen size
+bool display_start_strip_upload(uint16_t width, uint16_t height, unsigned long timeout_ms = 10000, unsigned long start_time = 0,
+                                uint8_t scale = 0);
+bool display_decode_strip_ex(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index);
+// Streaming full-image decode into an active strip session (read: see StripReadFn)
+bool display_decode_stream(size_t (*read)(void* ctx, uint8_t* buf, size_t len), void* read_ctx);
 void display_hide_strip_image();
+// Partial update: decode a JPEG tile at LCD (x, y) on the direct image screen,
+// switching to it (blank) first if another screen is showing
+bool display_decode_tile(const uint8_t* jpeg_data, size_t jpeg_size, int x, int y,
+                         unsigned long timeout_ms = 10000, unsigned long start_time = 0);
+// Same, for rgb565 / rle565 pixel data pulled through read() (see raw_image.h)
+bool display_draw_raw(bool rle, int x, int y, int width, int height,
+                      size_t (*read)(void* ctx, uint8_t* buf, size_t len), void* read_ctx,
+                      unsigned long timeout_ms = 10000, unsigned long start_time = 0);
+// Identifies the picture on the direct image screen: changes when it is replaced
+// or leaves the panel, 0 while another screen is showing (see delta frames)
+uint32_t display_direct_image_epoch();
+
+// Image cache (see image_cache.h). Capture records the bands of the active strip
+// session; end it with commit=true once the whole frame has been decoded.
+bool display_cache_capture_begin();
+bool display_cache_capture_end(uint32_t id, bool commit);
+// Show a cached frame on the direct image screen (blit, no decode)
+bool display_show_cached_image(uint32_t id, unsigned long timeout_ms = 10000, unsigned long start_time = 0);
+
+// Run fn with the display locked (LVGL and the panel to itself), then restore
+// the active screen and repaint it. For code that draws to the LCD directly.
+void display_run_exclusive(void (*fn)(void* ctx), void* ctx);
 
 #endif // DISPLAY_MANAGER_H
@@ -0,0 +1,644 @@
+/*
+ * Energy History Implementation
+ *
+ * Data flow:
+ *   sample -> per-second accumulator -> 1s ring
+ *                                    -> 1m accumulator -> 1m ring
+ *                                                      -> 15m accumulator -> pending -> segment file
+ *
+ * Samples arrive from every channel ingest path (MQTT on the network task,
+ * POST /api/power on AsyncTCP, direct UDP ingest on AsyncUDP); buckets are
+ * closed and checkpointed by energy_history_loop() on the network task. All of
+ * it runs under history_mutex.
+ *
+ * Open accumulators keep exact float/double sums; fixed-point rounding happens
+ * only when a bucket is stored.
+ *
+ * 15-minute segments: one append-only file per ENERGY_HISTORY_SEGMENT_BUCKETS
+ * periods (/history/q<first period>.bin): SegmentHeader, then FlashRecords in
+ * period order. A checkpoint appends to the newest segment, which rewrites at
+ * most its last flash block (a file overwritten in place is rewritten from the
+ * changed block to its end). Segments older than ENERGY_HISTORY_15M_BUCKETS
+ * periods are deleted whole.
+ */
+
+#include "energy_history.h"
+#include "board_config.h"
+#include "log_manager.h"
+#include "mem_placement.h"
+
+#include <LittleFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+static const int16_t NO_DATA = INT16_MIN;
+static const float DW_PER_KW = 100.0f;             // fixed point: 1 unit = 10 W
+static const uint32_t EPOCH_VALID_AFTER = 1700000000;  // wall clock set by SNTP
+
+static const char* HISTORY_DIR = "/history";
+static const uint32_t SEGMENT_MAGIC = 0x32484E45;  // "ENH2"
+static const uint32_t SEGMENT_PERIODS = ENERGY_HISTORY_SEGMENT_BUCKETS;
+
+struct BucketStat {
+    int16_t min_dw;
+    int16_t max_dw;
+    int16_t avg_dw;       // NO_DATA = no sample in the bucket
+    uint16_t covered_s;   // seconds of the bucket with data
+};
+
+struct Bucket {
+    BucketStat series[ENERGY_SERIES_COUNT];
+};
+
+struct FlashRecord {
+    uint32_t period;  // start / 900 (epoch); 0 = empty
+    BucketStat series[ENERGY_SERIES_COUNT];
+};
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint16_t record_size;
+    uint16_t reserved;
+    uint32_t first_period;  // multiple of SEGMENT_PERIODS
+};
+
+// ===== Accumulators =====
+
+struct SeriesAccum {
+    float min_kw;
+    float max_kw;
+    double energy_kws;   // kW x seconds
+    uint32_t covered_s;
+};
+
+struct TierAccum {
+    bool open;
+    uint32_t start;  // bucket start (seconds)
+    SeriesAccum series[ENERGY_SERIES_COUNT];
+};
+
+// Raw samples of the running second (solar and grid; home is derived)
+struct SecondAccum {
+    float sum_kw;
+    float min_kw;
+    float max_kw;
+    uint16_t count;
+    float last_kw;
+    uint32_t last_ms;  // 0 = never received
+};
+
+// ===== Storage =====
+
+// Fixed ring with the bucket start of the newest entry. Storage is allocated by
+// energy_history_init() (PSRAM when present); a ring that could not get it stays empty.
+template <typename T, size_t N>
+struct HistoryRing {
+    T* items;
+    size_t head;       // next write position
+    size_t count;
+    uint32_t newest_start;
+    uint32_t revision;
+
+    static const size_t BYTES = N * sizeof(T);
+
+    bool alloc() {
+        if (!items) items = (T*)mem_alloc_large(BYTES);
+        return items != nullptr;
+    }
+
+    void push(const T& item, uint32_t start) {
+        if (!items) return;
+        items[head] = item;
+        head = (head + 1) % N;
+        if (count < N) count++;
+        newest_start = start;
+        revision++;
+    }
+
+    // i = 0 is the oldest entry
+    const T& at(size_t i) const {
+        return items[(head + N - count + i) % N];
+    }
+};
+
+struct FineSample {
+    int16_t avg_dw[ENERGY_SERIES_COUNT];
+};
+
+static HistoryRing<FineSample, ENERGY_HISTORY_1S_BUCKETS> fine_ring;
+static HistoryRing<Bucket, ENERGY_HISTORY_1M_BUCKETS> minute_ring;
+
+static SecondAccum second_accum[2];  // ENERGY_SOLAR, ENERGY_GRID
+static TierAccum minute_accum;
+static TierAccum quarter_accum;
+
+static FlashRecord pending[ENERGY_HISTORY_CHECKPOINT_BUCKETS];
+static size_t pending_count = 0;
+static uint32_t last_period = 0;  // newest period persisted or pending (periods only grow)
+static uint32_t quarter_revision = 0;
+static bool flash_ok = false;
+static bool warned_no_clock = false;
+
+static uint32_t last_tick_ms = 0;
+
+// Guards all state above: samples come from the network task, reads from the
+// render task (trend screen) and web handlers
+static SemaphoreHandle_t history_mutex = nullptr;
+
+static void history_lock() { if (history_mutex) xSemaphoreTake(history_mutex, portMAX_DELAY); }
+static void history_unlock() { if (history_mutex) xSemaphoreGive(history_mutex); }
+
+// ===== Helpers =====
+
+static bool clock_valid() {
+    return time(nullptr) > (time_t)EPOCH_VALID_AFTER;
+}
+
+// Bucket clock: epoch seconds once SNTP has set the time, otherwise uptime
+static uint32_t clock_now_s() {
+    const time_t t = time(nullptr);
+    if (t > (time_t)EPOCH_VALID_AFTER) return (uint32_t)t;
+    return millis() / 1000;
+}
+
+static int16_t to_dw(float kw) {
+    const long v = lroundf(kw * DW_PER_KW);
+    if (v > INT16_MAX) return INT16_MAX;
+    if (v <= INT16_MIN) return INT16_MIN + 1;  // INT16_MIN is NO_DATA
+    return (int16_t)v;
+}
+
+static float from_dw(int16_t dw) {
+    return dw / DW_PER_KW;
+}
+
+static void accum_reset(TierAccum& a, uint32_t start) {
+    a.open = true;
+    a.start = start;
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        a.series[s] = {NAN, NAN, 0.0, 0};
+    }
+}
+
+static void series_add(SeriesAccum& a, float min_kw, float max_kw, double energy_kws, uint32_t covered_s) {
+    if (covered_s == 0) return;
+    if (a.covered_s == 0 || min_kw < a.min_kw) a.min_kw = min_kw;
+    if (a.covered_s == 0 || max_kw > a.max_kw) a.max_kw = max_kw;
+    a.energy_kws += energy_kws;
+    a.covered_s += covered_s;
+}
+
+static BucketStat series_stat(const SeriesAccum& a) {
+    if (a.covered_s == 0) {
+        return {NO_DATA, NO_DATA, NO_DATA, 0};
+    }
+    return {to_dw(a.min_kw), to_dw(a.max_kw), to_dw((float)(a.energy_kws / a.covered_s)),
+            (uint16_t)(a.covered_s > UINT16_MAX ? UINT16_MAX : a.covered_s)};
+}
+
+static EnergyHistoryPoint stat_point(const BucketStat& st, uint32_t start) {
+    EnergyHistoryPoint p = {start, false, NAN, NAN, NAN, 0.0f};
+    if (st.avg_dw == NO_DATA || st.covered_s == 0) return p;
+    p.has_data = true;
+    p.min_kw = from_dw(st.min_dw);
+    p.max_kw = from_dw(st.max_dw);
+    p.avg_kw = from_dw(st.avg_dw);
+    p.energy_kwh = p.avg_kw * st.covered_s / 3600.0f;
+    return p;
+}
+
+// ===== 15-minute segments =====
+
+static uint32_t segment_of(uint32_t period) {
+    return period - (period % SEGMENT_PERIODS);
+}
+
+static void segment_path(uint32_t first_period, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s/q%lu.bin", HISTORY_DIR, (unsigned long)first_period);
+}
+
+// First period of a segment file name, false for anything else in the directory
+static bool parse_segment_name(const char* name, uint32_t* first_period) {
+    const char* base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+    unsigned long v;
+    char tail[5];
+    if (sscanf(base, "q%lu.%4s", &v, tail) != 2 || strcmp(tail, "bin") != 0) return false;
+    *first_period = (uint32_t)v;
+    return (v % SEGMENT_PERIODS) == 0;
+}
+
+// Records of a segment; false if the file is missing or not a segment
+static bool segment_open(uint32_t first_period, File& f, size_t* records) {
+    char path[40];
+    segment_path(first_period, path, sizeof(path));
+    f = LittleFS.open(path, FILE_READ);
+    if (!f) return false;
+    SegmentHeader hdr;
+    if (f.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != SEGMENT_MAGIC ||
+        hdr.record_size != sizeof(FlashRecord) || hdr.first_period != first_period) {
+        f.close();
+        return false;
+    }
+    *records = (f.size() - sizeof(hdr)) / sizeof(FlashRecord);
+    return true;
+}
+
+// Delete segments that end before the retained window (and files that are no segment)
+static void drop_old_segments(uint32_t newest_period) {
+    const uint32_t keep_from = newest_period >= ENERGY_HISTORY_15M_BUCKETS
+        ? segment_of(newest_period + 1 - ENERGY_HISTORY_15M_BUCKETS) : 0;
+
+    File dir = LittleFS.open(HISTORY_DIR);
+    if (!dir || !dir.isDirectory()) return;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        const String path = f.path();
+        f.close();
+        uint32_t first;
+        if (!parse_segment_name(path.c_str(), &first) || first < keep_from) {
+            Logger.logMessagef("History", "Removing %s", path.c_str());
+            LittleFS.remove(path);
+        }
+    }
+}
+
+// Newest period on flash, so a clock that goes backwards never appends out of order
+static uint32_t newest_persisted_period() {
+    File dir = LittleFS.open(HISTORY_DIR);
+    if (!dir || !dir.isDirectory()) return 0;
+    uint32_t newest_segment = 0;
+    bool found = false;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        uint32_t first;
+        if (parse_segment_name(f.path(), &first) && (!found || first > newest_segment)) {
+            newest_segment = first;
+            found = true;
+        }
+        f.close();
+    }
+    dir.close();
+    if (!found) return 0;
+
+    File f;
+    size_t records;
+    FlashRecord rec;
+    if (!segment_open(newest_segment, f, &records)) return 0;
+    const bool ok = records > 0 && f.seek(sizeof(SegmentHeader) + (records - 1) * sizeof(FlashRecord)) &&
+                    f.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+    f.close();
+    return ok ? rec.period : 0;
+}
+
+static bool history_storage_init() {
+    if (!LittleFS.begin(true)) {
+        Logger.logMessage("History", "ERROR: LittleFS mount failed, 15-minute tier not persisted");
+        return false;
+    }
+    if (!LittleFS.exists(HISTORY_DIR) && !LittleFS.mkdir(HISTORY_DIR)) {
+        Logger.logMessage("History", "ERROR: Cannot create the history directory");
+        return false;
+    }
+    // The single preallocated ring file of earlier builds is no segment
+    drop_old_segments(0);
+    last_period = newest_persisted_period();
+    return true;
+}
+
+// Calls fn(record) for every stored 15-minute bucket in [first, last], oldest first
+template <typename Fn>
+static void for_each_record(uint32_t first, uint32_t last, Fn fn) {
+    if (flash_ok) {
+        for (uint32_t seg = segment_of(first); seg <= last; seg += SEGMENT_PERIODS) {
+            File f;
+            size_t records;
+            if (!segment_open(seg, f, &records)) continue;
+            FlashRecord batch[16];
+            while (records > 0) {
+                const size_t n = min(records, sizeof(batch) / sizeof(batch[0]));
+                if (f.read((uint8_t*)batch, n * sizeof(FlashRecord)) != n * sizeof(FlashRecord)) break;
+                for (size_t i = 0; i < n; i++) {
+                    if (batch[i].period >= first && batch[i].period <= last) fn(batch[i]);
+                }
+                records -= n;
+            }
+            f.close();
+        }
+    }
+    // Not yet checkpointed
+    for (size_t i = 0; i < pending_count; i++) {
+        if (pending[i].period >= first && pending[i].period <= last) fn(pending[i]);
+    }
+}
+
+// Append one segment's run of pending records; false leaves them pending
+static bool append_segment(uint32_t first_period, const FlashRecord* recs, size_t n, bool* created) {
+    char path[40];
+    segment_path(first_period, path, sizeof(path));
+    File f = LittleFS.open(path, FILE_APPEND);
+    if (!f) return false;
+
+    bool ok = true;
+    *created = (f.size() == 0);
+    if (*created) {
+        const SegmentHeader hdr = {SEGMENT_MAGIC, (uint16_t)sizeof(FlashRecord), 0, first_period};
+        ok = f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    } else if ((f.size() - sizeof(SegmentHeader)) % sizeof(FlashRecord) != 0) {
+        ok = false;  // torn by a power cut; an append would shift every later record
+    }
+    ok = ok && f.write((const uint8_t*)recs, n * sizeof(FlashRecord)) == n * sizeof(FlashRecord);
+    f.close();
+
+    if (!ok) {
+        Logger.logMessagef("History", "ERROR: Segment %s unwritable, dropping it", path);
+        LittleFS.remove(path);
+    }
+    return ok;
+}
+
+static void flush_pending() {
+    if (pending_count == 0 || !flash_ok) {
+        pending_count = 0;
+        return;
+    }
+
+    // Pending records are in period order; write them per segment
+    bool new_segment = false;
+    size_t done = 0;
+    while (done < pending_count) {
+        const uint32_t seg = segment_of(pending[done].period);
+        size_t n = 1;
+        while (done + n < pending_count && segment_of(pending[done + n].period) == seg) n++;
+        bool created = false;
+        const bool ok = append_segment(seg, pending + done, n, &created);
+        new_segment |= created;
+        if (!ok) {
+            Logger.logMessage("History", "ERROR: Cannot write history segment");
+            break;  // keep the rest pending, retry at the next checkpoint
+        }
+        done += n;
+    }
+
+    if (done > 0) {
+        Logger.logMessagef("History", "Checkpointed %u 15-minute buckets", (unsigned)done);
+        memmove(pending, pending + done, (pending_count - done) * sizeof(FlashRecord));
+        pending_count -= done;
+    }
+    if (new_segment) {
+        drop_old_segments(last_period);
+    }
+}
+
+void energy_history_flush() {
+    history_lock();
+    flush_pending();
+    history_unlock();
+}
+
+// ===== Bucket closing =====
+
+static void close_quarter() {
+    if (!quarter_accum.open) return;
+    quarter_accum.open = false;
+    quarter_revision++;
+
+    // Period numbers only mean something with wall-clock time
+    if (quarter_accum.start <= EPOCH_VALID_AFTER) {
+        if (!warned_no_clock) {
+            Logger.logMessage("History", "No wall-clock time yet, 15-minute buckets not persisted");
+            warned_no_clock = true;
+        }
+        return;
+    }
+
+    FlashRecord rec;
+    rec.period = quarter_accum.start / 900;
+    if (rec.period <= last_period) return;  // clock stepped back; segments stay in order
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        rec.series[s] = series_stat(quarter_accum.series[s]);
+    }
+
+    if (pending_count == ENERGY_HISTORY_CHECKPOINT_BUCKETS) {
+        flush_pending();
+        if (pending_count == ENERGY_HISTORY_CHECKPOINT_BUCKETS) return;  // write failed; drop
+    }
+    pending[pending_count++] = rec;
+    last_period = rec.period;
+    if (pending_count == ENERGY_HISTORY_CHECKPOINT_BUCKETS) {
+        flush_pending();
+    }
+}
+
+static void close_minute() {
+    if (!minute_accum.open) return;
+    minute_accum.open = false;
+
+    Bucket b;
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        b.series[s] = series_stat(minute_accum.series[s]);
+    }
+    minute_ring.push(b, minute_accum.start);
+
+    // Roll the exact sums (not the rounded bucket) into the 15-minute tier
+    const uint32_t quarter_start = minute_accum.start - (minute_accum.start % 900);
+    if (quarter_accum.open && quarter_accum.start != quarter_start) {
+        close_quarter();
+    }
+    if (!quarter_accum.open) {
+        accum_reset(quarter_accum, quarter_start);
+    }
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        const SeriesAccum& m = minute_accum.series[s];
+        series_add(quarter_accum.series[s], m.min_kw, m.max_kw, m.energy_kws, m.covered_s);
+    }
+}
+
+// Close the second that started at t: value per series = mean of its samples,
+// else the last sample if still fresh, else no data
+static void close_second(uint32_t t) {
+    const uint32_t now_ms = millis();
+    float avg[ENERGY_SERIES_COUNT];
+    float lo[ENERGY_SERIES_COUNT];
+    float hi[ENERGY_SERIES_COUNT];
+
+    for (int s = 0; s < 2; s++) {
+        SecondAccum& a = second_accum[s];
+        if (a.count > 0) {
+            avg[s] = a.sum_kw / a.count;
+            lo[s] = a.min_kw;
+            hi[s] = a.max_kw;
+        } else if (a.last_ms != 0 && (now_ms - a.last_ms) <= ENERGY_HISTORY_HOLD_MS) {
+            avg[s] = lo[s] = hi[s] = a.last_kw;
+        } else {
+            avg[s] = lo[s] = hi[s] = NAN;
+        }
+        a.sum_kw = 0.0f;
+        a.count = 0;
+    }
+
+    if (!isnan(avg[ENERGY_SOLAR]) && !isnan(avg[ENERGY_GRID])) {
+        avg[ENERGY_HOME] = avg[ENERGY_SOLAR] + avg[ENERGY_GRID];
+        lo[ENERGY_HOME] = hi[ENERGY_HOME] = avg[ENERGY_HOME];
+    } else {
+        avg[ENERGY_HOME] = lo[ENERGY_HOME] = hi[ENERGY_HOME] = NAN;
+    }
+
+    FineSample fs;
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        fs.avg_dw[s] = isnan(avg[s]) ? NO_DATA : to_dw(avg[s]);
+    }
+    fine_ring.push(fs, t);
+
+    const uint32_t minute_start = t - (t % 60);
+    if (minute_accum.open && minute_accum.start != minute_start) {
+        close_minute();
+    }
+    if (!minute_accum.open) {
+        accum_reset(minute_accum, minute_start);
+    }
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        if (!isnan(avg[s])) {
+            series_add(minute_accum.series[s], lo[s], hi[s], avg[s], 1);
+        }
+    }
+}
+
+// ===== Public API =====
+
+void energy_history_init() {
+    if (!history_mutex) history_mutex = xSemaphoreCreateMutex();
+    if (!fine_ring.alloc() || !minute_ring.alloc()) {
+        Logger.logMessage("History", "ERROR: Out of memory for the 1s/1m tiers");
+    }
+    flash_ok = history_storage_init();
+    last_tick_ms = millis();
+    Logger.logMessagef("History", "Tiers: %us x %u, %us x %u, %us x %u (%s), %u bytes %s",
+                      1, (unsigned)ENERGY_HISTORY_1S_BUCKETS,
+                      60, (unsigned)ENERGY_HISTORY_1M_BUCKETS,
+                      900, (unsigned)ENERGY_HISTORY_15M_BUCKETS, flash_ok ? "LittleFS" : "not persisted",
+                      (unsigned)(fine_ring.BYTES + minute_ring.BYTES), mem_has_psram() ? "PSRAM" : "RAM");
+}
+
+void energy_history_add_sample(EnergySeries series, float kw) {
+    if (series != ENERGY_SOLAR && series != ENERGY_GRID) return;  // home is derived
+    if (isnan(kw)) return;
+
+    history_lock();
+    SecondAccum& a = second_accum[series];
+    if (a.count == 0 || kw < a.min_kw) a.min_kw = kw;
+    if (a.count == 0 || kw > a.max_kw) a.max_kw = kw;
+    a.sum_kw += kw;
+    a.count++;
+    a.last_kw = kw;
+    a.last_ms = millis();
+    history_unlock();
+}
+
+void energy_history_loop() {
+    const uint32_t now_ms = millis();
+    if (now_ms - last_tick_ms < 1000) return;
+
+    // Stay on a 1 s grid; after a long stall skip ahead instead of replaying
+    last_tick_ms = (now_ms - last_tick_ms > 5000) ? now_ms : last_tick_ms + 1000;
+    history_lock();
+    close_second(clock_now_s() - 1);
+    history_unlock();
+}
+
+uint32_t energy_history_bucket_seconds(EnergyTier tier) {
+    switch (tier) {
+        case ENERGY_TIER_1S: return 1;
+        case ENERGY_TIER_1M: return 60;
+        default: return 900;
+    }
+}
+
+size_t energy_history_capacity(EnergyTier tier) {
+    switch (tier) {
+        case ENERGY_TIER_1S: return ENERGY_HISTORY_1S_BUCKETS;
+        case ENERGY_TIER_1M: return ENERGY_HISTORY_1M_BUCKETS;
+        default: return ENERGY_HISTORY_15M_BUCKETS;
+    }
+}
+
+uint32_t energy_history_revision(EnergyTier tier) {
+    // Single aligned 32-bit reads; no lock needed
+    switch (tier) {
+        case ENERGY_TIER_1S: return fine_ring.revision;
+        case ENERGY_TIER_1M: return minute_ring.revision;
+        default: return quarter_revision;
+    }
+}
+
+static size_t read_locked(EnergyTier tier, EnergySeries series, EnergyHistoryPoint* out, size_t max) {
+    if (tier == ENERGY_TIER_1S) {
+        const size_t n = min(max, fine_ring.count);
+        const size_t skip = fine_ring.count - n;
+        for (size_t i = 0; i < n; i++) {
+            const int16_t dw = fine_ring.at(skip + i).avg_dw[series];
+            const BucketStat st = {dw, dw, dw, (uint16_t)(dw == NO_DATA ? 0 : 1)};
+            out[i] = stat_point(st, fine_ring.newest_start - (uint32_t)(n - 1 - i));
+        }
+        return n;
+    }
+
+    if (tier == ENERGY_TIER_1M) {
+        const size_t n = min(max, minute_ring.count);
+        const size_t skip = minute_ring.count - n;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = stat_point(minute_ring.at(skip + i).series[series],
+                                minute_ring.newest_start - (uint32_t)(n - 1 - i) * 60);
+        }
+        return n;
+    }
+
+    // 15-minute tier: one point per period up to the last closed one (gaps = no data)
+    if (!clock_valid()) return 0;
+    const uint32_t newest = clock_now_s() / 900 - 1;
+    const size_t n = min(max, (size_t)ENERGY_HISTORY_15M_BUCKETS);
+    const uint32_t oldest = newest - (uint32_t)(n - 1);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = {(oldest + (uint32_t)i) * 900, false, NAN, NAN, NAN, 0.0f};
+    }
+    for_each_record(oldest, newest, [&](const FlashRecord& rec) {
+        out[rec.period - oldest] = stat_point(rec.series[series], rec.period * 900);
+    });
+    return n;
+}
+
+size_t energy_history_read(EnergyTier tier, EnergySeries series, EnergyHistoryPoint* out, size_t max) {
+    if (!out || max == 0 || series >= ENERGY_SERIES_COUNT) return 0;
+
+    history_lock();
+    const size_t n = read_locked(tier, series, out, max);
+    history_unlock();
+    return n;
+}
+
+float energy_history_energy_kwh(EnergySeries series, uint32_t from_epoch, uint32_t to_epoch) {
+    if (series >= ENERGY_SERIES_COUNT || !clock_valid() || to_epoch <= from_epoch) return 0.0f;
+
+    const uint32_t now = clock_now_s();
+    if (to_epoch > now) to_epoch = now;
+    uint32_t first = from_epoch / 900;
+    const uint32_t last = (to_epoch - 1) / 900;
+    if (last - first >= ENERGY_HISTORY_15M_BUCKETS) first = last - ENERGY_HISTORY_15M_BUCKETS + 1;
+
+    double kwh = 0.0;
+    history_lock();
+    for_each_record(first, last, [&](const FlashRecord& rec) {
+        kwh += stat_point(rec.series[series], rec.period * 900).energy_kwh;
+    });
+
+    // Open buckets: the running quarter plus the minute not yet rolled into it
+    const TierAccum* open_accums[] = {&quarter_accum, &minute_accum};
+    for (const TierAccum* a : open_accums) {
+        if (a->open && a->start >= from_epoch && a->start < to_epoch) {
+            kwh += a->series[series].energy_kws / 3600.0;
+        }
+    }
+    history_unlock();
+    return (float)kwh;
+}
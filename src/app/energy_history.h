@@ -0,0 +1,82 @@
+/*
+ * Energy History
+ *
+ * Multi-resolution time series of solar / grid / home power, fed by every MQTT
+ * sample. Three tiers, each bucket aggregated from the tier below:
+ *
+ *   ENERGY_TIER_1S   1 second   x ENERGY_HISTORY_1S_BUCKETS  (10 min)  RAM, avg only
+ *   ENERGY_TIER_1M   1 minute   x ENERGY_HISTORY_1M_BUCKETS  (24 h)    RAM
+ *   ENERGY_TIER_15M  15 minutes x ENERGY_HISTORY_15M_BUCKETS (30 days) LittleFS
+ *
+ * Buckets hold min / max / avg in fixed-point int16 (10 W units) plus the number
+ * of seconds with data; the energy integral is avg x covered seconds (exact
+ * sums are kept while a bucket is open, so coarser tiers do not accumulate
+ * rounding). Home = solar + grid, derived per second when both are known.
+ *
+ * The 15-minute tier is persisted to append-only segment files on the LittleFS
+ * data partition (ENERGY_HISTORY_SEGMENT_BUCKETS each; the oldest is deleted
+ * once it falls out of the window). Closed buckets are batched in RAM and
+ * appended together every ENERGY_HISTORY_CHECKPOINT_BUCKETS (default: hourly),
+ * so flash sees a couple of dozen small writes per day. It is only persisted once wall-clock time is set
+ * (SNTP), so records can be matched to their period after a reboot.
+ *
+ * RAM: 6 bytes per 1s bucket + 24 bytes per 1m bucket (~38 KB with defaults).
+ * Thread-safe: samples arrive from the network, AsyncTCP and AsyncUDP tasks, the
+ * trend screen reads from the render task; every public function takes an
+ * internal mutex.
+ */
+
+#ifndef ENERGY_HISTORY_H
+#define ENERGY_HISTORY_H
+
+#include <Arduino.h>
+
+enum EnergySeries {
+    ENERGY_SOLAR = 0,
+    ENERGY_GRID,
+    ENERGY_HOME,
+    ENERGY_SERIES_COUNT
+};
+
+enum EnergyTier {
+    ENERGY_TIER_1S = 0,
+    ENERGY_TIER_1M,
+    ENERGY_TIER_15M,
+    ENERGY_TIER_COUNT
+};
+
+struct EnergyHistoryPoint {
+    uint32_t start;      // bucket start (epoch seconds once time is set, else uptime seconds)
+    bool has_data;
+    float min_kw;
+    float max_kw;
+    float avg_kw;
+    float energy_kwh;    // integral over the covered part of the bucket
+};
+
+void energy_history_init();
+
+// Call for every received sample (kW); NAN samples are ignored
+void energy_history_add_sample(EnergySeries series, float kw);
+
+// Call periodically (network task): closes buckets on second/minute/15-minute boundaries
+// and checkpoints the 15-minute tier
+void energy_history_loop();
+
+// Write pending 15-minute buckets now (e.g. before a planned reboot)
+void energy_history_flush();
+
+uint32_t energy_history_bucket_seconds(EnergyTier tier);
+size_t energy_history_capacity(EnergyTier tier);
+
+// Buckets closed in a tier since boot (changes whenever a new bucket is appended)
+uint32_t energy_history_revision(EnergyTier tier);
+
+// Copy the newest buckets of a tier, oldest first; returns the number written
+size_t energy_history_read(EnergyTier tier, EnergySeries series, EnergyHistoryPoint* out, size_t max);
+
+// Energy (kWh) between two epoch times from the 15-minute tier plus the open
+// bucket (for daily totals). Bucket granularity; 0 without wall-clock time.
+float energy_history_energy_kwh(EnergySeries series, uint32_t from_epoch, uint32_t to_epoch);
+
+#endif // ENERGY_HISTORY_H
@@ -0,0 +1,381 @@
+/*
+ * Health Sampler Implementation
+ */
+
+#include "health_sampler.h"
+#include "board_config.h"
+#include "boot_timing.h"
+#include "idle_pacer.h"
+#include "image_arena.h"
+#include "log_manager.h"
+#include "perf_counters.h"
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <WiFi.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <memory>
+
+// Temperature sensor support (ESP32-C3, ESP32-S2, ESP32-S3, ESP32-C2, ESP32-C6, ESP32-H2)
+#if SOC_TEMP_SENSOR_SUPPORTED
+#include "driver/temperature_sensor.h"
+static temperature_sensor_handle_t temp_sensor = NULL;
+#endif
+
+// Serialized /api/health: written into the spare buffer, then published by
+// flipping json_current under the mutex (readers copy under the same mutex).
+// json_readers counts the responses still sending each buffer; a spare with
+// readers is left alone until they are done.
+static const size_t HEALTH_JSON_MAX = 4096;
+static char json_buf[2][HEALTH_JSON_MAX];
+static size_t json_len[2] = {0, 0};
+static int json_current = -1;
+static uint8_t json_readers[2] = {0, 0};
+
+static HealthSample history[HEALTH_HISTORY_SAMPLES];
+static size_t history_head = 0;
+static size_t history_count = 0;
+
+static SemaphoreHandle_t health_mutex = nullptr;
+
+// Run time counters of the previous sample: per-task deltas are matched by
+// task number, so tasks created or deleted in between simply start fresh
+struct TaskRuntime {
+    UBaseType_t number;
+    uint32_t runtime;
+};
+static TaskStatus_t task_stats[HEALTH_MAX_TASKS];
+static TaskRuntime prev_tasks[HEALTH_MAX_TASKS];
+static int prev_task_count = 0;
+static uint32_t prev_total_runtime = 0;
+
+// Idle pacer counters of the previous sample
+static IdlePacerStats prev_pacer = {};
+static uint32_t prev_pacer_ms = 0;
+
+static const char* reset_reason_name() {
+    switch (esp_reset_reason()) {
+        case ESP_RST_POWERON:   return "Power On";
+        case ESP_RST_SW:        return "Software";
+        case ESP_RST_PANIC:     return "Panic";
+        case ESP_RST_INT_WDT:   return "Interrupt WDT";
+        case ESP_RST_TASK_WDT:  return "Task WDT";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_DEEPSLEEP: return "Deep Sleep";
+        case ESP_RST_BROWNOUT:  return "Brownout";
+        case ESP_RST_SDIO:      return "SDIO";
+        default:                return "Unknown";
+    }
+}
+
+static uint32_t prev_runtime_of(UBaseType_t number, bool* found) {
+    for (int i = 0; i < prev_task_count; i++) {
+        if (prev_tasks[i].number == number) {
+            *found = true;
+            return prev_tasks[i].runtime;
+        }
+    }
+    *found = false;
+    return 0;
+}
+
+static uint8_t percent(uint32_t part, uint32_t whole) {
+    if (whole == 0) return 0;
+    const uint32_t p = (uint32_t)(((uint64_t)part * 100 + whole / 2) / whole);
+    return (uint8_t)(p > 100 ? 100 : p);
+}
+
+// Sample everything, add it to the history and serialize /api/health
+static void take_sample() {
+    HealthSample sample = {};
+    JsonDocument doc;
+
+    // System
+    sample.uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    doc["uptime_seconds"] = sample.uptime_s;
+    doc["reset_reason"] = reset_reason_name();
+
+    // CPU
+    doc["cpu_freq"] = ESP.getCpuFreqMHz();
+
+    // CPU usage: IDLE run time against the run time of all cores since the last sample
+    uint32_t total_runtime = 0;
+    const int task_count = (int)uxTaskGetSystemState(task_stats, HEALTH_MAX_TASKS, &total_runtime);
+    const uint32_t total_delta = total_runtime - prev_total_runtime;
+    const bool have_delta = prev_total_runtime != 0 && total_delta > 0;
+
+    uint32_t idle_delta = 0;
+    JsonArray tasks = doc["tasks"].to<JsonArray>();
+    for (int i = 0; i < task_count; i++) {
+        const TaskStatus_t& t = task_stats[i];
+        bool found = false;
+        const uint32_t delta = t.ulRunTimeCounter - prev_runtime_of(t.xTaskNumber, &found);
+        if (strstr(t.pcTaskName, "IDLE") != nullptr) {
+            idle_delta += found ? delta : 0;
+        }
+
+        JsonObject task = tasks.add<JsonObject>();
+        task["name"] = t.pcTaskName;
+        if (have_delta && found) {
+            task["cpu"] = percent(delta, total_delta);
+        } else {
+            task["cpu"] = nullptr;
+        }
+        task["stack_free"] = (uint32_t)t.usStackHighWaterMark;
+    }
+    if (have_delta) {
+        sample.cpu_usage = 100 - percent(idle_delta, total_delta * portNUM_PROCESSORS);
+    }
+    doc["cpu_usage"] = sample.cpu_usage;
+
+    // Idle pacing: idle-paced share of the period and render loop rate
+    IdlePacerStats pacer;
+    idle_pacer_get_stats(&pacer);
+    const uint32_t now_ms = millis();
+    const uint32_t pacer_period = now_ms - prev_pacer_ms;
+    if (prev_pacer_ms != 0 && pacer_period > 0) {
+        sample.idle_pct = percent(pacer.idle_ms - prev_pacer.idle_ms, pacer_period);
+        doc["render_hz"] = (float)(pacer.render_wakeups - prev_pacer.render_wakeups) * 1000.0f / pacer_period;
+    } else {
+        doc["render_hz"] = nullptr;
+    }
+    doc["idle_pct"] = sample.idle_pct;
+    doc["idle"] = idle_pacer_is_idle();
+    prev_pacer = pacer;
+    prev_pacer_ms = now_ms;
+
+    for (int i = 0; i < task_count; i++) {
+        prev_tasks[i].number = task_stats[i].xTaskNumber;
+        prev_tasks[i].runtime = task_stats[i].ulRunTimeCounter;
+    }
+    prev_task_count = task_count;
+    prev_total_runtime = total_runtime;
+
+    sample.temperature = NAN;
+#if SOC_TEMP_SENSOR_SUPPORTED
+    float temp_celsius = 0;
+    if (temp_sensor && temperature_sensor_get_celsius(temp_sensor, &temp_celsius) == ESP_OK) {
+        sample.temperature = temp_celsius;
+    }
+#endif
+    if (isnan(sample.temperature)) {
+        doc["temperature"] = nullptr;
+    } else {
+        doc["temperature"] = (int)sample.temperature;
+    }
+
+    // Memory
+    sample.heap_free = ESP.getFreeHeap();
+    sample.heap_min = ESP.getMinFreeHeap();
+    sample.heap_largest = ESP.getMaxAllocHeap();
+    doc["heap_free"] = sample.heap_free;
+    doc["heap_min"] = sample.heap_min;
+    doc["heap_size"] = ESP.getHeapSize();
+
+    if (sample.heap_free > 0) {
+        sample.fragmentation = 100 - percent(sample.heap_largest, sample.heap_free);
+    }
+    doc["heap_fragmentation"] = sample.fragmentation;
+
+    // Upload/strip buffer arena
+    ImageArenaStats arena;
+    image_arena_get_stats(&arena);
+    JsonObject arena_obj = doc["image_arena"].to<JsonObject>();
+    arena_obj["capacity"] = arena.capacity;
+    arena_obj["used"] = arena.used;
+    arena_obj["high_water"] = arena.high_water;
+    arena_obj["live"] = arena.live;
+    arena_obj["resets"] = arena.resets;
+    arena_obj["fallbacks"] = arena.fallbacks;
+
+    // Flash usage
+    doc["flash_used"] = ESP.getSketchSize();
+    doc["flash_total"] = ESP.getSketchSize() + ESP.getFreeSketchSpace();
+
+    // WiFi stats
+    if (WiFi.status() == WL_CONNECTED) {
+        sample.rssi = (int8_t)WiFi.RSSI();
+        doc["wifi_rssi"] = sample.rssi;
+        doc["wifi_channel"] = WiFi.channel();
+        doc["ip_address"] = WiFi.localIP().toString();
+        doc["hostname"] = WiFi.getHostname();
+    } else {
+        doc["wifi_rssi"] = nullptr;
+        doc["wifi_channel"] = nullptr;
+        doc["ip_address"] = nullptr;
+        doc["hostname"] = nullptr;
+    }
+
+    // Boot milestones (ms since reset, null = not reached)
+    JsonObject boot = doc["boot"].to<JsonObject>();
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        const uint32_t ms = boot_timing_get((BootPhase)i);
+        if (ms) {
+            boot[boot_timing_phase_name((BootPhase)i)] = ms;
+        } else {
+            boot[boot_timing_phase_name((BootPhase)i)] = nullptr;
+        }
+    }
+    boot["wifi_fast_connect"] = boot_timing_fast_wifi();
+
+    // Render/flush counters since boot (histogram bucket i counts durations
+    // below hist_bounds_us[i]; the last bucket is everything above)
+    PerfSnapshot perf;
+    perf_counters_snapshot(&perf);
+    JsonObject perf_obj = doc["perf"].to<JsonObject>();
+    for (int t = 0; t < PERF_TIMER_COUNT; t++) {
+        const PerfTimerStats& stats = perf.timers[t];
+        JsonObject timer = perf_obj[perf_timer_name((PerfTimer)t)].to<JsonObject>();
+        timer["count"] = stats.count;
+        timer["avg_us"] = stats.count ? (uint32_t)(stats.total_us / stats.count) : 0;
+        timer["max_us"] = stats.max_us;
+        JsonArray hist = timer["hist"].to<JsonArray>();
+        for (int b = 0; b < PERF_HIST_BUCKETS; b++) {
+            hist.add(stats.hist[b]);
+        }
+    }
+    JsonArray bounds = perf_obj["hist_bounds_us"].to<JsonArray>();
+    for (int b = 0; b < PERF_HIST_BUCKETS - 1; b++) {
+        bounds.add(PERF_HIST_BOUND_US(b));
+    }
+    perf_obj["flush_pixels"] = perf.flush_pixels;
+    perf_obj["flush_pixels_max"] = perf.flush_pixels_max;
+    perf_obj["spi_bytes"] = perf.spi_bytes;
+    perf_obj["spi_bytes_per_sec"] = perf.spi_bytes_per_sec;
+
+    doc["sample_period_ms"] = HEALTH_SAMPLE_PERIOD_MS;
+
+    // Serialize outside the lock; nobody reads the spare buffer. Responses only
+    // pin json_current, so once the spare has no readers it stays free.
+    const int spare = (json_current == 0) ? 1 : 0;
+    xSemaphoreTake(health_mutex, portMAX_DELAY);
+    const bool spare_busy = json_readers[spare] > 0;
+    xSemaphoreGive(health_mutex);
+    size_t len = 0;
+    if (spare_busy) {
+        // A response from before the last refresh is still going; try next period
+    } else if (measureJson(doc) < HEALTH_JSON_MAX) {
+        len = serializeJson(doc, json_buf[spare], HEALTH_JSON_MAX);
+    } else {
+        Logger.logMessage("Health", "WARNING: Health JSON too large, keeping the previous one");
+    }
+
+    xSemaphoreTake(health_mutex, portMAX_DELAY);
+    if (len > 0) {
+        json_len[spare] = len;
+        json_current = spare;
+    }
+    history[history_head] = sample;
+    history_head = (history_head + 1) % HEALTH_HISTORY_SAMPLES;
+    if (history_count < HEALTH_HISTORY_SAMPLES) history_count++;
+    xSemaphoreGive(health_mutex);
+}
+
+static void health_task(void* arg) {
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(HEALTH_SAMPLE_PERIOD_MS));
+        take_sample();
+    }
+}
+
+void health_sampler_init() {
+    if (health_mutex) return;
+    health_mutex = xSemaphoreCreateMutex();
+
+#if SOC_TEMP_SENSOR_SUPPORTED
+    // Installed once and left enabled: a read is then a register access
+    temperature_sensor_config_t temp_sensor_config = TEMPERATURE_SENSOR_CONFIG_DEFAULT(-10, 80);
+    if (temperature_sensor_install(&temp_sensor_config, &temp_sensor) != ESP_OK ||
+        temperature_sensor_enable(temp_sensor) != ESP_OK) {
+        Logger.logMessage("Health", "Temperature sensor unavailable");
+        temp_sensor = NULL;
+    }
+#endif
+
+    take_sample();
+    xTaskCreate(health_task, "health", HEALTH_TASK_STACK, nullptr, 1, nullptr);
+}
+
+// One response's hold on a JSON buffer, released when the response is deleted
+struct HealthJsonPin {
+    int index;
+    size_t len;
+
+    HealthJsonPin(int index, size_t len) : index(index), len(len) {}
+    ~HealthJsonPin() {
+        xSemaphoreTake(health_mutex, portMAX_DELAY);
+        json_readers[index]--;
+        xSemaphoreGive(health_mutex);
+    }
+
+    size_t fill(uint8_t* buffer, size_t max_len, size_t offset) {
+        const size_t n = min(max_len, len - offset);
+        xSemaphoreTake(health_mutex, portMAX_DELAY);
+        memcpy(buffer, json_buf[index] + offset, n);
+        xSemaphoreGive(health_mutex);
+        return n;
+    }
+};
+
+AsyncWebServerResponse* health_sampler_json_response(AsyncWebServerRequest* request) {
+    std::shared_ptr<HealthJsonPin> pin;
+    if (health_mutex) {
+        xSemaphoreTake(health_mutex, portMAX_DELAY);
+        if (json_current >= 0) {
+            json_readers[json_current]++;
+            pin = std::make_shared<HealthJsonPin>(json_current, json_len[json_current]);
+        }
+        xSemaphoreGive(health_mutex);
+    }
+    if (!pin) {
+        return request->beginResponse(503, "application/json", "{\"error\":\"No health sample yet\"}");
+    }
+
+    return request->beginResponse("application/json", pin->len,
+        [pin](uint8_t* buffer, size_t max_len, size_t index) -> size_t {
+            return pin->fill(buffer, max_len, index);
+        });
+}
+
+bool health_sampler_latest(HealthSample* out) {
+    if (!health_mutex) return false;
+    xSemaphoreTake(health_mutex, portMAX_DELAY);
+    const bool ok = history_count > 0;
+    if (ok) {
+        *out = history[(history_head + HEALTH_HISTORY_SAMPLES - 1) % HEALTH_HISTORY_SAMPLES];
+    }
+    xSemaphoreGive(health_mutex);
+    return ok;
+}
+
+void health_sampler_print_history(AsyncResponseStream* out) {
+    out->print("{\"sample_period_ms\":");
+    out->print(HEALTH_SAMPLE_PERIOD_MS);
+    out->print(",\"samples\":[");
+    if (health_mutex) {
+        xSemaphoreTake(health_mutex, portMAX_DELAY);
+        for (size_t i = 0; i < history_count; i++) {
+            const HealthSample& s = history[(history_head + HEALTH_HISTORY_SAMPLES - history_count + i) % HEALTH_HISTORY_SAMPLES];
+            out->printf("%s{\"uptime_s\":%lu,\"cpu\":%u,\"idle\":%u,\"heap_free\":%lu,\"heap_min\":%lu,\"heap_largest\":%lu,\"frag\":%u,",
+                        i ? "," : "", (unsigned long)s.uptime_s, s.cpu_usage, s.idle_pct, (unsigned long)s.heap_free,
+                        (unsigned long)s.heap_min, (unsigned long)s.heap_largest, s.fragmentation);
+            if (s.rssi) {
+                out->printf("\"rssi\":%d,", s.rssi);
+            } else {
+                out->print("\"rssi\":null,");
+            }
+            if (isnan(s.temperature)) {
+                out->print("\"temp\":null}");
+            } else {
+                out->printf("\"temp\":%.1f}", s.temperature);
+            }
+        }
+        xSemaphoreGive(health_mutex);
+    }
+    out->print("]}");
+}
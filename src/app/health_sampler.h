@@ -0,0 +1,53 @@
+/*
+ * Health Sampler
+ *
+ * A low-priority task takes one system snapshot every HEALTH_SAMPLE_PERIOD_MS
+ * (CPU load overall and per task, heap, RSSI, temperature) and serializes the
+ * GET /api/health document right away. Responses are filled from the latest
+ * JSON buffer, so polling costs no probing and every client sees the same
+ * fixed interval.
+ * The numeric part of each snapshot is kept in a ring of HEALTH_HISTORY_SAMPLES
+ * for GET /api/health/history.
+ *
+ * CPU figures are the share of run time over the last period: cpu_usage from
+ * the IDLE tasks of all cores, tasks[].cpu per task (100 = one whole core).
+ * idle_pct is the share of the period the render task spent idle-paced
+ * (see idle_pacer.h).
+ */
+
+#ifndef HEALTH_SAMPLER_H
+#define HEALTH_SAMPLER_H
+
+#include <Arduino.h>
+
+class AsyncResponseStream;
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+
+struct HealthSample {
+    uint32_t uptime_s;
+    uint32_t heap_free;
+    uint32_t heap_min;
+    uint32_t heap_largest;
+    float temperature;    // °C, NAN when the chip has no sensor
+    int8_t rssi;          // dBm, 0 = not connected
+    uint8_t cpu_usage;    // %
+    uint8_t fragmentation;  // %
+    uint8_t idle_pct;     // % of the period idle-paced
+};
+
+// Take the first sample and start the sampler task
+void health_sampler_init();
+
+// GET /api/health response, filled straight from the latest document's buffer
+// (503 before the first sample). The buffer stays pinned until the response is
+// gone: the sampler skips a refresh rather than overwrite it.
+AsyncWebServerResponse* health_sampler_json_response(AsyncWebServerRequest* request);
+
+// Latest numeric snapshot; false before the first sample
+bool health_sampler_latest(HealthSample* out);
+
+// Write the history ring as JSON, oldest sample first
+void health_sampler_print_history(AsyncResponseStream* out);
+
+#endif // HEALTH_SAMPLER_H
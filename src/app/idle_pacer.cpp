@@ -0,0 +1,78 @@
+/*
+ * Idle Pacer Implementation
+ */
+
+#include "idle_pacer.h"
+#include "board_config.h"
+#include "log_manager.h"
+#include <esp_pm.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static volatile bool display_idle = false;
+static volatile uint32_t last_activity_ms = 0;
+static TaskHandle_t render_task = nullptr;
+
+// Written by the render task only; 32-bit so readers never see a torn value
+static volatile uint32_t render_wakeups = 0;
+static volatile uint32_t idle_ms = 0;
+
+void idle_pacer_init() {
+#if IDLE_LIGHT_SLEEP
+#if CONFIG_PM_ENABLE
+    // Keep APB at 80 MHz (min 80): the LCD SPI clock and UART baud stay put
+    esp_pm_config_t pm = {};
+    pm.max_freq_mhz = ESP.getCpuFreqMHz();
+    pm.min_freq_mhz = 80;
+    pm.light_sleep_enable = true;
+    const esp_err_t err = esp_pm_configure(&pm);
+    if (err == ESP_OK) {
+        Logger.logMessagef("Idle", "Light sleep enabled (%d-%d MHz)", pm.min_freq_mhz, pm.max_freq_mhz);
+    } else {
+        Logger.logMessagef("Idle", "WARNING: Light sleep unavailable (%s)", esp_err_to_name(err));
+    }
+#else
+    Logger.logMessage("Idle", "WARNING: Light sleep needs CONFIG_PM_ENABLE");
+#endif
+#endif
+}
+
+void idle_pacer_note_activity() {
+    last_activity_ms = millis();
+}
+
+void idle_pacer_set_display_idle(bool idle) {
+    display_idle = idle;
+}
+
+bool idle_pacer_is_idle() {
+    return display_idle && (uint32_t)(millis() - last_activity_ms) >= IDLE_ACTIVITY_HOLD_MS;
+}
+
+void idle_pacer_render_wait(uint32_t ms) {
+    if (!render_task) render_task = xTaskGetCurrentTaskHandle();
+    render_wakeups = render_wakeups + 1;
+
+    const bool idle = idle_pacer_is_idle();
+    const uint32_t start = millis();
+    // Always block at least one tick: every task must yield once per iteration
+    TickType_t ticks = pdMS_TO_TICKS(ms);
+    if (ticks == 0) ticks = 1;
+    ulTaskNotifyTake(pdTRUE, ticks);
+    if (idle) {
+        idle_ms = idle_ms + (millis() - start);
+    }
+}
+
+void idle_pacer_wake() {
+    if (render_task) xTaskNotifyGive(render_task);
+}
+
+void idle_pacer_task_delay(uint32_t busy_ms) {
+    vTaskDelay(pdMS_TO_TICKS(idle_pacer_is_idle() ? IDLE_TASK_PERIOD_MS : busy_ms));
+}
+
+void idle_pacer_get_stats(IdlePacerStats* out) {
+    out->render_wakeups = render_wakeups;
+    out->idle_ms = idle_ms;
+}
@@ -0,0 +1,55 @@
+/*
+ * Idle Pacer
+ *
+ * The power screen changes at most once a second, so between MQTT updates the
+ * render, loop and network tasks have nothing to do. The display manager
+ * reports after each LVGL pass whether the display is idle (no invalidated
+ * area, no animation, no image screen); together with the time since the last
+ * upload activity that decides the pace of every task:
+ *
+ *   full rate   render task every RENDER_TASK_PERIOD_MS, LVGL refresh 10 ms
+ *   idle        render task sleeps until LVGL's next deadline (at most
+ *               RENDER_IDLE_PERIOD_MS), loop/network tasks IDLE_TASK_PERIOD_MS
+ *
+ * Work arriving from other tasks wakes the render task early (idle_pacer_wake),
+ * so idle pacing adds no latency to value changes. With IDLE_LIGHT_SLEEP the
+ * SoC light-sleeps while all tasks are blocked.
+ *
+ * All functions are lock-free and safe from any task (not from ISRs).
+ */
+
+#ifndef IDLE_PACER_H
+#define IDLE_PACER_H
+
+#include <Arduino.h>
+
+struct IdlePacerStats {
+    uint32_t render_wakeups;  // render task iterations since boot
+    uint32_t idle_ms;         // time the render task spent idle-paced since boot (wraps)
+};
+
+// Configure power management (light sleep) when enabled
+void idle_pacer_init();
+
+// Uploads and other bursts: stay at full rate for IDLE_ACTIVITY_HOLD_MS
+void idle_pacer_note_activity();
+
+// Display manager: result of the last LVGL pass
+void idle_pacer_set_display_idle(bool idle);
+
+// True when the display is idle and no activity was noted recently
+bool idle_pacer_is_idle();
+
+// Render task: block for up to ms (counted as idle time when idle-paced);
+// returns early on idle_pacer_wake()
+void idle_pacer_render_wait(uint32_t ms);
+
+// Wake the render task (new values, invalidations from other tasks)
+void idle_pacer_wake();
+
+// Loop/network tasks: vTaskDelay(busy_ms), or IDLE_TASK_PERIOD_MS while idle
+void idle_pacer_task_delay(uint32_t busy_ms);
+
+void idle_pacer_get_stats(IdlePacerStats* out);
+
+#endif // IDLE_PACER_H
@@ -1,20 +1,48 @@
 #include "image_api.h"
 
+#include "idle_pacer.h"
+#include "image_arena.h"
+#include "image_cache.h"
 #include "jpeg_preflight.h"
 #include "log_manager.h"
+#include "mem_placement.h"
 
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/task.h>
 
 // ===== Internal state =====
 
 static ImageApiConfig g_cfg;
-static ImageApiBackend g_backend = {nullptr, nullptr, nullptr};
+static ImageApiBackend g_backend;
+
+// Optional capture of a decoded upload into the image cache:
+//   ?cache=1          id = FNV-1a hash of the JPEG bytes (all strips, in order)
+//   ?cache_id=<hex>   id chosen by the client
+struct CacheRequest {
+    bool capture;
+    bool client_id;
+    uint32_t id;
+};
+
+// Upload body format (?format=): JPEG, or pixel data drawn without decode
+// (g_backend.draw_raw; layouts in raw_image.h)
+enum ImageFormat : uint8_t {
+    IMAGE_FORMAT_JPEG = 0,
+    IMAGE_FORMAT_RGB565,
+    IMAGE_FORMAT_RLE565
+};
 
 // Image upload buffer (allocated temporarily during upload)
 static uint8_t* image_upload_buffer = nullptr;
 static size_t image_upload_size = 0;
 static unsigned long image_upload_timeout_ms = 10000;
+static uint8_t image_upload_scale = 0;
+static CacheRequest image_upload_cache = {};
 
 // Upload state tracking
 enum UploadState {
@@ -32,12 +60,135 @@ struct PendingImageOp {
     bool dismiss;  // true = dismiss current image, false = show new image
     unsigned long timeout_ms;  // Display timeout in milliseconds
     unsigned long start_time;  // Time when upload completed (for accurate timeout)
+    CacheRequest cache;        // Capture the decoded image into the cache
+    bool show_cached;          // true = blit cached_id instead of decoding buffer
+    uint32_t cached_id;
+    uint8_t scale;             // decode at 1/2^scale
+};
+static PendingImageOp pending_image_op = {nullptr, 0, false, 10000, 0, {}, false, 0, 0};
+
+// ===== Strip decode pipeline =====
+// Strips are received into a small ring of slots on the AsyncTCP task and decoded
+// in order on a dedicated task, so strip N decodes while strip N+1 streams in.
+// Slot indices circulate through two FIFO queues: free -> (receive) -> ready ->
+// (decode) -> free. Slot buffers grow to the largest strip seen and are trimmed
+// by image_api_process_pending() once the pipeline has been idle for a while.
+
+struct StripSlot {
+    uint8_t* data;
+    size_t capacity;
+    size_t size;
+    int strip_index;
+    int strip_count;
+    int width;
+    int height;
+    unsigned long timeout_ms;
+    unsigned long start_time;
+    uint32_t session_gen;  // strip 0 opens a new generation (tiles: tile sequence number)
+    CacheRequest cache;    // taken from strip 0
+    bool tile;             // partial update at (x, y), not part of a strip session
+    int x;
+    int y;
+    ImageFormat format;    // tiles; strips are JPEG except from image_api_submit_strip()
+    uint32_t frame;        // delta frame the tile belongs to (0 = standalone tile)
+    uint32_t base_epoch;   // delta tiles: screen epoch they draw on (0 = keyframe)
+    uint8_t scale;         // strips: decode at 1/2^scale (taken from strip 0)
+    int rows;              // raw strips: band of rows at (0, y)
 };
-static PendingImageOp pending_image_op = {nullptr, 0, false, 10000, 0};
 
-// Current strip being uploaded (stateless - metadata comes with each request)
-static uint8_t* current_strip_buffer = nullptr;
-static size_t current_strip_size = 0;
+// Ready-queue entry for a streaming full-image decode (instead of a slot index)
+static const int STRIP_JOB_STREAM = -1;
+
+static StripSlot* strip_slots = nullptr;
+static size_t strip_slot_count = 0;
+static QueueHandle_t strip_free_q = nullptr;
+static QueueHandle_t strip_ready_q = nullptr;
+static TaskHandle_t strip_decode_task_handle = nullptr;
+
+static volatile uint32_t strip_session_gen = 0;    // upload side: current session
+static uint8_t strip_session_scale = 0;            // upload side: scale of the current session
+static portMUX_TYPE strip_session_mux = portMUX_INITIALIZER_UNLOCKED;  // HTTP and submitted strips open sessions
+static volatile uint32_t strip_failed_gen = 0;     // decode side: session whose decode failed
+static volatile uint32_t strip_last_done_gen = 0;  // decode side: session whose last strip finished
+
+// Tiles (decode side reports the last finished tile and its result)
+static uint32_t tile_seq = 0;                      // upload side
+static volatile uint32_t tile_done_seq = 0;
+static volatile uint32_t tile_failed_seq = 0;
+
+// Delta frames (decode side): frames whose base picture was gone or whose tile
+// failed, and the screen epoch after the last delta tile
+static volatile uint32_t frame_stale_gen = 0;
+static volatile uint32_t frame_failed_gen = 0;
+static volatile uint32_t frame_done_epoch = 0;
+
+// Cache capture of the session being decoded (decode task only)
+static CacheRequest strip_capture = {};
+static uint32_t strip_capture_hash = 0;
+static volatile uint32_t strip_cached_gen = 0;  // session whose frame was cached
+static volatile uint32_t strip_cached_id = 0;
+
+// Slot currently receiving a body (one strip upload at a time, like the old single buffer)
+static int rx_slot = -1;
+static AsyncWebServerRequest* rx_request = nullptr;
+
+// Delta frame tile waiting for a ring slot: about one tile decode. Tiles of one
+// TCP chunk arrive faster than any decode, so the parser must wait a little, but
+// a stuck decode task turns into a quick 503 instead of a stalled AsyncTCP task.
+static const unsigned long DELTA_SLOT_WAIT_MS = 50;
+
+// ===== Streaming full-image upload =====
+// POST /api/display/image?stream=1 (or automatically when the buffered path cannot
+// fit): the upload handler pushes body chunks into a small stream buffer and the
+// decode task pulls from it through TJpgDec's input callback, so decode starts on
+// the first bytes and peak RAM is the stream buffer, independent of file size.
+// The stream buffer is created on first use and kept for later uploads.
+// Body bytes are only acked to the TCP window once the decoder has drained them,
+// so the buffer can never overflow and the handler never waits for the decoder.
+static StreamBufferHandle_t stream_sb = nullptr;
+static AsyncWebServerRequest* stream_request = nullptr;  // upload currently streaming
+static bool stream_responded = false;                   // error already sent for stream_request
+static size_t stream_received = 0;
+static unsigned long stream_timeout_ms = 0;
+static unsigned long stream_start_time = 0;
+static volatile bool stream_eof = false;    // handler: all bytes pushed
+static volatile bool stream_abort = false;  // handler: upload failed/abandoned
+static volatile bool stream_done = false;   // decode task: finished (see stream_ok)
+static volatile bool stream_ok = false;
+static ImageFormat stream_format = IMAGE_FORMAT_JPEG;
+static uint8_t stream_scale = 0;
+static bool stream_job_queued = false;      // decode job queued and not yet finished
+static volatile bool buffered_decode_active = false;  // main loop is drawing a buffered upload
+static CacheRequest stream_cache = {};
+static uint32_t stream_hash = 0;
+static AsyncWebServerRequest* stream_drop_request = nullptr;  // failed stream whose body is still arriving
+
+// Client whose receive window the decode task reopens; the request (and its
+// client) is freed on disconnect, so it is only touched under the mutex
+static AsyncClient* stream_client = nullptr;
+static SemaphoreHandle_t stream_client_mutex = nullptr;
+static size_t stream_drained = 0;  // decode task: bytes drained but not acked yet
+
+// Drained bytes are acked in batches of about one TCP segment
+static const size_t STREAM_ACK_BATCH = 1024;
+
+static ImageApiStats upload_stats = {};
+static volatile bool uploads_paused = false;  // firmware update running
+
+// New uploads get 503 during a firmware update (checked on the first chunk;
+// the handlers' state checks then ignore the rest of the body)
+static bool reject_while_paused(AsyncWebServerRequest* request) {
+    if (!uploads_paused) return false;
+    request->send(503, "application/json", "{\"success\":false,\"message\":\"Firmware update in progress\"}");
+    return true;
+}
+
+// Also keeps the tasks at full rate for the upload (idle pacing off)
+static void count_upload(ImageUploadKind kind, size_t index, size_t len) {
+    idle_pacer_note_activity();
+    if (index == 0) upload_stats.requests[kind]++;
+    upload_stats.bytes[kind] += len;
+}
 
 static bool is_jpeg_magic(const uint8_t* buf, size_t sz) {
     return (buf && sz >= 3 && buf[0] == 0xFF && buf[1] == 0xD8 && buf[2] == 0xFF);
@@ -54,11 +205,618 @@ static unsigned long parse_timeout_ms(AsyncWebServerRequest* request) {
     return timeout_seconds * 1000UL;
 }
 
+static CacheRequest parse_cache_request(AsyncWebServerRequest* request) {
+    CacheRequest c = {false, false, 0};
+    if (!g_backend.cache_begin || !g_backend.cache_end) {
+        return c;
+    }
+    if (request->hasParam("cache_id")) {
+        c.capture = true;
+        c.client_id = true;
+        c.id = (uint32_t)strtoul(request->getParam("cache_id")->value().c_str(), nullptr, 16);
+    } else if (request->hasParam("cache")) {
+        c.capture = request->getParam("cache")->value() == "1";
+    }
+    return c;
+}
+
+// Missing ?format= means JPEG; false for an unknown or unsupported format
+static bool parse_image_format(AsyncWebServerRequest* request, ImageFormat* format) {
+    *format = IMAGE_FORMAT_JPEG;
+    if (!request->hasParam("format")) return true;
+
+    const String& name = request->getParam("format")->value();
+    if (name == "jpeg") return true;
+    if (!g_backend.draw_raw) return false;
+    if (name == "rgb565") {
+        *format = IMAGE_FORMAT_RGB565;
+        return true;
+    }
+    if (name == "rle565") {
+        *format = IMAGE_FORMAT_RLE565;
+        return true;
+    }
+    return false;
+}
+
+// ?scale=1|2|4|8 (JPEG decoded at 1/scale) as a jd_decomp() scale factor 0..3;
+// false for any other value
+static bool parse_scale(AsyncWebServerRequest* request, uint8_t* scale) {
+    *scale = 0;
+    if (!request->hasParam("scale")) return true;
+
+    const long denom = request->getParam("scale")->value().toInt();
+    for (uint8_t s = 0; s <= 3; s++) {
+        if (denom == (1L << s)) {
+            *scale = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Byte source over a fully received buffer (raw tiles)
+struct MemReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+};
+
+static size_t mem_read(void* ctx, uint8_t* buf, size_t len) {
+    MemReader* r = (MemReader*)ctx;
+    const size_t n = min(len, r->size - r->pos);
+    if (buf) memcpy(buf, r->data + r->pos, n);
+    r->pos += n;
+    return n;
+}
+
+// Slots are fixed at init; false if the body does not fit (or the ring could not be carved)
+static bool strip_slot_reserve(int idx, size_t size) {
+    StripSlot& s = strip_slots[idx];
+    if (s.capacity < size) return false;
+    s.size = 0;
+    return true;
+}
+
+// A show_image backend takes ownership of whole-image uploads and releases them
+// with free(), so their buffers come from the heap instead of the arena
+static bool upload_handed_off() {
+    return !(g_backend.start_strip_session && g_backend.decode_strip) && g_backend.show_image;
+}
+
+static uint8_t* upload_buffer_alloc(size_t size) {
+    return (uint8_t*)(upload_handed_off() ? mem_alloc_large(size) : image_arena_alloc(size));
+}
+
+// Room for an upload buffer that still leaves decode_headroom_bytes of internal heap
+static size_t upload_buffer_space() {
+    const size_t heap = mem_large_available(g_cfg.decode_headroom_bytes);
+    if (heap == 0 || upload_handed_off()) return heap;
+    return max(heap, image_arena_available());
+}
+
+static void strip_slot_release(int idx) {
+    strip_slots[idx].size = 0;
+    xQueueSend(strip_free_q, &idx, 0);
+}
+
+// No strip queued or decoding, and no stream job queued or decoding
+static bool strip_pipeline_idle() {
+    return strip_free_q && uxQueueMessagesWaiting(strip_free_q) == strip_slot_count &&
+           !(stream_job_queued && !stream_done);
+}
+
+// Reopen the TCP window by what the decoder has drained (decode task). ack() only
+// returns what AsyncTCP already counted as held back, so the rest is retried.
+static void stream_window_ack(size_t n) {
+    stream_drained += n;
+    if (stream_drained == 0) return;
+    if (stream_drained < STREAM_ACK_BATCH && !xStreamBufferIsEmpty(stream_sb)) return;
+
+    xSemaphoreTake(stream_client_mutex, portMAX_DELAY);
+    if (stream_client) {
+        stream_drained -= stream_client->ack(stream_drained);
+    } else {
+        stream_drained = 0;
+    }
+    xSemaphoreGive(stream_client_mutex);
+}
+
+// TJpgDec input source for streaming uploads (decode task side)
+static size_t stream_read(void* ctx, uint8_t* buf, size_t len) {
+    (void)ctx;
+    uint8_t scratch[64];
+    size_t got = 0;
+    unsigned long last_data = millis();
+
+    while (got < len) {
+        uint8_t* dst = buf ? (buf + got) : scratch;
+        size_t want = len - got;
+        if (!buf && want > sizeof(scratch)) want = sizeof(scratch);
+
+        const size_t n = xStreamBufferReceive(stream_sb, dst, want, pdMS_TO_TICKS(50));
+        stream_window_ack(n);
+        if (n > 0) {
+            got += n;
+            last_data = millis();
+            continue;
+        }
+        if (stream_abort) break;
+        if (stream_eof && xStreamBufferIsEmpty(stream_sb)) break;
+        if ((millis() - last_data) >= g_cfg.stream_stall_timeout_ms) {
+            Logger.logMessage("Image Stream", "ERROR: Upload stalled");
+            break;
+        }
+    }
+    return got;
+}
+
+static void strip_run_stream_job() {
+    stream_drained = 0;
+
+    // Deferred from the upload handler (hide current image, backend decides what this means)
+    if (g_backend.hide_current_image) {
+        g_backend.hide_current_image();
+    }
+
+    if (stream_format != IMAGE_FORMAT_JPEG) {
+        stream_ok = g_backend.draw_raw(stream_format == IMAGE_FORMAT_RLE565, 0, 0, g_cfg.lcd_width, g_cfg.lcd_height,
+                                       stream_read, nullptr, stream_timeout_ms, stream_start_time);
+        stream_done = true;
+        return;
+    }
+
+    bool ok = g_backend.start_strip_session &&
+              g_backend.start_strip_session(g_cfg.lcd_width, g_cfg.lcd_height, stream_scale,
+                                            stream_timeout_ms, stream_start_time);
+    if (!ok) {
+        Logger.logMessage("Image Stream", "ERROR: Failed to initialize display");
+    } else {
+        if (stream_cache.capture && !g_backend.cache_begin()) {
+            stream_cache.capture = false;
+        }
+        ok = g_backend.decode_stream(stream_read, nullptr);
+        if (!ok && stream_cache.capture) {
+            g_backend.cache_end(0, false);
+        }
+    }
+
+    stream_ok = ok;
+    stream_done = true;
+}
+
+// Tile job; delta frame tiles are skipped once their frame is lost (base picture
+// replaced: stale) or broken (an earlier tile failed)
+static void strip_run_tile_job(const StripSlot& s) {
+    const bool broken = s.frame && s.frame == frame_failed_gen;
+    const bool stale = s.frame && (s.frame == frame_stale_gen ||
+                                   (s.base_epoch && g_backend.screen_epoch() != s.base_epoch));
+    bool ok = false;
+    if (stale) {
+        if (frame_stale_gen != s.frame) Logger.logMessage("Strip Pipeline", "Delta frame base is gone, skipping");
+        frame_stale_gen = s.frame;
+    } else if (!broken) {
+        if (s.format == IMAGE_FORMAT_JPEG) {
+            ok = g_backend.decode_tile(s.data, s.size, s.x, s.y, s.timeout_ms, s.start_time);
+        } else {
+            MemReader reader = {s.data, s.size, 0};
+            ok = g_backend.draw_raw(s.format == IMAGE_FORMAT_RLE565, s.x, s.y, s.width, s.height,
+                                    mem_read, &reader, s.timeout_ms, s.start_time);
+        }
+        if (!ok) {
+            Logger.logMessagef("Strip Pipeline", "ERROR: Failed to decode tile at %d,%d", s.x, s.y);
+            if (s.frame) frame_failed_gen = s.frame;
+        }
+    }
+
+    if (s.frame) {
+        frame_done_epoch = g_backend.screen_epoch();
+    }
+    if (!ok) tile_failed_seq = s.session_gen;
+    tile_done_seq = s.session_gen;
+}
+
+// Decode task: consumes ready slots strictly in arrival order
+static void strip_decode_task(void* param) {
+    (void)param;
+    for (;;) {
+        int idx = -1;
+        if (xQueueReceive(strip_ready_q, &idx, portMAX_DELAY) != pdTRUE) continue;
+
+        if (idx == STRIP_JOB_STREAM) {
+            strip_run_stream_job();
+            continue;
+        }
+
+        StripSlot& s = strip_slots[idx];
+        if (s.tile) {
+            strip_run_tile_job(s);
+            strip_slot_release(idx);
+            continue;
+        }
+
+        const uint32_t gen = s.session_gen;
+        const bool is_last = (s.strip_index == s.strip_count - 1);
+
+        bool ok = (strip_failed_gen != gen);
+        if (ok && s.strip_index == 0) {
+            ok = g_backend.start_strip_session &&
+                 g_backend.start_strip_session(s.width, s.height, s.scale, s.timeout_ms, s.start_time);
+            if (!ok) Logger.logMessage("Strip Pipeline", "ERROR: Failed to initialize display");
+
+            strip_capture = s.cache;
+            strip_capture_hash = IMAGE_CACHE_HASH_SEED;
+            if (ok && strip_capture.capture && !g_backend.cache_begin()) {
+                strip_capture.capture = false;
+            }
+        }
+        if (ok && s.format == IMAGE_FORMAT_JPEG) {
+            ok = g_backend.decode_strip && g_backend.decode_strip(s.data, s.size, (uint8_t)s.strip_index);
+            if (!ok) Logger.logMessagef("Strip Pipeline", "ERROR: Failed to decode strip %d", s.strip_index);
+        } else if (ok) {
+            MemReader reader = {s.data, s.size, 0};
+            ok = g_backend.draw_raw && g_backend.draw_raw(s.format == IMAGE_FORMAT_RLE565, 0, s.y, s.width, s.rows,
+                                                          mem_read, &reader, s.timeout_ms, s.start_time);
+            if (!ok) Logger.logMessagef("Strip Pipeline", "ERROR: Failed to draw raw strip %d", s.strip_index);
+        }
+        if (strip_capture.capture) {
+            if (ok) {
+                strip_capture_hash = image_cache_hash(s.data, s.size, strip_capture_hash);
+            }
+            if (!ok || is_last) {
+                const uint32_t id = strip_capture.client_id ? strip_capture.id : strip_capture_hash;
+                if (g_backend.cache_end(id, ok)) {
+                    strip_cached_id = id;
+                    strip_cached_gen = gen;
+                }
+                strip_capture.capture = false;
+            }
+        }
+        if (!ok) {
+            strip_failed_gen = gen;
+        }
+
+        strip_slot_release(idx);
+
+        if (is_last) {
+            strip_last_done_gen = gen;
+        }
+    }
+}
+
+static void strip_pipeline_init() {
+    if (strip_slots) return;  // Task and queues live for the lifetime of the firmware
+
+    strip_slot_count = g_cfg.strip_queue_depth > 0 ? g_cfg.strip_queue_depth : 1;
+    strip_slots = (StripSlot*)calloc(strip_slot_count, sizeof(StripSlot));
+    strip_free_q = xQueueCreate(strip_slot_count, sizeof(int));
+    // Every slot plus the stream job fit, so submitting a strip never waits
+    strip_ready_q = xQueueCreate(strip_slot_count + 1, sizeof(int));
+    stream_client_mutex = xSemaphoreCreateMutex();
+
+    // One block carved first from the arena and never freed, so the slots sit
+    // below every upload buffer and the bump arena keeps reclaiming the rest
+    const size_t slot_bytes = (g_cfg.max_strip_size_bytes + 7) & ~(size_t)7;
+    uint8_t* ring = (uint8_t*)image_arena_alloc(strip_slot_count * slot_bytes);
+    if (!ring) {
+        Logger.logMessagef("Strip Pipeline", "ERROR: No memory for %u strip slots of %u bytes",
+                           (unsigned)strip_slot_count, (unsigned)slot_bytes);
+    }
+    for (int i = 0; i < (int)strip_slot_count; i++) {
+        strip_slots[i].data = ring ? ring + i * slot_bytes : nullptr;
+        strip_slots[i].capacity = ring ? slot_bytes : 0;
+        xQueueSend(strip_free_q, &i, 0);
+    }
+
+    // Pinned to the app core on dual-core parts, away from the WiFi/TCP stack
+#if CONFIG_FREERTOS_UNICORE
+    xTaskCreate(strip_decode_task, "strip_decode", 6144, nullptr, 2, &strip_decode_task_handle);
+#else
+    xTaskCreatePinnedToCore(strip_decode_task, "strip_decode", 6144, nullptr, 2, &strip_decode_task_handle, APP_CPU_NUM);
+#endif
+}
+
 // ===== Handlers =====
 
-// POST /api/display/image - Upload and display JPEG image (deferred decode)
+static void send_busy(AsyncWebServerRequest* request, const char* json) {
+    AsyncWebServerResponse* response = request->beginResponse(503, "application/json", json);
+    response->addHeader("Retry-After", "1");
+    request->send(response);
+}
+
+static void send_strip_queue_full(AsyncWebServerRequest* request) {
+    send_busy(request, "{\"success\":false,\"busy\":true,\"message\":\"Strip queue full, retry\"}");
+}
+
+// The body of another strip or tile is still arriving (one receive at a time)
+static void send_rx_busy(AsyncWebServerRequest* request) {
+    send_busy(request, "{\"success\":false,\"busy\":true,\"message\":\"Another upload is receiving, retry\"}");
+}
+
+// A reply that is only known after the body callback returned (decode results).
+// AsyncTCP calls _ack() on every TCP ack and poll, the same polling a chunked
+// response gets with RESPONSE_TRY_AGAIN, and poll() is asked for the reply each
+// time until it has one. Unlike a chunked response, the status line is only
+// written then, so the result still picks the code (500, 409, ...).
+typedef std::function<bool(int* code, char* body, size_t body_size)> DeferredReplyPoll;
+
+class DeferredReply : public AsyncWebServerResponse {
+public:
+    explicit DeferredReply(DeferredReplyPoll poll) : _poll(std::move(poll)) {}
+
+    bool _sourceValid() const override { return true; }
+
+    void _respond(AsyncWebServerRequest* request) override {
+        _state = RESPONSE_CONTENT;
+        _ack(request, 0, 0);
+    }
+
+    size_t _ack(AsyncWebServerRequest* request, size_t len, uint32_t time) override {
+        (void)time;
+        _ackedLength += len;
+        if (_state == RESPONSE_WAIT_ACK) {
+            if (_ackedLength >= _writtenLength) _state = RESPONSE_END;
+            return 0;
+        }
+        if (_state != RESPONSE_CONTENT) return 0;
+
+        if (_out_len == 0) {
+            int code = 200;
+            char body[256];
+            if (!_poll(&code, body, sizeof(body))) return 0;
+            const int n = snprintf(_out, sizeof(_out),
+                                   "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\n%s"
+                                   "Connection: close\r\n\r\n%s",
+                                   code, responseCodeToString(code), (unsigned)strlen(body),
+                                   code == 503 ? "Retry-After: 1\r\n" : "", body);
+            _out_len = (n > 0 && (size_t)n < sizeof(_out)) ? (size_t)n : sizeof(_out) - 1;
+        }
+
+        const size_t n = request->client()->write(_out + _writtenLength, _out_len - _writtenLength);
+        _writtenLength += n;
+        if (_writtenLength >= _out_len) _state = RESPONSE_WAIT_ACK;
+        return n;
+    }
+
+private:
+    DeferredReplyPoll _poll;
+    char _out[448];
+    size_t _out_len = 0;
+};
+
+static void send_deferred(AsyncWebServerRequest* request, DeferredReplyPoll poll) {
+    request->send(new DeferredReply(std::move(poll)));
+}
+
+// Hand slot to request for its body; the slot goes back to the ring if the
+// client disconnects before the last chunk (AsyncTCP task, like the handlers)
+static void rx_begin(AsyncWebServerRequest* request, int slot) {
+    rx_slot = slot;
+    rx_request = request;
+    request->onDisconnect([request]() {
+        if (rx_request != request) return;
+        strip_slot_release(rx_slot);
+        rx_slot = -1;
+        rx_request = nullptr;
+    });
+}
+
+static void stream_set_client(AsyncClient* client) {
+    xSemaphoreTake(stream_client_mutex, portMAX_DELAY);
+    stream_client = client;
+    xSemaphoreGive(stream_client_mutex);
+}
+
+// Stop holding back the window once the decoder no longer drains the body
+// (AsyncTCP task); ack() is capped at what is still unacked
+static void stream_release_window(AsyncWebServerRequest* request) {
+    if (request == stream_request) stream_set_client(nullptr);
+    request->client()->ack(SIZE_MAX);
+}
+
+static void stream_fail(AsyncWebServerRequest* request, int code, const char* resp) {
+    stream_abort = true;
+    stream_release_window(request);
+    stream_responded = true;
+    stream_request = nullptr;
+    stream_drop_request = request;  // the rest of the body is acked and dropped
+    Logger.logEnd();
+    request->send(code, "application/json", resp);
+}
+
+// First chunk of a streaming upload: claim the stream and queue the decode job.
+// Answers the request and returns false if it cannot start.
+static bool stream_begin(AsyncWebServerRequest* request, unsigned long timeout_ms, ImageFormat format, uint8_t scale) {
+    if (stream_request || (stream_job_queued && !stream_done)) {
+        Logger.logEnd("ERROR: Stream decode already in progress");
+        request->send(409, "application/json", "{\"success\":false,\"message\":\"Stream decode already in progress\"}");
+        return false;
+    }
+    // Never wait for the decode task here (AsyncTCP task); the ready queue keeps
+    // room for the stream job, so this only trips before the pipeline exists
+    if (!strip_ready_q || uxQueueSpacesAvailable(strip_ready_q) == 0) {
+        Logger.logEnd("Strip queue full (503)");
+        send_strip_queue_full(request);
+        return false;
+    }
+    if (!stream_sb) {
+        // Everything the TCP window lets in is held until drained, so the buffer
+        // must fit a full window
+        size_t sb_bytes = g_cfg.stream_buffer_bytes;
+#ifdef CONFIG_LWIP_TCP_WND_DEFAULT
+        if (sb_bytes < CONFIG_LWIP_TCP_WND_DEFAULT) sb_bytes = CONFIG_LWIP_TCP_WND_DEFAULT;
+#endif
+        stream_sb = xStreamBufferCreate(sb_bytes, 1);
+        if (!stream_sb) {
+            Logger.logEnd("ERROR: No memory for stream buffer");
+            request->send(507, "application/json", "{\"success\":false,\"message\":\"Out of memory\"}");
+            return false;
+        }
+    }
+
+    // Buffered uploads are drawn by the main loop, not the decode task; claiming
+    // the job under the same lock as its idle check keeps the two from drawing at once
+    portENTER_CRITICAL(&strip_session_mux);
+    const bool loop_drawing = buffered_decode_active;
+    if (!loop_drawing) {
+        stream_done = false;
+        stream_job_queued = true;
+    }
+    portEXIT_CRITICAL(&strip_session_mux);
+    if (loop_drawing) {
+        Logger.logEnd("Image decode in progress (503)");
+        send_busy(request, "{\"success\":false,\"busy\":true,\"message\":\"Image decode in progress, retry\"}");
+        return false;
+    }
+
+    xStreamBufferReset(stream_sb);
+
+    stream_request = request;
+    stream_drop_request = nullptr;
+    stream_responded = false;
+    stream_received = 0;
+    stream_timeout_ms = timeout_ms;
+    stream_start_time = millis();
+    stream_eof = false;
+    stream_abort = false;
+    stream_ok = false;
+    stream_format = format;
+    stream_scale = scale;
+    stream_cache = parse_cache_request(request);
+    stream_cache.capture &= (format == IMAGE_FORMAT_JPEG);  // capture taps the JPEG decoder
+    stream_hash = IMAGE_CACHE_HASH_SEED;
+
+    const int job = STRIP_JOB_STREAM;
+    if (xQueueSend(strip_ready_q, &job, 0) != pdTRUE) {
+        stream_request = nullptr;
+        stream_job_queued = false;
+        Logger.logEnd("Strip queue full (503)");
+        send_strip_queue_full(request);
+        return false;
+    }
+    stream_set_client(request->client());
+
+    // Client went away mid-body: unblock the decoder and free the stream
+    request->onDisconnect([request]() {
+        if (stream_request == request) {
+            stream_set_client(nullptr);
+            stream_abort = true;
+            stream_request = nullptr;
+        }
+        if (stream_drop_request == request) stream_drop_request = nullptr;
+    });
+    return true;
+}
+
+// Push a body chunk to the decoder without waiting (AsyncTCP task). The chunk
+// stays unacked until the decoder drains it, which throttles the TCP receive
+// window to the decode rate and keeps the buffer from filling up.
+static bool stream_push(AsyncWebServerRequest* request, const uint8_t* data, size_t len) {
+    if (stream_done) {
+        // Decoder finished (EOI or error); drop the rest
+        stream_release_window(request);
+        return true;
+    }
+    request->client()->ackLater();
+    return xStreamBufferSend(stream_sb, data, len, 0) == len;
+}
+
+static void handleImageStreamChunk(AsyncWebServerRequest* request, size_t index, uint8_t* data, size_t len, bool final) {
+    if (request != stream_request || stream_responded) {
+        return;
+    }
+
+    if (index == 0 && len > 0 && stream_format == IMAGE_FORMAT_JPEG) {
+        if (!is_jpeg_magic(data, len)) {
+            stream_fail(request, 400, "{\"success\":false,\"message\":\"Invalid JPEG file\"}");
+            return;
+        }
+
+        // Preflight is only conclusive if the SOF segment is in the first chunk
+        char preflight_err[160];
+        if (jpeg_preflight_has_sof(data, len) &&
+            !jpeg_preflight_tjpgd_supported(data, len, g_cfg.lcd_width, g_cfg.lcd_height,
+                                            preflight_err, sizeof(preflight_err), stream_scale)) {
+            Logger.logLinef("ERROR: JPEG preflight failed: %s", preflight_err);
+            char resp[256];
+            snprintf(resp, sizeof(resp), "{\"success\":false,\"message\":\"%s\"}", preflight_err);
+            stream_fail(request, 400, resp);
+            return;
+        }
+    }
+
+    if (len > 0) {
+        if (!stream_push(request, data, len)) {
+            stream_fail(request, 500, "{\"success\":false,\"message\":\"Decoder stalled\"}");
+            return;
+        }
+        stream_received += len;
+        if (stream_cache.capture) {
+            stream_hash = image_cache_hash(data, len, stream_hash);
+        }
+    }
+
+    if (!final) {
+        return;
+    }
+
+    // The whole body is in: the decoder has nothing left to wait for
+    stream_eof = true;
+    stream_release_window(request);
+    stream_responded = true;
+    stream_request = nullptr;
+    Logger.logLinef("Streamed %u bytes", (unsigned)stream_received);
+    Logger.logEnd();
+
+    // Answer once the decoder has consumed the tail and finished
+    const unsigned long since = millis();
+    const uint32_t cache_id = stream_cache.client_id ? stream_cache.id : stream_hash;
+    send_deferred(request, [since, cache_id](int* code, char* body, size_t body_size) -> bool {
+        if (!stream_done) {
+            if ((millis() - since) < g_cfg.strip_drain_timeout_ms) return false;
+            stream_abort = true;
+            Logger.logMessage("Image Stream", "ERROR: Decode timeout");
+            *code = 500;
+            snprintf(body, body_size, "{\"success\":false,\"message\":\"Decode timeout\"}");
+            return true;
+        }
+        if (!stream_ok) {
+            Logger.logMessage("Image Stream", "ERROR: Stream decode failed");
+            *code = 500;
+            snprintf(body, body_size, "{\"success\":false,\"message\":\"Decode failed\"}");
+            return true;
+        }
+
+        // Decode is done, so the captured frame is complete; its hash covers the whole body
+        char cache_field[32] = "";
+        if (stream_cache.capture && g_backend.cache_end(cache_id, true)) {
+            snprintf(cache_field, sizeof(cache_field), ",\"cache_id\":\"%08lx\"", (unsigned long)cache_id);
+        }
+        Logger.logMessage("Image Stream", "Image displayed");
+        snprintf(body, body_size,
+                 "{\"success\":true,\"message\":\"Image displayed (%lus timeout)\",\"streamed\":true%s}",
+                 (unsigned long)(stream_timeout_ms / 1000), cache_field);
+        return true;
+    });
+}
+
+// POST /api/display/image[?format=rgb565|rle565][?scale=2|4|8] - Upload and display
+// JPEG image (deferred decode); raw formats always stream straight to the panel.
+// With scale the JPEG is scale-times the panel size and decoded downscaled.
 static void handleImageUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
     (void)filename;
+    count_upload(IMAGE_UPLOAD_FULL, index, len);
+    if (index == 0 && reject_while_paused(request)) return;
+
+    if (index > 0 && request == stream_request) {
+        handleImageStreamChunk(request, index, data, len, final);
+        return;
+    }
+    if (index > 0 && request == stream_drop_request) {
+        stream_release_window(request);
+        if (final) stream_drop_request = nullptr;
+        return;
+    }
 
     // First chunk - initialize upload
     if (index == 0) {
@@ -81,53 +839,90 @@ static void handleImageUpload(AsyncWebServerRequest *request, String filename, s
             Logger.logMessage("Upload", "Previous upload completed, proceeding");
         }
 
+        ImageFormat format;
+        if (!parse_image_format(request, &format)) {
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Unsupported format\"}");
+            return;
+        }
+        uint8_t scale;
+        if (!parse_scale(request, &scale) || (scale && format != IMAGE_FORMAT_JPEG)) {
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Unsupported scale (1, 2, 4 or 8, JPEG only)\"}");
+            return;
+        }
+
         Logger.logBegin("Image Upload");
         Logger.logLinef("Total size: %u bytes", request->contentLength());
 
         image_upload_timeout_ms = parse_timeout_ms(request);
         Logger.logLinef("Timeout: %lu ms", image_upload_timeout_ms);
+        image_upload_cache = parse_cache_request(request);
+        image_upload_scale = scale;
+        if (scale) {
+            Logger.logLinef("Scale: 1/%d", 1 << scale);
+        }
 
         Logger.logLinef("Free heap before clear: %u bytes", ESP.getFreeHeap());
 
         // Free any pending image buffer to make room for new upload
         if (pending_image_op.buffer) {
             Logger.logMessage("Upload", "Freeing pending image buffer");
-            free((void*)pending_image_op.buffer);
+            image_arena_free(pending_image_op.buffer);
             pending_image_op.buffer = nullptr;
             pending_image_op.size = 0;
         }
 
-        // Hide current image (backend decides what this means)
-        if (g_backend.hide_current_image) {
-            g_backend.hide_current_image();
-        }
+        // The current image is hidden by the task that draws the new one (decode
+        // task for streams, main loop for buffered uploads): hiding takes the
+        // display lock, which a running decode can hold for a long time
 
         Logger.logLinef("Free heap after clear: %u bytes", ESP.getFreeHeap());
 
-        // Check file size
         size_t total_size = request->contentLength();
+
+        // Stream straight into the decoder when asked to, or when the file cannot
+        // be buffered whole (too large for the upload limit or for free heap)
+        if (g_backend.decode_stream || format != IMAGE_FORMAT_JPEG) {
+            bool want_stream = (format != IMAGE_FORMAT_JPEG);
+            if (!want_stream && request->hasParam("stream")) {
+                want_stream = request->getParam("stream")->value() == "1";
+            }
+            if (!want_stream && (total_size > g_cfg.max_image_size_bytes || upload_buffer_space() < total_size)) {
+                Logger.logMessage("Upload", "Image cannot be buffered, streaming instead");
+                want_stream = true;
+            }
+
+            if (want_stream) {
+                if (!stream_begin(request, image_upload_timeout_ms, format, scale)) {
+                    return;
+                }
+                handleImageStreamChunk(request, index, data, len, final);
+                return;
+            }
+        }
+
+        // Check file size
         if (total_size > g_cfg.max_image_size_bytes) {
             Logger.logEnd("ERROR: Image too large");
             request->send(400, "application/json", "{\"success\":false,\"message\":\"Image too large\"}");
             return;
         }
 
-        // Check available memory (upload size + decode headroom)
-        size_t free_heap = ESP.getFreeHeap();
-        size_t required_heap = total_size + g_cfg.decode_headroom_bytes;
-        if (free_heap < required_heap) {
-            Logger.logLinef("ERROR: Insufficient memory (need %u, have %u)", required_heap, free_heap);
+        // Check available memory (upload buffer from the arena or PSRAM/heap,
+        // decode headroom always from internal heap)
+        size_t available = upload_buffer_space();
+        if (available < total_size) {
+            Logger.logLinef("ERROR: Insufficient memory (need %u, have %u)", total_size, available);
             char error_msg[192];
             snprintf(error_msg, sizeof(error_msg),
                      "{\"success\":false,\"message\":\"Insufficient memory: need %uKB, have %uKB. Try reducing image size.\"}",
-                     (unsigned)(required_heap / 1024), (unsigned)(free_heap / 1024));
+                     (unsigned)(total_size / 1024), (unsigned)(available / 1024));
             Logger.logEnd();
             request->send(507, "application/json", error_msg);
             return;
         }
 
         // Allocate buffer
-        image_upload_buffer = (uint8_t*)malloc(total_size);
+        image_upload_buffer = upload_buffer_alloc(total_size);
         if (!image_upload_buffer) {
             Logger.logEnd("ERROR: Memory allocation failed");
             request->send(507, "application/json", "{\"success\":false,\"message\":\"Memory allocation failed\"}");
@@ -161,7 +956,7 @@ static void handleImageUpload(AsyncWebServerRequest *request, String filename, s
                                 image_upload_buffer[0], image_upload_buffer[1],
                                 image_upload_buffer[2], image_upload_buffer[3]);
                 Logger.logEnd("ERROR: Not a valid JPEG file");
-                free(image_upload_buffer);
+                image_arena_free(image_upload_buffer);
                 image_upload_buffer = nullptr;
                 image_upload_size = 0;
                 upload_state = UPLOAD_IDLE;
@@ -177,10 +972,11 @@ static void handleImageUpload(AsyncWebServerRequest *request, String filename, s
                     g_cfg.lcd_width,
                     g_cfg.lcd_height,
                     preflight_err,
-                    sizeof(preflight_err))) {
+                    sizeof(preflight_err),
+                    image_upload_scale)) {
                 Logger.logLinef("ERROR: JPEG preflight failed: %s", preflight_err);
                 Logger.logEnd();
-                free(image_upload_buffer);
+                image_arena_free(image_upload_buffer);
                 image_upload_buffer = nullptr;
                 image_upload_size = 0;
                 upload_state = UPLOAD_IDLE;
@@ -194,7 +990,7 @@ static void handleImageUpload(AsyncWebServerRequest *request, String filename, s
             // Queue image for display by main loop (deferred operation)
             if (pending_image_op.buffer) {
                 Logger.logMessage("Upload", "Replacing pending image");
-                free((void*)pending_image_op.buffer);
+                image_arena_free(pending_image_op.buffer);
             }
 
             pending_image_op.buffer = image_upload_buffer;
@@ -202,6 +998,12 @@ static void handleImageUpload(AsyncWebServerRequest *request, String filename, s
             pending_image_op.dismiss = false;
             pending_image_op.timeout_ms = image_upload_timeout_ms;
             pending_image_op.start_time = millis();
+            pending_image_op.show_cached = false;
+            pending_image_op.scale = image_upload_scale;
+            pending_image_op.cache = image_upload_cache;
+            if (image_upload_cache.capture && !image_upload_cache.client_id) {
+                pending_image_op.cache.id = image_cache_hash(image_upload_buffer, image_upload_size);
+            }
             pending_op_id++;
             upload_state = UPLOAD_READY_TO_DISPLAY;
 
@@ -211,10 +1013,16 @@ static void handleImageUpload(AsyncWebServerRequest *request, String filename, s
 
             Logger.logEnd("Image queued for display");
 
-            char response_msg[160];
+            char cache_field[32] = "";
+            if (pending_image_op.cache.capture) {
+                snprintf(cache_field, sizeof(cache_field), ",\"cache_id\":\"%08lx\"",
+                         (unsigned long)pending_image_op.cache.id);
+            }
+
+            char response_msg[192];
             snprintf(response_msg, sizeof(response_msg),
-                     "{\"success\":true,\"message\":\"Image queued for display (%lus timeout)\"}",
-                     (unsigned long)(image_upload_timeout_ms / 1000));
+                     "{\"success\":true,\"message\":\"Image queued for display (%lus timeout)\"%s}",
+                     (unsigned long)(image_upload_timeout_ms / 1000), cache_field);
             request->send(200, "application/json", response_msg);
         } else {
             Logger.logEnd("ERROR: No data received");
@@ -229,20 +1037,169 @@ static void handleImageDelete(AsyncWebServerRequest *request) {
     Logger.logMessage("Portal", "Image dismiss requested");
 
     if (pending_image_op.buffer) {
-        free((void*)pending_image_op.buffer);
+        image_arena_free(pending_image_op.buffer);
     }
     pending_image_op.buffer = nullptr;
     pending_image_op.size = 0;
     pending_image_op.dismiss = true;
+    pending_image_op.show_cached = false;
     upload_state = UPLOAD_READY_TO_DISPLAY;
     pending_op_id++;
 
     request->send(200, "application/json", "{\"success\":true,\"message\":\"Image dismiss queued\"}");
 }
 
-// POST /api/display/image/strips?strip_index=N&strip_count=T&width=W&height=H[&timeout=seconds]
-// Upload a single JPEG strip (stateless/atomic); decode is synchronous.
+// ===== Image cache =====
+
+static bool parse_cache_id(AsyncWebServerRequest* request, uint32_t* id) {
+    if (!request->hasParam("id")) return false;
+    const String value = request->getParam("id")->value();
+    char* end = nullptr;
+    *id = (uint32_t)strtoul(value.c_str(), &end, 16);
+    return value.length() > 0 && end && *end == '\0';
+}
+
+// GET /api/display/image/cache - List cached frames
+static void handleImageCacheList(AsyncWebServerRequest *request) {
+    ImageCacheStats stats;
+    image_cache_get_stats(&stats);
+
+    ImageCacheInfo infos[IMAGE_CACHE_MAX_ENTRIES];
+    const size_t count = image_cache_list(infos, IMAGE_CACHE_MAX_ENTRIES);
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"success\":true,\"storage\":\"%s\",\"used_bytes\":%u,\"capacity_bytes\":%u,\"entries\":[",
+                     image_cache_storage_name(stats.storage), (unsigned)stats.used_bytes, (unsigned)stats.capacity_bytes);
+    for (size_t i = 0; i < count; i++) {
+        response->printf("%s{\"id\":\"%08lx\",\"width\":%u,\"height\":%u,\"bytes\":%u,\"hits\":%u}",
+                         i ? "," : "", (unsigned long)infos[i].id, (unsigned)infos[i].width,
+                         (unsigned)infos[i].height, (unsigned)infos[i].bytes, (unsigned)infos[i].hits);
+    }
+    response->print("]}");
+    request->send(response);
+}
+
+// POST /api/display/image/cache/show?id=<hex>[&timeout=seconds] - Blit a cached frame
+static void handleImageCacheShow(AsyncWebServerRequest *request) {
+    uint32_t id = 0;
+    if (!parse_cache_id(request, &id)) {
+        request->send(400, "application/json", "{\"success\":false,\"message\":\"Missing or invalid id\"}");
+        return;
+    }
+    if (!image_cache_contains(id)) {
+        request->send(404, "application/json", "{\"success\":false,\"message\":\"Image not cached\"}");
+        return;
+    }
+
+    const unsigned long timeout_ms = parse_timeout_ms(request);
+    Logger.logMessagef("Portal", "Show cached image %08lx (%lu ms)", (unsigned long)id, timeout_ms);
+
+    // Deferred like uploads: the main loop owns screen switches
+    if (pending_image_op.buffer) {
+        image_arena_free(pending_image_op.buffer);
+        pending_image_op.buffer = nullptr;
+        pending_image_op.size = 0;
+    }
+    pending_image_op.dismiss = false;
+    pending_image_op.show_cached = true;
+    pending_image_op.cached_id = id;
+    pending_image_op.timeout_ms = timeout_ms;
+    pending_image_op.start_time = millis();
+    upload_state = UPLOAD_READY_TO_DISPLAY;
+    pending_op_id++;
+
+    char response[128];
+    snprintf(response, sizeof(response),
+             "{\"success\":true,\"message\":\"Cached image queued for display (%lus timeout)\"}",
+             timeout_ms / 1000);
+    request->send(200, "application/json", response);
+}
+
+// DELETE /api/display/image/cache[?id=<hex>] - Drop one frame, or all without id
+static void handleImageCacheDelete(AsyncWebServerRequest *request) {
+    if (!request->hasParam("id")) {
+        image_cache_clear();
+        request->send(200, "application/json", "{\"success\":true,\"message\":\"Image cache cleared\"}");
+        return;
+    }
+
+    uint32_t id = 0;
+    if (!parse_cache_id(request, &id)) {
+        request->send(400, "application/json", "{\"success\":false,\"message\":\"Invalid id\"}");
+        return;
+    }
+    if (!image_cache_remove(id)) {
+        request->send(404, "application/json", "{\"success\":false,\"message\":\"Image not cached\"}");
+        return;
+    }
+    request->send(200, "application/json", "{\"success\":true,\"message\":\"Cached image removed\"}");
+}
+
+// Magic + best-effort header preflight for a fully received slot.
+// On failure fills resp with the JSON error body (HTTP 400).
+static bool strip_slot_check(int slot_idx, int image_width, int image_height, char* resp, size_t resp_size) {
+    const StripSlot& slot = strip_slots[slot_idx];
+
+    if (!is_jpeg_magic(slot.data, slot.size)) {
+        Logger.logLinef("ERROR: Invalid JPEG header (strip %d)", slot.strip_index);
+        snprintf(resp, resp_size, "{\"success\":false,\"message\":\"Invalid JPEG data\"}");
+        return false;
+    }
+
+    char preflight_err[160];
+    const int remaining_height = image_height;
+    if (!jpeg_preflight_tjpgd_fragment_supported(
+            slot.data,
+            slot.size,
+            image_width,
+            remaining_height,
+            g_cfg.lcd_height,
+            preflight_err,
+            sizeof(preflight_err),
+            slot.scale)) {
+        Logger.logLinef("ERROR: JPEG fragment preflight failed (strip %d): %s", slot.strip_index, preflight_err);
+        snprintf(resp, resp_size, "{\"success\":false,\"message\":\"%s\"}", preflight_err);
+        return false;
+    }
+
+    return true;
+}
+
+// Hand a validated slot to the decode task
+static void strip_slot_submit(int slot_idx) {
+    xQueueSend(strip_ready_q, &slot_idx, 0);
+}
+
+// Strip 0 of a new picture: next session generation (upload handlers and
+// image_api_submit_strip() run on different tasks)
+static uint32_t strip_session_open(uint8_t scale) {
+    portENTER_CRITICAL(&strip_session_mux);
+    const uint32_t gen = ++strip_session_gen;
+    strip_session_scale = scale;
+    portEXIT_CRITICAL(&strip_session_mux);
+    return gen;
+}
+
+// A session's final result for a deferred reply: false while its last strip is
+// still queued or decoding (for at most strip_drain_timeout_ms from since)
+static bool strip_session_result(uint32_t gen, unsigned long since, bool* ok) {
+    if (strip_last_done_gen != gen && (millis() - since) < g_cfg.strip_drain_timeout_ms) {
+        return false;
+    }
+    *ok = (strip_last_done_gen == gen) && (strip_failed_gen != gen);
+    return true;
+}
+
+
+// POST /api/display/image/strips?strip_index=N&strip_count=T&width=W&height=H[&timeout=seconds][&scale=2|4|8]
+// Upload a single JPEG strip (stateless/atomic). The strip is validated and queued
+// for the decode task; the response goes out without waiting for decode, except
+// for the last strip, which waits for the pipeline to drain and reports the result.
+// Ring full -> 503 + Retry-After (client retries the same strip).
 static void handleStripUpload(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    count_upload(IMAGE_UPLOAD_STRIP, index, len);
+    if (index == 0 && reject_while_paused(request)) return;
+
     // Validate required params
     if (index == 0) {
         const bool has_required =
@@ -289,110 +1246,780 @@ static void handleStripUpload(AsyncWebServerRequest *request, uint8_t *data, siz
             return;
         }
 
-        // Initialize display session on first strip
-        if (stripIndex == 0) {
-            if (!g_backend.start_strip_session || !g_backend.start_strip_session(imageWidth, imageHeight, timeoutMs, millis())) {
-                Logger.logEnd("ERROR: Failed to initialize display");
-                request->send(500, "application/json", "{\"success\":false,\"message\":\"Failed to initialize display\"}");
-                return;
-            }
+        // The decoder is set up by strip 0, so every strip must use its scale
+        uint8_t scale;
+        if (!parse_scale(request, &scale) || (stripIndex > 0 && scale != strip_session_scale)) {
+            Logger.logEnd("ERROR: Invalid scale");
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Invalid scale (1, 2, 4 or 8, same for all strips)\"}");
+            return;
+        }
+
+        // A failed decode poisons the rest of its session; strip 0 starts a new one
+        if (stripIndex > 0 && strip_failed_gen == strip_session_gen) {
+            Logger.logEnd("ERROR: Session already failed");
+            request->send(500, "application/json", "{\"success\":false,\"message\":\"Decode failed\"}");
+            return;
+        }
+
+        if (total == 0 || total > g_cfg.max_strip_size_bytes) {
+            Logger.logEnd("ERROR: Strip too large");
+            request->send(413, "application/json", "{\"success\":false,\"message\":\"Strip too large\"}");
+            return;
+        }
+
+        if (rx_slot >= 0) {
+            Logger.logEnd("Receive slot busy (503)");
+            send_rx_busy(request);
+            return;
         }
 
-        if (current_strip_buffer) {
-            free((void*)current_strip_buffer);
-            current_strip_buffer = nullptr;
+        int slot = -1;
+        if (!strip_free_q || xQueueReceive(strip_free_q, &slot, 0) != pdTRUE) {
+            Logger.logEnd("Strip queue full (503)");
+            send_strip_queue_full(request);
+            return;
         }
 
-        current_strip_buffer = (uint8_t*)malloc(total);
-        if (!current_strip_buffer) {
+        if (!strip_slot_reserve(slot, total)) {
+            strip_slot_release(slot);
             Logger.logLinef("ERROR: Out of memory (requested %u bytes, free heap: %u)", (unsigned)total, ESP.getFreeHeap());
             Logger.logEnd();
             request->send(507, "application/json", "{\"success\":false,\"message\":\"Out of memory\"}");
             return;
         }
 
-        current_strip_size = 0;
+        StripSlot& s = strip_slots[slot];
+        s.tile = false;
+        s.format = IMAGE_FORMAT_JPEG;
+        s.strip_index = stripIndex;
+        s.strip_count = totalStrips;
+        s.width = imageWidth;
+        s.height = imageHeight;
+        s.timeout_ms = timeoutMs;
+        s.start_time = millis();
+        s.session_gen = (stripIndex == 0) ? strip_session_open(scale) : strip_session_gen;
+        s.scale = scale;
+        s.cache = parse_cache_request(request);
+
+        rx_begin(request, slot);
+    }
+
+    // Chunks of a request that was already answered (error/503) are ignored
+    if (rx_slot < 0 || rx_request != request) {
+        return;
     }
 
-    if (current_strip_buffer && current_strip_size + len <= total) {
-        memcpy((uint8_t*)current_strip_buffer + current_strip_size, data, len);
-        current_strip_size += len;
+    StripSlot& slot = strip_slots[rx_slot];
+    if (slot.size + len <= total) {
+        memcpy(slot.data + slot.size, data, len);
+        slot.size += len;
     }
 
-    // Final chunk: decode synchronously before returning
+    // Final chunk: validate and hand the slot to the decode task
     if (index + len >= total) {
+        const int slot_idx = rx_slot;
+        rx_slot = -1;
+        rx_request = nullptr;
+
         Logger.logLinef("Strip %d complete: %u bytes received (expected %u)",
-                        stripIndex, (unsigned)current_strip_size, (unsigned)total);
+                        stripIndex, (unsigned)slot.size, (unsigned)total);
 
-        if (current_strip_size != total) {
-            Logger.logLinef("ERROR: Size mismatch! Received %u, expected %u", (unsigned)current_strip_size, (unsigned)total);
-            free((void*)current_strip_buffer);
-            current_strip_buffer = nullptr;
+        if (slot.size != total) {
+            Logger.logLinef("ERROR: Size mismatch! Received %u, expected %u", (unsigned)slot.size, (unsigned)total);
+            strip_slot_release(slot_idx);
             Logger.logEnd();
             request->send(500, "application/json", "{\"success\":false,\"message\":\"Incomplete upload\"}");
             return;
         }
 
-        if (!is_jpeg_magic(current_strip_buffer, current_strip_size)) {
-            Logger.logLinef("ERROR: Invalid JPEG header");
-            free((void*)current_strip_buffer);
-            current_strip_buffer = nullptr;
+        char resp[256];
+        if (!strip_slot_check(slot_idx, imageWidth, imageHeight, resp, sizeof(resp))) {
+            strip_slot_release(slot_idx);
             Logger.logEnd();
-            request->send(400, "application/json", "{\"success\":false,\"message\":\"Invalid JPEG data\"}");
+            request->send(400, "application/json", resp);
             return;
         }
 
-        // Best-effort header preflight
-        char preflight_err[160];
-        const int remaining_height = imageHeight;
-        if (!jpeg_preflight_tjpgd_fragment_supported(
-                current_strip_buffer,
-                current_strip_size,
-                imageWidth,
-                remaining_height,
-                g_cfg.lcd_height,
-                preflight_err,
-                sizeof(preflight_err))) {
-            Logger.logLinef("ERROR: JPEG fragment preflight failed: %s", preflight_err);
-            free((void*)current_strip_buffer);
-            current_strip_buffer = nullptr;
-            Logger.logEnd();
+        const bool is_last = (stripIndex == totalStrips - 1);
+        const uint32_t gen = slot.session_gen;
+        strip_slot_submit(slot_idx);
 
-            char resp[256];
-            snprintf(resp, sizeof(resp), "{\"success\":false,\"message\":\"%s\"}", preflight_err);
-            request->send(400, "application/json", resp);
+        if (!is_last) {
+            if (strip_failed_gen == gen) {
+                Logger.logLinef("ERROR: Failed to decode strip %d", stripIndex);
+                Logger.logEnd();
+                request->send(500, "application/json", "{\"success\":false,\"message\":\"Decode failed\"}");
+                return;
+            }
+            Logger.logEnd();
+
+            char response[128];
+            snprintf(response, sizeof(response),
+                     "{\"success\":true,\"strip_index\":%d,\"strip_count\":%d,\"complete\":false}",
+                     stripIndex, totalStrips);
+            request->send(200, "application/json", response);
             return;
         }
 
-        bool success = false;
-        if (g_backend.decode_strip) {
-            success = g_backend.decode_strip(current_strip_buffer, current_strip_size, (uint8_t)stripIndex, false);
+        // The last strip reports the whole image once the ring has drained; the
+        // reply is polled from AsyncTCP so this task never waits for the decoder
+        Logger.logEnd();
+        const unsigned long since = millis();
+        send_deferred(request, [gen, totalStrips, since](int* code, char* body, size_t body_size) -> bool {
+            bool ok;
+            if (!strip_session_result(gen, since, &ok)) return false;
+            if (!ok) {
+                Logger.logMessagef("Strip Upload", "ERROR: Failed to decode strip %d", totalStrips - 1);
+                *code = 500;
+                snprintf(body, body_size, "{\"success\":false,\"message\":\"Decode failed\"}");
+                return true;
+            }
+            Logger.logMessagef("Strip Upload", "✓ All %d strips uploaded and decoded", totalStrips);
+            char cache_field[32] = "";
+            if (strip_cached_gen == gen) {
+                snprintf(cache_field, sizeof(cache_field), ",\"cache_id\":\"%08lx\"", (unsigned long)strip_cached_id);
+            }
+            snprintf(body, body_size,
+                     "{\"success\":true,\"strip_index\":%d,\"strip_count\":%d,\"complete\":true%s}",
+                     totalStrips - 1, totalStrips, cache_field);
+            return true;
+        });
+    }
+}
+
+// For a deferred reply: true once the decode task has finished the tile with
+// sequence number seq (tiles finish in order, so later ones count too)
+static bool tile_done(uint32_t seq) {
+    return (int32_t)(tile_done_seq - seq) >= 0;
+}
+
+// POST /api/display/image/tile?x=X&y=Y[&timeout=seconds][&format=rgb565|rle565&width=W&height=H]
+// Partial update: the body is a small baseline JPEG (or raw pixels of the given
+// size) drawn with its top-left corner at (x, y) over the image on screen (strip,
+// stream or cached upload); the rest of the panel is not touched. The tile goes through the strip decode task, in order
+// with queued strips, and the response is sent once it has been decoded.
+static void handleTileUpload(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    count_upload(IMAGE_UPLOAD_TILE, index, len);
+    if (index == 0 && reject_while_paused(request)) return;
+
+    if (index == 0) {
+        if (!request->hasParam("x", false) || !request->hasParam("y", false)) {
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Missing required parameters: x, y\"}");
+            return;
         }
 
-        free((void*)current_strip_buffer);
-        current_strip_buffer = nullptr;
-        current_strip_size = 0;
+        const int x = request->getParam("x", false)->value().toInt();
+        const int y = request->getParam("y", false)->value().toInt();
+        if (x < 0 || y < 0 || x >= g_cfg.lcd_width || y >= g_cfg.lcd_height) {
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Tile position outside the display\"}");
+            return;
+        }
+        if (total == 0 || total > g_cfg.max_tile_size_bytes) {
+            request->send(413, "application/json", "{\"success\":false,\"message\":\"Tile too large\"}");
+            return;
+        }
 
-        const bool is_last = (stripIndex == totalStrips - 1);
-        if (!success) {
-            Logger.logLinef("ERROR: Failed to decode strip %d", stripIndex);
-            Logger.logEnd();
-            request->send(500, "application/json", "{\"success\":false,\"message\":\"Decode failed\"}");
+        ImageFormat format;
+        if (!parse_image_format(request, &format)) {
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Unsupported format\"}");
             return;
         }
 
-        if (is_last) {
-            Logger.logLinef("✓ All %d strips uploaded and decoded", totalStrips);
+        // Raw pixels carry no header: the size comes with the request
+        int width = 0;
+        int height = 0;
+        if (format != IMAGE_FORMAT_JPEG) {
+            width = request->hasParam("width", false) ? request->getParam("width", false)->value().toInt() : 0;
+            height = request->hasParam("height", false) ? request->getParam("height", false)->value().toInt() : 0;
+            if (width <= 0 || height <= 0 || x + width > g_cfg.lcd_width || y + height > g_cfg.lcd_height) {
+                request->send(400, "application/json", "{\"success\":false,\"message\":\"Raw tile needs width and height that fit the display\"}");
+                return;
+            }
+            if (format == IMAGE_FORMAT_RGB565 && total != (size_t)width * height * 2) {
+                request->send(400, "application/json", "{\"success\":false,\"message\":\"rgb565 body size does not match width x height\"}");
+                return;
+            }
         }
 
-        Logger.logEnd();
+        if (rx_slot >= 0) {
+            send_rx_busy(request);
+            return;
+        }
+
+        int slot = -1;
+        if (!strip_free_q || xQueueReceive(strip_free_q, &slot, 0) != pdTRUE) {
+            send_strip_queue_full(request);
+            return;
+        }
+        if (!strip_slot_reserve(slot, total)) {
+            strip_slot_release(slot);
+            request->send(507, "application/json", "{\"success\":false,\"message\":\"Out of memory\"}");
+            return;
+        }
+
+        StripSlot& s = strip_slots[slot];
+        s.tile = true;
+        s.x = x;
+        s.y = y;
+        s.format = format;
+        s.strip_index = 0;
+        s.strip_count = 1;
+        s.width = width;
+        s.height = height;
+        s.timeout_ms = parse_timeout_ms(request);
+        s.start_time = millis();
+        s.session_gen = ++tile_seq;
+        s.cache = {};
+        s.frame = 0;
+        s.base_epoch = 0;
+
+        rx_begin(request, slot);
+    }
+
+    if (rx_slot < 0 || rx_request != request) {
+        return;
+    }
+
+    StripSlot& slot = strip_slots[rx_slot];
+    if (slot.size + len <= total) {
+        memcpy(slot.data + slot.size, data, len);
+        slot.size += len;
+    }
 
-        char response[160];
+    if (index + len < total) {
+        return;
+    }
+
+    const int slot_idx = rx_slot;
+    rx_slot = -1;
+    rx_request = nullptr;
+
+    if (slot.size != total) {
+        strip_slot_release(slot_idx);
+        request->send(500, "application/json", "{\"success\":false,\"message\":\"Incomplete upload\"}");
+        return;
+    }
+
+    char preflight_err[160] = "Invalid JPEG data";
+    if (slot.format == IMAGE_FORMAT_JPEG &&
+        (!is_jpeg_magic(slot.data, slot.size) ||
+         !jpeg_preflight_tjpgd_tile_supported(slot.data, slot.size,
+                                              g_cfg.lcd_width - slot.x, g_cfg.lcd_height - slot.y,
+                                              &slot.width, &slot.height,
+                                              preflight_err, sizeof(preflight_err)))) {
+        Logger.logMessagef("Tile Upload", "ERROR: %s", preflight_err);
+        strip_slot_release(slot_idx);
+        char resp[256];
+        snprintf(resp, sizeof(resp), "{\"success\":false,\"message\":\"%s\"}", preflight_err);
+        request->send(400, "application/json", resp);
+        return;
+    }
+
+    const int x = slot.x;
+    const int y = slot.y;
+    const int w = slot.width;
+    const int h = slot.height;
+    const uint32_t seq = slot.session_gen;
+    strip_slot_submit(slot_idx);
+    LOG_DEBUGF(LOG_MODULE_IMAGE, "Tile %dx%d at %d,%d: %u bytes", w, h, x, y, (unsigned)total);
+
+    // Answered from AsyncTCP's polling once the decode task has drawn the tile
+    const unsigned long since = millis();
+    send_deferred(request, [seq, x, y, w, h, since](int* code, char* body, size_t body_size) -> bool {
+        const bool done = tile_done(seq);
+        if (!done && (millis() - since) < g_cfg.strip_drain_timeout_ms) return false;
+        if (!done || tile_failed_seq == seq) {
+            *code = 500;
+            snprintf(body, body_size, "{\"success\":false,\"message\":\"Decode failed\"}");
+            return true;
+        }
+        snprintf(body, body_size, "{\"success\":true,\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}", x, y, w, h);
+        return true;
+    });
+}
+
+// ===== Batched strips =====
+// POST /api/display/image/strips/batch?strip_start=N&strip_count=T&width=W&height=H[&timeout=seconds][&scale=2|4|8]
+// Body: consecutive entries of [uint32 little-endian length][JPEG strip], carrying
+// strips strip_start, strip_start+1, ... Entries are parsed as the body streams in
+// and each completed strip is queued for the decode task right away. When the ring
+// is full the batch stops with 503 and reports how many strips it queued, so the
+// client resends from there (the parser never waits on the AsyncTCP task).
+
+struct BatchRxState {
+    AsyncWebServerRequest* request;
+    bool done;              // response already sent (error); ignore remaining chunks
+    int strip_start;
+    int next_index;
+    int strip_count;
+    int width;
+    int height;
+    unsigned long timeout_ms;
+    unsigned long start_time;
+    uint32_t gen;
+    uint8_t hdr[4];         // length prefix (may straddle body chunks)
+    size_t hdr_len;
+    int slot;               // slot receiving the current entry (-1 = reading prefix)
+    size_t entry_len;
+    CacheRequest cache;
+    uint8_t scale;
+};
+static BatchRxState batch_rx = {};
+
+static void batch_fail(int code, const char* resp) {
+    if (batch_rx.slot >= 0) {
+        strip_slot_release(batch_rx.slot);
+        batch_rx.slot = -1;
+    }
+    batch_rx.done = true;
+    Logger.logEnd();
+    batch_rx.request->send(code, "application/json", resp);
+}
+
+static void handleStripBatchUpload(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    count_upload(IMAGE_UPLOAD_STRIP_BATCH, index, len);
+    if (index == 0 && reject_while_paused(request)) return;
+    const bool final_chunk = (index + len >= total);
+
+    if (index == 0) {
+        // Abandoned batch (client disconnect): return its slot
+        if (batch_rx.slot >= 0) {
+            strip_slot_release(batch_rx.slot);
+        }
+        batch_rx = {};
+        batch_rx.slot = -1;
+
+        if (!request->hasParam("strip_count", false) || !request->hasParam("width", false) ||
+            !request->hasParam("height", false)) {
+            request->send(400, "application/json", "{\"success\":false,\"message\":\"Missing required parameters: strip_count, width, height\"}");
+            return;
+        }
+
+        batch_rx.request = request;
+        batch_rx.strip_start = request->hasParam("strip_start", false)
+            ? request->getParam("strip_start", false)->value().toInt() : 0;
+        batch_rx.next_index = batch_rx.strip_start;
+        batch_rx.strip_count = request->getParam("strip_count", false)->value().toInt();
+        batch_rx.width = request->getParam("width", false)->value().toInt();
+        batch_rx.height = request->getParam("height", false)->value().toInt();
+        batch_rx.timeout_ms = request->hasParam("timeout", false)
+            ? (unsigned long)request->getParam("timeout", false)->value().toInt() * 1000UL
+            : g_cfg.default_timeout_ms;
+        batch_rx.start_time = millis();
+        batch_rx.gen = strip_session_gen;
+        batch_rx.cache = parse_cache_request(request);
+
+        Logger.logBegin("Strip Batch");
+        Logger.logLinef("Strips from %d of %d, body: %u bytes, image: %dx%d",
+                        batch_rx.strip_start, batch_rx.strip_count, (unsigned)total, batch_rx.width, batch_rx.height);
+
+        if (batch_rx.strip_start < 0 || batch_rx.strip_start >= batch_rx.strip_count) {
+            batch_fail(400, "{\"success\":false,\"message\":\"Invalid strip index\"}");
+            return;
+        }
+        if (batch_rx.width <= 0 || batch_rx.height <= 0 || batch_rx.width > g_cfg.lcd_width || batch_rx.height > g_cfg.lcd_height) {
+            batch_fail(400, "{\"success\":false,\"message\":\"Invalid image dimensions\"}");
+            return;
+        }
+        if (!parse_scale(request, &batch_rx.scale) ||
+            (batch_rx.strip_start > 0 && batch_rx.scale != strip_session_scale)) {
+            batch_fail(400, "{\"success\":false,\"message\":\"Invalid scale (1, 2, 4 or 8, same for all strips)\"}");
+            return;
+        }
+        if (batch_rx.strip_start > 0 && strip_failed_gen == strip_session_gen) {
+            batch_fail(500, "{\"success\":false,\"message\":\"Decode failed\"}");
+            return;
+        }
+        if (!strip_free_q) {
+            batch_fail(500, "{\"success\":false,\"message\":\"Strip pipeline not initialized\"}");
+            return;
+        }
+    }
+
+    if (batch_rx.request != request || batch_rx.done) {
+        return;
+    }
+
+    while (len > 0) {
+        if (batch_rx.slot < 0) {
+            // Length prefix
+            const size_t take = (len < 4 - batch_rx.hdr_len) ? len : (4 - batch_rx.hdr_len);
+            memcpy(batch_rx.hdr + batch_rx.hdr_len, data, take);
+            batch_rx.hdr_len += take;
+            data += take;
+            len -= take;
+            if (batch_rx.hdr_len < 4) break;
+
+            batch_rx.hdr_len = 0;
+            batch_rx.entry_len = (size_t)batch_rx.hdr[0] | ((size_t)batch_rx.hdr[1] << 8) |
+                                 ((size_t)batch_rx.hdr[2] << 16) | ((size_t)batch_rx.hdr[3] << 24);
+
+            if (batch_rx.next_index >= batch_rx.strip_count) {
+                batch_fail(400, "{\"success\":false,\"message\":\"More strips than strip_count\"}");
+                return;
+            }
+            if (batch_rx.entry_len == 0 || batch_rx.entry_len > g_cfg.max_strip_size_bytes) {
+                Logger.logLinef("ERROR: Strip %d length %u invalid", batch_rx.next_index, (unsigned)batch_rx.entry_len);
+                batch_fail(400, "{\"success\":false,\"message\":\"Invalid strip length\"}");
+                return;
+            }
+
+            // Ring full: stop here; the client resends from the first strip not queued
+            int slot = -1;
+            if (xQueueReceive(strip_free_q, &slot, 0) != pdTRUE) {
+                const int received = batch_rx.next_index - batch_rx.strip_start;
+                Logger.logLinef("Strip queue full after %d strips (503)", received);
+                batch_rx.done = true;
+                Logger.logEnd();
+                char resp[160];
+                snprintf(resp, sizeof(resp),
+                         "{\"success\":false,\"busy\":true,\"strips_received\":%d,\"message\":\"Strip queue full, retry\"}",
+                         received);
+                send_busy(request, resp);
+                return;
+            }
+            batch_rx.slot = slot;
+            if (!strip_slot_reserve(slot, batch_rx.entry_len)) {
+                Logger.logLinef("ERROR: Out of memory (requested %u bytes, free heap: %u)",
+                                (unsigned)batch_rx.entry_len, ESP.getFreeHeap());
+                batch_fail(507, "{\"success\":false,\"message\":\"Out of memory\"}");
+                return;
+            }
+
+            if (batch_rx.next_index == 0) {
+                batch_rx.gen = strip_session_open(batch_rx.scale);
+            }
+
+            StripSlot& s = strip_slots[slot];
+            s.tile = false;
+            s.format = IMAGE_FORMAT_JPEG;
+            s.strip_index = batch_rx.next_index;
+            s.strip_count = batch_rx.strip_count;
+            s.width = batch_rx.width;
+            s.height = batch_rx.height;
+            s.timeout_ms = batch_rx.timeout_ms;
+            s.start_time = batch_rx.start_time;
+            s.session_gen = batch_rx.gen;
+            s.scale = batch_rx.scale;
+            s.cache = batch_rx.cache;
+            continue;
+        }
+
+        // Entry payload
+        StripSlot& s = strip_slots[batch_rx.slot];
+        const size_t want = batch_rx.entry_len - s.size;
+        const size_t take = (len < want) ? len : want;
+        memcpy(s.data + s.size, data, take);
+        s.size += take;
+        data += take;
+        len -= take;
+        if (s.size < batch_rx.entry_len) break;
+
+        char resp[256];
+        if (!strip_slot_check(batch_rx.slot, batch_rx.width, batch_rx.height, resp, sizeof(resp))) {
+            batch_fail(400, resp);
+            return;
+        }
+        if (strip_failed_gen == batch_rx.gen) {
+            batch_fail(500, "{\"success\":false,\"message\":\"Decode failed\"}");
+            return;
+        }
+
+        strip_slot_submit(batch_rx.slot);
+        batch_rx.slot = -1;
+        batch_rx.next_index++;
+    }
+
+    if (!final_chunk) {
+        return;
+    }
+
+    if (batch_rx.slot >= 0 || batch_rx.hdr_len > 0) {
+        batch_fail(400, "{\"success\":false,\"message\":\"Truncated strip entry\"}");
+        return;
+    }
+
+    const int received = batch_rx.next_index - batch_rx.strip_start;
+    const bool is_last = (batch_rx.next_index == batch_rx.strip_count);
+    batch_rx.done = true;
+
+    if (received == 0 || strip_failed_gen == batch_rx.gen) {
+        Logger.logEnd(received > 0 ? "ERROR: Decode failed" : "ERROR: Empty batch");
+        request->send(received > 0 ? 500 : 400, "application/json",
+                      received > 0 ? "{\"success\":false,\"message\":\"Decode failed\"}"
+                                   : "{\"success\":false,\"message\":\"No strips in batch\"}");
+        return;
+    }
+
+    Logger.logLinef("%d strips queued%s", received, is_last ? ", image complete" : "");
+    Logger.logEnd();
+
+    if (!is_last) {
+        char response[224];
         snprintf(response, sizeof(response),
-                 "{\"success\":true,\"strip_index\":%d,\"strip_count\":%d,\"complete\":%s}",
-                 stripIndex, totalStrips, is_last ? "true" : "false");
+                 "{\"success\":true,\"strip_start\":%d,\"strips_received\":%d,\"strip_count\":%d,\"complete\":false}",
+                 batch_rx.strip_start, received, batch_rx.strip_count);
         request->send(200, "application/json", response);
+        return;
+    }
+
+    // The batch with the last strip reports the whole image once the ring has
+    // drained (polled from AsyncTCP, see handleStripUpload)
+    const uint32_t gen = batch_rx.gen;
+    const int strip_start = batch_rx.strip_start;
+    const int strip_count = batch_rx.strip_count;
+    const unsigned long since = millis();
+    send_deferred(request, [gen, strip_start, received, strip_count, since](int* code, char* body, size_t body_size) -> bool {
+        bool ok;
+        if (!strip_session_result(gen, since, &ok)) return false;
+        if (!ok) {
+            Logger.logMessage("Strip Batch", "ERROR: Decode failed");
+            *code = 500;
+            snprintf(body, body_size, "{\"success\":false,\"message\":\"Decode failed\"}");
+            return true;
+        }
+        char cache_field[32] = "";
+        if (strip_cached_gen == gen) {
+            snprintf(cache_field, sizeof(cache_field), ",\"cache_id\":\"%08lx\"", (unsigned long)strip_cached_id);
+        }
+        snprintf(body, body_size,
+                 "{\"success\":true,\"strip_start\":%d,\"strips_received\":%d,\"strip_count\":%d,\"complete\":true%s}",
+                 strip_start, received, strip_count, cache_field);
+        return true;
+    });
+}
+
+// ===== Delta frames =====
+// POST /api/display/image/delta?seq=N[&base=M][&timeout=seconds]
+// Video-style updates on the direct image screen: each frame carries only the
+// regions that changed since frame base. Body: consecutive entries of
+// [uint16 x][uint16 y][uint32 length] (little-endian) + a JPEG tile. Tiles are
+// parsed as the body streams in and queued for the decode task like /tile; the
+// response (the frame's ack) is sent once every tile is on the panel.
+// Without base the frame is a keyframe and may draw over anything. A delta is
+// only drawn while frame base is still on screen untouched; otherwise the reply
+// is 409 with "resync":true and the client sends a keyframe.
+
+struct DeltaRxState {
+    AsyncWebServerRequest* request;
+    bool done;              // response already sent (error); ignore remaining chunks
+    uint32_t seq;
+    uint32_t frame;         // frame generation, tagged on its tiles
+    uint32_t base_epoch;    // 0 = keyframe
+    unsigned long timeout_ms;
+    unsigned long start_time;
+    uint8_t hdr[8];         // entry header (may straddle body chunks)
+    size_t hdr_len;
+    int slot;               // slot receiving the current tile (-1 = reading header)
+    size_t entry_len;
+    int tiles;
+    uint32_t last_tile_seq;
+};
+static DeltaRxState delta_rx = {};
+static uint32_t delta_frame_gen = 0;
+static uint32_t delta_seq = 0;    // last acknowledged frame
+static uint32_t delta_epoch = 0;  // screen epoch right after it (0 = no usable base)
+
+static void delta_fail(int code, const char* resp) {
+    if (delta_rx.slot >= 0) {
+        strip_slot_release(delta_rx.slot);
+        delta_rx.slot = -1;
     }
+    delta_rx.done = true;
+    if (code == 503) {
+        send_busy(delta_rx.request, resp);
+    } else {
+        delta_rx.request->send(code, "application/json", resp);
+    }
+}
+
+static void delta_fail_resync() {
+    char resp[96];
+    snprintf(resp, sizeof(resp), "{\"success\":false,\"resync\":true,\"seq\":%lu}", (unsigned long)delta_seq);
+    delta_fail(409, resp);
+}
+
+static void handleDeltaFrameUpload(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    count_upload(IMAGE_UPLOAD_DELTA, index, len);
+    if (index == 0 && reject_while_paused(request)) return;
+    const bool final_chunk = (index + len >= total);
+
+    if (index == 0) {
+        // One frame at a time; its ack must not be lost to a concurrent frame
+        if (delta_rx.request && !delta_rx.done) {
+            send_busy(request, "{\"success\":false,\"busy\":true,\"message\":\"Another frame is receiving, retry\"}");
+            return;
+        }
+        delta_rx = {};
+        delta_rx.slot = -1;
+        delta_rx.request = request;
+
+        // Client gone mid-body: return the slot and end the frame
+        request->onDisconnect([request]() {
+            if (delta_rx.request != request || delta_rx.done) return;
+            if (delta_rx.slot >= 0) {
+                strip_slot_release(delta_rx.slot);
+                delta_rx.slot = -1;
+            }
+            delta_rx.done = true;
+        });
+
+        if (!request->hasParam("seq", false)) {
+            delta_fail(400, "{\"success\":false,\"message\":\"Missing required parameter: seq\"}");
+            return;
+        }
+        delta_rx.seq = (uint32_t)strtoul(request->getParam("seq", false)->value().c_str(), nullptr, 10);
+
+        if (request->hasParam("base", false)) {
+            const uint32_t base = (uint32_t)strtoul(request->getParam("base", false)->value().c_str(), nullptr, 10);
+            if (delta_epoch == 0 || base != delta_seq) {
+                delta_fail_resync();
+                return;
+            }
+            delta_rx.base_epoch = delta_epoch;
+        }
+
+        // The picture changes from here on; it is a base again once this frame is acked
+        delta_seq = 0;
+        delta_epoch = 0;
+
+        delta_rx.frame = ++delta_frame_gen;
+        delta_rx.timeout_ms = parse_timeout_ms(request);
+        delta_rx.start_time = millis();
+    }
+
+    if (delta_rx.request != request || delta_rx.done) {
+        return;
+    }
+
+    while (len > 0) {
+        if (delta_rx.slot < 0) {
+            // Entry header
+            const size_t want = sizeof(delta_rx.hdr) - delta_rx.hdr_len;
+            const size_t take = (len < want) ? len : want;
+            memcpy(delta_rx.hdr + delta_rx.hdr_len, data, take);
+            delta_rx.hdr_len += take;
+            data += take;
+            len -= take;
+            if (delta_rx.hdr_len < sizeof(delta_rx.hdr)) break;
+
+            delta_rx.hdr_len = 0;
+            const uint8_t* h = delta_rx.hdr;
+            const int x = h[0] | (h[1] << 8);
+            const int y = h[2] | (h[3] << 8);
+            delta_rx.entry_len = (size_t)h[4] | ((size_t)h[5] << 8) | ((size_t)h[6] << 16) | ((size_t)h[7] << 24);
+
+            if (x >= g_cfg.lcd_width || y >= g_cfg.lcd_height) {
+                delta_fail(400, "{\"success\":false,\"message\":\"Tile position outside the display\"}");
+                return;
+            }
+            if (delta_rx.entry_len == 0 || delta_rx.entry_len > g_cfg.max_tile_size_bytes) {
+                delta_fail(400, "{\"success\":false,\"message\":\"Invalid tile length\"}");
+                return;
+            }
+            if (frame_stale_gen == delta_rx.frame) {
+                delta_fail_resync();
+                return;
+            }
+
+            // Ring full: give the decode task one tile's time to free a slot
+            int slot = -1;
+            if (xQueueReceive(strip_free_q, &slot, pdMS_TO_TICKS(DELTA_SLOT_WAIT_MS)) != pdTRUE) {
+                delta_fail(503, "{\"success\":false,\"busy\":true,\"message\":\"Strip queue full, retry\"}");
+                return;
+            }
+            delta_rx.slot = slot;
+            if (!strip_slot_reserve(slot, delta_rx.entry_len)) {
+                delta_fail(507, "{\"success\":false,\"message\":\"Out of memory\"}");
+                return;
+            }
+
+            StripSlot& s = strip_slots[slot];
+            s.tile = true;
+            s.x = x;
+            s.y = y;
+            s.format = IMAGE_FORMAT_JPEG;
+            s.strip_index = 0;
+            s.strip_count = 1;
+            s.timeout_ms = delta_rx.timeout_ms;
+            s.start_time = delta_rx.start_time;
+            s.session_gen = ++tile_seq;
+            s.cache = {};
+            s.frame = delta_rx.frame;
+            s.base_epoch = delta_rx.base_epoch;
+            continue;
+        }
+
+        // Tile payload
+        StripSlot& s = strip_slots[delta_rx.slot];
+        const size_t want = delta_rx.entry_len - s.size;
+        const size_t take = (len < want) ? len : want;
+        memcpy(s.data + s.size, data, take);
+        s.size += take;
+        data += take;
+        len -= take;
+        if (s.size < delta_rx.entry_len) break;
+
+        char preflight_err[160] = "Invalid JPEG data";
+        if (!is_jpeg_magic(s.data, s.size) ||
+            !jpeg_preflight_tjpgd_tile_supported(s.data, s.size,
+                                                 g_cfg.lcd_width - s.x, g_cfg.lcd_height - s.y,
+                                                 &s.width, &s.height,
+                                                 preflight_err, sizeof(preflight_err))) {
+            Logger.logMessagef("Delta Frame", "ERROR: Tile %d: %s", delta_rx.tiles, preflight_err);
+            char resp[256];
+            snprintf(resp, sizeof(resp), "{\"success\":false,\"message\":\"%s\"}", preflight_err);
+            delta_fail(400, resp);
+            return;
+        }
+
+        delta_rx.last_tile_seq = s.session_gen;
+        xQueueSend(strip_ready_q, &delta_rx.slot, portMAX_DELAY);
+        delta_rx.slot = -1;
+        delta_rx.tiles++;
+    }
+
+    if (!final_chunk) {
+        return;
+    }
+
+    if (delta_rx.slot >= 0 || delta_rx.hdr_len > 0) {
+        delta_fail(400, "{\"success\":false,\"message\":\"Truncated tile entry\"}");
+        return;
+    }
+    if (delta_rx.tiles == 0) {
+        delta_fail(400, "{\"success\":false,\"message\":\"No tiles in frame\"}");
+        return;
+    }
+
+    LOG_DEBUGF(LOG_MODULE_IMAGE, "Delta frame %lu: %d tiles, %u bytes%s",
+               (unsigned long)delta_rx.seq, delta_rx.tiles, (unsigned)total, delta_rx.base_epoch ? "" : " (key)");
+
+    // The ack is polled from AsyncTCP once the last tile is on the panel. The
+    // frame stays in progress until then: the next frame's base check needs
+    // delta_seq, and a frame arriving meanwhile gets 503.
+    const unsigned long since = millis();
+    send_deferred(request, [since](int* code, char* body, size_t body_size) -> bool {
+        const bool done = tile_done(delta_rx.last_tile_seq);
+        if (!done && (millis() - since) < g_cfg.strip_drain_timeout_ms) return false;
+        delta_rx.done = true;
+        if (frame_stale_gen == delta_rx.frame) {
+            *code = 409;
+            snprintf(body, body_size, "{\"success\":false,\"resync\":true,\"seq\":%lu}", (unsigned long)delta_seq);
+            return true;
+        }
+        if (!done || frame_failed_gen == delta_rx.frame) {
+            *code = 500;
+            snprintf(body, body_size, "{\"success\":false,\"message\":\"Decode failed\"}");
+            return true;
+        }
+
+        delta_seq = delta_rx.seq;
+        delta_epoch = frame_done_epoch;
+        snprintf(body, body_size, "{\"success\":true,\"seq\":%lu,\"tiles\":%d}",
+                 (unsigned long)delta_rx.seq, delta_rx.tiles);
+        return true;
+    });
 }
 
 // ===== Public API =====
@@ -400,29 +2027,43 @@ static void handleStripUpload(AsyncWebServerRequest *request, uint8_t *data, siz
 void image_api_init(const ImageApiConfig& cfg, const ImageApiBackend& backend) {
     g_cfg = cfg;
     g_backend = backend;
+    // Tiles share the strip slots
+    g_cfg.max_tile_size_bytes = min(g_cfg.max_tile_size_bytes, g_cfg.max_strip_size_bytes);
 
     image_upload_timeout_ms = g_cfg.default_timeout_ms;
 
     // Best-effort: reset state
     upload_state = UPLOAD_IDLE;
     pending_op_id = 0;
-    pending_image_op = {nullptr, 0, false, g_cfg.default_timeout_ms, 0};
+    pending_image_op = {nullptr, 0, false, g_cfg.default_timeout_ms, 0, {}, false, 0, 0};
 
-    if (current_strip_buffer) {
-        free((void*)current_strip_buffer);
-        current_strip_buffer = nullptr;
-    }
-    current_strip_size = 0;
+    image_arena_init(g_cfg.arena_bytes);
+    strip_pipeline_init();
 
     if (image_upload_buffer) {
-        free((void*)image_upload_buffer);
+        image_arena_free(image_upload_buffer);
         image_upload_buffer = nullptr;
     }
     image_upload_size = 0;
 }
 
 void image_api_register_routes(AsyncWebServer* server) {
-    // Register the more specific /strips endpoint before /image.
+    // Register the more specific endpoints first: a route also matches any
+    // "<route>/..." URL, so /strips would otherwise swallow /strips/batch.
+    if (g_backend.show_cached) {
+        server->on("/api/display/image/cache/show", HTTP_POST, handleImageCacheShow);
+        server->on("/api/display/image/cache", HTTP_GET, handleImageCacheList);
+        server->on("/api/display/image/cache", HTTP_DELETE, handleImageCacheDelete);
+    }
+
+    server->on(
+        "/api/display/image/strips/batch",
+        HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        NULL,
+        handleStripBatchUpload
+    );
+
     server->on(
         "/api/display/image/strips",
         HTTP_POST,
@@ -431,6 +2072,26 @@ void image_api_register_routes(AsyncWebServer* server) {
         handleStripUpload
     );
 
+    if (g_backend.decode_tile && g_backend.screen_epoch) {
+        server->on(
+            "/api/display/image/delta",
+            HTTP_POST,
+            [](AsyncWebServerRequest *request) {},
+            NULL,
+            handleDeltaFrameUpload
+        );
+    }
+
+    if (g_backend.decode_tile) {
+        server->on(
+            "/api/display/image/tile",
+            HTTP_POST,
+            [](AsyncWebServerRequest *request) {},
+            NULL,
+            handleTileUpload
+        );
+    }
+
     server->on(
         "/api/display/image",
         HTTP_POST,
@@ -441,19 +2102,8 @@ void image_api_register_routes(AsyncWebServer* server) {
     server->on("/api/display/image", HTTP_DELETE, handleImageDelete);
 }
 
-void image_api_process_pending(bool ota_in_progress) {
-    static unsigned long last_processed_id = 0;
-
-    if (upload_state != UPLOAD_READY_TO_DISPLAY || ota_in_progress) {
-        return;
-    }
-
-    if (pending_op_id == last_processed_id) {
-        return;
-    }
-
-    last_processed_id = pending_op_id;
-
+// The pending dismiss, cached show or buffered decode (main loop)
+static void process_pending_op() {
     if (pending_image_op.dismiss) {
         if (g_backend.hide_current_image) {
             g_backend.hide_current_image();
@@ -463,21 +2113,46 @@ void image_api_process_pending(bool ota_in_progress) {
         return;
     }
 
+    if (pending_image_op.show_cached) {
+        pending_image_op.show_cached = false;
+        upload_state = UPLOAD_IDLE;
+        if (!g_backend.show_cached ||
+            !g_backend.show_cached(pending_image_op.cached_id, pending_image_op.timeout_ms, pending_image_op.start_time)) {
+            Logger.logMessagef("Portal", "ERROR: Failed to show cached image %08lx", (unsigned long)pending_image_op.cached_id);
+        }
+        return;
+    }
+
     if (pending_image_op.buffer && pending_image_op.size > 0) {
-        const uint8_t* buf = pending_image_op.buffer;
+        uint8_t* buf = pending_image_op.buffer;
         const size_t sz = pending_image_op.size;
 
+        // Deferred from the upload handler
+        if (g_backend.hide_current_image) {
+            g_backend.hide_current_image();
+        }
+
         bool success = false;
         if (g_backend.start_strip_session && g_backend.decode_strip) {
-            if (!g_backend.start_strip_session(g_cfg.lcd_width, g_cfg.lcd_height, pending_image_op.timeout_ms, pending_image_op.start_time)) {
+            if (!g_backend.start_strip_session(g_cfg.lcd_width, g_cfg.lcd_height, pending_image_op.scale,
+                                               pending_image_op.timeout_ms, pending_image_op.start_time)) {
                 Logger.logMessage("Portal", "ERROR: Failed to init direct image screen for JPEG");
                 success = false;
             } else {
-                success = g_backend.decode_strip(buf, sz, 0, false);
+                const CacheRequest& cache = pending_image_op.cache;
+                const bool capture = cache.capture && g_backend.cache_begin();
+                success = g_backend.decode_strip(buf, sz, 0);
+                if (capture) {
+                    g_backend.cache_end(cache.id, success);
+                }
             }
+        } else if (g_backend.show_image) {
+            // Hand the upload buffer over instead of letting the backend copy it
+            pending_image_op.buffer = nullptr;
+            success = g_backend.show_image(buf, sz, pending_image_op.timeout_ms, pending_image_op.start_time);
         }
 
-        free((void*)pending_image_op.buffer);
+        image_arena_free(pending_image_op.buffer);
         pending_image_op.buffer = nullptr;
         pending_image_op.size = 0;
         upload_state = UPLOAD_IDLE;
@@ -491,3 +2166,115 @@ void image_api_process_pending(bool ota_in_progress) {
     // Invalid state
     upload_state = UPLOAD_IDLE;
 }
+
+void image_api_process_pending(bool ota_in_progress) {
+    static unsigned long last_processed_id = 0;
+
+    uploads_paused = ota_in_progress;
+
+    if (upload_state != UPLOAD_READY_TO_DISPLAY || ota_in_progress) {
+        return;
+    }
+
+    if (pending_op_id == last_processed_id) {
+        return;
+    }
+
+    // Let queued strips and streams finish before a full image takes over the
+    // display; a stream starting meanwhile gets 503 (see stream_begin)
+    portENTER_CRITICAL(&strip_session_mux);
+    const bool idle = strip_pipeline_idle();
+    buffered_decode_active = idle;
+    portEXIT_CRITICAL(&strip_session_mux);
+    if (!idle) {
+        return;
+    }
+
+    last_processed_id = pending_op_id;
+    process_pending_op();
+    buffered_decode_active = false;
+}
+
+
+ImageSubmitResult image_api_submit_strip(const ImageStripDesc& desc, const uint8_t* data, size_t size,
+                                         uint32_t* session) {
+    if (uploads_paused || !strip_free_q || !session) return IMAGE_SUBMIT_FAILED;
+
+    if (desc.strip_index < 0 || desc.strip_index >= desc.strip_count || desc.scale > 3 ||
+        desc.width <= 0 || desc.height <= 0 || desc.width > g_cfg.lcd_width || desc.height > g_cfg.lcd_height ||
+        size == 0 || size > g_cfg.max_strip_size_bytes) {
+        return IMAGE_SUBMIT_FAILED;
+    }
+    if (desc.rle) {
+        if (!g_backend.draw_raw || desc.scale || desc.rows <= 0 || desc.y < 0 || desc.y + desc.rows > desc.height) {
+            return IMAGE_SUBMIT_FAILED;
+        }
+    } else {
+        char preflight_err[160];
+        if (!is_jpeg_magic(data, size) ||
+            !jpeg_preflight_tjpgd_fragment_supported(data, size, desc.width, desc.height, g_cfg.lcd_height,
+                                                     preflight_err, sizeof(preflight_err), desc.scale)) {
+            Logger.logMessagef("Strip Pipeline", "ERROR: Submitted strip %d rejected", desc.strip_index);
+            return IMAGE_SUBMIT_FAILED;
+        }
+    }
+
+    // Later strips must continue the caller's session: an HTTP upload that
+    // opened its own in between (or a failed decode) ends it
+    if (desc.strip_index > 0 && (*session == 0 || *session != strip_session_gen || strip_failed_gen == *session)) {
+        return IMAGE_SUBMIT_FAILED;
+    }
+
+    int slot = -1;
+    if (xQueueReceive(strip_free_q, &slot, 0) != pdTRUE) {
+        return IMAGE_SUBMIT_BUSY;
+    }
+    if (!strip_slot_reserve(slot, size)) {
+        strip_slot_release(slot);
+        return IMAGE_SUBMIT_FAILED;
+    }
+    count_upload(IMAGE_UPLOAD_MULTICAST, desc.strip_index == 0 ? 0 : 1, size);
+
+    StripSlot& s = strip_slots[slot];
+    memcpy(s.data, data, size);
+    s.size = size;
+    s.tile = false;
+    s.format = desc.rle ? IMAGE_FORMAT_RLE565 : IMAGE_FORMAT_JPEG;
+    s.strip_index = desc.strip_index;
+    s.strip_count = desc.strip_count;
+    s.width = desc.width;
+    s.height = desc.height;
+    s.y = desc.y;
+    s.rows = desc.rows;
+    s.timeout_ms = desc.timeout_ms;
+    s.start_time = millis();
+    s.scale = desc.scale;
+    s.cache = {};  // the cache taps the JPEG decoder; raw strips would leave holes
+    s.session_gen = (desc.strip_index == 0) ? strip_session_open(desc.scale) : *session;
+    *session = s.session_gen;
+
+    strip_slot_submit(slot);
+    return IMAGE_SUBMIT_OK;
+}
+
+bool image_api_session_done(uint32_t session, bool* ok) {
+    const bool failed = (strip_failed_gen == session);
+    if (ok) *ok = !failed;
+    return failed || strip_last_done_gen == session;
+}
+
+void image_api_get_stats(ImageApiStats* out) {
+    *out = upload_stats;
+}
+
+const char* image_api_upload_kind_name(ImageUploadKind kind) {
+    switch (kind) {
+        case IMAGE_UPLOAD_FULL:        return "image";
+        case IMAGE_UPLOAD_STRIP:       return "strip";
+        case IMAGE_UPLOAD_STRIP_BATCH: return "strip_batch";
+        case IMAGE_UPLOAD_TILE:        return "tile";
+        case IMAGE_UPLOAD_DELTA:       return "delta";
+        case IMAGE_UPLOAD_MULTICAST:   return "multicast";
+        default:                       return "unknown";
+    }
+}
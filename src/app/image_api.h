@@ -5,25 +5,119 @@
 
 class AsyncWebServer;
 
+// Pull-style JPEG source for streaming decode: copy up to len bytes into buf and
+// return the count (0 = end of data / aborted). buf == NULL means skip len bytes.
+typedef size_t (*ImageStreamReadFn)(void* ctx, uint8_t* buf, size_t len);
+
 // Small adapter layer for porting this feature to other projects:
 // provide these hooks to connect the HTTP upload endpoints to your display pipeline.
 struct ImageApiBackend {
-    void (*hide_current_image)();
-    bool (*start_strip_session)(int width, int height, unsigned long timeout_ms, unsigned long start_time);
-    bool (*decode_strip)(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index, bool output_bgr565);
+    void (*hide_current_image)() = nullptr;
+    // width/height: on-screen size; scale: JPEGs of the session are decoded at
+    // 1/2^scale (0..3), so they are width << scale pixels wide
+    bool (*start_strip_session)(int width, int height, uint8_t scale, unsigned long timeout_ms, unsigned long start_time) = nullptr;
+    bool (*decode_strip)(const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index) = nullptr;
+    // Optional, for pipelines without strip hooks: show a whole buffered upload.
+    // Takes ownership of jpeg_data (malloc'd, release with free()) whether or not
+    // it succeeds, so the decoder can read it in place instead of copying it.
+    bool (*show_image)(uint8_t* jpeg_data, size_t jpeg_size, unsigned long timeout_ms, unsigned long start_time) = nullptr;
+    // Optional: decode a full image as it arrives (runs on the decode task after
+    // start_strip_session). nullptr disables streaming uploads.
+    bool (*decode_stream)(ImageStreamReadFn read, void* read_ctx) = nullptr;
+
+    // Optional partial update: decode a small JPEG with its top-left corner at LCD
+    // (x, y), over the current image (runs on the decode task). nullptr disables
+    // /api/display/image/tile.
+    bool (*decode_tile)(const uint8_t* jpeg_data, size_t jpeg_size, int x, int y,
+                        unsigned long timeout_ms, unsigned long start_time) = nullptr;
+
+    // Optional: identifies the picture tiles draw on; must change whenever it is
+    // replaced or leaves the panel (0 = not showing). Called on the decode task.
+    // nullptr disables /api/display/image/delta.
+    uint32_t (*screen_epoch)() = nullptr;
+
+    // Optional: draw pixel data that needs no decode, rgb565 (rle=false) or rle565
+    // (rle=true) of width x height at LCD (x, y), pulled through read(); runs on
+    // the decode task. nullptr disables ?format= uploads.
+    bool (*draw_raw)(bool rle, int x, int y, int width, int height, ImageStreamReadFn read, void* read_ctx,
+                     unsigned long timeout_ms, unsigned long start_time) = nullptr;
+
+    // Optional decoded-frame cache (nullptr disables ?cache= and /image/cache routes).
+    // cache_begin() runs right after start_strip_session() and records what the
+    // session draws; cache_end() stores it under id (commit) or discards it.
+    bool (*cache_begin)() = nullptr;
+    bool (*cache_end)(uint32_t id, bool commit) = nullptr;
+    bool (*show_cached)(uint32_t id, unsigned long timeout_ms, unsigned long start_time) = nullptr;
 };
 
 struct ImageApiConfig {
     int lcd_width = 0;
     int lcd_height = 0;
     size_t max_image_size_bytes = 100 * 1024;
-    size_t decode_headroom_bytes = 50 * 1024;  // extra heap headroom beyond upload size
+    size_t decode_headroom_bytes = 50 * 1024;  // internal heap kept free beyond the upload buffer
     unsigned long default_timeout_ms = 10000;
     unsigned long max_timeout_ms = 86400UL * 1000UL;
+    size_t stream_buffer_bytes = 4096;           // ring between upload handler and streaming decode
+    unsigned long stream_stall_timeout_ms = 3000;  // decode gives up when no data arrives this long
+    size_t max_strip_size_bytes = 32 * 1024;     // size of each strip slot, so the limit for one strip
+    size_t max_tile_size_bytes = 16 * 1024;      // body limit for /api/display/image/tile (at most a slot)
+    size_t strip_queue_depth = 3;                // strip slots buffered ahead of the decode task
+    unsigned long strip_drain_timeout_ms = 5000;  // last strip waits this long for decode to finish
+    size_t arena_bytes = 0;                      // upload/strip buffer arena reserved at init (0 = heap only);
+                                                 // the strip slots are carved from it first and kept
 };
 
 void image_api_init(const ImageApiConfig& cfg, const ImageApiBackend& backend);
 void image_api_register_routes(AsyncWebServer* server);
 
+// Upload counters since boot, per endpoint (updated on the AsyncTCP task and by
+// image_api_submit_strip(); readers may see a sample mid-update)
+enum ImageUploadKind {
+    IMAGE_UPLOAD_FULL = 0,     // POST /api/display/image
+    IMAGE_UPLOAD_STRIP,        // POST /api/display/image/strips
+    IMAGE_UPLOAD_STRIP_BATCH,  // POST /api/display/image/strips/batch
+    IMAGE_UPLOAD_TILE,         // POST /api/display/image/tile
+    IMAGE_UPLOAD_DELTA,        // POST /api/display/image/delta
+    IMAGE_UPLOAD_MULTICAST,    // image_api_submit_strip() (multicast frames, one request per frame)
+    IMAGE_UPLOAD_KIND_COUNT
+};
+
+struct ImageApiStats {
+    uint32_t requests[IMAGE_UPLOAD_KIND_COUNT];
+    uint64_t bytes[IMAGE_UPLOAD_KIND_COUNT];   // body bytes received
+};
+
+void image_api_get_stats(ImageApiStats* out);
+const char* image_api_upload_kind_name(ImageUploadKind kind);  // e.g. "strip_batch"
+
+// Strips from a transport other than HTTP (image_multicast.h), submitted in
+// order from any task but the decode task; validated and queued like
+// POST /api/display/image/strips. *session is written by strip 0 (which opens a
+// new session and shows the direct image screen) and passed back with the
+// frame's later strips; they fail once another upload has opened a session.
+struct ImageStripDesc {
+    int strip_index;
+    int strip_count;
+    int width;                  // picture size; strips are full width
+    int height;
+    uint8_t scale;              // JPEG: decode at 1/2^scale (0..3, same for all strips)
+    bool rle;                   // rle565 band of rows at (0, y) instead of a JPEG strip
+    int y;
+    int rows;
+    unsigned long timeout_ms;
+};
+
+enum ImageSubmitResult {
+    IMAGE_SUBMIT_OK = 0,
+    IMAGE_SUBMIT_BUSY,          // strip ring full, submit the same strip again later
+    IMAGE_SUBMIT_FAILED         // invalid strip, session lost or pipeline paused
+};
+
+ImageSubmitResult image_api_submit_strip(const ImageStripDesc& desc, const uint8_t* data, size_t size,
+                                         uint32_t* session);
+
+// True once a submitted session has finished decoding (ok: every strip drew)
+bool image_api_session_done(uint32_t session, bool* ok);
+
 // Call from the main loop. Keeps /api/display/image deferred behavior.
 void image_api_process_pending(bool ota_in_progress);
@@ -0,0 +1,110 @@
+/*
+ * Image Arena Implementation
+ */
+
+#include "image_arena.h"
+#include "log_manager.h"
+#include "mem_placement.h"
+#include <freertos/FreeRTOS.h>
+
+// Precedes every block; prev links the blocks so the top can walk back
+struct BlockHeader {
+    uint32_t prev;   // offset of the previous block's header, NO_BLOCK for the first
+    uint32_t size;   // header + payload, LIVE_FLAG while allocated
+};
+
+static const uint32_t NO_BLOCK = 0xFFFFFFFFu;
+static const uint32_t LIVE_FLAG = 0x80000000u;
+static const size_t ALIGN = 8;
+
+static uint8_t* base = nullptr;
+static size_t capacity = 0;
+static size_t top = 0;
+static uint32_t last = NO_BLOCK;  // header offset of the block at the top
+static ImageArenaStats stats = {};
+static portMUX_TYPE arena_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline BlockHeader* header_at(uint32_t offset) {
+    return (BlockHeader*)(base + offset);
+}
+
+static inline size_t block_bytes(size_t size) {
+    return sizeof(BlockHeader) + ((size + ALIGN - 1) & ~(ALIGN - 1));
+}
+
+bool image_arena_init(size_t bytes) {
+    if (base || bytes == 0) return base != nullptr;
+
+    bytes &= ~(ALIGN - 1);
+    base = (uint8_t*)mem_alloc_large(bytes);
+    if (!base) {
+        Logger.logMessagef("ImageArena", "ERROR: Failed to reserve %u bytes, using heap", (unsigned)bytes);
+        return false;
+    }
+    capacity = bytes;
+    stats.capacity = bytes;
+    Logger.logMessagef("ImageArena", "Reserved %u KB (%s)", (unsigned)(bytes / 1024), mem_has_psram() ? "PSRAM" : "RAM");
+    return true;
+}
+
+void* image_arena_alloc(size_t size) {
+    if (size == 0) return nullptr;
+    const size_t need = block_bytes(size);
+
+    portENTER_CRITICAL(&arena_mux);
+    void* ptr = nullptr;
+    if (base && need <= capacity - top) {
+        BlockHeader* hdr = header_at(top);
+        hdr->prev = last;
+        hdr->size = (uint32_t)need | LIVE_FLAG;
+        last = (uint32_t)top;
+        top += need;
+        ptr = hdr + 1;
+        stats.live++;
+        if (top > stats.high_water) stats.high_water = top;
+    } else {
+        stats.fallbacks++;
+    }
+    stats.used = top;
+    portEXIT_CRITICAL(&arena_mux);
+
+    return ptr ? ptr : mem_alloc_large(size);
+}
+
+void image_arena_free(void* ptr) {
+    if (!ptr) return;
+    if (!base || (uint8_t*)ptr < base || (uint8_t*)ptr >= base + capacity) {
+        free(ptr);
+        return;
+    }
+
+    portENTER_CRITICAL(&arena_mux);
+    BlockHeader* hdr = (BlockHeader*)ptr - 1;
+    hdr->size &= ~LIVE_FLAG;
+    stats.live--;
+
+    // Pull the top back over the freed blocks at the end
+    while (last != NO_BLOCK && !(header_at(last)->size & LIVE_FLAG)) {
+        top = last;
+        last = header_at(last)->prev;
+    }
+    if (last == NO_BLOCK) {
+        top = 0;
+        stats.resets++;
+    }
+    stats.used = top;
+    portEXIT_CRITICAL(&arena_mux);
+}
+
+size_t image_arena_available() {
+    portENTER_CRITICAL(&arena_mux);
+    const size_t room = capacity - top;
+    portEXIT_CRITICAL(&arena_mux);
+    return room > sizeof(BlockHeader) ? room - sizeof(BlockHeader) : 0;
+}
+
+void image_arena_get_stats(ImageArenaStats* out) {
+    portENTER_CRITICAL(&arena_mux);
+    *out = stats;
+    portEXIT_CRITICAL(&arena_mux);
+}
@@ -0,0 +1,44 @@
+/*
+ * Image Arena
+ *
+ * One region reserved at boot for upload and strip buffers, so a day of image
+ * pushes does not chop up the heap. Allocation bumps a top pointer; freeing
+ * marks the block and pulls the top back over every freed block at the end,
+ * so a session's buffers (released in roughly reverse order, or all at once
+ * when the session ends) give the whole region back. When the region is full
+ * or was never reserved, allocations fall back to mem_alloc_large().
+ *
+ * Safe from any task: allocations come from the AsyncTCP handlers, frees
+ * also from the loop task.
+ */
+
+#ifndef IMAGE_ARENA_H
+#define IMAGE_ARENA_H
+
+#include <Arduino.h>
+
+struct ImageArenaStats {
+    size_t capacity;      // reserved bytes (0 = no arena)
+    size_t used;          // current top, including freed blocks below live ones
+    size_t high_water;    // highest top since boot
+    uint32_t live;        // blocks allocated and not yet freed
+    uint32_t resets;      // times the arena emptied completely
+    uint32_t fallbacks;   // allocations served from the heap instead
+};
+
+// Reserve the region (PSRAM when present). false if it could not be allocated;
+// the arena then serves everything from the heap.
+bool image_arena_init(size_t bytes);
+
+// 8-byte aligned block from the arena, else from the heap; nullptr if neither fits
+void* image_arena_alloc(size_t size);
+
+// Release a block from image_arena_alloc() (nullptr is ignored)
+void image_arena_free(void* ptr);
+
+// Largest block the arena itself can hand out right now
+size_t image_arena_available();
+
+void image_arena_get_stats(ImageArenaStats* stats);
+
+#endif // IMAGE_ARENA_H
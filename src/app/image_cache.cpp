@@ -0,0 +1,644 @@
+/*
+ * Image Cache Implementation
+ *
+ * Compressed frame format: a stream of 16-bit words
+ *   0x8000 | n, pixel         run of n identical pixels (n = 1..32767)
+ *   n, pixel_1 ... pixel_n    n literal pixels (n = 1..RLE_MAX_LITERALS)
+ * Flat UI graphics (alerts, icons) compress to a few KB; photos stay close to
+ * raw size and may not fit the flash partition at all.
+ *
+ * Flash file layout: FlashHeader followed by the compressed words.
+ */
+
+#include "image_cache.h"
+#include "board_config.h"
+#include "log_manager.h"
+
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static const uint16_t RLE_RUN_FLAG = 0x8000;
+static const uint16_t RLE_MAX_RUN = 0x7FFF;
+static const size_t RLE_MAX_LITERALS = 128;
+static const size_t RLE_MIN_RUN = 3;  // shorter runs are cheaper as literals
+
+static const char* CACHE_DIR = "/imgcache";
+static const char* CAPTURE_TMP_PATH = "/imgcache/capture.tmp";
+static const uint32_t FLASH_MAGIC = 0x31434D49;  // "IMC1"
+
+struct FlashHeader {
+    uint32_t magic;
+    uint32_t id;
+    uint16_t width;
+    uint16_t height;
+    uint32_t bytes;
+};
+
+struct CacheEntry {
+    bool used;
+    uint32_t id;
+    uint16_t width;
+    uint16_t height;
+    uint32_t bytes;
+    uint8_t* data;       // PSRAM storage (nullptr for flash)
+    uint32_t last_used;  // value of use_clock at last capture/blit (LRU)
+    uint32_t hits;
+};
+
+static CacheEntry entries[IMAGE_CACHE_MAX_ENTRIES];
+static ImageCacheStorage storage = IMAGE_CACHE_NONE;
+static SemaphoreHandle_t cache_mutex = nullptr;
+static uint32_t use_clock = 0;
+
+// ===== Capture state (single capture at a time, owned by the decode task) =====
+
+struct CaptureState {
+    bool active;
+    bool failed;
+    uint16_t width;
+    uint16_t height;
+    uint16_t rows_done;
+    size_t bytes;
+
+    // PSRAM: encode straight into the destination buffer
+    uint8_t* buf;
+    size_t capacity;
+
+    // Flash: encode into a staging block, appended to a temp file
+    File file;
+    uint16_t stage[256];
+    size_t stage_len;
+
+    // RLE encoder
+    uint16_t run_px;
+    uint32_t run_len;
+    uint16_t lit[RLE_MAX_LITERALS];
+    size_t lit_len;
+};
+static CaptureState cap;
+
+static void cache_lock() { xSemaphoreTake(cache_mutex, portMAX_DELAY); }
+static void cache_unlock() { xSemaphoreGive(cache_mutex); }
+
+static void entry_path(uint32_t id, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s/%08lx.rle", CACHE_DIR, (unsigned long)id);
+}
+
+static CacheEntry* find_entry(uint32_t id) {
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].used && entries[i].id == id) return &entries[i];
+    }
+    return nullptr;
+}
+
+static void drop_entry(CacheEntry* e) {
+    if (storage == IMAGE_CACHE_PSRAM) {
+        heap_caps_free(e->data);
+    } else if (storage == IMAGE_CACHE_FLASH) {
+        char path[32];
+        entry_path(e->id, path, sizeof(path));
+        LittleFS.remove(path);
+    }
+    *e = {};
+}
+
+static CacheEntry* lru_entry() {
+    CacheEntry* oldest = nullptr;
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (!entries[i].used) continue;
+        if (!oldest || entries[i].last_used < oldest->last_used) oldest = &entries[i];
+    }
+    return oldest;
+}
+
+static bool evict_lru() {
+    CacheEntry* e = lru_entry();
+    if (!e) return false;
+    Logger.logMessagef("ImageCache", "Evicting %08lx (%u bytes)", (unsigned long)e->id, (unsigned)e->bytes);
+    drop_entry(e);
+    return true;
+}
+
+static size_t used_bytes() {
+    size_t total = 0;
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].used) total += entries[i].bytes;
+    }
+    return total;
+}
+
+// Files that cannot be indexed (damaged, or beyond IMAGE_CACHE_MAX_ENTRIES) are
+// deleted: nothing would ever evict them, and they share the partition
+static void index_flash_entries() {
+    File dir = LittleFS.open(CACHE_DIR);
+    if (!dir || !dir.isDirectory()) return;
+
+    int slot = 0;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        FlashHeader hdr;
+        const bool valid = slot < IMAGE_CACHE_MAX_ENTRIES &&
+                           f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+                           hdr.magic == FLASH_MAGIC &&
+                           f.size() == sizeof(hdr) + hdr.bytes;
+        const String path = f.path();
+        f.close();
+        if (!valid) {
+            Logger.logMessagef("ImageCache", "Removing orphan %s", path.c_str());
+            LittleFS.remove(path);
+            continue;
+        }
+
+        CacheEntry& e = entries[slot++];
+        e.used = true;
+        e.id = hdr.id;
+        e.width = hdr.width;
+        e.height = hdr.height;
+        e.bytes = hdr.bytes;
+    }
+}
+
+// Frames left by a build that cached on flash keep their partition space
+static void remove_flash_entries() {
+    if (!LittleFS.begin(false) || !LittleFS.exists(CACHE_DIR)) return;
+
+    File dir = LittleFS.open(CACHE_DIR);
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        const String path = f.path();
+        f.close();
+        LittleFS.remove(path);
+    }
+    dir.close();
+    LittleFS.rmdir(CACHE_DIR);
+}
+
+bool image_cache_init() {
+    if (storage != IMAGE_CACHE_NONE) return true;
+
+    if (!cache_mutex) {
+        cache_mutex = xSemaphoreCreateMutex();
+    }
+
+    if (psramFound()) {
+        storage = IMAGE_CACHE_PSRAM;
+    } else if (!IMAGE_CACHE_ON_FLASH) {
+        Logger.logMessage("ImageCache", "No PSRAM, cache disabled (IMAGE_CACHE_ON_FLASH is off)");
+        remove_flash_entries();
+        return false;
+    } else if (LittleFS.begin(true)) {
+        if (!LittleFS.exists(CACHE_DIR)) {
+            LittleFS.mkdir(CACHE_DIR);
+        }
+        storage = IMAGE_CACHE_FLASH;
+        LittleFS.remove(CAPTURE_TMP_PATH);  // capture interrupted by a reset
+        index_flash_entries();
+    } else {
+        Logger.logMessage("ImageCache", "ERROR: No PSRAM and LittleFS mount failed, cache disabled");
+        return false;
+    }
+
+    ImageCacheStats stats;
+    image_cache_get_stats(&stats);
+    Logger.logMessagef("ImageCache", "Storage: %s, %u frames, %u/%u bytes",
+                      image_cache_storage_name(storage), (unsigned)stats.entries,
+                      (unsigned)stats.used_bytes, (unsigned)stats.capacity_bytes);
+    return true;
+}
+
+const char* image_cache_storage_name(ImageCacheStorage s) {
+    switch (s) {
+        case IMAGE_CACHE_PSRAM: return "psram";
+        case IMAGE_CACHE_FLASH: return "flash";
+        default: return "none";
+    }
+}
+
+uint32_t image_cache_hash(const uint8_t* data, size_t len, uint32_t seed) {
+    uint32_t h = seed;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// ===== RLE encoder =====
+
+static void capture_flush_stage() {
+    if (cap.stage_len == 0 || cap.failed) {
+        cap.stage_len = 0;
+        return;
+    }
+
+    const uint8_t* src = (const uint8_t*)cap.stage;
+    size_t remaining = cap.stage_len * sizeof(uint16_t);
+    while (remaining > 0) {
+        const size_t n = cap.file.write(src, remaining);
+        src += n;
+        remaining -= n;
+        if (remaining == 0) break;
+
+        // Partition full: make room by dropping the oldest frame, then retry
+        cache_lock();
+        const bool evicted = evict_lru();
+        cache_unlock();
+        if (!evicted) {
+            Logger.logMessage("ImageCache", "ERROR: Frame does not fit the flash partition");
+            cap.failed = true;
+            break;
+        }
+    }
+    cap.stage_len = 0;
+}
+
+static void capture_put(uint16_t word) {
+    if (cap.failed) return;
+
+    if (storage == IMAGE_CACHE_PSRAM) {
+        if (cap.bytes + sizeof(uint16_t) > cap.capacity) {
+            cap.failed = true;
+            return;
+        }
+        memcpy(cap.buf + cap.bytes, &word, sizeof(word));
+    } else {
+        cap.stage[cap.stage_len++] = word;
+        if (cap.stage_len == sizeof(cap.stage) / sizeof(cap.stage[0])) {
+            capture_flush_stage();
+        }
+    }
+    cap.bytes += sizeof(uint16_t);
+}
+
+static void rle_flush_literals() {
+    if (cap.lit_len == 0) return;
+    capture_put((uint16_t)cap.lit_len);
+    for (size_t i = 0; i < cap.lit_len; i++) {
+        capture_put(cap.lit[i]);
+    }
+    cap.lit_len = 0;
+}
+
+static void rle_flush_run() {
+    if (cap.run_len == 0) return;
+
+    if (cap.run_len >= RLE_MIN_RUN) {
+        rle_flush_literals();
+        capture_put((uint16_t)(RLE_RUN_FLAG | cap.run_len));
+        capture_put(cap.run_px);
+    } else {
+        for (uint32_t i = 0; i < cap.run_len; i++) {
+            cap.lit[cap.lit_len++] = cap.run_px;
+            if (cap.lit_len == RLE_MAX_LITERALS) rle_flush_literals();
+        }
+    }
+    cap.run_len = 0;
+}
+
+static inline void rle_push(uint16_t px) {
+    if (cap.run_len > 0 && px == cap.run_px && cap.run_len < RLE_MAX_RUN) {
+        cap.run_len++;
+        return;
+    }
+    rle_flush_run();
+    cap.run_px = px;
+    cap.run_len = 1;
+}
+
+// ===== Capture =====
+
+bool image_cache_capture_begin(uint16_t width, uint16_t height) {
+    if (storage == IMAGE_CACHE_NONE || width == 0 || height == 0) return false;
+
+    image_cache_capture_abort();
+
+    cap.width = width;
+    cap.height = height;
+
+    if (storage == IMAGE_CACHE_PSRAM) {
+        // Worst case: every pixel a literal, plus one header word per literal packet
+        const size_t pixels = (size_t)width * height;
+        cap.capacity = (pixels + pixels / RLE_MAX_LITERALS + 1) * sizeof(uint16_t);
+        cap.buf = (uint8_t*)heap_caps_malloc(cap.capacity, MALLOC_CAP_SPIRAM);
+        if (!cap.buf) {
+            Logger.logMessagef("ImageCache", "ERROR: Capture buffer allocation failed (%u bytes)", (unsigned)cap.capacity);
+            return false;
+        }
+    } else {
+        cap.file = LittleFS.open(CAPTURE_TMP_PATH, FILE_WRITE);
+        if (!cap.file) {
+            Logger.logMessage("ImageCache", "ERROR: Cannot create capture file");
+            return false;
+        }
+        FlashHeader hdr = {FLASH_MAGIC, 0, width, height, 0};
+        cap.file.write((const uint8_t*)&hdr, sizeof(hdr));  // rewritten on commit
+    }
+
+    cap.active = true;
+    return true;
+}
+
+void image_cache_capture_rows(uint16_t y, uint16_t width, uint16_t rows, const uint16_t* pixels) {
+    if (!cap.active || cap.failed) return;
+
+    // Only full-width rows arriving in raster order can be captured
+    if (width != cap.width || y != cap.rows_done || y + rows > cap.height) {
+        Logger.logMessagef("ImageCache", "Capture skipped: rows %u..%u (%u wide) out of order",
+                          (unsigned)y, (unsigned)(y + rows - 1), (unsigned)width);
+        cap.failed = true;
+        return;
+    }
+
+    const size_t count = (size_t)width * rows;
+    for (size_t i = 0; i < count; i++) {
+        rle_push(pixels[i]);
+    }
+    cap.rows_done += rows;
+}
+
+void image_cache_capture_abort() {
+    if (cap.buf) heap_caps_free(cap.buf);
+    if (cap.file) {
+        cap.file.close();
+        LittleFS.remove(CAPTURE_TMP_PATH);
+    }
+    cap = {};
+}
+
+bool image_cache_capture_commit(uint32_t id) {
+    if (!cap.active) return false;
+
+    rle_flush_run();
+    rle_flush_literals();
+    if (storage == IMAGE_CACHE_FLASH) capture_flush_stage();
+
+    if (cap.failed || cap.rows_done != cap.height) {
+        Logger.logMessagef("ImageCache", "Capture of %08lx incomplete (%u/%u rows)",
+                          (unsigned long)id, (unsigned)cap.rows_done, (unsigned)cap.height);
+        image_cache_capture_abort();
+        return false;
+    }
+
+    cache_lock();
+
+    CacheEntry* existing = find_entry(id);
+    if (existing) drop_entry(existing);
+
+    if (storage == IMAGE_CACHE_PSRAM) {
+        if (cap.bytes > IMAGE_CACHE_PSRAM_BYTES) {
+            cache_unlock();
+            Logger.logMessagef("ImageCache", "Frame %08lx too large (%u bytes)", (unsigned long)id, (unsigned)cap.bytes);
+            image_cache_capture_abort();
+            return false;
+        }
+        while (used_bytes() + cap.bytes > IMAGE_CACHE_PSRAM_BYTES && evict_lru()) {
+        }
+        uint8_t* shrunk = (uint8_t*)heap_caps_realloc(cap.buf, cap.bytes, MALLOC_CAP_SPIRAM);
+        if (shrunk) cap.buf = shrunk;
+    } else {
+        FlashHeader hdr = {FLASH_MAGIC, id, cap.width, cap.height, (uint32_t)cap.bytes};
+        cap.file.seek(0);
+        cap.file.write((const uint8_t*)&hdr, sizeof(hdr));
+        cap.file.close();
+
+        char path[32];
+        entry_path(id, path, sizeof(path));
+        if (!LittleFS.rename(CAPTURE_TMP_PATH, path)) {
+            cache_unlock();
+            Logger.logMessage("ImageCache", "ERROR: Cannot store captured frame");
+            image_cache_capture_abort();
+            return false;
+        }
+    }
+
+    CacheEntry* slot = nullptr;
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES && !slot; i++) {
+        if (!entries[i].used) slot = &entries[i];
+    }
+    if (!slot) {
+        slot = lru_entry();
+        drop_entry(slot);
+    }
+
+    slot->used = true;
+    slot->id = id;
+    slot->width = cap.width;
+    slot->height = cap.height;
+    slot->bytes = cap.bytes;
+    slot->data = (storage == IMAGE_CACHE_PSRAM) ? cap.buf : nullptr;
+    slot->last_used = ++use_clock;
+    slot->hits = 0;
+
+    cache_unlock();
+
+    Logger.logMessagef("ImageCache", "Cached %08lx: %ux%u, %u bytes (%u%% of raw)",
+                      (unsigned long)id, (unsigned)cap.width, (unsigned)cap.height, (unsigned)cap.bytes,
+                      (unsigned)(cap.bytes * 100 / ((size_t)cap.width * cap.height * 2)));
+
+    cap.buf = nullptr;  // owned by the entry now
+    cap = {};
+    return true;
+}
+
+// ===== Lookup / blit =====
+
+bool image_cache_contains(uint32_t id) {
+    if (storage == IMAGE_CACHE_NONE) return false;
+    cache_lock();
+    const bool found = find_entry(id) != nullptr;
+    cache_unlock();
+    return found;
+}
+
+// Word source over a PSRAM buffer or a flash file (read in small blocks)
+struct RleReader {
+    const uint8_t* mem;
+    File* file;
+    size_t remaining;  // bytes left in the compressed stream
+    uint16_t block[128];
+    size_t block_len;
+    size_t block_pos;
+};
+
+static bool rle_read(RleReader& r, uint16_t& word) {
+    if (r.remaining < sizeof(uint16_t)) return false;
+    r.remaining -= sizeof(uint16_t);
+
+    if (r.mem) {
+        memcpy(&word, r.mem, sizeof(word));
+        r.mem += sizeof(word);
+        return true;
+    }
+
+    if (r.block_pos == r.block_len) {
+        const size_t want = min(sizeof(r.block), r.remaining + sizeof(uint16_t));
+        r.block_len = r.file->read((uint8_t*)r.block, want) / sizeof(uint16_t);
+        r.block_pos = 0;
+        if (r.block_len == 0) return false;
+    }
+    word = r.block[r.block_pos++];
+    return true;
+}
+
+bool image_cache_blit(uint32_t id, ImageCacheSink sink, void* ctx, uint16_t band_rows) {
+    if (storage == IMAGE_CACHE_NONE || !sink || band_rows == 0) return false;
+
+    cache_lock();
+
+    CacheEntry* e = find_entry(id);
+    if (!e) {
+        cache_unlock();
+        return false;
+    }
+
+    const unsigned long start_us = micros();
+    const uint16_t width = e->width;
+    const uint16_t height = e->height;
+
+    // Band buffer is sent by DMA, so it must live in internal RAM
+    const size_t band_pixels = (size_t)width * band_rows;
+    uint16_t* band = (uint16_t*)heap_caps_malloc(band_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+    if (!band) {
+        cache_unlock();
+        Logger.logMessage("ImageCache", "ERROR: Blit buffer allocation failed");
+        return false;
+    }
+
+    RleReader reader = {};
+    File file;
+    reader.remaining = e->bytes;
+    if (storage == IMAGE_CACHE_PSRAM) {
+        reader.mem = e->data;
+    } else {
+        char path[32];
+        entry_path(id, path, sizeof(path));
+        file = LittleFS.open(path, FILE_READ);
+        if (!file || !file.seek(sizeof(FlashHeader))) {
+            heap_caps_free(band);
+            cache_unlock();
+            Logger.logMessagef("ImageCache", "ERROR: Cannot read %s", path);
+            return false;
+        }
+        reader.file = &file;
+    }
+
+    const size_t total = (size_t)width * height;
+    size_t done = 0;
+    size_t fill = 0;
+    uint16_t band_y = 0;
+    bool ok = true;
+
+    while (done < total) {
+        uint16_t hdr, px;
+        if (!rle_read(reader, hdr)) {
+            ok = false;
+            break;
+        }
+        const bool run = (hdr & RLE_RUN_FLAG) != 0;
+        size_t n = hdr & RLE_MAX_RUN;
+        if (n == 0 || n > total - done || (run && !rle_read(reader, px))) {
+            ok = false;
+            break;
+        }
+
+        while (n > 0) {
+            if (!run && !rle_read(reader, px)) {
+                ok = false;
+                break;
+            }
+            band[fill++] = px;
+            done++;
+            n--;
+
+            if (fill == band_pixels || done == total) {
+                const uint16_t rows = (uint16_t)(fill / width);
+                sink(ctx, band_y, width, rows, band);
+                band_y += rows;
+                fill = 0;
+            }
+        }
+        if (!ok) break;
+    }
+
+    if (file) file.close();
+    heap_caps_free(band);
+
+    if (ok) {
+        e->hits++;
+        e->last_used = ++use_clock;
+    }
+
+    cache_unlock();
+
+    if (ok) {
+        Logger.logMessagef("ImageCache", "Blit %08lx: %ux%u in %lu us",
+                          (unsigned long)id, (unsigned)width, (unsigned)height, micros() - start_us);
+    } else {
+        Logger.logMessagef("ImageCache", "ERROR: Frame %08lx is corrupt", (unsigned long)id);
+    }
+    return ok;
+}
+
+// ===== Management =====
+
+bool image_cache_remove(uint32_t id) {
+    if (storage == IMAGE_CACHE_NONE) return false;
+    cache_lock();
+    CacheEntry* e = find_entry(id);
+    if (e) drop_entry(e);
+    cache_unlock();
+    return e != nullptr;
+}
+
+void image_cache_clear() {
+    if (storage == IMAGE_CACHE_NONE) return;
+    cache_lock();
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].used) drop_entry(&entries[i]);
+    }
+    cache_unlock();
+}
+
+size_t image_cache_list(ImageCacheInfo* out, size_t max) {
+    if (storage == IMAGE_CACHE_NONE || !out) return 0;
+
+    cache_lock();
+
+    // Insertion sort by recency (tiny table)
+    const CacheEntry* sorted[IMAGE_CACHE_MAX_ENTRIES];
+    size_t count = 0;
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (!entries[i].used) continue;
+        size_t pos = count++;
+        while (pos > 0 && sorted[pos - 1]->last_used < entries[i].last_used) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = &entries[i];
+    }
+
+    if (count > max) count = max;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = {sorted[i]->id, sorted[i]->width, sorted[i]->height, sorted[i]->bytes, sorted[i]->hits};
+    }
+
+    cache_unlock();
+    return count;
+}
+
+void image_cache_get_stats(ImageCacheStats* stats) {
+    if (!stats) return;
+    *stats = {};
+    stats->storage = storage;
+    if (storage == IMAGE_CACHE_NONE) return;
+
+    cache_lock();
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].used) stats->entries++;
+    }
+    stats->used_bytes = used_bytes();
+    cache_unlock();
+
+    stats->capacity_bytes = (storage == IMAGE_CACHE_PSRAM) ? (size_t)IMAGE_CACHE_PSRAM_BYTES
+                                                           : LittleFS.totalBytes();
+}
@@ -0,0 +1,81 @@
+/*
+ * Image Cache
+ *
+ * Content-addressed cache of decoded frames, so images that are pushed over and
+ * over (alerts, icons, placeholders) can be re-displayed with a straight blit:
+ * no network transfer and no JPEG decode.
+ *
+ * Frames are stored RLE-compressed, as the exact RGB565 words the decoder sent
+ * to the LCD (panel byte order), keyed by a 32-bit id: either client supplied or
+ * the FNV-1a hash of the JPEG bytes (image_cache_hash()).
+ *
+ * Storage:
+ *   - PSRAM when present (budget: IMAGE_CACHE_PSRAM_BYTES)
+ *   - otherwise, with IMAGE_CACHE_ON_FLASH, one file per frame on the LittleFS
+ *     data partition (no cache without either)
+ * Least recently used frames are evicted when space runs out.
+ *
+ * Capture runs on the decode task while an upload is decoded; lookups, blits and
+ * deletes come from the main loop and web handlers. All entry points are
+ * serialized by an internal mutex.
+ */
+
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <Arduino.h>
+
+enum ImageCacheStorage {
+    IMAGE_CACHE_NONE,   // init failed / not initialized: every call is a no-op
+    IMAGE_CACHE_PSRAM,
+    IMAGE_CACHE_FLASH
+};
+
+struct ImageCacheInfo {
+    uint32_t id;
+    uint16_t width;
+    uint16_t height;
+    uint32_t bytes;  // compressed size
+    uint32_t hits;   // blits since the frame was cached (or since boot, for flash)
+};
+
+struct ImageCacheStats {
+    ImageCacheStorage storage;
+    size_t entries;
+    size_t used_bytes;
+    size_t capacity_bytes;
+};
+
+// Receives decoded full-width rows during a blit (pixels in panel byte order)
+typedef void (*ImageCacheSink)(void* ctx, uint16_t y, uint16_t width, uint16_t rows, const uint16_t* pixels);
+
+// Pick the storage backend and index existing frames (flash). Safe to call once.
+bool image_cache_init();
+
+const char* image_cache_storage_name(ImageCacheStorage storage);
+
+// FNV-1a; chain calls (pass the previous result as seed) to hash data in pieces
+static const uint32_t IMAGE_CACHE_HASH_SEED = 2166136261u;
+uint32_t image_cache_hash(const uint8_t* data, size_t len, uint32_t seed = IMAGE_CACHE_HASH_SEED);
+
+// Capture: begin() a width x height frame, feed full-width rows top to bottom,
+// then commit() under an id (replacing any frame with that id) or abort().
+// Beginning a new capture aborts one left open.
+bool image_cache_capture_begin(uint16_t width, uint16_t height);
+void image_cache_capture_rows(uint16_t y, uint16_t width, uint16_t rows, const uint16_t* pixels);
+bool image_cache_capture_commit(uint32_t id);
+void image_cache_capture_abort();
+
+bool image_cache_contains(uint32_t id);
+
+// Decompress a frame and hand it to sink() in bands of up to band_rows rows
+bool image_cache_blit(uint32_t id, ImageCacheSink sink, void* ctx, uint16_t band_rows = 16);
+
+bool image_cache_remove(uint32_t id);
+void image_cache_clear();
+
+// Fill up to max entries (most recently used first); returns the count written
+size_t image_cache_list(ImageCacheInfo* out, size_t max);
+void image_cache_get_stats(ImageCacheStats* stats);
+
+#endif // IMAGE_CACHE_H
@@ -0,0 +1,409 @@
+/*
+ * Image Multicast Implementation
+ */
+
+#include "image_multicast.h"
+#include "board_config.h"
+#include "idle_pacer.h"
+#include "image_api.h"
+#include "image_arena.h"
+#include "log_manager.h"
+
+#if IMAGE_MULTICAST_PORT
+#include <AsyncUDP.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+static ImageMulticastStats stats = {};
+
+#if IMAGE_MULTICAST_PORT
+
+#define MCAST_VERSION 1
+#define MCAST_DATA_HEADER_BYTES 40
+
+// Submitted frame not finished by then: its session was taken over by an HTTP
+// upload (same bound as the HTTP strip path's drain wait)
+#define MCAST_DECODE_TIMEOUT_MS 5000
+
+enum McastType : uint8_t {
+    MCAST_DATA = 1,
+    MCAST_NACK = 2,
+    MCAST_END = 3,
+    MCAST_ACK = 4
+};
+
+struct McastStrip {
+    uint32_t offset;       // in the frame buffer
+    uint32_t size;
+    uint32_t missing;      // fragment bitmap, bit set = not received yet
+    uint8_t frag_count;    // 0 = no fragment seen yet
+    uint16_t y;            // rle565 band
+    uint16_t rows;
+};
+
+enum McastFrameState : uint8_t {
+    FRAME_NONE = 0,
+    FRAME_RECEIVING,       // reassembling; complete strips go to the pipeline in order
+    FRAME_DECODING,        // every strip submitted, buffer released
+    FRAME_DONE             // result reported; retransmissions for others are ignored
+};
+
+struct McastFrame {
+    McastFrameState state;
+    uint32_t id;
+    uint8_t* buf;
+    uint32_t size;
+    uint16_t width;
+    uint16_t height;
+    uint8_t strip_count;
+    uint8_t format;
+    uint8_t scale;
+    unsigned long timeout_ms;
+    uint8_t next_submit;           // strips below this index are in the pipeline
+    uint32_t session;              // image_api_submit_strip() session
+    unsigned long last_packet_ms;
+    unsigned long nack_due_ms;     // 0 = none scheduled
+    uint8_t nacks;
+    bool ok;
+    IPAddress sender;
+    uint16_t sender_port;
+    McastStrip strips[IMAGE_MULTICAST_MAX_STRIPS];
+};
+
+static AsyncUDP udp;
+static SemaphoreHandle_t frame_mutex = nullptr;  // UDP task (packets) vs loop task (timers)
+static McastFrame frame;
+
+static inline uint16_t read_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void write_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_header(uint8_t* p, McastType type, uint32_t id) {
+    p[0] = 'E';
+    p[1] = 'I';
+    p[2] = MCAST_VERSION;
+    p[3] = type;
+    write_le32(p + 4, id);
+}
+
+static uint32_t fragment_mask(uint8_t count) {
+    return count >= 32 ? 0xFFFFFFFFu : ((1u << count) - 1);
+}
+
+// Randomized per device, so a fleet that lost the same strip does not NACK at once
+static unsigned long nack_delay_ms() {
+    return IMAGE_MULTICAST_NACK_DELAY_MS + random(IMAGE_MULTICAST_NACK_DELAY_MS + 1);
+}
+
+static void send_ack(uint32_t id, bool ok, const IPAddress& to, uint16_t port) {
+    uint8_t pkt[9];
+    write_header(pkt, MCAST_ACK, id);
+    pkt[8] = ok ? 0 : 1;
+    udp.writeTo(pkt, sizeof(pkt), to, port);
+}
+
+static bool frame_missing() {
+    for (int i = frame.next_submit; i < frame.strip_count; i++) {
+        if (frame.strips[i].frag_count == 0 || frame.strips[i].missing) return true;
+    }
+    return false;
+}
+
+static void send_nack() {
+    uint8_t pkt[10 + 6 * IMAGE_MULTICAST_MAX_STRIPS];
+    write_header(pkt, MCAST_NACK, frame.id);
+    uint8_t n = 0;
+    for (int i = frame.next_submit; i < frame.strip_count; i++) {
+        const McastStrip& st = frame.strips[i];
+        if (st.frag_count && !st.missing) continue;
+        uint8_t* entry = pkt + 10 + 6 * n++;
+        entry[0] = (uint8_t)i;
+        entry[1] = 0;
+        write_le32(entry + 2, st.frag_count ? st.missing : 0xFFFFFFFFu);
+    }
+    pkt[8] = n;
+    pkt[9] = 0;
+    udp.writeTo(pkt, 10 + 6 * n, frame.sender, frame.sender_port);
+    stats.nacks_sent++;
+}
+
+static void frame_release() {
+    image_arena_free(frame.buf);
+    frame.buf = nullptr;
+}
+
+// End of a frame: free its buffer and tell the sender
+static void frame_finish(bool ok) {
+    frame_release();
+    frame.state = FRAME_DONE;
+    frame.ok = ok;
+    if (ok) {
+        stats.frames_shown++;
+    } else {
+        stats.frames_dropped++;
+    }
+    send_ack(frame.id, ok, frame.sender, frame.sender_port);
+}
+
+// Hand complete strips to the pipeline, strictly in order; stops at the first
+// gap or when the strip ring is full (the loop retries)
+static void frame_pump() {
+    while (frame.state == FRAME_RECEIVING && frame.next_submit < frame.strip_count) {
+        const McastStrip& st = frame.strips[frame.next_submit];
+        if (st.frag_count == 0 || st.missing) return;
+
+        ImageStripDesc desc;
+        desc.strip_index = frame.next_submit;
+        desc.strip_count = frame.strip_count;
+        desc.width = frame.width;
+        desc.height = frame.height;
+        desc.scale = frame.scale;
+        desc.rle = (frame.format == 1);
+        desc.y = st.y;
+        desc.rows = st.rows;
+        desc.timeout_ms = frame.timeout_ms;
+
+        const ImageSubmitResult result = image_api_submit_strip(desc, frame.buf + st.offset, st.size, &frame.session);
+        if (result == IMAGE_SUBMIT_BUSY) return;
+        if (result != IMAGE_SUBMIT_OK) {
+            Logger.logMessagef("Multicast", "Frame %08lx: strip %d rejected, frame dropped",
+                               (unsigned long)frame.id, frame.next_submit);
+            frame_finish(false);
+            return;
+        }
+        frame.next_submit++;
+    }
+
+    if (frame.state == FRAME_RECEIVING) {
+        // The strip slots hold copies of everything
+        frame_release();
+        frame.state = FRAME_DECODING;
+        frame.last_packet_ms = millis();
+    }
+}
+
+static bool frame_start(const uint8_t* p, const IPAddress& from, uint16_t port) {
+    if (frame.state == FRAME_RECEIVING) {
+        Logger.logMessagef("Multicast", "Frame %08lx incomplete, replaced", (unsigned long)frame.id);
+        stats.frames_dropped++;
+    }
+    frame_release();
+    frame.state = FRAME_NONE;
+
+    const uint32_t size = read_le32(p + 8);
+    const uint16_t width = read_le16(p + 12);
+    const uint16_t height = read_le16(p + 14);
+    const uint8_t strip_count = p[17];
+    if (size == 0 || size > IMAGE_MULTICAST_MAX_FRAME_BYTES || width == 0 || height == 0 ||
+        strip_count == 0 || strip_count > IMAGE_MULTICAST_MAX_STRIPS || p[34] > 1 || p[35] > 3) {
+        return false;
+    }
+
+    uint8_t* buf = (uint8_t*)image_arena_alloc(size);
+    if (!buf) {
+        Logger.logMessagef("Multicast", "ERROR: No room for a %u byte frame", (unsigned)size);
+        return false;
+    }
+
+    frame = McastFrame();
+    frame.id = read_le32(p + 4);
+    frame.buf = buf;
+    frame.size = size;
+    frame.width = width;
+    frame.height = height;
+    frame.strip_count = strip_count;
+    frame.format = p[34];
+    frame.scale = p[35];
+    frame.timeout_ms = (unsigned long)read_le16(p + 32) * 1000UL;
+    frame.sender = from;
+    frame.sender_port = port;
+    frame.state = FRAME_RECEIVING;
+    stats.frames++;
+    return true;
+}
+
+static void on_data(const uint8_t* p, size_t len, const IPAddress& from, uint16_t port) {
+    if (len <= MCAST_DATA_HEADER_BYTES) {
+        stats.malformed++;
+        return;
+    }
+
+    const uint32_t id = read_le32(p + 4);
+    if (frame.state == FRAME_NONE || id != frame.id) {
+        // Retransmission of an older frame for another display
+        if (frame.state != FRAME_NONE && (int32_t)(id - frame.id) < 0) return;
+        if (!frame_start(p, from, port)) {
+            stats.malformed++;
+            return;
+        }
+    }
+    // Complete here: retransmission for another display
+    if (frame.state != FRAME_RECEIVING) return;
+
+    const uint8_t index = p[16];
+    const uint8_t frag_index = p[18];
+    const uint8_t frag_count = p[19];
+    const uint32_t strip_offset = read_le32(p + 20);
+    const uint32_t strip_size = read_le32(p + 24);
+    const uint32_t frag_offset = read_le32(p + 28);
+    const size_t payload = len - MCAST_DATA_HEADER_BYTES;
+
+    const bool geometry_ok =
+        read_le32(p + 8) == frame.size && read_le16(p + 12) == frame.width && read_le16(p + 14) == frame.height &&
+        p[17] == frame.strip_count && p[34] == frame.format && p[35] == frame.scale &&
+        index < frame.strip_count && frag_count > 0 && frag_count <= IMAGE_MULTICAST_MAX_FRAGMENTS &&
+        frag_index < frag_count && strip_size > 0 && strip_offset <= frame.size &&
+        strip_size <= frame.size - strip_offset && frag_offset <= strip_size && payload <= strip_size - frag_offset;
+    McastStrip& st = frame.strips[index];
+    if (!geometry_ok ||
+        (st.frag_count && (st.offset != strip_offset || st.size != strip_size || st.frag_count != frag_count))) {
+        stats.malformed++;
+        return;
+    }
+
+    if (st.frag_count == 0) {
+        st.offset = strip_offset;
+        st.size = strip_size;
+        st.frag_count = frag_count;
+        st.missing = fragment_mask(frag_count);
+        st.y = read_le16(p + 36);
+        st.rows = read_le16(p + 38);
+    }
+    const uint32_t bit = 1u << frag_index;
+    if (st.missing & bit) {
+        memcpy(frame.buf + strip_offset + frag_offset, p + MCAST_DATA_HEADER_BYTES, payload);
+        st.missing &= ~bit;
+    }
+    frame.last_packet_ms = millis();
+
+    frame_pump();
+}
+
+static void on_end(const uint8_t* p, const IPAddress& from, uint16_t port) {
+    const uint32_t id = read_le32(p + 4);
+
+    if (frame.state != FRAME_NONE && id == frame.id) {
+        if (frame.state == FRAME_DONE) {
+            // The sender is still waiting: our ACK was lost
+            send_ack(frame.id, frame.ok, from, port);
+        } else if (frame.state == FRAME_RECEIVING) {
+            frame.last_packet_ms = millis();
+            frame.nack_due_ms = millis() + nack_delay_ms();
+            if (!frame.nack_due_ms) frame.nack_due_ms = 1;
+        }
+        return;
+    }
+
+    // A frame we saw nothing of: an empty NACK asks for all of it
+    if (frame.state == FRAME_NONE || (int32_t)(id - frame.id) > 0) {
+        uint8_t pkt[10];
+        write_header(pkt, MCAST_NACK, id);
+        pkt[8] = 0;
+        pkt[9] = 0;
+        udp.writeTo(pkt, sizeof(pkt), from, port);
+        stats.nacks_sent++;
+    }
+}
+
+// AsyncUDP task
+static void on_packet(AsyncUDPPacket& packet) {
+    stats.packets++;
+    idle_pacer_note_activity();
+
+    const uint8_t* p = packet.data();
+    const size_t len = packet.length();
+    if (len < 8 || p[0] != 'E' || p[1] != 'I' || p[2] != MCAST_VERSION) {
+        stats.malformed++;
+        return;
+    }
+
+    xSemaphoreTake(frame_mutex, portMAX_DELAY);
+    if (p[3] == MCAST_DATA) {
+        on_data(p, len, packet.remoteIP(), packet.remotePort());
+    } else if (p[3] == MCAST_END) {
+        on_end(p, packet.remoteIP(), packet.remotePort());
+    }
+    xSemaphoreGive(frame_mutex);
+}
+
+#endif // IMAGE_MULTICAST_PORT
+
+void image_multicast_begin() {
+#if IMAGE_MULTICAST_PORT
+    if (!frame_mutex) {
+        frame_mutex = xSemaphoreCreateMutex();
+    }
+
+    IPAddress group;
+    if (!group.fromString(IMAGE_MULTICAST_GROUP)) {
+        Logger.logMessage("Multicast", "ERROR: Invalid IMAGE_MULTICAST_GROUP");
+        return;
+    }
+
+    // Reconnect: the old membership died with the link
+    udp.close();
+    if (!udp.listenMulticast(group, IMAGE_MULTICAST_PORT)) {
+        Logger.logMessagef("Multicast", "ERROR: Join %s:%d failed", IMAGE_MULTICAST_GROUP, IMAGE_MULTICAST_PORT);
+        return;
+    }
+    udp.onPacket(on_packet);
+    Logger.logMessagef("Multicast", "Joined %s:%d", IMAGE_MULTICAST_GROUP, IMAGE_MULTICAST_PORT);
+#endif
+}
+
+void image_multicast_loop() {
+#if IMAGE_MULTICAST_PORT
+    if (!frame_mutex) return;
+
+    xSemaphoreTake(frame_mutex, portMAX_DELAY);
+    const unsigned long now = millis();
+
+    if (frame.state == FRAME_RECEIVING) {
+        frame_pump();
+    }
+
+    if (frame.state == FRAME_RECEIVING) {
+        // No end marker (lost, or the sender paused): a quiet stream also asks
+        if (!frame.nack_due_ms && now - frame.last_packet_ms >= IMAGE_MULTICAST_NACK_RETRY_MS) {
+            frame.nack_due_ms = now ? now : 1;
+        }
+        if (frame.nack_due_ms && (long)(now - frame.nack_due_ms) >= 0 && frame_missing()) {
+            if (frame.nacks >= IMAGE_MULTICAST_NACK_LIMIT) {
+                Logger.logMessagef("Multicast", "Frame %08lx incomplete after %d NACKs, dropped",
+                                   (unsigned long)frame.id, frame.nacks);
+                frame_finish(false);
+            } else {
+                send_nack();
+                frame.nacks++;
+                frame.nack_due_ms = now + IMAGE_MULTICAST_NACK_RETRY_MS + nack_delay_ms();
+                if (!frame.nack_due_ms) frame.nack_due_ms = 1;
+            }
+        }
+    } else if (frame.state == FRAME_DECODING) {
+        bool ok = false;
+        if (image_api_session_done(frame.session, &ok)) {
+            frame_finish(ok);
+        } else if (now - frame.last_packet_ms > MCAST_DECODE_TIMEOUT_MS) {
+            frame_finish(false);
+        }
+    }
+
+    xSemaphoreGive(frame_mutex);
+#endif
+}
+
+void image_multicast_get_stats(ImageMulticastStats* out) {
+    if (out) *out = stats;
+}
@@ -0,0 +1,71 @@
+/*
+ * Image Multicast
+ *
+ * Fleet distribution of strip images: every display joins the multicast group
+ * IMAGE_MULTICAST_GROUP:IMAGE_MULTICAST_PORT and one sender transmission
+ * updates all of them (tools/multicast_image.py). Strips are reassembled from
+ * fragments, then handed in order to the strip pipeline of the HTTP uploads
+ * (image_api_submit_strip), so decode, screen handling and timeouts are the
+ * same as POST /api/display/image/strips.
+ *
+ * Reliability is receiver-driven: after the sender's end marker (or a pause in
+ * the stream) each device unicasts a NACK for what it is missing, the sender
+ * re-multicasts those fragments, and a device that shows the frame unicasts
+ * an ACK. Sender cost grows with the losses, not with the number of displays.
+ *
+ * Packets (UDP, little-endian, magic 'E' 'I', version 1):
+ *
+ *   DATA  sender -> group, 40-byte header + fragment payload
+ *     0   2  magic            20  4  strip offset in frame
+ *     2   1  version          24  4  strip size
+ *     3   1  type = 1         28  4  fragment offset in strip
+ *     4   4  frame id         32  2  timeout seconds (0 = stay until replaced)
+ *     8   4  frame size       34  1  format (0 = JPEG, 1 = rle565)
+ *     12  2  width            35  1  JPEG scale, log2 (0..3)
+ *     14  2  height           36  2  rle565: strip top row
+ *     16  1  strip index      38  2  rle565: strip rows
+ *     17  1  strip count
+ *     18  1  fragment index
+ *     19  1  fragment count (1..32)
+ *
+ *   END   sender -> group: magic, version, type = 3, frame id (8 bytes)
+ *
+ *   NACK  device -> sender: magic, version, type = 2, frame id, u8 entry
+ *         count, u8 0, then per incomplete strip: u8 strip index, u8 0,
+ *         u32 missing fragment bitmap (0xFFFFFFFF: strip not seen at all)
+ *
+ *   ACK   device -> sender: magic, version, type = 4, frame id, u8 status
+ *         (0 = shown, 1 = decode failed or frame dropped)
+ *
+ * Frame ids only move forward (wrapping compare); a newer frame replaces an
+ * incomplete one. One frame is reassembled at a time.
+ */
+
+#ifndef IMAGE_MULTICAST_H
+#define IMAGE_MULTICAST_H
+
+#include <Arduino.h>
+
+#define IMAGE_MULTICAST_MAX_STRIPS 64
+#define IMAGE_MULTICAST_MAX_FRAGMENTS 32
+
+// Counters since boot (UDP task and loop task write, readers may see a sample
+// mid-update)
+struct ImageMulticastStats {
+    uint32_t packets;          // datagrams received on the group port
+    uint32_t malformed;        // dropped for size, magic or inconsistent geometry
+    uint32_t frames;           // frames started
+    uint32_t frames_shown;     // frames whose strips all decoded
+    uint32_t frames_dropped;   // incomplete, replaced, or failed
+    uint32_t nacks_sent;
+};
+
+// Join the group (on every WiFi connect; rejoins after a reconnect)
+void image_multicast_begin();
+
+// Main loop: submit strips the ring had no room for, send NACKs and ACKs
+void image_multicast_loop();
+
+void image_multicast_get_stats(ImageMulticastStats* out);
+
+#endif // IMAGE_MULTICAST_H
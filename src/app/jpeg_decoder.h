@@ -0,0 +1,102 @@
+/*
+ * JPEG Decoder Backends
+ *
+ * Common interface for the decoders behind StripDecoder:
+ *   TJpgDec (ROM)     every target; streams, scales, ~4KB work area + one band
+ *   esp_driver_jpeg   hardware codec on ESP32-P4
+ *   esp_new_jpeg      SIMD software decoder on ESP32-S3 (when the component is installed)
+ *
+ * StripDecoder gives each JPEG to the target's accelerated backend first and
+ * falls back to TJpgDec for jobs it does not take (streamed input or scaled
+ * output) or when it fails. All uploads go through the same
+ * jpeg_preflight checks, so every board accepts exactly the same files.
+ * JPEG_DECODER_ACCEL (board_config.h) = false forces TJpgDec everywhere.
+ */
+
+#ifndef JPEG_DECODER_H
+#define JPEG_DECODER_H
+
+#include <Arduino.h>
+
+// Stream source: copy up to len bytes into buf and return the count (0 = end of
+// data or error). buf == NULL means skip len bytes.
+typedef size_t (*JpegReadFn)(void* ctx, uint8_t* buf, size_t len);
+
+// Receives decoded pixels in panel byte order: a w x h rectangle at (x, y) from
+// the image's top-left corner, rows packed (stride w). Return false to abort.
+typedef bool (*JpegPixelSink)(void* ctx, int x, int y, int w, int h, const uint16_t* pixels);
+
+// The TJpgDec pixel pass: RGB888 → RGB565 in panel byte order
+void strip_convert_row(const uint8_t* rgb888, uint16_t* dst, int count);
+
+struct JpegDecodeJob {
+    const uint8_t* data;   // whole JPEG in memory, or nullptr to pull it through read()
+    size_t size;
+    JpegReadFn read;
+    void* read_ctx;
+    uint8_t scale;         // output = source / 2^scale (0..3)
+    int max_width;         // widest output the caller accepts
+};
+
+// Filled in by decode() before the first sink call
+struct JpegDecodeInfo {
+    int width;             // output size
+    int height;
+    size_t bytes_read;     // compressed bytes consumed
+};
+
+class JpegDecoderBackend {
+public:
+    virtual ~JpegDecoderBackend() {}
+
+    virtual const char* name() const = 0;
+
+    // Whether decode() handles this kind of job at all (input type, scale,
+    // pixel order); false sends it to TJpgDec
+    virtual bool accepts(const JpegDecodeJob& job) const = 0;
+
+    // Session start/end: allocate and release decode buffers. Backends that need
+    // per-image buffers grow them in decode() and keep them until end().
+    virtual bool begin(int max_width) = 0;
+    virtual void end() = 0;
+    virtual size_t buffer_bytes() const = 0;
+
+    virtual bool decode(const JpegDecodeJob& job, JpegPixelSink sink, void* sink_ctx, JpegDecodeInfo* info) = 0;
+};
+
+// ROM TJpgDec; hands out one MCU row band per sink call (or one MCU block with
+// set_block_output(true), the smallest buffer)
+class TjpgdDecoder : public JpegDecoderBackend {
+public:
+    TjpgdDecoder() {}
+    ~TjpgdDecoder() { end(); }
+
+    const char* name() const override { return "TJpgDec"; }
+    bool accepts(const JpegDecodeJob& job) const override { (void)job; return true; }
+    bool begin(int max_width) override;
+    void end() override;
+    size_t buffer_bytes() const override { return work ? WORK_SIZE + pixel_buffer_bytes : 0; }
+    bool decode(const JpegDecodeJob& job, JpegPixelSink sink, void* sink_ctx, JpegDecodeInfo* info) override;
+
+    // Call before begin()
+    void set_block_output(bool block) { block_output = block; }
+
+    // Tallest MCU supported (4:2:0 subsampling = 16 lines)
+    static const int MAX_MCU_LINES = 16;
+
+private:
+    // TJpgDec requires: 3100 + (width * height * 2 / MCU_size) bytes
+    // For 240x16: minimum ~3220 bytes, using 4096 for safety
+    static const size_t WORK_SIZE = 4096;
+    void* work = nullptr;
+    uint16_t* pixel_buffer = nullptr;
+    size_t pixel_buffer_bytes = 0;
+    int buffer_width = 0;
+    bool block_output = false;
+};
+
+// The target's accelerated backend (new instance, owned by the caller), or
+// nullptr when TJpgDec is all there is
+JpegDecoderBackend* jpeg_decoder_create_accelerated();
+
+#endif // JPEG_DECODER_H
@@ -0,0 +1,221 @@
+/*
+ * Accelerated JPEG Decoder Backends
+ *
+ * ESP32-P4: esp_driver_jpeg (hardware codec)
+ * ESP32-S3: esp_new_jpeg (SIMD software decoder, espressif/esp_new_jpeg component)
+ *
+ * Both decode a whole JPEG held in memory into an RGB565 buffer and hand it to
+ * the sink in one piece. The buffers grow to the largest JPEG of the session and
+ * are freed in end(). Streamed input and scaled output stay on TJpgDec.
+ */
+
+#include "jpeg_decoder.h"
+#include "board_config.h"
+#include "lcd_driver.h"
+#include "log_manager.h"
+
+#if JPEG_DECODER_ACCEL && defined(CONFIG_IDF_TARGET_ESP32P4) && __has_include(<driver/jpeg_decode.h>)
+    #define JPEG_ACCEL_HW_CODEC 1
+    #include <driver/jpeg_decode.h>
+#elif JPEG_DECODER_ACCEL && defined(CONFIG_IDF_TARGET_ESP32S3) && __has_include(<esp_jpeg_dec.h>)
+    #define JPEG_ACCEL_ESP_NEW_JPEG 1
+    #include <esp_jpeg_dec.h>
+#endif
+
+#if JPEG_ACCEL_HW_CODEC
+
+// Output is padded to whole MCUs (at most 16x16 for 4:2:0)
+static inline uint32_t align_mcu(uint32_t v) {
+    return (v + 15) & ~15u;
+}
+
+class HwJpegDecoder : public JpegDecoderBackend {
+public:
+    ~HwJpegDecoder() { end(); }
+
+    const char* name() const override { return "JPEG codec"; }
+
+    bool accepts(const JpegDecodeJob& job) const override {
+        return job.data && job.scale == 0;
+    }
+
+    bool begin(int max_width) override {
+        (void)max_width;
+        if (engine) return true;
+        jpeg_decode_engine_cfg_t cfg = {};
+        cfg.intr_priority = 0;
+        cfg.timeout_ms = 100;
+        if (jpeg_new_decoder_engine(&cfg, &engine) != ESP_OK) {
+            Logger.logMessage("JPEG codec", "ERROR: Failed to create decoder engine");
+            engine = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    void end() override {
+        free(in_buf);
+        free(out_buf);
+        in_buf = nullptr;
+        out_buf = nullptr;
+        in_cap = 0;
+        out_cap = 0;
+        if (engine) {
+            jpeg_del_decoder_engine(engine);
+            engine = nullptr;
+        }
+    }
+
+    size_t buffer_bytes() const override { return in_cap + out_cap; }
+
+    bool decode(const JpegDecodeJob& job, JpegPixelSink sink, void* sink_ctx, JpegDecodeInfo* info) override {
+        if (!engine) return false;
+
+        jpeg_decode_picture_info_t pic = {};
+        if (jpeg_decoder_get_info(job.data, job.size, &pic) != ESP_OK || pic.width == 0 || pic.height == 0) {
+            return false;
+        }
+        if ((int)pic.width > job.max_width) {
+            return false;
+        }
+
+        // The codec reads and writes DMA-capable, cache-aligned buffers only
+        if (!grow(&in_buf, &in_cap, job.size, JPEG_DEC_ALLOC_INPUT_BUFFER)) return false;
+        const uint32_t stride = align_mcu(pic.width);
+        if (!grow(&out_buf, &out_cap, (size_t)stride * align_mcu(pic.height) * sizeof(uint16_t),
+                  JPEG_DEC_ALLOC_OUTPUT_BUFFER)) {
+            return false;
+        }
+        memcpy(in_buf, job.data, job.size);
+
+        jpeg_decode_cfg_t cfg = {};
+        cfg.output_format = JPEG_DECODE_OUT_FORMAT_RGB565;
+        cfg.rgb_order = JPEG_DEC_RGB_ELEMENT_ORDER_RGB;
+        cfg.conv_std = JPEG_YUV_RGB_CONV_STD_BT601;
+        uint32_t out_size = 0;
+        if (jpeg_decoder_process(engine, &cfg, in_buf, job.size, out_buf, out_cap, &out_size) != ESP_OK) {
+            Logger.logMessage("JPEG codec", "ERROR: Decode failed");
+            return false;
+        }
+
+        // Little-endian, MCU-padded rows → panel byte order, packed to the real
+        // width (in place: every destination pixel is at or before its source)
+        uint16_t* px = (uint16_t*)out_buf;
+        for (uint32_t y = 0; y < pic.height; y++) {
+            const uint16_t* src = px + y * stride;
+            uint16_t* dst = px + y * pic.width;
+            for (uint32_t x = 0; x < pic.width; x++) {
+                dst[x] = lcd_swap16(src[x]);
+            }
+        }
+
+        info->width = pic.width;
+        info->height = pic.height;
+        info->bytes_read = job.size;
+        return sink(sink_ctx, 0, 0, pic.width, pic.height, px);
+    }
+
+private:
+    jpeg_decoder_handle_t engine = nullptr;
+    uint8_t* in_buf = nullptr;
+    uint8_t* out_buf = nullptr;
+    size_t in_cap = 0;
+    size_t out_cap = 0;
+
+    static bool grow(uint8_t** buf, size_t* cap, size_t size, jpeg_dec_buffer_alloc_direction_t dir) {
+        if (*cap >= size) return true;
+        free(*buf);
+        jpeg_decode_memory_alloc_cfg_t mem = {};
+        mem.buffer_direction = dir;
+        size_t allocated = 0;
+        *buf = (uint8_t*)jpeg_alloc_decoder_mem(size, &mem, &allocated);
+        *cap = *buf ? allocated : 0;
+        return *buf != nullptr;
+    }
+};
+
+JpegDecoderBackend* jpeg_decoder_create_accelerated() {
+    return new HwJpegDecoder();
+}
+
+#elif JPEG_ACCEL_ESP_NEW_JPEG
+
+class EspNewJpegDecoder : public JpegDecoderBackend {
+public:
+    ~EspNewJpegDecoder() { end(); }
+
+    const char* name() const override { return "esp_new_jpeg"; }
+
+    bool accepts(const JpegDecodeJob& job) const override {
+        return job.data && job.scale == 0;
+    }
+
+    bool begin(int max_width) override {
+        (void)max_width;
+        return true;
+    }
+
+    void end() override {
+        if (out_buf) {
+            jpeg_free_align(out_buf);
+        }
+        out_buf = nullptr;
+        out_cap = 0;
+    }
+
+    size_t buffer_bytes() const override { return out_cap; }
+
+    bool decode(const JpegDecodeJob& job, JpegPixelSink sink, void* sink_ctx, JpegDecodeInfo* info) override {
+        jpeg_dec_config_t cfg = DEFAULT_JPEG_DEC_CONFIG();
+        cfg.output_type = JPEG_PIXEL_FORMAT_RGB565_BE;  // panel byte order, no swap pass
+        cfg.rotate = JPEG_ROTATE_0D;
+
+        jpeg_dec_handle_t dec = nullptr;
+        if (jpeg_dec_open(&cfg, &dec) != JPEG_ERR_OK) {
+            return false;
+        }
+
+        bool ok = false;
+        jpeg_dec_io_t io = {};
+        jpeg_dec_header_info_t hdr = {};
+        io.inbuf = (uint8_t*)job.data;
+        io.inbuf_len = (int)job.size;
+        int out_len = 0;
+        if (jpeg_dec_parse_header(dec, &io, &hdr) == JPEG_ERR_OK && (int)hdr.width <= job.max_width &&
+            jpeg_dec_get_outbuf_len(dec, &out_len) == JPEG_ERR_OK && grow((size_t)out_len)) {
+            io.outbuf = out_buf;
+            ok = (jpeg_dec_process(dec, &io) == JPEG_ERR_OK);
+        }
+        jpeg_dec_close(dec);
+        if (!ok) return false;
+
+        info->width = hdr.width;
+        info->height = hdr.height;
+        info->bytes_read = job.size - io.inbuf_remain;
+        return sink(sink_ctx, 0, 0, hdr.width, hdr.height, (const uint16_t*)out_buf);
+    }
+
+private:
+    uint8_t* out_buf = nullptr;
+    size_t out_cap = 0;
+
+    bool grow(size_t size) {
+        if (out_cap >= size) return true;
+        end();
+        out_buf = (uint8_t*)jpeg_calloc_align(size, 16);
+        out_cap = out_buf ? size : 0;
+        return out_buf != nullptr;
+    }
+};
+
+JpegDecoderBackend* jpeg_decoder_create_accelerated() {
+    return new EspNewJpegDecoder();
+}
+
+#else
+
+JpegDecoderBackend* jpeg_decoder_create_accelerated() {
+    return nullptr;
+}
+
+#endif
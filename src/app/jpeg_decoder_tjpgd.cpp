@@ -0,0 +1,267 @@
+/*
+ * TJpgDec Backend
+ *
+ * ROM TJpgDec: pulls the JPEG from memory or a read callback, converts each MCU
+ * block RGB888 → RGB565 in panel byte order and hands out full-width MCU
+ * row bands (or single blocks), so a whole image needs only one band of RAM.
+ */
+
+#include "jpeg_decoder.h"
+#include "lcd_driver.h"
+#include "log_manager.h"
+#include "mem_placement.h"
+
+// TJpgDec (tjpgd) decoder implementation
+// Use the ESP-ROM TJpgDec header for the active target.
+// Why: Arduino-ESP32 typically links jd_prepare/jd_decomp to the chip ROM implementation. The ROM ABI
+// (types, struct layout, and callback signatures) is chip-specific; mismatches can compile but fail at
+// runtime (often as JDR_INP / jd_prepare failed).
+// Prefer CONFIG_IDF_TARGET_* when available (more robust if multiple chip headers are visible).
+// Fall back to __has_include for toolchains that don't define CONFIG_IDF_TARGET_*.
+#if defined(CONFIG_IDF_TARGET_ESP32)
+    #include <esp32/rom/tjpgd.h>
+#elif defined(CONFIG_IDF_TARGET_ESP32S2)
+    #if __has_include(<esp32s2/rom/tjpgd.h>)
+        #include <esp32s2/rom/tjpgd.h>
+    #else
+        #error "Missing <esp32s2/rom/tjpgd.h> in this Arduino-ESP32 install"
+    #endif
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
+    #include <esp32s3/rom/tjpgd.h>
+#elif defined(CONFIG_IDF_TARGET_ESP32C2)
+    #if __has_include(<esp32c2/rom/tjpgd.h>)
+        #include <esp32c2/rom/tjpgd.h>
+    #else
+        #error "Missing <esp32c2/rom/tjpgd.h> in this Arduino-ESP32 install"
+    #endif
+#elif defined(CONFIG_IDF_TARGET_ESP32C3)
+    #include <esp32c3/rom/tjpgd.h>
+#elif defined(CONFIG_IDF_TARGET_ESP32C5)
+    #if __has_include(<esp32c5/rom/tjpgd.h>)
+        #include <esp32c5/rom/tjpgd.h>
+    #else
+        #error "Missing <esp32c5/rom/tjpgd.h> in this Arduino-ESP32 install"
+    #endif
+#elif defined(CONFIG_IDF_TARGET_ESP32C6)
+    #include <esp32c6/rom/tjpgd.h>
+#elif defined(CONFIG_IDF_TARGET_ESP32H2)
+    #if __has_include(<esp32h2/rom/tjpgd.h>)
+        #include <esp32h2/rom/tjpgd.h>
+    #else
+        #error "Missing <esp32h2/rom/tjpgd.h> in this Arduino-ESP32 install"
+    #endif
+#elif defined(CONFIG_IDF_TARGET_ESP32P4)
+    #if __has_include(<esp32p4/rom/tjpgd.h>)
+        #include <esp32p4/rom/tjpgd.h>
+    #else
+        #error "Missing <esp32p4/rom/tjpgd.h> in this Arduino-ESP32 install"
+    #endif
+#else
+    #if __has_include(<esp32/rom/tjpgd.h>)
+        #include <esp32/rom/tjpgd.h>
+    #elif __has_include(<esp32s3/rom/tjpgd.h>)
+        #include <esp32s3/rom/tjpgd.h>
+    #elif __has_include(<esp32c6/rom/tjpgd.h>)
+        #include <esp32c6/rom/tjpgd.h>
+    #elif __has_include(<esp32c5/rom/tjpgd.h>)
+        #include <esp32c5/rom/tjpgd.h>
+    #elif __has_include(<esp32c3/rom/tjpgd.h>)
+        #include <esp32c3/rom/tjpgd.h>
+    #elif __has_include(<esp32s2/rom/tjpgd.h>)
+        #include <esp32s2/rom/tjpgd.h>
+    #elif __has_include(<esp32c2/rom/tjpgd.h>)
+        #include <esp32c2/rom/tjpgd.h>
+    #elif __has_include(<esp32h2/rom/tjpgd.h>)
+        #include <esp32h2/rom/tjpgd.h>
+    #elif __has_include(<esp32p4/rom/tjpgd.h>)
+        #include <esp32p4/rom/tjpgd.h>
+    #else
+        #error "Unsupported ESP32 target for TJpgDec (no ROM tjpgd.h found)"
+    #endif
+#endif
+
+// One decode: input source and output state, reached by both TJpgDec callbacks
+// through the single opaque device pointer
+struct TjpgdSession {
+    const JpegDecodeJob* job;
+    size_t pos;              // compressed bytes consumed
+    JpegPixelSink sink;
+    void* sink_ctx;
+    uint16_t* pixel_buffer;  // One output block (block output) or one MCU-row band
+    int buffer_width;
+    int out_width;           // Decoded (scaled) image width
+    bool block_output;
+};
+
+// TJpgDec input function - read from memory buffer or stream callback
+// Signature must match ROM: UINT (*)(JDEC*, BYTE*, UINT)
+static UINT jpeg_input_func(JDEC* jd, BYTE* buff, UINT nbyte) {
+    TjpgdSession* session = (TjpgdSession*)jd->device;
+    if (!session) return 0;
+
+    const JpegDecodeJob* job = session->job;
+    if (!job->data) {
+        // Stream: buff == NULL means skip; the callback discards in that case
+        const size_t got = job->read ? job->read(job->read_ctx, buff, (size_t)nbyte) : 0;
+        session->pos += got;
+        return (UINT)got;
+    }
+    if (session->pos >= job->size) return 0;
+
+    const size_t remaining = job->size - session->pos;
+    const size_t requested = (size_t)nbyte;
+    const size_t to_read = (requested < remaining) ? requested : remaining;
+
+    if (buff && to_read > 0) {
+        memcpy(buff, job->data + session->pos, to_read);
+    }
+
+    session->pos += to_read;
+    return (UINT)to_read;
+}
+
+// RGB888 → RGB565 for one row, packed in panel byte order
+static inline void convert_row(const uint8_t* src, uint16_t* dst, int count) {
+    for (int x = 0; x < count; x++) {
+        uint8_t r = *src++;
+        uint8_t g = *src++;
+        uint8_t b = *src++;
+
+        // RGB565: RRRR RGGG GGGB BBBB
+        dst[x] = lcd_swap16(((r & 0xF8) << 8) |   // Red in high bits
+                            ((g & 0xFC) << 3) |   // Green in middle
+                            (b >> 3));            // Blue in low bits
+    }
+}
+
+void strip_convert_row(const uint8_t* rgb888, uint16_t* dst, int count) {
+    convert_row(rgb888, dst, count);
+}
+
+// TJpgDec output function - convert RGB888→RGB565 and pass it on
+// TJpgDec hands over one MCU block per call, left to right, top to bottom.
+//   block: convert the block and hand it to the sink as is
+//   band:  place the block into the MCU-row band buffer; hand over the band
+//          when the block at the right edge of the image arrives
+static UINT jpeg_output_func(JDEC* jd, void* bitmap, JRECT* rect) {
+    TjpgdSession* session = (TjpgdSession*)jd->device;
+    const uint8_t* src = (const uint8_t*)bitmap;
+
+    if (!session || !session->pixel_buffer) {
+        Logger.logMessage("TJpgDec", "ERROR: Invalid context or pixel_buffer");
+        return 0;
+    }
+
+    const int block_w = rect->right - rect->left + 1;
+    const int block_h = rect->bottom - rect->top + 1;
+    if (block_h > TjpgdDecoder::MAX_MCU_LINES) {
+        Logger.logMessagef("TJpgDec", "ERROR: block height %d > %d", block_h, TjpgdDecoder::MAX_MCU_LINES);
+        return 0;
+    }
+
+    if (session->block_output) {
+        if (block_w > TjpgdDecoder::MAX_MCU_LINES) {
+            Logger.logMessagef("TJpgDec", "ERROR: block width %d > %d", block_w, TjpgdDecoder::MAX_MCU_LINES);
+            return 0;
+        }
+        convert_row(src, session->pixel_buffer, block_w * block_h);
+        return session->sink(session->sink_ctx, rect->left, rect->top, block_w, block_h, session->pixel_buffer) ? 1 : 0;
+    }
+
+    // Band: rows of this block land at column rect->left of the band
+    if (rect->right >= session->buffer_width) {
+        Logger.logMessagef("TJpgDec", "ERROR: block right %d >= buffer_width %d", rect->right, session->buffer_width);
+        return 0;
+    }
+    for (int y = 0; y < block_h; y++) {
+        convert_row(src, session->pixel_buffer + y * session->out_width + rect->left, block_w);
+        src += block_w * 3;
+    }
+
+    if (rect->right == session->out_width - 1) {
+        // Band complete: the whole MCU row goes out in one piece
+        if (!session->sink(session->sink_ctx, 0, rect->top, session->out_width, block_h, session->pixel_buffer)) {
+            return 0;
+        }
+    }
+
+    return 1;  // Continue decoding
+}
+
+bool TjpgdDecoder::begin(int max_width) {
+    // Re-begin without end(): drop the previous session's buffers first
+    end();
+
+    // Band output needs room for the tallest MCU row (16 lines for 4:2:0); the
+    // actual band height follows the MCU height of each JPEG
+    if (block_output) {
+        pixel_buffer_bytes = MAX_MCU_LINES * MAX_MCU_LINES * sizeof(uint16_t);
+    } else {
+        pixel_buffer_bytes = (size_t)max_width * MAX_MCU_LINES * sizeof(uint16_t);
+    }
+    // Pixels go to the panel by SPI DMA: keep them out of PSRAM
+    work = malloc(WORK_SIZE);
+    pixel_buffer = (uint16_t*)mem_alloc_dma(pixel_buffer_bytes);
+    if (!work || !pixel_buffer) {
+        Logger.logMessagef("TJpgDec", "ERROR: Failed to allocate decode buffers (%u bytes)",
+                          (unsigned)(WORK_SIZE + pixel_buffer_bytes));
+        end();
+        return false;
+    }
+    buffer_width = max_width;
+    return true;
+}
+
+void TjpgdDecoder::end() {
+    free(pixel_buffer);
+    free(work);
+    pixel_buffer = nullptr;
+    pixel_buffer_bytes = 0;
+    work = nullptr;
+    buffer_width = 0;
+}
+
+bool TjpgdDecoder::decode(const JpegDecodeJob& job, JpegPixelSink sink, void* sink_ctx, JpegDecodeInfo* info) {
+    if (!work || !pixel_buffer) {
+        Logger.logMessage("TJpgDec", "ERROR: decode called without begin()");
+        return false;
+    }
+
+    JDEC jdec;
+    JRESULT res;
+
+    TjpgdSession session = {&job, 0, sink, sink_ctx, pixel_buffer, buffer_width, 0, block_output};
+
+    // Prepare decoder
+    res = jd_prepare(&jdec, jpeg_input_func, work, (UINT)WORK_SIZE, &session);
+    if (res != JDR_OK) {
+        Logger.logMessagef("TJpgDec", "ERROR: jd_prepare failed: %d", res);
+        return false;
+    }
+
+    // Band geometry comes from the JPEG itself: full (scaled) width, MCU height
+    // (msy * 8 >> scale) lines per band. The source must be a multiple of
+    // 2^scale so TJpgDec's per-MCU rounding adds up to exactly the output size.
+    const uint8_t scale = job.scale;
+    const int out_width = jdec.width >> scale;
+    const int out_height = jdec.height >> scale;
+    const int mask = (1 << scale) - 1;
+    if (out_width > job.max_width || out_width > buffer_width || (jdec.width & mask) || (jdec.height & mask) ||
+        jdec.msy * 8 > MAX_MCU_LINES) {
+        Logger.logMessagef("TJpgDec", "ERROR: JPEG is %dx%d (MCU %dx%d, 1/%d), max width %d",
+                          jdec.width, jdec.height, jdec.msx * 8, jdec.msy * 8, 1 << scale, job.max_width);
+        return false;
+    }
+    session.out_width = out_width;
+    info->width = out_width;
+    info->height = out_height;
+
+    // Decompress and hand the pixels to the sink
+    res = jd_decomp(&jdec, jpeg_output_func, (BYTE)scale);
+    info->bytes_read = session.pos;
+    if (res != JDR_OK) {
+        Logger.logMessagef("TJpgDec", "ERROR: jd_decomp failed: %d", res);
+        return false;
+    }
+    return true;
+}
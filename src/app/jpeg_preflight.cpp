@@ -121,7 +121,8 @@ bool jpeg_preflight_tjpgd_supported(
     int expected_width,
     int expected_height,
     char* err,
-    size_t err_sz
+    size_t err_sz,
+    uint8_t scale
 ) {
     JpegSofInfo info;
     if (!jpeg_parse_sof_best_effort(data, size, info) || !info.found) {
@@ -129,9 +130,15 @@ bool jpeg_preflight_tjpgd_supported(
         return false;
     }
 
-    if ((int)info.width != expected_width || (int)info.height != expected_height) {
-        snprintf(err, err_sz, "Unsupported JPEG dimensions: got %ux%u, expected %dx%d",
-                 (unsigned)info.width, (unsigned)info.height, expected_width, expected_height);
+    if ((int)info.width != (expected_width << scale) || (int)info.height != (expected_height << scale)) {
+        if (scale) {
+            snprintf(err, err_sz, "Unsupported JPEG dimensions: got %ux%u, expected %dx%d for 1/%d scale",
+                     (unsigned)info.width, (unsigned)info.height,
+                     expected_width << scale, expected_height << scale, 1 << scale);
+        } else {
+            snprintf(err, err_sz, "Unsupported JPEG dimensions: got %ux%u, expected %dx%d",
+                     (unsigned)info.width, (unsigned)info.height, expected_width, expected_height);
+        }
         return false;
     }
 
@@ -145,7 +152,8 @@ bool jpeg_preflight_tjpgd_fragment_supported(
     int max_height,
     int panel_max_height,
     char* err,
-    size_t err_sz
+    size_t err_sz,
+    uint8_t scale
 ) {
     JpegSofInfo info;
     if (!jpeg_parse_sof_best_effort(data, size, info) || !info.found) {
@@ -153,16 +161,54 @@ bool jpeg_preflight_tjpgd_fragment_supported(
         return false;
     }
 
-    if ((int)info.width != expected_width) {
-        snprintf(err, err_sz, "Unsupported JPEG fragment width: got %u, expected %d", (unsigned)info.width, expected_width);
+    if ((int)info.width != (expected_width << scale)) {
+        snprintf(err, err_sz, "Unsupported JPEG fragment width: got %u, expected %d",
+                 (unsigned)info.width, expected_width << scale);
         return false;
     }
 
     const int h = (int)info.height;
-    if (h <= 0 || h > max_height || h > panel_max_height) {
-        snprintf(err, err_sz, "Unsupported JPEG fragment height: got %u (max %d)", (unsigned)info.height, max_height);
+    const int limit = (max_height < panel_max_height ? max_height : panel_max_height) << scale;
+    if (h <= 0 || h > limit) {
+        snprintf(err, err_sz, "Unsupported JPEG fragment height: got %u (max %d)", (unsigned)info.height, limit);
+        return false;
+    }
+    if (h & ((1 << scale) - 1)) {
+        snprintf(err, err_sz, "Unsupported JPEG fragment height: %u is not a multiple of %d", (unsigned)info.height, 1 << scale);
+        return false;
+    }
+
+    return jpeg_preflight_common(info, err, err_sz);
+}
+
+bool jpeg_preflight_tjpgd_tile_supported(
+    const uint8_t* data,
+    size_t size,
+    int max_width,
+    int max_height,
+    int* width,
+    int* height,
+    char* err,
+    size_t err_sz
+) {
+    JpegSofInfo info;
+    if (!jpeg_parse_sof_best_effort(data, size, info) || !info.found) {
+        snprintf(err, err_sz, "Invalid JPEG header (missing SOF marker)");
         return false;
     }
 
+    if (info.width == 0 || info.height == 0 || (int)info.width > max_width || (int)info.height > max_height) {
+        snprintf(err, err_sz, "Tile does not fit: got %ux%u, max %dx%d at this position",
+                 (unsigned)info.width, (unsigned)info.height, max_width, max_height);
+        return false;
+    }
+
+    if (width) *width = info.width;
+    if (height) *height = info.height;
     return jpeg_preflight_common(info, err, err_sz);
 }
+
+bool jpeg_preflight_has_sof(const uint8_t* data, size_t size) {
+    JpegSofInfo info;
+    return jpeg_parse_sof_best_effort(data, size, info) && info.found;
+}
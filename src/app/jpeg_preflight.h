@@ -8,18 +8,23 @@
 
 // Validates a full-frame JPEG against exact dimensions.
 // Returns true if the JPEG header looks compatible, else writes a human-friendly error.
+// scale: the JPEG is decoded at 1/2^scale (0..3), so it must be exactly
+// expected size << scale.
 bool jpeg_preflight_tjpgd_supported(
     const uint8_t* data,
     size_t size,
     int expected_width,
     int expected_height,
     char* err,
-    size_t err_sz
+    size_t err_sz,
+    uint8_t scale = 0
 );
 
 // Validates a JPEG fragment (strip) against expected width and height bounds.
 // max_height is typically the remaining image height for this fragment.
 // panel_max_height is the display panel height cap.
+// All sizes are decoded (output) pixels; with scale the fragment must be
+// expected_width << scale wide and its height a multiple of 2^scale.
 bool jpeg_preflight_tjpgd_fragment_supported(
     const uint8_t* data,
     size_t size,
@@ -27,5 +32,23 @@ bool jpeg_preflight_tjpgd_fragment_supported(
     int max_height,
     int panel_max_height,
     char* err,
+    size_t err_sz,
+    uint8_t scale = 0
+);
+
+// Validates a JPEG tile (partial update) that must fit within max_width x max_height
+// (the panel area right of / below its placement). Reports the tile size.
+bool jpeg_preflight_tjpgd_tile_supported(
+    const uint8_t* data,
+    size_t size,
+    int max_width,
+    int max_height,
+    int* width,
+    int* height,
+    char* err,
     size_t err_sz
 );
+
+// True if the buffer already contains the SOF segment (used to decide whether a
+// preflight on the first bytes of a streamed upload is conclusive).
+bool jpeg_preflight_has_sof(const uint8_t* data, size_t size);
@@ -0,0 +1,231 @@
+/*
+ * JSON Path Extractor Implementation
+ *
+ * A minimal pull scanner: matching descends only along the compiled path
+ * (recursion depth <= JSON_PATH_MAX_TOKENS); everything else is skipped
+ * iteratively, so hostile nesting in a payload cannot grow the stack.
+ */
+
+#include "json_path.h"
+#include <math.h>
+#include <string.h>
+
+struct Scanner {
+    const char* p;
+    const char* end;
+};
+
+static void skip_ws(Scanner& s) {
+    while (s.p < s.end && (*s.p == ' ' || *s.p == '\t' || *s.p == '\n' || *s.p == '\r')) s.p++;
+}
+
+static bool consume(Scanner& s, char c) {
+    skip_ws(s);
+    if (s.p < s.end && *s.p == c) {
+        s.p++;
+        return true;
+    }
+    return false;
+}
+
+// At an opening quote: step past the closing one
+static bool skip_string(Scanner& s) {
+    s.p++;
+    while (s.p < s.end) {
+        const char c = *s.p++;
+        if (c == '\\') {
+            if (s.p >= s.end) return false;
+            s.p++;
+        } else if (c == '"') {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Skip one value (scalar, string or container); stops at the delimiter after it
+static bool skip_value(Scanner& s) {
+    int depth = 0;
+    skip_ws(s);
+    while (s.p < s.end) {
+        const char c = *s.p;
+        if (c == '"') {
+            if (!skip_string(s)) return false;
+            if (depth == 0) return true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+            s.p++;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) return true;  // end of the enclosing container
+            depth--;
+            s.p++;
+            if (depth == 0) return true;
+        } else if (c == ',' && depth == 0) {
+            return true;
+        } else {
+            s.p++;
+        }
+    }
+    return depth == 0;
+}
+
+// JSON number grammar (lenient: leading '+' and zeros accepted)
+static bool parse_number(Scanner& s, float* out) {
+    const char* p = s.p;
+    bool negative = false;
+    if (p < s.end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    double value = 0.0;
+    int digits = 0;
+    while (p < s.end && *p >= '0' && *p <= '9') {
+        value = value * 10.0 + (*p++ - '0');
+        digits++;
+    }
+    if (p < s.end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < s.end && *p >= '0' && *p <= '9') {
+            value += (*p++ - '0') * scale;
+            scale *= 0.1;
+            digits++;
+        }
+    }
+    if (digits == 0) return false;
+
+    if (p < s.end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < s.end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            p++;
+        }
+        int exponent = 0;
+        while (p < s.end && *p >= '0' && *p <= '9') {
+            if (exponent < 400) exponent = exponent * 10 + (*p - '0');
+            p++;
+        }
+        value *= pow(10.0, exp_negative ? -exponent : exponent);
+    }
+
+    s.p = p;
+    *out = (float)(negative ? -value : value);
+    return true;
+}
+
+// Value at the end of the path: number or numeric string
+static bool parse_leaf(Scanner& s, float* out) {
+    skip_ws(s);
+    if (s.p >= s.end) return false;
+    if (*s.p != '"') return parse_number(s, out);
+
+    Scanner inner = {s.p + 1, s.end};
+    skip_ws(inner);
+    return parse_number(inner, out) && (skip_ws(inner), inner.p < inner.end && *inner.p == '"');
+}
+
+static bool match(Scanner& s, const JsonPath& path, uint8_t depth, float* out) {
+    if (depth == path.count) return parse_leaf(s, out);
+
+    const JsonPathToken& tok = path.tokens[depth];
+    if (tok.index >= 0) {
+        if (!consume(s, '[')) return false;
+        if (consume(s, ']')) return false;
+        for (int i = 0;; i++) {
+            if (i == tok.index) return match(s, path, depth + 1, out);
+            if (!skip_value(s)) return false;
+            if (!consume(s, ',')) return false;  // ']' or garbage: index past the end
+        }
+    }
+
+    if (!consume(s, '{')) return false;
+    if (consume(s, '}')) return false;
+    const char* key = path.keys + tok.key_offset;
+    for (;;) {
+        skip_ws(s);
+        if (s.p >= s.end || *s.p != '"') return false;
+        const char* name = s.p + 1;
+        if (!skip_string(s)) return false;
+        const size_t name_len = (size_t)(s.p - 1 - name);
+        if (!consume(s, ':')) return false;
+
+        if (name_len == tok.key_len && memcmp(name, key, name_len) == 0) {
+            return match(s, path, depth + 1, out);
+        }
+        if (!skip_value(s)) return false;
+        if (!consume(s, ',')) return false;  // '}': key not present
+    }
+}
+
+bool json_path_compile(JsonPath* path, const char* spec) {
+    *path = JsonPath();
+    if (!spec) return false;
+
+    if (strcmp(spec, ".") == 0 || spec[0] == '\0') {
+        path->raw = true;
+        path->valid = true;
+        return true;
+    }
+
+    size_t key_used = 0;
+    const char* p = spec;
+    if (*p == '.') p++;  // optional leading dot (".power")
+
+    while (*p) {
+        if (path->count == JSON_PATH_MAX_TOKENS) return false;
+        JsonPathToken& tok = path->tokens[path->count];
+
+        if (*p == '[') {
+            p++;
+            int index = 0;
+            int digits = 0;
+            while (*p >= '0' && *p <= '9') {
+                index = index * 10 + (*p++ - '0');
+                if (index > 32767) return false;
+                digits++;
+            }
+            if (digits == 0 || *p != ']') return false;
+            p++;
+            tok.index = (int16_t)index;
+            tok.key_offset = 0;
+            tok.key_len = 0;
+        } else {
+            const char* start = p;
+            while (*p && *p != '.' && *p != '[') p++;
+            const size_t len = (size_t)(p - start);
+            if (len == 0 || key_used + len > JSON_PATH_MAX_LEN) return false;
+            memcpy(path->keys + key_used, start, len);
+            tok.index = -1;
+            tok.key_offset = (uint8_t)key_used;
+            tok.key_len = (uint8_t)len;
+            key_used += len;
+        }
+        path->count++;
+
+        if (*p == '.') {
+            p++;
+            if (*p == '\0') return false;  // trailing dot
+        }
+    }
+
+    path->valid = true;
+    return true;
+}
+
+bool json_path_extract(const JsonPath& path, const char* payload, size_t len, float* out) {
+    if (!path.valid || !payload) return false;
+
+    Scanner s = {payload, payload + len};
+    float value;
+    if (path.raw) {
+        if (!parse_leaf(s, &value)) return false;
+    } else if (!match(s, path, 0, &value)) {
+        return false;
+    }
+
+    if (isnan(value) || isinf(value)) return false;
+    *out = value;
+    return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * JSON Path Extractor
+ *
+ * Pulls one number out of a JSON payload without building a document: the path
+ * is compiled once into tokens, then the payload is scanned in place (no copy,
+ * no heap, no null terminator needed). Siblings of the path are skipped without
+ * being parsed; the scan stops as soon as the value is found.
+ *
+ * Path syntax:
+ *   "."                 whole payload is a plain number (e.g. "1.234")
+ *   "power"             top-level key
+ *   "sensor.power"      nested objects
+ *   "phases[1].power"   array index (0-based)
+ *   "[0]"               payload is an array
+ *
+ * Values may be JSON numbers or numeric strings ("1.5"). Keys are compared
+ * byte for byte (escape sequences in keys are not decoded).
+ */
+
+#ifndef JSON_PATH_H
+#define JSON_PATH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_PATH_MAX_TOKENS 8
+#define JSON_PATH_MAX_LEN 32
+
+struct JsonPathToken {
+    int16_t index;       // >= 0: array index; -1: object key
+    uint8_t key_offset;  // key position in JsonPath::keys
+    uint8_t key_len;
+};
+
+struct JsonPath {
+    bool valid = false;
+    bool raw = false;    // "." : payload is the number itself
+    uint8_t count = 0;
+    JsonPathToken tokens[JSON_PATH_MAX_TOKENS];
+    char keys[JSON_PATH_MAX_LEN];
+};
+
+// Compile a path spec; returns false (and an invalid path) on syntax errors
+bool json_path_compile(JsonPath* path, const char* spec);
+
+// Extract the number at path from payload[0..len); false if absent or not numeric
+bool json_path_extract(const JsonPath& path, const char* payload, size_t len, float* out);
+
+#endif // JSON_PATH_H
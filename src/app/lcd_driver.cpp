@@ -1,19 +1,219 @@
 #include "lcd_driver.h"
+#include "perf_counters.h"
+#include <driver/spi_master.h>
+#include <esp_attr.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <hal/gpio_ll.h>
+#include <soc/gpio_struct.h>
+
+// ESP-IDF spi_master with DMA. The Arduino SPIClass path sent one byte per
+// transfer() call with CS/DC toggled through digitalWrite, so a full frame cost
+// ~134k calls. Here every command/parameter group/pixel buffer is one transaction.
+// CS is framed by the peripheral; DC is a single store to the GPIO set/clear
+// register from the pre-transfer callback (pin fixed at compile time, so
+// gpio_ll folds to the right register for esp32 and esp32c3 alike).
+//
+// Host selection: the classic ESP32 routes the default LCD pins (18/23) natively
+// on VSPI (SPI3_HOST); every other target only exposes SPI2_HOST as general SPI.
+#ifndef LCD_SPI_HOST
+#if defined(CONFIG_IDF_TARGET_ESP32)
+#define LCD_SPI_HOST SPI3_HOST
+#else
+#define LCD_SPI_HOST SPI2_HOST
+#endif
+#endif
+
+// Rotation is done by the controller's address mapping: MADCTL picks which RAM
+// axis the column/row counters walk and in which direction, and the window
+// offsets follow the visible area to wherever that puts it in the 240x320 RAM
+// (LCD_X_OFFSET/LCD_Y_OFFSET are its portrait position; a mirrored axis counts
+// from the other end). The mappings match what LVGL's sw_rotate used to produce.
+#define LCD_RAM_WIDTH  240
+#define LCD_RAM_HEIGHT 320
+#define LCD_X_OFFSET_MIRRORED (LCD_RAM_WIDTH - LCD_WIDTH - LCD_X_OFFSET)
+#define LCD_Y_OFFSET_MIRRORED (LCD_RAM_HEIGHT - LCD_HEIGHT - LCD_Y_OFFSET)
+
+#if LCD_ROTATION == 1
+// (x, y) -> portrait (y, LCD_HEIGHT - 1 - x)
+#define LCD_MADCTL_ROTATION (ST7789_MADCTL_MY | ST7789_MADCTL_MV)
+static constexpr uint16_t WINDOW_X_OFFSET = LCD_Y_OFFSET_MIRRORED;
+static constexpr uint16_t WINDOW_Y_OFFSET = LCD_X_OFFSET;
+#elif LCD_ROTATION == 2
+// (x, y) -> portrait (LCD_WIDTH - 1 - x, LCD_HEIGHT - 1 - y)
+#define LCD_MADCTL_ROTATION (ST7789_MADCTL_MX | ST7789_MADCTL_MY)
+static constexpr uint16_t WINDOW_X_OFFSET = LCD_X_OFFSET_MIRRORED;
+static constexpr uint16_t WINDOW_Y_OFFSET = LCD_Y_OFFSET_MIRRORED;
+#elif LCD_ROTATION == 3
+// (x, y) -> portrait (LCD_WIDTH - 1 - y, x)
+#define LCD_MADCTL_ROTATION (ST7789_MADCTL_MX | ST7789_MADCTL_MV)
+static constexpr uint16_t WINDOW_X_OFFSET = LCD_Y_OFFSET;
+static constexpr uint16_t WINDOW_Y_OFFSET = LCD_X_OFFSET_MIRRORED;
+#else
+#define LCD_MADCTL_ROTATION 0x00
+static constexpr uint16_t WINDOW_X_OFFSET = LCD_X_OFFSET;
+static constexpr uint16_t WINDOW_Y_OFFSET = LCD_Y_OFFSET;
+#endif
+
+static spi_device_handle_t lcd_spi = nullptr;
+
+// Serializes bus users across tasks (LVGL flush on the render task, strip decode on
+// the image decode task). Recursive so locked helpers can call each other.
+static SemaphoreHandle_t lcd_mutex = nullptr;
+
+void lcd_lock() {
+    if (lcd_mutex) xSemaphoreTakeRecursive(lcd_mutex, portMAX_DELAY);
+}
+
+void lcd_unlock() {
+    if (lcd_mutex) xSemaphoreGiveRecursive(lcd_mutex);
+}
+
+// Transaction user word: bit 0 = DC level (0 = command, 1 = data),
+// bit 1 = last transaction of an async batch (fire the completion callback).
+#define LCD_TRANS_DC    0x01
+#define LCD_TRANS_LAST  0x02
+
+// Async batch: up to 5 window transactions (3 commands + 2 parameter groups) plus
+// the pixel chunks. Sized so one full draw buffer fits in a single batch.
+#define LCD_ASYNC_MAX_CHUNKS \
+    (((LCD_LOGICAL_WIDTH * LCD_DRAW_BUF_LINES * 2) + LCD_SPI_MAX_TRANSFER_BYTES - 1) / LCD_SPI_MAX_TRANSFER_BYTES)
+#define LCD_ASYNC_MAX_TRANS (5 + LCD_ASYNC_MAX_CHUNKS)
+
+static spi_transaction_t async_trans[LCD_ASYNC_MAX_TRANS];
+static int async_inflight = 0;
+static lcd_done_cb_t async_done_cb = nullptr;
+static void *async_done_arg = nullptr;
+
+// Runs right before each transaction is clocked out so DC switches in lockstep
+// with the hardware-driven CS.
+static void IRAM_ATTR lcd_spi_pre_transfer_cb(spi_transaction_t *t) {
+    gpio_ll_set_level(&GPIO, LCD_DC_PIN, (uint32_t)((intptr_t)t->user & LCD_TRANS_DC));
+}
+
+// Runs from the SPI interrupt after each transaction. The bus interrupt is not
+// allocated with ESP_INTR_FLAG_IRAM, so it is masked while flash is busy and the
+// completion callback may live in flash.
+static void IRAM_ATTR lcd_spi_post_transfer_cb(spi_transaction_t *t) {
+    if (((intptr_t)t->user & LCD_TRANS_LAST) && async_done_cb) {
+        async_done_cb(async_done_arg);
+    }
+}
+
+void lcd_wait_idle() {
+    lcd_lock();
+    spi_transaction_t *done = nullptr;
+    while (async_inflight > 0) {
+        spi_device_get_trans_result(lcd_spi, &done, portMAX_DELAY);
+        async_inflight--;
+    }
+    lcd_unlock();
+}
+
+// Short command/parameter writes: data lives in the transaction itself (no DMA
+// descriptor setup), polled because waiting on an interrupt costs more than the
+// few bytes on the wire.
+static void lcd_send_small(const uint8_t *data, size_t len, int dc) {
+    if (len == 0) return;
+    lcd_wait_idle();  // polling transactions must not overlap queued ones
+    perf_count_spi_bytes(len);
+
+    spi_transaction_t t = {};
+    t.length = len * 8;
+    t.user = (void *)(intptr_t)dc;
+    if (len <= 4) {
+        t.flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t.tx_data, data, len);
+    } else {
+        t.tx_buffer = data;
+    }
+    spi_device_polling_transmit(lcd_spi, &t);
+}
 
-static SPIClass *spi = &SPI;
+// Bulk pixel writes: one DMA transaction per max_transfer_sz chunk. Blocking, but
+// the calling task sleeps on the transfer-done semaphore instead of spinning.
+static void lcd_send_bulk(const uint8_t *data, size_t len) {
+    lcd_wait_idle();
+    perf_count_spi_bytes(len);
+    while (len > 0) {
+        const size_t chunk = (len > LCD_SPI_MAX_TRANSFER_BYTES) ? LCD_SPI_MAX_TRANSFER_BYTES : len;
+
+        spi_transaction_t t = {};
+        t.length = chunk * 8;
+        t.tx_buffer = data;
+        t.user = (void *)LCD_TRANS_DC;
+        spi_device_transmit(lcd_spi, &t);
+
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+// Window transactions, shared by the blocking and the async path
+static void trans_cmd(spi_transaction_t *t, uint8_t cmd) {
+    memset(t, 0, sizeof(*t));
+    t->length = 8;
+    t->flags = SPI_TRANS_USE_TXDATA;
+    t->tx_data[0] = cmd;
+    t->user = (void *)0;
+}
+
+static void trans_range(spi_transaction_t *t, uint16_t start, uint16_t end) {
+    memset(t, 0, sizeof(*t));
+    t->length = 32;
+    t->flags = SPI_TRANS_USE_TXDATA;
+    t->tx_data[0] = (uint8_t)(start >> 8);
+    t->tx_data[1] = (uint8_t)(start & 0xFF);
+    t->tx_data[2] = (uint8_t)(end >> 8);
+    t->tx_data[3] = (uint8_t)(end & 0xFF);
+    t->user = (void *)LCD_TRANS_DC;
+}
+
+// Column/row range last sent to the controller, (start << 16) | end in RAM
+// coordinates (lcd_lock held). RAMWR restarts at the window origin, so an
+// unchanged CASET/RASET is skipped: full-width strip bands and repeated LVGL
+// areas only send RAMWR.
+#define LCD_WINDOW_UNKNOWN 0xFFFFFFFFu
+static uint32_t window_cols = LCD_WINDOW_UNKNOWN;
+static uint32_t window_rows = LCD_WINDOW_UNKNOWN;
+
+// Fill t[] (room for 5) with the transactions that select a logical window and
+// start RAMWR; returns their count. *bytes: bytes they put on the bus.
+static int window_transactions(spi_transaction_t *t, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                               size_t *bytes) {
+    const uint32_t cols = ((uint32_t)(x0 + WINDOW_X_OFFSET) << 16) | (uint16_t)(x1 + WINDOW_X_OFFSET);
+    const uint32_t rows = ((uint32_t)(y0 + WINDOW_Y_OFFSET) << 16) | (uint16_t)(y1 + WINDOW_Y_OFFSET);
+    int n = 0;
+    *bytes = 1;
+    if (cols != window_cols) {
+        trans_cmd(&t[n++], ST7789_CASET);
+        trans_range(&t[n++], (uint16_t)(cols >> 16), (uint16_t)cols);
+        window_cols = cols;
+        *bytes += 5;
+    }
+    if (rows != window_rows) {
+        trans_cmd(&t[n++], ST7789_RASET);
+        trans_range(&t[n++], (uint16_t)(rows >> 16), (uint16_t)rows);
+        window_rows = rows;
+        *bytes += 5;
+    }
+    trans_cmd(&t[n++], ST7789_RAMWR);
+    return n;
+}
 
 void lcd_write_command(uint8_t cmd) {
-    digitalWrite(LCD_DC_PIN, LOW);
-    digitalWrite(LCD_CS_PIN, LOW);
-    spi->transfer(cmd);
-    digitalWrite(LCD_CS_PIN, HIGH);
+    // Raw window commands: the parameters that follow are not tracked
+    if (cmd == ST7789_CASET) window_cols = LCD_WINDOW_UNKNOWN;
+    if (cmd == ST7789_RASET) window_rows = LCD_WINDOW_UNKNOWN;
+    lcd_send_small(&cmd, 1, 0);
 }
 
 void lcd_write_data(uint8_t data) {
-    digitalWrite(LCD_DC_PIN, HIGH);
-    digitalWrite(LCD_CS_PIN, LOW);
-    spi->transfer(data);
-    digitalWrite(LCD_CS_PIN, HIGH);
+    lcd_send_small(&data, 1, 1);
+}
+
+void lcd_write_data_bytes(const uint8_t *data, size_t len) {
+    lcd_send_small(data, len, 1);
 }
 
 void lcd_set_backlight(uint8_t brightness) {
@@ -22,92 +222,148 @@ void lcd_set_backlight(uint8_t brightness) {
     analogWrite(LCD_BL_PIN, (brightness * 255) / 100);
 }
 
+// One wait and one bus acquisition for the whole polled sequence, with CS held
+// low from the first command to RAMWR (DC can only flip between transactions)
 void lcd_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-    // 1.69" module uses 20px Y offset (panel always in portrait mode)
-    const uint16_t y_offset = 20;
-    const uint16_t x_offset = 0;
-
-    lcd_write_command(ST7789_CASET);
-    lcd_write_data((x0 + x_offset) >> 8);
-    lcd_write_data((x0 + x_offset) & 0xFF);
-    lcd_write_data((x1 + x_offset) >> 8);
-    lcd_write_data((x1 + x_offset) & 0xFF);
-
-    lcd_write_command(ST7789_RASET);
-    lcd_write_data((y0 + y_offset) >> 8);
-    lcd_write_data((y0 + y_offset) & 0xFF);
-    lcd_write_data((y1 + y_offset) >> 8);
-    lcd_write_data((y1 + y_offset) & 0xFF);
+    lcd_lock();
+    lcd_wait_idle();
+
+    spi_transaction_t t[5];
+    size_t bytes;
+    const int n = window_transactions(t, x0, y0, x1, y1, &bytes);
+    perf_count_spi_bytes(bytes);
+
+    spi_device_acquire_bus(lcd_spi, portMAX_DELAY);
+    for (int i = 0; i < n; i++) {
+        if (i < n - 1) t[i].flags |= SPI_TRANS_CS_KEEP_ACTIVE;
+        spi_device_polling_transmit(lcd_spi, &t[i]);
+    }
+    spi_device_release_bus(lcd_spi);
 
-    lcd_write_command(ST7789_RAMWR);
+    lcd_unlock();
 }
 
 void lcd_fill_screen(uint16_t color) {
-    lcd_set_window(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
+    // A few pre-swapped rows, re-sent until the window is full
+    static const int FILL_LINES = 8;
+    static DMA_ATTR uint16_t fill_buf[LCD_LOGICAL_WIDTH * FILL_LINES];
 
-    digitalWrite(LCD_DC_PIN, HIGH);
-    digitalWrite(LCD_CS_PIN, LOW);
+    lcd_lock();
 
-    uint8_t hi = (uint8_t)(color >> 8);
-    uint8_t lo = (uint8_t)(color & 0xFF);
+    const uint16_t be = lcd_swap16(color);
+    for (uint32_t i = 0; i < (uint32_t)LCD_LOGICAL_WIDTH * FILL_LINES; i++) {
+        fill_buf[i] = be;
+    }
 
-    for (uint32_t i = 0; i < (uint32_t)LCD_WIDTH * LCD_HEIGHT; i++) {
-        spi->transfer(hi);
-        spi->transfer(lo);
+    lcd_set_window(0, 0, LCD_LOGICAL_WIDTH - 1, LCD_LOGICAL_HEIGHT - 1);
+
+    for (int y = 0; y < LCD_LOGICAL_HEIGHT; y += FILL_LINES) {
+        const int lines = (LCD_LOGICAL_HEIGHT - y < FILL_LINES) ? (LCD_LOGICAL_HEIGHT - y) : FILL_LINES;
+        lcd_send_bulk((const uint8_t *)fill_buf, (size_t)LCD_LOGICAL_WIDTH * lines * sizeof(uint16_t));
     }
 
-    digitalWrite(LCD_CS_PIN, HIGH);
+    lcd_unlock();
 }
 
-void lcd_push_colors(uint16_t *data, uint32_t len) {
-    digitalWrite(LCD_DC_PIN, HIGH);
-    digitalWrite(LCD_CS_PIN, LOW);
+void lcd_push_colors(const uint16_t *data, uint32_t len) {
+    lcd_send_bulk((const uint8_t *)data, (size_t)len * sizeof(uint16_t));
+}
 
-    for (uint32_t i = 0; i < len; i++) {
-        spi->transfer((uint8_t)(data[i] >> 8));
-        spi->transfer((uint8_t)(data[i] & 0xFF));
+static void async_queue(spi_transaction_t *t) {
+    spi_device_queue_trans(lcd_spi, t, portMAX_DELAY);
+    async_inflight++;
+}
+
+void lcd_push_pixels_async(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                           const uint16_t *pixels, uint32_t len,
+                           lcd_done_cb_t done_cb, void *arg) {
+    size_t bytes = (size_t)len * sizeof(uint16_t);
+    const int chunks = (int)((bytes + LCD_SPI_MAX_TRANSFER_BYTES - 1) / LCD_SPI_MAX_TRANSFER_BYTES);
+
+    // Larger than one batch (not expected for LVGL-sized areas): send blocking
+    if (chunks > LCD_ASYNC_MAX_CHUNKS || bytes == 0) {
+        lcd_push_pixels_at(x0, y0, x1 - x0 + 1, y1 - y0 + 1, pixels);
+        if (done_cb) done_cb(arg);
+        return;
     }
 
-    digitalWrite(LCD_CS_PIN, HIGH);
+    lcd_lock();
+
+    // Reap the previous batch; its transaction slots get reused below
+    lcd_wait_idle();
+
+    async_done_cb = done_cb;
+    async_done_arg = arg;
+
+    size_t window_bytes;
+    const int n = window_transactions(async_trans, x0, y0, x1, y1, &window_bytes);
+    for (int i = 0; i < n; i++) {
+        async_queue(&async_trans[i]);
+    }
+    perf_count_spi_bytes(window_bytes + bytes);
+
+    const uint8_t *src = (const uint8_t *)pixels;
+    for (int i = 0; i < chunks; i++) {
+        const size_t chunk = (bytes > LCD_SPI_MAX_TRANSFER_BYTES) ? LCD_SPI_MAX_TRANSFER_BYTES : bytes;
+        spi_transaction_t *t = &async_trans[n + i];
+        memset(t, 0, sizeof(*t));
+        t->length = chunk * 8;
+        t->tx_buffer = src;
+        t->user = (void *)(intptr_t)(LCD_TRANS_DC | ((i == chunks - 1) ? LCD_TRANS_LAST : 0));
+        async_queue(t);
+        src += chunk;
+        bytes -= chunk;
+    }
+
+    lcd_unlock();
 }
 
-void lcd_push_pixels_at(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels) {
+void lcd_push_pixels_at(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels) {
+    lcd_lock();
+
     // Set window to target area
     lcd_set_window(x, y, x + w - 1, y + h - 1);
-    
+
     // Push pixel data
-    digitalWrite(LCD_DC_PIN, HIGH);
-    digitalWrite(LCD_CS_PIN, LOW);
-    
-    uint32_t total = (uint32_t)w * h;
-    for (uint32_t i = 0; i < total; i++) {
-        spi->transfer((uint8_t)(pixels[i] >> 8));
-        spi->transfer((uint8_t)(pixels[i] & 0xFF));
-    }
-    
-    digitalWrite(LCD_CS_PIN, HIGH);
+    lcd_push_colors(pixels, (uint32_t)w * h);
+
+    lcd_unlock();
 }
 
 void lcd_init() {
-    pinMode(LCD_CS_PIN, OUTPUT);
     pinMode(LCD_DC_PIN, OUTPUT);
     pinMode(LCD_RST_PIN, OUTPUT);
     pinMode(LCD_BL_PIN, OUTPUT);
 
-    digitalWrite(LCD_CS_PIN, HIGH);
     digitalWrite(LCD_DC_PIN, HIGH);
 
     // Start backlight off until init completes
     analogWrite(LCD_BL_PIN, 0);
 
-    // SPI (Mode 3, MSB first) per Waveshare sample
-    spi->begin(LCD_SCK_PIN, -1, LCD_MOSI_PIN, LCD_CS_PIN);
-    spi->setDataMode(SPI_MODE3);
-    spi->setBitOrder(MSBFIRST);
-    spi->setFrequency(60000000); // 60MHz - within ST7789 spec
+    lcd_mutex = xSemaphoreCreateRecursiveMutex();
+
+    // SPI bus (write-only, DMA). Mode 3, MSB first per Waveshare sample.
+    spi_bus_config_t buscfg = {};
+    buscfg.mosi_io_num = LCD_MOSI_PIN;
+    buscfg.miso_io_num = -1;
+    buscfg.sclk_io_num = LCD_SCK_PIN;
+    buscfg.quadwp_io_num = -1;
+    buscfg.quadhd_io_num = -1;
+    buscfg.max_transfer_sz = LCD_SPI_MAX_TRANSFER_BYTES;
+    ESP_ERROR_CHECK(spi_bus_initialize(LCD_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO));
+
+    // CS is driven by the SPI peripheral so it frames each transaction exactly
+    spi_device_interface_config_t devcfg = {};
+    devcfg.mode = 3;
+    devcfg.clock_speed_hz = LCD_SPI_FREQ_HZ;
+    devcfg.spics_io_num = LCD_CS_PIN;
+    devcfg.flags = SPI_DEVICE_NO_DUMMY;
+    devcfg.queue_size = LCD_ASYNC_MAX_TRANS;
+    devcfg.pre_cb = lcd_spi_pre_transfer_cb;
+    devcfg.post_cb = lcd_spi_post_transfer_cb;
+    ESP_ERROR_CHECK(spi_bus_add_device(LCD_SPI_HOST, &devcfg, &lcd_spi));
 
     // Hardware reset (matches sample timing)
-    digitalWrite(LCD_CS_PIN, LOW);
     delay(20);
     digitalWrite(LCD_RST_PIN, LOW);
     delay(20);
@@ -115,20 +371,20 @@ void lcd_init() {
     delay(120);
 
     // ST7789V2 init sequence (from Waveshare sample)
-    // BGR mode (manufacturer default) - display_manager.cpp swaps RGB→BGR in flush callback
-    // This allows LVGL to blend colors correctly in RGB space, fixing anti-aliasing artifacts
-    lcd_write_command(0x36);
-    lcd_write_data(0x00);  // BGR mode (bit 3 = 0), portrait orientation
+    // MADCTL bit 3 = 0 takes RGB565 in R-G-B order on this module, so LVGL output
+    // (true RGB, blended in RGB space) and RGB565 strips need no channel swap.
+    // The upper bits carry LCD_ROTATION.
+    lcd_write_command(ST7789_MADCTL);
+    lcd_write_data(LCD_MADCTL_ROTATION);  // RGB order (bit 3 = 0)
 
     lcd_write_command(0x3A);
     lcd_write_data(0x05);
 
-    lcd_write_command(0xB2);
-    lcd_write_data(0x0B);
-    lcd_write_data(0x0B);
-    lcd_write_data(0x00);
-    lcd_write_data(0x33);
-    lcd_write_data(0x35);
+    {
+        static const uint8_t porch[] = {0x0B, 0x0B, 0x00, 0x33, 0x35};
+        lcd_write_command(0xB2);
+        lcd_write_data_bytes(porch, sizeof(porch));
+    }
 
     lcd_write_command(0xB7);
     lcd_write_data(0x11);
@@ -158,42 +414,27 @@ void lcd_init() {
     lcd_write_command(0xD6);
     lcd_write_data(0xA1);
 
-    lcd_write_command(0xE0);
-    lcd_write_data(0xF0);
-    lcd_write_data(0x06);
-    lcd_write_data(0x0B);
-    lcd_write_data(0x0A);
-    lcd_write_data(0x09);
-    lcd_write_data(0x26);
-    lcd_write_data(0x29);
-    lcd_write_data(0x33);
-    lcd_write_data(0x41);
-    lcd_write_data(0x18);
-    lcd_write_data(0x16);
-    lcd_write_data(0x15);
-    lcd_write_data(0x29);
-    lcd_write_data(0x2D);
-
-    lcd_write_command(0xE1);
-    lcd_write_data(0xF0);
-    lcd_write_data(0x04);
-    lcd_write_data(0x08);
-    lcd_write_data(0x08);
-    lcd_write_data(0x07);
-    lcd_write_data(0x03);
-    lcd_write_data(0x28);
-    lcd_write_data(0x32);
-    lcd_write_data(0x40);
-    lcd_write_data(0x3B);
-    lcd_write_data(0x19);
-    lcd_write_data(0x18);
-    lcd_write_data(0x2A);
-    lcd_write_data(0x2E);
-
-    lcd_write_command(0xE4);
-    lcd_write_data(0x25);
-    lcd_write_data(0x00);
-    lcd_write_data(0x00);
+    {
+        static const uint8_t gamma_pos[] = {
+            0xF0, 0x06, 0x0B, 0x0A, 0x09, 0x26, 0x29, 0x33, 0x41, 0x18, 0x16, 0x15, 0x29, 0x2D,
+        };
+        lcd_write_command(0xE0);
+        lcd_write_data_bytes(gamma_pos, sizeof(gamma_pos));
+    }
+
+    {
+        static const uint8_t gamma_neg[] = {
+            0xF0, 0x04, 0x08, 0x08, 0x07, 0x03, 0x28, 0x32, 0x40, 0x3B, 0x19, 0x18, 0x2A, 0x2E,
+        };
+        lcd_write_command(0xE1);
+        lcd_write_data_bytes(gamma_neg, sizeof(gamma_neg));
+    }
+
+    {
+        static const uint8_t gate_ctrl[] = {0x25, 0x00, 0x00};
+        lcd_write_command(0xE4);
+        lcd_write_data_bytes(gate_ctrl, sizeof(gate_ctrl));
+    }
 
     lcd_write_command(0x21);
 
@@ -2,23 +2,55 @@
 #define LCD_DRIVER_H
 
 #include <Arduino.h>
-#include <SPI.h>
 #include "board_config.h"
 
 // ST7789V2 commands
 #define ST7789_CASET   0x2A
 #define ST7789_RASET   0x2B
 #define ST7789_RAMWR   0x2C
+#define ST7789_MADCTL  0x36
+
+// MADCTL address mapping bits (row/column mirror, row/column exchange)
+#define ST7789_MADCTL_MY 0x80
+#define ST7789_MADCTL_MX 0x40
+#define ST7789_MADCTL_MV 0x20
+
+// Pixel buffers handed to lcd_push_colors()/lcd_push_pixels_at() are sent to the
+// bus as-is (one DMA transfer, no per-pixel work in the driver). They must already
+// be in panel byte order: RGB565 high byte first. Use lcd_swap16() when packing.
+static inline uint16_t lcd_swap16(uint16_t color) {
+    return (uint16_t)((color >> 8) | (color << 8));
+}
 
 void lcd_init();
 void lcd_set_backlight(uint8_t brightness);  // 0-100%
 void lcd_write_command(uint8_t cmd);
 void lcd_write_data(uint8_t data);
+void lcd_write_data_bytes(const uint8_t *data, size_t len);
+// Coordinates are logical (rotated): 0..LCD_LOGICAL_WIDTH-1, 0..LCD_LOGICAL_HEIGHT-1
 void lcd_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
-void lcd_fill_screen(uint16_t color);
-void lcd_push_colors(uint16_t *data, uint32_t len);
+void lcd_fill_screen(uint16_t color);  // color in native RGB565 (driver swaps)
+void lcd_push_colors(const uint16_t *data, uint32_t len);
+
+// Non-blocking window + pixel write. Queues CASET/RASET/RAMWR and the pixel data
+// on the SPI DMA queue and returns immediately; done_cb(arg) runs from the SPI
+// interrupt once the last byte is out. The pixel buffer must stay untouched until
+// then. Any blocking lcd_* call first waits for queued transfers to finish.
+typedef void (*lcd_done_cb_t)(void *arg);
+void lcd_push_pixels_async(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                           const uint16_t *pixels, uint32_t len,
+                           lcd_done_cb_t done_cb, void *arg);
+
+// Block until every queued async transfer has completed
+void lcd_wait_idle();
+
+// Bus ownership across tasks. lcd_fill_screen(), lcd_push_pixels_at() and
+// lcd_push_pixels_async() lock internally; hold the lock yourself only when
+// issuing lcd_set_window() + lcd_push_colors() as a pair. Recursive.
+void lcd_lock();
+void lcd_unlock();
 
 // Direct pixel writing for strip-based image display (bypasses LVGL)
-void lcd_push_pixels_at(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels);
+void lcd_push_pixels_at(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels);
 
 #endif // LCD_DRIVER_H
@@ -1,65 +1,284 @@
 /*
  * Log Manager Implementation
- * 
+ *
  * Indentation-based logger with nested blocks and automatic timing.
- * Routes output to Serial only.
+ * Lines are assembled on the caller's stack and copied into a byte ring under
+ * a short spinlock; the "log" task writes the ring to Serial.
  */
 
 #include "log_manager.h"
 #include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 
-// Initialize static members
-unsigned long LogManager::startTimes[3] = {0, 0, 0};
-uint8_t LogManager::nestLevel = 0;
+static_assert((LOG_BUFFER_BYTES & (LOG_BUFFER_BYTES - 1)) == 0, "LOG_BUFFER_BYTES must be a power of two");
+
+// Longest line (indent + module + message + timing); longer lines are truncated
+#define LOG_LINE_MAX 192
+
+// Tasks that can be inside logBegin/logEnd blocks at the same time
+#define LOG_NEST_TASKS 8
+
+// Ring: log_head counts every byte ever written; position p lives at
+// ring[p % LOG_BUFFER_BYTES] until LOG_BUFFER_BYTES newer bytes overwrite it
+static char ring[LOG_BUFFER_BYTES];
+static uint32_t log_head = 0;
+static portMUX_TYPE log_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Serializes UART output between the drain task and flush()
+static SemaphoreHandle_t drain_mutex = nullptr;
+
+// Nested block tracking, per task (a slot at level 0 is free for reuse)
+struct TaskNest {
+    TaskHandle_t task;
+    uint8_t level;                // Current nesting depth (0-2, 3+ = overflow)
+    unsigned long start[3];       // Start time for each nesting level
+};
+static TaskNest nests[LOG_NEST_TASKS] = {};
+
+static const char* const module_names[LOG_MODULE_COUNT] = {
+    "Main", "WiFi", "MQTT", "Display", "StripDecoder", "Image", "Portal", "History"
+};
 
 // Global LogManager instance
 LogManager Logger;
 
 // Constructor
 LogManager::LogManager() {
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        levels[i] = LOG_DEFAULT_LEVEL;
+    }
+#if MQTT_LOG_MESSAGES
+    levels[LOG_MODULE_MQTT] = LOG_LEVEL_DEBUG;
+#endif
 }
 
-// Initialize (sets baud rate for Serial)
+// Initialize Serial and start draining the ring (lines logged before this are kept)
 void LogManager::begin(unsigned long baud) {
     Serial.begin(baud);
+    drain_mutex = xSemaphoreCreateMutex();
+    xTaskCreate(drainTask, "log", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, nullptr);
+}
+
+// ============================================================================
+// Per-task nesting (all under log_mux; slots may be taken over by other tasks)
+// ============================================================================
+
+// Slot of the calling task; must hold log_mux. nullptr if all slots are busy.
+static TaskNest* nest_slot(bool claim) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    TaskNest* idle = nullptr;
+    for (int i = 0; i < LOG_NEST_TASKS; i++) {
+        if (nests[i].task == self) return &nests[i];
+        if (!idle && nests[i].level == 0) idle = &nests[i];
+    }
+    if (claim && idle) {
+        idle->task = self;
+    }
+    return claim ? idle : nullptr;
+}
+
+static uint8_t nest_level() {
+    portENTER_CRITICAL(&log_mux);
+    TaskNest* slot = nest_slot(false);
+    uint8_t level = slot ? slot->level : 0;
+    portEXIT_CRITICAL(&log_mux);
+    return level;
+}
+
+// Enter a block; returns the level the "Starting..." line is printed at
+static uint8_t nest_enter() {
+    const unsigned long now = millis();
+    portENTER_CRITICAL(&log_mux);
+    TaskNest* slot = nest_slot(true);
+    uint8_t level = 0;
+    if (slot) {
+        level = slot->level;
+        // Save start time if we haven't exceeded max depth
+        if (level < 3) {
+            slot->start[level] = now;
+        }
+        // Increment nesting level (but don't overflow)
+        if (slot->level < 255) {
+            slot->level++;
+        }
+    }
+    portEXIT_CRITICAL(&log_mux);
+    return level;
 }
 
-// Get indentation string based on nesting level
-const char* LogManager::indent() {
+// Leave a block; false if the task is not inside one (extra end() calls)
+static bool nest_leave(uint8_t* level, unsigned long* elapsed) {
+    const unsigned long now = millis();
+    portENTER_CRITICAL(&log_mux);
+    TaskNest* slot = nest_slot(false);
+    bool ok = slot && slot->level > 0;
+    if (ok) {
+        slot->level--;
+        *level = slot->level;
+        // 0ms if we exceeded max depth
+        *elapsed = (slot->level < 3) ? now - slot->start[slot->level] : 0;
+    }
+    portEXIT_CRITICAL(&log_mux);
+    return ok;
+}
+
+// Get indentation string for a nesting level
+static const char* indent(uint8_t level) {
     static const char* indents[] = {
         "",         // Level 0: no indent
         "  ",       // Level 1: 2 spaces
         "    ",     // Level 2: 4 spaces
         "      "    // Level 3+: 6 spaces
     };
-    
-    uint8_t level = nestLevel;
+
     if (level > 3) level = 3; // Cap at 3 for indentation
     return indents[level];
 }
 
-// Begin a log block
-void LogManager::logBegin(const char* module) {
-    print(indent());
-    print("[");
-    print(module);
-    println("] Starting...");
-    
-    // Save start time if we haven't exceeded max depth
-    if (nestLevel < 3) {
-        startTimes[nestLevel] = millis();
+// ============================================================================
+// Ring buffer
+// ============================================================================
+
+void LogManager::push(const char* data, size_t len) {
+    // A write larger than the ring keeps only its newest bytes
+    if (len > LOG_BUFFER_BYTES) {
+        data += len - LOG_BUFFER_BYTES;
+        len = LOG_BUFFER_BYTES;
+    }
+
+    portENTER_CRITICAL(&log_mux);
+    const uint32_t pos = log_head % LOG_BUFFER_BYTES;
+    const size_t first = (len < LOG_BUFFER_BYTES - pos) ? len : LOG_BUFFER_BYTES - pos;
+    memcpy(ring + pos, data, first);
+    memcpy(ring, data + first, len - first);
+    log_head += len;
+    portEXIT_CRITICAL(&log_mux);
+}
+
+// One complete line: indent, optional "[module] ", message, optional suffix
+void LogManager::pushLine(const char* module, const char* message, const char* suffix) {
+    char line[LOG_LINE_MAX];
+    int n = snprintf(line, sizeof(line) - 2, "%s%s%s%s%s%s",
+                     indent(nest_level()),
+                     module ? "[" : "", module ? module : "", module ? "] " : "",
+                     message, suffix ? suffix : "");
+    if (n < 0) return;
+    if (n > (int)sizeof(line) - 3) n = sizeof(line) - 3;
+    line[n++] = '\r';
+    line[n++] = '\n';
+    push(line, n);
+}
+
+size_t LogManager::read(uint32_t* cursor, char* out, size_t max, uint32_t* lost) {
+    portENTER_CRITICAL(&log_mux);
+    uint32_t pos = *cursor;
+    uint32_t available = log_head - pos;
+
+    // Overwritten: resume at the oldest byte, then at the next line start
+    if (available > LOG_BUFFER_BYTES) {
+        uint32_t skipped = available - LOG_BUFFER_BYTES;
+        pos = log_head - LOG_BUFFER_BYTES;
+        while (pos != log_head && ring[pos % LOG_BUFFER_BYTES] != '\n') {
+            pos++;
+            skipped++;
+        }
+        if (pos != log_head) {
+            pos++;
+            skipped++;
+        }
+        if (lost) *lost += skipped;
+        available = log_head - pos;
+    }
+
+    const size_t n = (available < max) ? available : max;
+    const uint32_t start = pos % LOG_BUFFER_BYTES;
+    const size_t first = (n < LOG_BUFFER_BYTES - start) ? n : LOG_BUFFER_BYTES - start;
+    memcpy(out, ring + start, first);
+    memcpy(out + first, ring, n - first);
+    *cursor = pos + n;
+    portEXIT_CRITICAL(&log_mux);
+    return n;
+}
+
+uint32_t LogManager::headCursor() {
+    portENTER_CRITICAL(&log_mux);
+    const uint32_t head = log_head;
+    portEXIT_CRITICAL(&log_mux);
+    return head;
+}
+
+uint32_t LogManager::oldestCursor() {
+    portENTER_CRITICAL(&log_mux);
+    const uint32_t oldest = (log_head > LOG_BUFFER_BYTES) ? log_head - LOG_BUFFER_BYTES : 0;
+    portEXIT_CRITICAL(&log_mux);
+    return oldest;
+}
+
+// Write everything new to Serial (only this blocks on the UART)
+void LogManager::drain() {
+    if (!drain_mutex) return;
+    xSemaphoreTake(drain_mutex, portMAX_DELAY);
+    char chunk[256];
+    size_t n;
+    while ((n = read(&uart_cursor, chunk, sizeof(chunk), &uart_dropped)) > 0) {
+        Serial.write((const uint8_t*)chunk, n);
     }
-    
-    // Increment nesting level (but don't overflow)
-    if (nestLevel < 255) {
-        nestLevel++;
+    xSemaphoreGive(drain_mutex);
+}
+
+void LogManager::drainTask(void* arg) {
+    LogManager* self = (LogManager*)arg;
+    for (;;) {
+        self->drain();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+    }
+}
+
+void LogManager::flush() {
+    drain();
+    Serial.flush();
+}
+
+// ============================================================================
+// Levels
+// ============================================================================
+
+void LogManager::setLevel(LogModule module, uint8_t level) {
+    if (module < 0 || module >= LOG_MODULE_COUNT) return;
+    levels[module] = (level > LOG_LEVEL_DEBUG) ? LOG_LEVEL_DEBUG : level;
+}
+
+const char* LogManager::moduleName(LogModule module) {
+    if (module < 0 || module >= LOG_MODULE_COUNT) return "?";
+    return module_names[module];
+}
+
+int LogManager::moduleFromName(const char* name) {
+    if (!name) return -1;
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        if (strcasecmp(name, module_names[i]) == 0) return i;
     }
+    return -1;
+}
+
+// ============================================================================
+// Logging API
+// ============================================================================
+
+// Begin a log block
+void LogManager::logBegin(const char* module) {
+    char line[LOG_LINE_MAX];
+    snprintf(line, sizeof(line), "%s[%s] Starting...\r\n", indent(nest_enter()), module);
+    push(line, strlen(line));
 }
 
 // Add a line to current block
 void LogManager::logLine(const char* message) {
-    print(indent());
-    println(message);
+    pushLine(nullptr, message, nullptr);
 }
 
 // Add a formatted line (printf-style)
@@ -69,66 +288,49 @@ void LogManager::logLinef(const char* format, ...) {
     va_start(args, format);
     vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
-    
-    print(indent());
-    println(buffer);
+
+    pushLine(nullptr, buffer, nullptr);
 }
 
 // End a log block
 void LogManager::logEnd(const char* message) {
-    // Decrement nesting level first (but don't underflow)
-    if (nestLevel > 0) {
-        nestLevel--;
-    } else {
+    uint8_t level;
+    unsigned long elapsed;
+    if (!nest_leave(&level, &elapsed)) {
         // Extra end() calls are ignored gracefully
         return;
     }
-    
-    // Calculate elapsed time (0ms if we exceeded max depth)
-    unsigned long elapsed = 0;
-    if (nestLevel < 3) {
-        elapsed = millis() - startTimes[nestLevel];
-    }
-    
+
     // Print end message with timing
     const char* msg = (message && strlen(message) > 0) ? message : "Done";
-    print(indent());
-    print(msg);
-    print(" (");
-    print(elapsed);
-    println("ms)");
+    char line[LOG_LINE_MAX];
+    snprintf(line, sizeof(line), "%s%s (%lums)\r\n", indent(level), msg, elapsed);
+    push(line, strlen(line));
 }
 
-// Single-line logging with timing
+// Single-line logging (timing suffix kept for output compatibility)
 void LogManager::logMessage(const char* module, const char* msg) {
-    unsigned long start = millis();
-    print(indent());
-    print("[");
-    print(module);
-    print("] ");
-    print(msg);
-    print(" (");
-    print(millis() - start);
-    println("ms)");
+    pushLine(module, msg, " (0ms)");
 }
 
 void LogManager::logMessagef(const char* module, const char* format, ...) {
-    unsigned long start = millis();
-    
     char buffer[128];
     va_list args;
     va_start(args, format);
     vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
-    
-    print(indent());
-    print("[");
-    print(module);
-    print("] ");
-    print(buffer);
-    print(" (");
-    print(millis() - start);
-    println("ms)");
+
+    pushLine(module, buffer, " (0ms)");
+}
+
+void LogManager::logLevelf(LogModule module, const char* format, ...) {
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    pushLine(moduleName(module), buffer, nullptr);
 }
 
 // Aliases for logMessage (for backward compatibility)
@@ -147,10 +349,12 @@ void LogManager::logQuickf(const char* module, const char* format, ...) {
 
 // Write single byte (required by Print class)
 size_t LogManager::write(uint8_t c) {
-    return Serial.write(c);
+    push((const char*)&c, 1);
+    return 1;
 }
 
 // Write buffer of bytes (required by Print class)
 size_t LogManager::write(const uint8_t *buffer, size_t size) {
-    return Serial.write(buffer, size);
+    push((const char*)buffer, size);
+    return size;
 }
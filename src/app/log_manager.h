@@ -1,52 +1,137 @@
 /*
- * Log Manager - Serial Logging with Formatting
- * 
+ * Log Manager - Buffered Logging with Formatting
+ *
  * Provides structured logging with:
- * - Nested blocks with automatic indentation
+ * - Nested blocks with automatic indentation (tracked per task)
  * - Automatic timing for each block
  * - Printf-style formatting
+ * - Per-module levels, filtered at compile time and at runtime
+ *
+ * Callers never wait for the UART: every call formats one complete line and
+ * copies it into a RAM ring buffer (LOG_BUFFER_BYTES). A low-priority task
+ * drains the ring to Serial. When the UART falls behind, the oldest lines are
+ * overwritten and counted as dropped instead of stalling the caller.
+ *
+ * The ring keeps what was already sent, so readers with their own cursor
+ * (read()) can replay recent history as well as follow new output.
+ *
+ * LEVELED LOGGING:
+ *   LOG_DEBUGF(LOG_MODULE_MQTT, "Received on %s", topic);
+ * prints "[MQTT] Received on ..." if the MQTT level is DEBUG. Calls above
+ * LOG_MAX_LEVEL (board_config.h) compile to nothing; calls above the module's
+ * runtime level cost one compare and never evaluate their arguments.
+ * The plain logMessage/logBegin/... methods are unfiltered (INFO).
  */
 
 #ifndef LOG_MANAGER_H
 #define LOG_MANAGER_H
 
 #include <Arduino.h>
+#include "board_config.h"
+
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN  1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+
+enum LogModule {
+    LOG_MODULE_MAIN = 0,
+    LOG_MODULE_WIFI,
+    LOG_MODULE_MQTT,
+    LOG_MODULE_DISPLAY,
+    LOG_MODULE_STRIP,
+    LOG_MODULE_IMAGE,
+    LOG_MODULE_PORTAL,
+    LOG_MODULE_HISTORY,
+    LOG_MODULE_COUNT
+};
 
 class LogManager : public Print {
 public:
     LogManager();
-    
-    // Initialize with hardware serial
+
+    // Initialize hardware serial and start the drain task
     void begin(unsigned long baud);
-    
-    // Print interface implementation (backward compatible)
+
+    // Print interface implementation (backward compatible, written to the ring as is)
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
-    
+
+    // Send everything buffered to Serial now (blocking; use before a restart)
+    void flush() override;
+
     // Nested logging with automatic timing
     void logBegin(const char* module);
     void logLine(const char* message);
     void logLinef(const char* format, ...);
     void logEnd(const char* message = nullptr);
-    
+
     // Convenience methods (begin + line + end)
     void logMessage(const char* module, const char* message);
     void logMessagef(const char* module, const char* format, ...);
-    
+
     // Single-line logging with timing (no nesting)
     void logQuick(const char* module, const char* message);
     void logQuickf(const char* module, const char* format, ...);
-    
+
+    // Leveled logging (use the LOG_* macros below)
+    void logLevelf(LogModule module, const char* format, ...);
+
+    // Runtime levels (LOG_LEVEL_*), default LOG_DEFAULT_LEVEL
+    bool enabled(LogModule module, uint8_t level) const { return level <= levels[module]; }
+    void setLevel(LogModule module, uint8_t level);
+    uint8_t getLevel(LogModule module) const { return levels[module]; }
+    static const char* moduleName(LogModule module);
+    static int moduleFromName(const char* name);  // -1 if unknown
+
+    // Ring readers. A cursor is a byte position in the log stream; start from
+    // oldestCursor() to replay the buffered history or headCursor() for new
+    // output only. Returns bytes copied. If the reader fell behind and lines
+    // were overwritten, *lost is incremented and the cursor skips to the next
+    // complete line.
+    size_t read(uint32_t* cursor, char* out, size_t max, uint32_t* lost = nullptr);
+    uint32_t headCursor();
+    uint32_t oldestCursor();
+
+    // Bytes the UART drain lost to overwrites since boot
+    uint32_t droppedBytes() const { return uart_dropped; }
+
 private:
-    // Nested block tracking
-    static unsigned long startTimes[3];  // Start time for each nesting level
-    static uint8_t nestLevel;            // Current nesting depth (0-2, 3+ = overflow)
-    
-    // Helper methods
-    const char* indent();                // Get indentation string for current level
+    uint8_t levels[LOG_MODULE_COUNT];
+    uint32_t uart_cursor = 0;
+    uint32_t uart_dropped = 0;
+
+    void push(const char* data, size_t len);
+    void pushLine(const char* module, const char* message, const char* suffix);
+    void drain();
+    static void drainTask(void* arg);
 };
 
 // Global instance (to replace Serial usage)
 extern LogManager Logger;
 
+#if LOG_MAX_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERRORF(module, ...) do { if (Logger.enabled(module, LOG_LEVEL_ERROR)) Logger.logLevelf(module, __VA_ARGS__); } while (0)
+#else
+#define LOG_ERRORF(module, ...) do {} while (0)
+#endif
+
+#if LOG_MAX_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARNF(module, ...) do { if (Logger.enabled(module, LOG_LEVEL_WARN)) Logger.logLevelf(module, __VA_ARGS__); } while (0)
+#else
+#define LOG_WARNF(module, ...) do {} while (0)
+#endif
+
+#if LOG_MAX_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFOF(module, ...) do { if (Logger.enabled(module, LOG_LEVEL_INFO)) Logger.logLevelf(module, __VA_ARGS__); } while (0)
+#else
+#define LOG_INFOF(module, ...) do {} while (0)
+#endif
+
+#if LOG_MAX_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUGF(module, ...) do { if (Logger.enabled(module, LOG_LEVEL_DEBUG)) Logger.logLevelf(module, __VA_ARGS__); } while (0)
+#else
+#define LOG_DEBUGF(module, ...) do {} while (0)
+#endif
+
 #endif // LOG_MANAGER_H
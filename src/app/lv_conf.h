@@ -27,7 +27,7 @@
 #define LV_COLOR_DEPTH 16
 
 /*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)*/
-#define LV_COLOR_16_SWAP 0  /* Disabled - we do RGB→BGR swap in flush callback instead */
+#define LV_COLOR_16_SWAP 1  /* Draw buffers are already in panel byte order: flush sends them as-is */
 
 /*Enable features to draw on transparent background.
  *It's required if opa, and transform_* style properties are used.
@@ -46,7 +46,10 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 0
+/*Custom: heap_caps_malloc_prefer() with capability hints, so LVGL can use PSRAM when the board has it.
+ *Allocations below LV_MEM_CUSTOM_PSRAM_MIN bytes (objects, styles) try internal RAM first,
+ *larger ones (SJPG decode buffers, image caches) try PSRAM first; each falls back to the other.*/
+#define LV_MEM_CUSTOM 1
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
     #define LV_MEM_SIZE (48U * 1024U)          /*[bytes]*/
@@ -60,10 +63,15 @@
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
-    #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
-    #define LV_MEM_CUSTOM_ALLOC   malloc
-    #define LV_MEM_CUSTOM_FREE    free
-    #define LV_MEM_CUSTOM_REALLOC realloc
+    #define LV_MEM_CUSTOM_INCLUDE <esp_heap_caps.h>   /*Header for the dynamic memory function*/
+    #define LV_MEM_CUSTOM_PSRAM_MIN 1024
+    #define LV_MEM_CUSTOM_CAPS(size, psram_first) \
+        (((((size) >= LV_MEM_CUSTOM_PSRAM_MIN) == (psram_first)) ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL) | MALLOC_CAP_8BIT)
+    #define LV_MEM_CUSTOM_ALLOC(size) \
+        heap_caps_malloc_prefer((size), 2, LV_MEM_CUSTOM_CAPS(size, 1), LV_MEM_CUSTOM_CAPS(size, 0))
+    #define LV_MEM_CUSTOM_FREE    heap_caps_free
+    #define LV_MEM_CUSTOM_REALLOC(p, size) \
+        heap_caps_realloc_prefer((p), (size), 2, LV_MEM_CUSTOM_CAPS(size, 1), LV_MEM_CUSTOM_CAPS(size, 0))
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -78,7 +86,7 @@
  *====================*/
 
 /*Default display refresh period. LVG will redraw changed areas with this period time*/
-#define LV_DISP_DEF_REFR_PERIOD 10      /*[ms]*/  /* Faster refresh for smoother updates */
+#define LV_DISP_DEF_REFR_PERIOD 10      /*[ms]*/  /* Full rate; stretched to RENDER_IDLE_PERIOD_MS while idle (idle_pacer.h) */
 
 /*Input device read period in milliseconds*/
 #define LV_INDEV_DEF_READ_PERIOD 30     /*[ms]*/
@@ -191,7 +199,7 @@
 #define LV_FONT_MONTSERRAT_26 0
 #define LV_FONT_MONTSERRAT_28 0
 #define LV_FONT_MONTSERRAT_30 0
-#define LV_FONT_MONTSERRAT_32 1  /* Used: power arrows and values */
+#define LV_FONT_MONTSERRAT_32 1  /* Used: power arrows, value glyph atlas (numeric_label) */
 #define LV_FONT_MONTSERRAT_34 0
 #define LV_FONT_MONTSERRAT_36 0
 #define LV_FONT_MONTSERRAT_38 0
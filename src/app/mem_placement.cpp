@@ -0,0 +1,34 @@
+/*
+ * Memory Placement Implementation
+ */
+
+#include "mem_placement.h"
+#include <esp_heap_caps.h>
+
+static const uint32_t CAPS_PSRAM = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+static const uint32_t CAPS_INTERNAL = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+
+bool mem_has_psram() {
+    return heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+}
+
+void* mem_alloc_dma(size_t size) {
+    return heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+}
+
+void* mem_alloc_large(size_t size) {
+    return heap_caps_malloc_prefer(size, 2, CAPS_PSRAM, CAPS_INTERNAL);
+}
+
+size_t mem_large_available(size_t internal_reserve) {
+    const size_t internal_free = heap_caps_get_free_size(CAPS_INTERNAL);
+    if (internal_free < internal_reserve) return 0;
+    if (mem_has_psram()) {
+        return heap_caps_get_free_size(CAPS_PSRAM);
+    }
+    return internal_free - internal_reserve;
+}
+
+size_t mem_large_max_alloc() {
+    return heap_caps_get_largest_free_block(mem_has_psram() ? CAPS_PSRAM : CAPS_INTERNAL);
+}
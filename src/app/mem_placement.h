@@ -0,0 +1,37 @@
+/*
+ * Memory Placement
+ *
+ * Where the large buffers go:
+ *   mem_alloc_dma()     internal, DMA-capable   LVGL draw buffers (SPI flush source)
+ *   mem_alloc_large()   PSRAM when present      upload/strip buffers, ImageScreen JPEG
+ *                                               copy, energy history tiers
+ * LVGL's own heap uses heap_caps_malloc_prefer() as well (see LV_MEM_CUSTOM in
+ * lv_conf.h): small objects internal first, large buffers PSRAM first. The
+ * image cache picks PSRAM vs LittleFS itself (image_cache.cpp).
+ *
+ * Without PSRAM every large allocation comes from the internal heap, as before.
+ * All of these are released with free().
+ */
+
+#ifndef MEM_PLACEMENT_H
+#define MEM_PLACEMENT_H
+
+#include <Arduino.h>
+
+bool mem_has_psram();
+
+// Internal, DMA-capable memory (SPI transfer source)
+void* mem_alloc_dma(size_t size);
+
+// PSRAM if present (falls back to internal heap), for data the CPU only
+// streams through
+void* mem_alloc_large(size_t size);
+
+// Free bytes for a large buffer that still leave internal_reserve bytes of
+// internal heap (decoder work areas, LVGL, network stack)
+size_t mem_large_available(size_t internal_reserve);
+
+// Largest single large buffer that can be allocated right now
+size_t mem_large_max_alloc();
+
+#endif // MEM_PLACEMENT_H
@@ -1,19 +1,28 @@
 /*
  * MQTT Manager Implementation
- * 
+ *
  * Uses PubSubClient library for MQTT connectivity.
  * Handles connection, subscription, and message parsing.
  */
 
 #include "mqtt_manager.h"
+#include "board_config.h"
 #include "log_manager.h"
+#include "energy_history.h"
+#include "json_path.h"
+#include "boot_timing.h"
 #include <WiFi.h>
 #include <PubSubClient.h>
-#include <ArduinoJson.h>
 
 // Increase MQTT buffer size for large JSON messages
 #define MQTT_MAX_PACKET_SIZE 512
 
+// Open-addressing table of exact topics: power of two, at most half full
+#define TOPIC_HASH_SLOTS 32
+static_assert(TOPIC_HASH_SLOTS >= 2 * MQTT_MAX_CHANNELS, "TOPIC_HASH_SLOTS too small for MQTT_MAX_CHANNELS");
+static_assert((TOPIC_HASH_SLOTS & (TOPIC_HASH_SLOTS - 1)) == 0, "TOPIC_HASH_SLOTS must be a power of two");
+static_assert(MQTT_MAX_CHANNELS <= 32, "change mask holds one bit per channel");
+
 // MQTT client instances
 static WiFiClient wifi_client;
 static PubSubClient mqtt_client(wifi_client);
@@ -23,70 +32,327 @@ static char mqtt_broker[CONFIG_MQTT_BROKER_MAX_LEN] = "";
 static uint16_t mqtt_port = 1883;
 static char mqtt_username[CONFIG_MQTT_USERNAME_MAX_LEN] = "";
 static char mqtt_password[CONFIG_MQTT_PASSWORD_MAX_LEN] = "";
-static char topic_solar[CONFIG_MQTT_TOPIC_MAX_LEN] = "";
-static char topic_grid[CONFIG_MQTT_TOPIC_MAX_LEN] = "";
-static char solar_value_path[32] = ".";
-static char grid_value_path[32] = ".";
 
-// Power values (NAN = not received yet)
-static float solar_power_kw = NAN;
-static float grid_power_kw = NAN;
+struct MqttChannel {
+    char name[MQTT_CHANNEL_NAME_MAX_LEN];
+    char topic[CONFIG_MQTT_TOPIC_MAX_LEN];
+    char path_spec[JSON_PATH_MAX_LEN];
+    char unit[MQTT_CHANNEL_UNIT_MAX_LEN];
+    JsonPath path;            // compiled once at registration (see json_path.h)
+    float scale;
+    uint32_t topic_hash;
+    int8_t next_same_topic;   // next channel fed by the same exact topic, -1 = end
+    bool wildcard;
+    bool extract_failing;     // failures are logged once per streak, not per message
+
+    // Last value (NAN = not received yet)
+    float value;
+    unsigned long updated_ms;
+
+    // Direct ingest ordering (mqtt_manager_push_value)
+    uint32_t push_seq;
+    unsigned long push_ms;    // millis() of the last accepted sequenced push, 0 = none
+};
+
+static MqttChannel channels[MQTT_MAX_CHANNELS];
+static size_t channel_count = 0;
+
+static int8_t topic_slots[TOPIC_HASH_SLOTS];   // first channel per exact topic, -1 = empty
+static int8_t wildcard_channels[MQTT_MAX_CHANNELS];
+static size_t wildcard_count = 0;
+static uint32_t table_config_hash = 0;         // channel config the table was built from, 0 = not built
+
+// Channels whose value changed since the consumer last cleared them. Set on the
+// network task, consumed on the render task: updated under a spinlock.
+static uint32_t changed_mask = 0;
+static unsigned long changed_since_ms = 0;  // millis() of the oldest unconsumed change
+static portMUX_TYPE changed_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Values are written by the network task (MQTT) and by direct ingest (AsyncTCP
+// and UDP tasks): value, timestamps and push sequence change together
+static portMUX_TYPE value_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Table layout (entries, count, topic index). Changed only by the network task,
+// which therefore reads it unlocked; lookups and pushes from other tasks hold it
+static SemaphoreHandle_t table_mutex = nullptr;
+static void table_lock() { if (table_mutex) xSemaphoreTake(table_mutex, portMAX_DELAY); }
+static void table_unlock() { if (table_mutex) xSemaphoreGive(table_mutex); }
 
 // Connection retry settings
+static MqttStats stats = {};
+
 static unsigned long last_reconnect_attempt = 0;
 static const unsigned long RECONNECT_INTERVAL = 5000; // 5 seconds
 
+// FNV-1a (h continues an earlier hash)
+static uint32_t topic_hash(const char* topic, uint32_t h = 2166136261u) {
+    while (*topic) {
+        h ^= (uint8_t)*topic++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Slot holding topic, or the empty slot where it would go
+static int find_topic_slot(const char* topic, uint32_t hash) {
+    int slot = (int)(hash & (TOPIC_HASH_SLOTS - 1));
+    for (int probe = 0; probe < TOPIC_HASH_SLOTS; probe++) {
+        const int8_t idx = topic_slots[slot];
+        if (idx < 0) return slot;
+        const MqttChannel& ch = channels[idx];
+        if (ch.topic_hash == hash && strcmp(ch.topic, topic) == 0) return slot;
+        slot = (slot + 1) & (TOPIC_HASH_SLOTS - 1);
+    }
+    return -1;  // unreachable while the table is at most half full
+}
+
+// MQTT topic filter match ("+" = one level, "#" = all remaining levels)
+static bool topic_matches(const char* filter, const char* topic) {
+    while (*filter) {
+        if (*filter == '#') return true;
+        if (*filter == '+') {
+            while (*topic && *topic != '/') topic++;
+            filter++;
+            continue;
+        }
+        if (*filter != *topic) {
+            // "a/#" also matches "a"
+            return *topic == '\0' && filter[0] == '/' && filter[1] == '#' && filter[2] == '\0';
+        }
+        filter++;
+        topic++;
+    }
+    return *topic == '\0';
+}
+
+static void mark_changed(int id, float previous, float value) {
+    if (previous == value || (isnan(previous) && isnan(value))) return;
+    const unsigned long now = millis();
+    portENTER_CRITICAL(&changed_mux);
+    if (changed_mask == 0) changed_since_ms = now;
+    changed_mask |= 1u << id;
+    portEXIT_CRITICAL(&changed_mux);
+}
+
+// Store a channel value (NAN = unparsable payload) and feed its consumers
+static void channel_store(int id, float value) {
+    MqttChannel& ch = channels[id];
+    portENTER_CRITICAL(&value_mux);
+    const float previous = ch.value;
+    ch.value = value;
+    if (!isnan(value)) ch.updated_ms = millis();
+    portEXIT_CRITICAL(&value_mux);
+    mark_changed(id, previous, value);
+    if (isnan(value)) return;
+
+    LOG_DEBUGF(LOG_MODULE_MQTT, "%s updated: %.3f %s", ch.name, value, ch.unit);
+
+    if (id == MQTT_CHANNEL_SOLAR) {
+        energy_history_add_sample(ENERGY_SOLAR, value);
+        boot_timing_mark(BOOT_PHASE_FIRST_VALUE);
+    } else if (id == MQTT_CHANNEL_GRID) {
+        energy_history_add_sample(ENERGY_GRID, value);
+        boot_timing_mark(BOOT_PHASE_FIRST_VALUE);
+    }
+}
+
+static void channel_subscribe(const MqttChannel& ch) {
+    if (mqtt_client.subscribe(ch.topic)) {
+        Logger.logMessagef("MQTT", "Subscribed to %s: %s", ch.name, ch.topic);
+    } else {
+        Logger.logMessagef("MQTT", "Failed to subscribe to %s: %s", ch.name, ch.topic);
+    }
+}
+
 /**
- * Extract numeric value from MQTT payload
- * @param payload - MQTT message payload (null-terminated string)
- * @param path - JSON field path, or "." for direct numeric value
- * @return Extracted float value, or NAN on error
+ * Update a channel from a payload (scanned in place, no allocation)
+ * @param id - channel to update; its value becomes NAN if the payload has no
+ *             number at the channel's path
  */
-static float extract_value(const char* payload, const char* path) {
-    // Direct numeric value (no JSON parsing needed)
-    if (path[0] == '.' && path[1] == '\0') {
-        return atof(payload);
-    }
-    
-    // JSON field extraction
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload);
-    
-    if (error) {
-        Logger.logMessagef("MQTT", "Failed to parse JSON: %s", error.c_str());
-        return NAN;
-    }
-    
-    if (doc.containsKey(path)) {
-        return doc[path];
-    } else {
-        Logger.logMessagef("MQTT", "JSON missing field '%s'", path);
-        return NAN;
+static void channel_update(int id, const byte* payload, unsigned int length) {
+    MqttChannel& ch = channels[id];
+
+    float raw;
+    if (!json_path_extract(ch.path, (const char*)payload, length, &raw)) {
+        stats.parse_failures++;
+        channel_store(id, NAN);
+        if (!ch.extract_failing) {
+            Logger.logMessagef("MQTT", "No numeric value at '%s' for %s in: %.*s", ch.path_spec, ch.name,
+                               (int)(length > 96 ? 96 : length), (const char*)payload);
+            ch.extract_failing = true;
+        }
+        return;
     }
+
+    ch.extract_failing = false;
+    channel_store(id, raw * ch.scale);
 }
 
 // MQTT callback for incoming messages
 void mqtt_callback(char* topic, byte* payload, unsigned int length) {
-    // Create null-terminated string from payload
-    char message[length + 1];
-    memcpy(message, payload, length);
-    message[length] = '\0';
-    
-    Logger.logMessagef("MQTT", "Received on %s: %s", topic, message);
-    
-    // Check which topic this message is from
-    if (strcmp(topic, topic_solar) == 0) {
-        solar_power_kw = extract_value(message, solar_value_path);
-        if (!isnan(solar_power_kw)) {
-            Logger.logMessagef("MQTT", "Solar power updated: %.3f kW", solar_power_kw);
+    LOG_DEBUGF(LOG_MODULE_MQTT, "Received on %s: %.*s", topic, (int)length, (const char*)payload);
+    stats.messages++;
+
+    // Exact topics: one hash lookup, then every channel on that topic
+    const int slot = find_topic_slot(topic, topic_hash(topic));
+    if (slot >= 0) {
+        for (int id = topic_slots[slot]; id >= 0; id = channels[id].next_same_topic) {
+            channel_update(id, payload, length);
         }
-    } 
-    else if (strcmp(topic, topic_grid) == 0) {
-        grid_power_kw = extract_value(message, grid_value_path);
-        if (!isnan(grid_power_kw)) {
-            Logger.logMessagef("MQTT", "Grid power updated: %.3f kW", grid_power_kw);
+    }
+
+    for (size_t i = 0; i < wildcard_count; i++) {
+        if (topic_matches(channels[wildcard_channels[i]].topic, topic)) {
+            channel_update(wildcard_channels[i], payload, length);
+        }
+    }
+}
+
+// Add a table entry (table_lock held); *subscribe: first channel on its topic
+static int channel_insert(const char* name, const char* topic, const char* value_path,
+                          float scale, const char* unit, bool* subscribe) {
+    *subscribe = false;
+    if (!name || !topic) return -1;
+
+    if (channel_count >= MQTT_MAX_CHANNELS) {
+        Logger.logMessagef("MQTT", "ERROR: Channel table full, '%s' not added", name);
+        return -1;
+    }
+
+    const int id = (int)channel_count;
+    MqttChannel& ch = channels[id];
+    ch = MqttChannel();
+    strlcpy(ch.name, name, sizeof(ch.name));
+    strlcpy(ch.topic, topic, sizeof(ch.topic));
+    strlcpy(ch.path_spec, (value_path && value_path[0]) ? value_path : ".", sizeof(ch.path_spec));
+    strlcpy(ch.unit, unit ? unit : "", sizeof(ch.unit));
+    ch.scale = (isnan(scale) || scale == 0.0f) ? 1.0f : scale;
+    ch.value = NAN;
+    ch.next_same_topic = -1;
+
+    if (!json_path_compile(&ch.path, ch.path_spec)) {
+        Logger.logMessagef("MQTT", "ERROR: Invalid value path '%s' for %s", ch.path_spec, ch.name);
+        if (id > MQTT_CHANNEL_GRID) return -1;
+        // Built-ins keep their id; the invalid path never matches
+    }
+    channel_count++;
+
+    // Built-in channels stay registered (stable ids) even without a topic
+    if (ch.topic[0] == '\0') return id;
+
+    ch.wildcard = strchr(ch.topic, '+') || strchr(ch.topic, '#');
+    bool first_on_topic = true;
+    if (ch.wildcard) {
+        wildcard_channels[wildcard_count++] = (int8_t)id;
+    } else {
+        ch.topic_hash = topic_hash(ch.topic);
+        const int slot = find_topic_slot(ch.topic, ch.topic_hash);
+        if (topic_slots[slot] < 0) {
+            topic_slots[slot] = (int8_t)id;
+        } else {
+            // Append to the topic's chain (keeps registration order)
+            int tail = topic_slots[slot];
+            while (channels[tail].next_same_topic >= 0) tail = channels[tail].next_same_topic;
+            channels[tail].next_same_topic = (int8_t)id;
+            first_on_topic = false;
         }
     }
+
+    *subscribe = first_on_topic;
+    return id;
+}
+
+int mqtt_manager_add_channel(const char* name, const char* topic, const char* value_path,
+                             float scale, const char* unit) {
+    bool subscribe;
+    table_lock();
+    const int id = channel_insert(name, topic, value_path, scale, unit, &subscribe);
+    table_unlock();
+    if (subscribe && mqtt_client.connected()) {
+        channel_subscribe(channels[id]);
+    }
+    return id;
+}
+
+// Extra channels from the config string: one per line, "name;topic;path;scale;unit"
+// (path, scale and unit optional; blank lines and lines starting with '#' ignored)
+static void add_config_channels(const char* spec) {
+    const char* line = spec;
+    while (line && *line) {
+        const char* eol = strchr(line, '\n');
+        const size_t len = eol ? (size_t)(eol - line) : strlen(line);
+
+        char buf[CONFIG_MQTT_TOPIC_MAX_LEN + 64];
+        if (len > 0 && len < sizeof(buf) && line[0] != '#') {
+            memcpy(buf, line, len);
+            buf[len] = '\0';
+
+            char* fields[5] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+            char* p = buf;
+            for (int f = 0; f < 5 && p; f++) {
+                fields[f] = p;
+                p = strchr(p, ';');
+                if (p) *p++ = '\0';
+            }
+            for (char*& field : fields) {
+                if (!field) continue;
+                while (*field == ' ' || *field == '\t') field++;
+                char* end = field + strlen(field);
+                while (end > field && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) *--end = '\0';
+            }
+
+            if (fields[0] && fields[0][0] && fields[1] && fields[1][0]) {
+                bool subscribe;
+                channel_insert(fields[0], fields[1], fields[2],
+                               (fields[3] && fields[3][0]) ? (float)atof(fields[3]) : 1.0f,
+                               fields[4], &subscribe);
+            } else if (fields[0] && fields[0][0]) {
+                Logger.logMessagef("MQTT", "Ignoring channel line: %s", buf);
+            }
+        }
+
+        line = eol ? eol + 1 : nullptr;
+    }
+}
+
+// Hash of every config field that shapes the channel table
+static uint32_t channel_config_hash(const DeviceConfig* config) {
+    const char* fields[] = {config->mqtt_topic_solar, config->mqtt_solar_value_path,
+                            config->mqtt_topic_grid, config->mqtt_grid_value_path, config->mqtt_channels};
+    uint32_t h = 2166136261u;
+    for (const char* field : fields) {
+        h = topic_hash(field, h) * 16777619u;  // field separator
+    }
+    return h ? h : 1;
+}
+
+// Subscribe once per distinct topic (chain heads and wildcard filters)
+static void subscribe_all() {
+    for (int slot = 0; slot < TOPIC_HASH_SLOTS; slot++) {
+        if (topic_slots[slot] >= 0) {
+            channel_subscribe(channels[topic_slots[slot]]);
+        }
+    }
+    for (size_t i = 0; i < wildcard_count; i++) {
+        channel_subscribe(channels[wildcard_channels[i]]);
+    }
+}
+
+// Channel table: built-ins first (ids MQTT_CHANNEL_SOLAR / MQTT_CHANNEL_GRID)
+static void build_channel_table(const DeviceConfig* config) {
+    if (!table_mutex) table_mutex = xSemaphoreCreateMutex();
+
+    bool subscribe;
+    table_lock();
+    channel_count = 0;
+    wildcard_count = 0;
+    memset(topic_slots, -1, sizeof(topic_slots));
+    channel_insert("solar", config->mqtt_topic_solar, config->mqtt_solar_value_path, 1.0f, "kW", &subscribe);
+    channel_insert("grid", config->mqtt_topic_grid, config->mqtt_grid_value_path, 1.0f, "kW", &subscribe);
+    add_config_channels(config->mqtt_channels);
+    table_unlock();
+
+    if (mqtt_client.connected()) subscribe_all();
 }
 
 // Attempt to connect to MQTT broker
@@ -95,43 +361,30 @@ bool mqtt_reconnect() {
         Logger.logMessage("MQTT", "No broker configured, skipping connection");
         return false;
     }
-    
+
     Logger.logMessagef("MQTT", "Connecting to %s:%d", mqtt_broker, mqtt_port);
-    
+
     // Generate unique client ID
     String client_id = "ESP32-" + WiFi.macAddress();
     client_id.replace(":", "");
-    
+
     bool connected = false;
     if (strlen(mqtt_username) > 0) {
         connected = mqtt_client.connect(client_id.c_str(), mqtt_username, mqtt_password);
     } else {
         connected = mqtt_client.connect(client_id.c_str());
     }
-    
+
     if (connected) {
         Logger.logMessage("MQTT", "Connected successfully");
-        
-        // Subscribe to topics
-        if (strlen(topic_solar) > 0) {
-            if (mqtt_client.subscribe(topic_solar)) {
-                Logger.logMessagef("MQTT", "Subscribed to solar: %s", topic_solar);
-            } else {
-                Logger.logMessagef("MQTT", "Failed to subscribe to solar: %s", topic_solar);
-            }
-        }
-        
-        if (strlen(topic_grid) > 0) {
-            if (mqtt_client.subscribe(topic_grid)) {
-                Logger.logMessagef("MQTT", "Subscribed to grid: %s", topic_grid);
-            } else {
-                Logger.logMessagef("MQTT", "Failed to subscribe to grid: %s", topic_grid);
-            }
-        }
-        
+        stats.connects++;
+        boot_timing_mark(BOOT_PHASE_MQTT);
+
+        subscribe_all();
         return true;
     } else {
         Logger.logMessagef("MQTT", "Connection failed, state=%d", mqtt_client.state());
+        stats.connect_failures++;
         return false;
     }
 }
@@ -142,40 +395,47 @@ void mqtt_manager_init(const DeviceConfig *config) {
         Logger.logMessage("MQTT", "Config is NULL, skipping init");
         return;
     }
-    
+
     // Copy configuration
     strlcpy(mqtt_broker, config->mqtt_broker, CONFIG_MQTT_BROKER_MAX_LEN);
     mqtt_port = config->mqtt_port;
     strlcpy(mqtt_username, config->mqtt_username, CONFIG_MQTT_USERNAME_MAX_LEN);
     strlcpy(mqtt_password, config->mqtt_password, CONFIG_MQTT_PASSWORD_MAX_LEN);
-    strlcpy(topic_solar, config->mqtt_topic_solar, CONFIG_MQTT_TOPIC_MAX_LEN);
-    strlcpy(topic_grid, config->mqtt_topic_grid, CONFIG_MQTT_TOPIC_MAX_LEN);
-    strlcpy(solar_value_path, config->mqtt_solar_value_path, 32);
-    strlcpy(grid_value_path, config->mqtt_grid_value_path, 32);
-    
+
+    // Built on the first call and when the channel config changed (saved without
+    // a reboot); a WiFi reconnect only reconnects the client and keeps the values
+    const uint32_t config_hash = channel_config_hash(config);
+    if (config_hash != table_config_hash) {
+        build_channel_table(config);
+        table_config_hash = config_hash;
+    }
+
     // Skip if no broker configured
     if (strlen(mqtt_broker) == 0) {
         Logger.logMessage("MQTT", "No broker configured");
         return;
     }
-    
+
     Logger.logBegin("MQTT Init");
     Logger.logLinef("Broker: %s:%d", mqtt_broker, mqtt_port);
     Logger.logLinef("Username: %s", strlen(mqtt_username) > 0 ? mqtt_username : "(none)");
-    Logger.logLinef("Solar topic: %s (path: %s)", strlen(topic_solar) > 0 ? topic_solar : "(none)", solar_value_path);
-    Logger.logLinef("Grid topic: %s (path: %s)", strlen(topic_grid) > 0 ? topic_grid : "(none)", grid_value_path);
+    for (size_t i = 0; i < channel_count; i++) {
+        const MqttChannel& ch = channels[i];
+        Logger.logLinef("%s topic: %s (path: %s, x%g %s)", ch.name,
+                        ch.topic[0] ? ch.topic : "(none)", ch.path_spec, ch.scale, ch.unit);
+    }
     Logger.logEnd();
-    
+
     // Configure MQTT client
     mqtt_client.setServer(mqtt_broker, mqtt_port);
     mqtt_client.setBufferSize(MQTT_MAX_PACKET_SIZE);
     mqtt_client.setCallback(mqtt_callback);
-    
+
     // Initial connection attempt
     mqtt_reconnect();
 }
 
-// Process MQTT (call in main loop)
+// Process MQTT (call from the network task)
 void mqtt_manager_loop() {
     if (!mqtt_client.connected()) {
         // Attempt reconnection with backoff
@@ -190,14 +450,105 @@ void mqtt_manager_loop() {
     }
 }
 
+void mqtt_manager_get_stats(MqttStats* out) {
+    *out = stats;
+}
+
+int mqtt_manager_find_channel(const char* name) {
+    int id = -1;
+    table_lock();
+    for (size_t i = 0; i < channel_count; i++) {
+        if (strcmp(channels[i].name, name) == 0) {
+            id = (int)i;
+            break;
+        }
+    }
+    table_unlock();
+    return id;
+}
+
+size_t mqtt_manager_channel_count() {
+    return channel_count;
+}
+
+bool mqtt_manager_get_channel(int id, MqttChannelInfo* info) {
+    if (!info) return false;
+    table_lock();
+    if (id < 0 || (size_t)id >= channel_count) {
+        table_unlock();
+        return false;
+    }
+    const MqttChannel& ch = channels[id];
+    info->name = ch.name;
+    info->topic = ch.topic;
+    info->unit = ch.unit;
+    info->scale = ch.scale;
+    info->value = ch.value;
+    info->updated_ms = ch.updated_ms;
+    table_unlock();
+    return true;
+}
+
+MqttPushResult mqtt_manager_push_value(int id, float value, bool has_seq, uint32_t seq) {
+    if (isnan(value)) return MQTT_PUSH_UNKNOWN;
+    table_lock();
+    if (id < 0 || (size_t)id >= channel_count) {
+        table_unlock();
+        return MQTT_PUSH_UNKNOWN;
+    }
+    MqttChannel& ch = channels[id];
+
+    if (has_seq) {
+        const unsigned long now = millis();
+        portENTER_CRITICAL(&value_mux);
+        // A sender that went quiet (or restarted) starts a new sequence
+        const bool fresh = ch.push_ms == 0 || now - ch.push_ms > MQTT_PUSH_SEQ_RESET_MS;
+        const bool newer = fresh || (int32_t)(seq - ch.push_seq) > 0;
+        if (newer) {
+            ch.push_seq = seq;
+            ch.push_ms = now ? now : 1;
+        }
+        portEXIT_CRITICAL(&value_mux);
+        if (!newer) {
+            table_unlock();
+            return MQTT_PUSH_STALE;
+        }
+    }
+
+    channel_store(id, value);
+    table_unlock();
+    return MQTT_PUSH_OK;
+}
+
+float mqtt_manager_get_value(int id) {
+    if (id < 0 || (size_t)id >= channel_count) return NAN;
+    return channels[id].value;
+}
+
+uint32_t mqtt_manager_get_changes(unsigned long* since_ms) {
+    portENTER_CRITICAL(&changed_mux);
+    const uint32_t mask = changed_mask;
+    if (since_ms) *since_ms = changed_since_ms;
+    portEXIT_CRITICAL(&changed_mux);
+    return mask;
+}
+
+void mqtt_manager_clear_changes(uint32_t mask) {
+    const unsigned long now = millis();
+    portENTER_CRITICAL(&changed_mux);
+    changed_mask &= ~mask;
+    if (changed_mask) changed_since_ms = now;  // remaining bits: restart their window
+    portEXIT_CRITICAL(&changed_mux);
+}
+
 // Get solar power value
 float mqtt_manager_get_solar_power() {
-    return solar_power_kw;
+    return mqtt_manager_get_value(MQTT_CHANNEL_SOLAR);
 }
 
 // Get grid power value
 float mqtt_manager_get_grid_power() {
-    return grid_power_kw;
+    return mqtt_manager_get_value(MQTT_CHANNEL_GRID);
 }
 
 // Check connection status
@@ -1,14 +1,26 @@
 /*
  * MQTT Manager
- * 
+ *
  * Manages MQTT connection and subscriptions for energy monitoring.
- * Subscribes to solar power and grid power topics, parses incoming messages.
- * 
+ * Values come from a table of channels, each with a topic, value path, scale
+ * and unit. Solar and grid are the two built-in channels (from the config
+ * fields); more can be added with the mqtt_channels config string or
+ * mqtt_manager_add_channel().
+ *
+ * Dispatch cost is independent of the number of channels: exact topics are
+ * looked up in a hash table (channels sharing a topic are chained, so one JSON
+ * payload can feed several channels), and only channels with wildcard topics
+ * ("+" / "#") are matched one by one.
+ *
+ * The same value store takes direct pushes (power_ingest.h: UDP and
+ * POST /api/power) through mqtt_manager_push_value(), which orders pushes by
+ * sender sequence number; consumers cannot tell the sources apart.
+ *
  * USAGE:
  *   mqtt_manager_init(&device_config);  // Initialize with config
- *   mqtt_manager_loop();                 // Call in main loop
- *   float solar = mqtt_manager_get_solar_power();
- *   float grid = mqtt_manager_get_grid_power();
+ *   mqtt_manager_loop();                 // Call periodically (network task)
+ *   float solar = mqtt_manager_get_value(MQTT_CHANNEL_SOLAR);
+ *   int soc = mqtt_manager_find_channel("battery_soc");
  */
 
 #ifndef MQTT_MANAGER_H
@@ -17,11 +29,66 @@
 #include <Arduino.h>
 #include "config_manager.h"
 
+// Built-in channels (always registered, in this order)
+#define MQTT_CHANNEL_SOLAR 0
+#define MQTT_CHANNEL_GRID  1
+
+#define MQTT_CHANNEL_NAME_MAX_LEN 16
+#define MQTT_CHANNEL_UNIT_MAX_LEN 8
+
+struct MqttChannelInfo {
+    const char* name;
+    const char* topic;
+    const char* unit;
+    float scale;
+    float value;                // scaled, NAN if not received (or last payload unparsable)
+    unsigned long updated_ms;   // millis() of the last valid value, 0 = never
+};
+
 // API Functions
-void mqtt_manager_init(const DeviceConfig *config);  // Initialize MQTT with config
+void mqtt_manager_init(const DeviceConfig *config);  // Initialize MQTT with config (again on WiFi reconnect)
 void mqtt_manager_loop();                             // Process MQTT messages (call in loop)
+bool mqtt_manager_is_connected();                     // Check if MQTT is connected
+
+// Register a channel (value = payload value at value_path x scale). Returns the
+// channel id, or -1 if the table is full or the path is invalid. Subscribes
+// immediately when connected.
+int mqtt_manager_add_channel(const char* name, const char* topic, const char* value_path,
+                             float scale, const char* unit);
+
+int mqtt_manager_find_channel(const char* name);      // Channel id by name, -1 if none
+size_t mqtt_manager_channel_count();
+bool mqtt_manager_get_channel(int id, MqttChannelInfo* info);
+float mqtt_manager_get_value(int id);                 // Last value, NAN if not received
+
+// Set a channel's value directly (any task). With has_seq, last writer wins by
+// sequence: a push whose seq is not newer than the channel's last accepted push
+// (wrapping compare) is dropped, unless no push arrived for
+// MQTT_PUSH_SEQ_RESET_MS (sender restarted). MQTT updates always apply.
+enum MqttPushResult {
+    MQTT_PUSH_OK = 0,
+    MQTT_PUSH_STALE,     // older sequence number
+    MQTT_PUSH_UNKNOWN    // no such channel (or NAN value)
+};
+MqttPushResult mqtt_manager_push_value(int id, float value, bool has_seq, uint32_t seq);
+
+// Counters since boot (network task writes, readers may see a sample mid-update)
+struct MqttStats {
+    uint32_t messages;          // payloads received
+    uint32_t parse_failures;    // channel updates without a number at the value path
+    uint32_t connects;          // successful broker connections
+    uint32_t connect_failures;  // failed connection attempts
+};
+void mqtt_manager_get_stats(MqttStats* out);
+
+// Change notification: bit (1 << id) is set when a channel's value changes (a
+// repeated identical reading sets nothing). since_ms = millis() of the oldest
+// change not yet cleared. Consumers clear the bits they have handled.
+#define MQTT_CHANNEL_BIT(id) (1u << (id))
+uint32_t mqtt_manager_get_changes(unsigned long* since_ms);
+void mqtt_manager_clear_changes(uint32_t mask);
+
 float mqtt_manager_get_solar_power();                 // Get last solar power value (kW), NAN if not received
 float mqtt_manager_get_grid_power();                  // Get last grid power value (kW), NAN if not received
-bool mqtt_manager_is_connected();                     // Check if MQTT is connected
 
 #endif // MQTT_MANAGER_H
@@ -0,0 +1,208 @@
+/*
+ * Numeric Label Implementation
+ */
+
+#include "numeric_label.h"
+#include "log_manager.h"
+#include <string.h>
+
+#define NUMERIC_LABEL_FONT lv_font_montserrat_32
+#define NUMERIC_LABEL_MAX_CHARS 15
+
+static const char GLYPH_CHARS[] = "0123456789.-";
+static const int GLYPH_COUNT = sizeof(GLYPH_CHARS) - 1;
+
+// Shared atlas: one cell per glyph, CELL rows cover the ink of every glyph
+// (ink_top = first row below the line top), 4bpp packed two pixels per byte
+struct GlyphCell {
+    uint8_t advance;   // pen advance (all digits: the widest digit)
+    uint8_t box_x;     // ink offset within the cell
+};
+
+static GlyphCell cells[GLYPH_COUNT];
+static uint8_t* atlas = nullptr;
+static int cell_w = 0;
+static int cell_h = 0;
+static int cell_stride = 0;   // bytes per cell row
+static int ink_top = 0;
+static size_t atlas_bytes = 0;
+
+struct NumericLabelData {
+    char text[NUMERIC_LABEL_MAX_CHARS + 1];
+    lv_color_t color;
+    lv_color_t palette[16];   // color blended onto black at alpha 0, 17, ..., 255
+};
+
+static int glyph_index(char c) {
+    const char* p = strchr(GLYPH_CHARS, c);
+    return (p && c) ? (int)(p - GLYPH_CHARS) : -1;
+}
+
+static bool atlas_build() {
+    if (atlas) return true;
+    const lv_font_t* font = &NUMERIC_LABEL_FONT;
+    const int line_top_to_base = font->line_height - font->base_line;
+
+    // Pass 1: metrics (cell width, rows with ink, tabular digit advance)
+    lv_font_glyph_dsc_t dsc[GLYPH_COUNT];
+    int digit_advance = 0;
+    int top = font->line_height, bottom = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        if (!lv_font_get_glyph_dsc(font, &dsc[i], GLYPH_CHARS[i], 0) || dsc[i].bpp != 4) {
+            Logger.logMessagef("NumLabel", "ERROR: no 4bpp glyph for '%c'", GLYPH_CHARS[i]);
+            return false;
+        }
+        if (i < 10 && dsc[i].adv_w > digit_advance) digit_advance = dsc[i].adv_w;
+        const int y0 = line_top_to_base - dsc[i].box_h - dsc[i].ofs_y;
+        if (y0 < top) top = y0;
+        if (y0 + dsc[i].box_h > bottom) bottom = y0 + dsc[i].box_h;
+    }
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        const int advance = (i < 10) ? digit_advance : dsc[i].adv_w;
+        cells[i].advance = (uint8_t)advance;
+        // Center digit ink in the tabular advance; '.' and '-' keep their bearing
+        const int box_x = (i < 10) ? (advance - dsc[i].box_w) / 2 : dsc[i].ofs_x;
+        cells[i].box_x = (uint8_t)(box_x < 0 ? 0 : box_x);
+        if (cells[i].box_x + dsc[i].box_w > cell_w) cell_w = cells[i].box_x + dsc[i].box_w;
+        if (advance > cell_w) cell_w = advance;
+    }
+    if (top < 0) top = 0;
+    ink_top = top;
+    cell_h = bottom - top;
+    cell_stride = (cell_w + 1) / 2;
+
+    atlas_bytes = (size_t)GLYPH_COUNT * cell_h * cell_stride;
+    atlas = (uint8_t*)lv_mem_alloc(atlas_bytes);
+    if (!atlas) {
+        atlas_bytes = 0;
+        return false;
+    }
+    memset(atlas, 0, atlas_bytes);
+
+    // Pass 2: copy the font's packed 4bpp bitmaps (rows not byte aligned) into cells
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        const uint8_t* bmp = lv_font_get_glyph_bitmap(font, GLYPH_CHARS[i]);
+        if (!bmp) continue;
+        uint8_t* cell = atlas + (size_t)i * cell_h * cell_stride;
+        const int y0 = line_top_to_base - dsc[i].box_h - dsc[i].ofs_y - ink_top;
+        for (int y = 0; y < dsc[i].box_h; y++) {
+            for (int x = 0; x < dsc[i].box_w; x++) {
+                const uint32_t bit = (uint32_t)(y * dsc[i].box_w + x);
+                const uint8_t v = (bit & 1) ? (bmp[bit >> 1] & 0x0F) : (bmp[bit >> 1] >> 4);
+                const int cx = cells[i].box_x + x;
+                const int cy = y0 + y;
+                if (cy < 0 || cy >= cell_h || cx >= cell_w) continue;
+                cell[cy * cell_stride + (cx >> 1)] |= (cx & 1) ? v : (uint8_t)(v << 4);
+            }
+        }
+    }
+    return true;
+}
+
+static void build_palette(NumericLabelData* d) {
+    const lv_color_t black = lv_color_black();
+    for (int i = 0; i < 16; i++) {
+        d->palette[i] = lv_color_mix(d->color, black, (lv_opa_t)(i * 17));
+    }
+}
+
+static int text_width(const char* text) {
+    int w = 0;
+    for (const char* p = text; *p; p++) {
+        const int g = glyph_index(*p);
+        if (g >= 0) w += cells[g].advance;
+    }
+    return w;
+}
+
+// Paint the clipped part of the object: background, then one cell per character
+static void draw_cb(lv_event_t* e) {
+    lv_obj_t* obj = lv_event_get_target(e);
+    NumericLabelData* d = (NumericLabelData*)lv_obj_get_user_data(obj);
+    lv_draw_ctx_t* draw_ctx = lv_event_get_draw_ctx(e);
+    if (!d || !atlas) return;
+
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    lv_area_t clip;
+    if (!_lv_area_intersect(&clip, &coords, draw_ctx->clip_area)) return;
+
+    lv_color_t* buf = (lv_color_t*)draw_ctx->buf;
+    const lv_area_t* buf_area = draw_ctx->buf_area;
+    const lv_coord_t stride = lv_area_get_width(buf_area);
+    const lv_coord_t clip_w = lv_area_get_width(&clip);
+
+    for (lv_coord_t y = clip.y1; y <= clip.y2; y++) {
+        lv_color_fill(buf + (y - buf_area->y1) * stride + (clip.x1 - buf_area->x1), d->palette[0], clip_w);
+    }
+
+    // Ink rows of the cells, clipped
+    const lv_coord_t cells_y1 = coords.y1 + ink_top;
+    const lv_coord_t y1 = LV_MAX(clip.y1, cells_y1);
+    const lv_coord_t y2 = LV_MIN(clip.y2, cells_y1 + cell_h - 1);
+    if (y1 > y2) return;
+
+    lv_coord_t pen = coords.x1 + (lv_area_get_width(&coords) - text_width(d->text)) / 2;
+    for (const char* p = d->text; *p; p++) {
+        const int g = glyph_index(*p);
+        if (g < 0) continue;
+        const lv_coord_t x1 = LV_MAX(clip.x1, pen);
+        const lv_coord_t x2 = LV_MIN(clip.x2, pen + cell_w - 1);
+        const uint8_t* cell = atlas + (size_t)g * cell_h * cell_stride;
+        for (lv_coord_t y = y1; y <= y2 && x1 <= x2; y++) {
+            const uint8_t* src = cell + (y - cells_y1) * cell_stride;
+            lv_color_t* dst = buf + (y - buf_area->y1) * stride - buf_area->x1;
+            for (lv_coord_t x = x1; x <= x2; x++) {
+                const int cx = x - pen;
+                const uint8_t v = (cx & 1) ? (src[cx >> 1] & 0x0F) : (src[cx >> 1] >> 4);
+                if (v) dst[x] = d->palette[v];
+            }
+        }
+        pen += cells[g].advance;
+    }
+}
+
+static void delete_cb(lv_event_t* e) {
+    lv_obj_t* obj = lv_event_get_target(e);
+    lv_mem_free(lv_obj_get_user_data(obj));
+    lv_obj_set_user_data(obj, nullptr);
+}
+
+lv_obj_t* numeric_label_create(lv_obj_t* parent, lv_coord_t width) {
+    atlas_build();
+
+    lv_obj_t* obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(obj, width, NUMERIC_LABEL_FONT.line_height);
+
+    NumericLabelData* d = (NumericLabelData*)lv_mem_alloc(sizeof(NumericLabelData));
+    if (d) {
+        d->text[0] = '\0';
+        d->color = lv_color_white();
+        build_palette(d);
+    }
+    lv_obj_set_user_data(obj, d);
+    lv_obj_add_event_cb(obj, draw_cb, LV_EVENT_DRAW_MAIN, nullptr);
+    lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, nullptr);
+    return obj;
+}
+
+void numeric_label_set_text(lv_obj_t* obj, const char* text) {
+    NumericLabelData* d = (NumericLabelData*)lv_obj_get_user_data(obj);
+    if (!d || strncmp(d->text, text, sizeof(d->text)) == 0) return;
+    strlcpy(d->text, text, sizeof(d->text));
+    lv_obj_invalidate(obj);
+}
+
+void numeric_label_set_color(lv_obj_t* obj, lv_color_t color) {
+    NumericLabelData* d = (NumericLabelData*)lv_obj_get_user_data(obj);
+    if (!d || d->color.full == color.full) return;
+    d->color = color;
+    build_palette(d);
+    lv_obj_invalidate(obj);
+}
+
+size_t numeric_label_atlas_bytes() {
+    return atlas_bytes;
+}
@@ -0,0 +1,35 @@
+/*
+ * Numeric Label
+ *
+ * Drop-in for the PowerScreen value labels, which only ever show digits, '.',
+ * '-' (and "--"). The glyphs are rasterized once from lv_font_montserrat_32
+ * into a small 4bpp atlas of fixed-width cells, so a value change skips text
+ * layout and font processing: the draw callback copies each cell into the draw
+ * buffer through a 16-entry palette (the text color pre-blended onto the black
+ * background, rebuilt when the color changes).
+ *
+ * Digits share one advance (tabular figures) so values do not jitter as they
+ * change; text is centered in the object. Other characters are skipped. The
+ * label must sit on a black background (it paints its whole area).
+ *
+ * USAGE:
+ *   lv_obj_t* value = numeric_label_create(parent, 107);
+ *   numeric_label_set_text(value, "1.25");
+ *   numeric_label_set_color(value, lv_color_hex(0x00FF00));
+ */
+
+#ifndef NUMERIC_LABEL_H
+#define NUMERIC_LABEL_H
+
+#include <lvgl.h>
+
+// Object of the given width and the font's line height
+lv_obj_t* numeric_label_create(lv_obj_t* parent, lv_coord_t width);
+
+void numeric_label_set_text(lv_obj_t* obj, const char* text);
+void numeric_label_set_color(lv_obj_t* obj, lv_color_t color);
+
+// Atlas size in bytes (0 until the first label is created)
+size_t numeric_label_atlas_bytes();
+
+#endif // NUMERIC_LABEL_H
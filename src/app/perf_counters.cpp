@@ -0,0 +1,75 @@
+/*
+ * Performance Counters Implementation
+ */
+
+#include "perf_counters.h"
+#include <freertos/FreeRTOS.h>
+
+static PerfSnapshot counters = {};
+static portMUX_TYPE perf_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// SPI rate window (render task only)
+static unsigned long rate_window_start_ms = 0;
+static uint64_t rate_window_start_bytes = 0;
+
+static const char* const TIMER_NAMES[PERF_TIMER_COUNT] = {
+    "flush",
+    "lvgl_handler",
+    "strip_decode",
+};
+
+// May run in the SPI completion interrupt (flush timing)
+void perf_record(PerfTimer timer, uint32_t us) {
+    if (timer >= PERF_TIMER_COUNT) return;
+
+    int bucket = 0;
+    while (bucket < PERF_HIST_BUCKETS - 1 && us >= PERF_HIST_BOUND_US(bucket)) {
+        bucket++;
+    }
+
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    PerfTimerStats& t = counters.timers[timer];
+    t.count++;
+    t.total_us += us;
+    if (us > t.max_us) t.max_us = us;
+    t.hist[bucket]++;
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+void perf_count_flush_pixels(uint32_t pixels) {
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    counters.flush_pixels += pixels;
+    if (pixels > counters.flush_pixels_max) counters.flush_pixels_max = pixels;
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+void perf_count_spi_bytes(uint32_t bytes) {
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    counters.spi_bytes += bytes;
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+void perf_counters_update() {
+    const unsigned long now = millis();
+    const unsigned long elapsed = now - rate_window_start_ms;
+    if (elapsed < 1000) return;
+
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    const uint64_t bytes = counters.spi_bytes;
+    counters.spi_bytes_per_sec = (uint32_t)((bytes - rate_window_start_bytes) * 1000ULL / elapsed);
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+
+    rate_window_start_ms = now;
+    rate_window_start_bytes = bytes;
+}
+
+void perf_counters_snapshot(PerfSnapshot* out) {
+    if (!out) return;
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    *out = counters;
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+const char* perf_timer_name(PerfTimer timer) {
+    return timer < PERF_TIMER_COUNT ? TIMER_NAMES[timer] : "";
+}
@@ -0,0 +1,56 @@
+/*
+ * Performance Counters
+ *
+ * Always-on, fixed-size render/flush instrumentation, reported by GET
+ * /api/health and GET /metrics. Recording is a few adds under a spinlock (safe from the SPI
+ * completion interrupt), so it stays enabled in release builds.
+ *
+ *   PERF_FLUSH          LVGL flush: flush_cb until the panel transfer is done
+ *   PERF_LVGL_HANDLER   one lv_timer_handler() call (render + flush queueing)
+ *   PERF_STRIP_DECODE   one JPEG strip decoded and pushed to the panel
+ *
+ * Each timer keeps count / total / max and a histogram with power-of-two
+ * bucket bounds (PERF_HIST_BOUND_US(i) = 250 us << i, the last bucket is open).
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <Arduino.h>
+
+enum PerfTimer {
+    PERF_FLUSH = 0,
+    PERF_LVGL_HANDLER,
+    PERF_STRIP_DECODE,
+    PERF_TIMER_COUNT
+};
+
+#define PERF_HIST_BUCKETS 8
+#define PERF_HIST_BOUND_US(i) (250UL << (i))  // upper bound of bucket i (< PERF_HIST_BUCKETS - 1)
+
+struct PerfTimerStats {
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint32_t hist[PERF_HIST_BUCKETS];
+};
+
+struct PerfSnapshot {
+    PerfTimerStats timers[PERF_TIMER_COUNT];
+    uint64_t flush_pixels;        // pixels sent by LVGL flushes
+    uint32_t flush_pixels_max;    // largest single flush
+    uint64_t spi_bytes;           // all bytes sent to the panel (commands, LVGL, strips, blits)
+    uint32_t spi_bytes_per_sec;   // over the last completed 1 s window
+};
+
+void perf_record(PerfTimer timer, uint32_t us);
+void perf_count_flush_pixels(uint32_t pixels);
+void perf_count_spi_bytes(uint32_t bytes);
+
+// Roll the SPI rate window; call periodically (render task)
+void perf_counters_update();
+
+void perf_counters_snapshot(PerfSnapshot* out);
+const char* perf_timer_name(PerfTimer timer);  // JSON key, e.g. "flush"
+
+#endif // PERF_COUNTERS_H
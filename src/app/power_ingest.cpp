@@ -0,0 +1,86 @@
+/*
+ * Power Ingest Implementation
+ */
+
+#include "power_ingest.h"
+#include "board_config.h"
+#include "idle_pacer.h"
+#include "log_manager.h"
+
+#include <AsyncUDP.h>
+
+static PowerIngestStats stats = {};
+
+#if POWER_INGEST_UDP_PORT
+static AsyncUDP udp;
+static bool listening = false;
+
+static inline uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// AsyncUDP task: whole datagram is validated before any record is applied
+static void on_packet(AsyncUDPPacket& packet) {
+    stats.udp_packets++;
+    const uint8_t* data = packet.data();
+    const size_t len = packet.length();
+
+    if (len == 0 || len % POWER_INGEST_RECORD_SIZE != 0 ||
+        len > POWER_INGEST_RECORD_SIZE * POWER_INGEST_MAX_RECORDS) {
+        stats.udp_malformed++;
+        return;
+    }
+    for (size_t off = 0; off < len; off += POWER_INGEST_RECORD_SIZE) {
+        if (data[off] != 'E' || data[off + 1] != 'P') {
+            stats.udp_malformed++;
+            return;
+        }
+    }
+
+    for (size_t off = 0; off < len; off += POWER_INGEST_RECORD_SIZE) {
+        const uint8_t* rec = data + off;
+        const int32_t milli = (int32_t)read_le32(rec + 4);
+        power_ingest_push(rec[2], milli * 0.001f, true, read_le32(rec + 8));
+    }
+}
+#endif
+
+void power_ingest_begin() {
+#if POWER_INGEST_UDP_PORT
+    if (listening) return;
+    if (!udp.listen(POWER_INGEST_UDP_PORT)) {
+        Logger.logMessagef("Ingest", "UDP listen on port %d failed", POWER_INGEST_UDP_PORT);
+        return;
+    }
+    udp.onPacket(on_packet);
+    listening = true;
+    Logger.logMessagef("Ingest", "Listening for power values on UDP port %d", POWER_INGEST_UDP_PORT);
+#endif
+}
+
+MqttPushResult power_ingest_push(int id, float value, bool has_seq, uint32_t seq) {
+    const MqttPushResult result = mqtt_manager_push_value(id, value, has_seq, seq);
+    switch (result) {
+        case MQTT_PUSH_OK:
+            stats.accepted++;
+            // Straight to the render task: the network task would only notice
+            // the change on its next (possibly idle-paced) pass
+            idle_pacer_wake();
+            break;
+        case MQTT_PUSH_STALE:
+            stats.stale++;
+            break;
+        default:
+            stats.unknown++;
+            break;
+    }
+    return result;
+}
+
+void power_ingest_count_http() {
+    stats.http_requests++;
+}
+
+void power_ingest_get_stats(PowerIngestStats* out) {
+    if (out) *out = stats;
+}
@@ -0,0 +1,62 @@
+/*
+ * Power Ingest
+ *
+ * Direct, broker-less value updates for the MQTT channel table: a sender on
+ * the LAN (energy meter bridge, Home Assistant automation) pushes values
+ * straight to the device, skipping the broker round trip. Values land in the
+ * same store as MQTT payloads (mqtt_manager_push_value), so screens, history
+ * and /metrics cannot tell the sources apart; both may feed one channel.
+ *
+ * UDP (POWER_INGEST_UDP_PORT, 0 = off): each datagram carries 1..16 records
+ * of 12 bytes, little-endian:
+ *
+ *   offset  size  field
+ *   0       2     magic 'E' 'P'
+ *   2       1     channel id (configuration order: 0 = solar, 1 = grid, ...)
+ *   3       1     flags, 0
+ *   4       4     int32 value in thousandths of the channel unit (W for kW)
+ *   8       4     uint32 sequence number, increasing per sender
+ *
+ * HTTP: POST /api/power (web_portal_api_power.h) with values by channel name.
+ *
+ * Sequenced pushes are ordered per channel (see mqtt_manager_push_value): a
+ * late or duplicated datagram never overwrites a newer value.
+ *
+ * USAGE:
+ *   power_ingest_begin();                        // once the network stack is up
+ *   power_ingest_push(id, value, true, seq);     // HTTP handler
+ */
+
+#ifndef POWER_INGEST_H
+#define POWER_INGEST_H
+
+#include "mqtt_manager.h"
+
+#include <Arduino.h>
+
+#define POWER_INGEST_RECORD_SIZE 12
+#define POWER_INGEST_MAX_RECORDS 16
+
+// Counters since boot (written by the UDP and AsyncTCP tasks, readers may see
+// a sample mid-update)
+struct PowerIngestStats {
+    uint32_t udp_packets;      // datagrams received
+    uint32_t udp_malformed;    // datagrams dropped for size or magic
+    uint32_t http_requests;    // POST /api/power bodies parsed
+    uint32_t accepted;         // values stored
+    uint32_t stale;            // values dropped for an old sequence number
+    uint32_t unknown;          // values for channels that do not exist
+};
+
+// Start the UDP listener (no-op when POWER_INGEST_UDP_PORT is 0 or already listening)
+void power_ingest_begin();
+
+// Store one value and count the outcome (any task)
+MqttPushResult power_ingest_push(int id, float value, bool has_seq, uint32_t seq);
+
+// HTTP handler: one request parsed
+void power_ingest_count_http();
+
+void power_ingest_get_stats(PowerIngestStats* out);
+
+#endif // POWER_INGEST_H
@@ -0,0 +1,103 @@
+/*
+ * Power Statistics
+ *
+ * Sliding-window min/max/avg over the last N samples, O(1) amortized per sample:
+ *   - samples live in a fixed ring (no heap; size is a template parameter)
+ *   - min and max come from monotonic deques of ring positions: each position is
+ *     pushed and popped at most once, so a sample costs O(1) amortized instead of
+ *     a scan of the whole window
+ *   - values are kept as integer watts with a 64-bit running sum, so the average
+ *     does not drift over long uptimes (no float accumulation error)
+ *
+ * Memory: N * (4 + 2 * sizeof(index)) bytes, index = uint16_t up to 65535 samples.
+ */
+
+#ifndef POWER_STATISTICS_H
+#define POWER_STATISTICS_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+template <size_t N>
+class PowerStatistics {
+    static_assert(N > 0, "PowerStatistics window must hold at least one sample");
+    typedef typename std::conditional<(N <= 65535), uint16_t, uint32_t>::type Index;
+
+public:
+    void addSample(float kw) {
+        if (isnan(kw)) return;  // Ignore invalid samples
+
+        const int32_t watts = (int32_t)lroundf(kw * 1000.0f);
+
+        if (count == N) {
+            // Window full: the slot at head holds the oldest sample, drop it
+            running_sum -= ring[head];
+            min_q.drop_front_if(head);
+            max_q.drop_front_if(head);
+        } else {
+            count++;
+        }
+
+        ring[head] = watts;
+        running_sum += watts;
+
+        // Keep deques monotonic: min_q increasing, max_q decreasing (front = extreme)
+        while (!min_q.empty() && ring[min_q.back()] >= watts) min_q.pop_back();
+        min_q.push_back(head);
+        while (!max_q.empty() && ring[max_q.back()] <= watts) max_q.pop_back();
+        max_q.push_back(head);
+
+        head = (head + 1 == N) ? 0 : (Index)(head + 1);
+    }
+
+    float getMin() const { return count ? ring[min_q.front()] / 1000.0f : NAN; }
+    float getMax() const { return count ? ring[max_q.front()] / 1000.0f : NAN; }
+    float getAvg() const { return count ? (float)((double)running_sum / count / 1000.0) : NAN; }
+
+    bool hasData() const { return count > 0; }
+    size_t getSampleCount() const { return count; }
+    static constexpr size_t capacity() { return N; }
+
+    void clear() {
+        head = 0;
+        count = 0;
+        running_sum = 0;
+        min_q.clear();
+        max_q.clear();
+    }
+
+private:
+    // Fixed-capacity double-ended queue of ring positions
+    class IndexDeque {
+    public:
+        bool empty() const { return size == 0; }
+        Index front() const { return items[first]; }
+        Index back() const { return items[wrap(first + size - 1)]; }
+        void push_back(Index v) { items[wrap(first + size)] = v; size++; }
+        void pop_back() { size--; }
+        void drop_front_if(Index v) {
+            if (size && items[first] == v) {
+                first = wrap(first + 1);
+                size--;
+            }
+        }
+        void clear() { first = 0; size = 0; }
+
+    private:
+        static size_t wrap(size_t i) { return i >= N ? i - N : i; }
+        Index items[N];
+        size_t first = 0;
+        size_t size = 0;
+    };
+
+    int32_t ring[N];
+    Index head = 0;
+    size_t count = 0;
+    int64_t running_sum = 0;
+    IndexDeque min_q;
+    IndexDeque max_q;
+};
+
+#endif // POWER_STATISTICS_H
@@ -0,0 +1,140 @@
+/*
+ * Raw RGB565 Image Drawing Implementation
+ */
+
+#include "raw_image.h"
+#include "board_config.h"
+#include "lcd_driver.h"
+#include "log_manager.h"
+
+#include <esp_heap_caps.h>
+
+static const uint16_t RLE_RUN_FLAG = 0x8000;
+static const uint16_t RLE_MAX_COUNT = 0x7FFF;
+
+// Buffered reader for rle565: headers are read word by word, literals in bulk
+struct RleInput {
+    RawImageReadFn read;
+    void* ctx;
+    uint8_t block[256];
+    size_t len;
+    size_t pos;
+    // Current header (carried across bands)
+    uint16_t left;
+    bool run;
+    uint16_t run_px;
+};
+
+// Make at least two bytes available (false at end of data)
+static bool rle_fill(RleInput& in) {
+    if (in.len - in.pos >= sizeof(uint16_t)) return true;
+    const size_t keep = in.len - in.pos;
+    memmove(in.block, in.block + in.pos, keep);
+    in.len = keep + in.read(in.ctx, in.block + keep, sizeof(in.block) - keep);
+    in.pos = 0;
+    return in.len >= sizeof(uint16_t);
+}
+
+static bool rle_word(RleInput& in, uint16_t* word) {
+    if (!rle_fill(in)) return false;
+    memcpy(word, in.block + in.pos, sizeof(*word));
+    in.pos += sizeof(*word);
+    return true;
+}
+
+// Decode count pixels into dst; remaining = pixels left in the image
+static bool rle_decode(RleInput& in, uint16_t* dst, size_t count, size_t remaining) {
+    size_t i = 0;
+    while (i < count) {
+        if (in.left == 0) {
+            uint16_t hdr;
+            if (!rle_word(in, &hdr)) return false;
+            in.run = (hdr & RLE_RUN_FLAG) != 0;
+            in.left = hdr & RLE_MAX_COUNT;
+            if (in.left == 0 || in.left > remaining - i) return false;
+            if (in.run && !rle_word(in, &in.run_px)) return false;
+        }
+
+        size_t n = min((size_t)in.left, count - i);
+        if (in.run) {
+            for (size_t k = 0; k < n; k++) dst[i + k] = in.run_px;
+        } else {
+            // Literals: copy whatever is buffered, at least one pixel
+            if (!rle_fill(in)) return false;
+            n = min(n, (in.len - in.pos) / sizeof(uint16_t));
+            memcpy(dst + i, in.block + in.pos, n * sizeof(uint16_t));
+            in.pos += n * sizeof(uint16_t);
+        }
+        in.left -= n;
+        i += n;
+    }
+    return true;
+}
+
+// Read exactly len bytes (the source may return short counts)
+static bool read_full(RawImageReadFn read, void* ctx, uint8_t* buf, size_t len) {
+    while (len > 0) {
+        const size_t n = read(ctx, buf, len);
+        if (n == 0) return false;
+        buf += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool raw_image_draw(bool rle, int x, int y, int width, int height, RawImageReadFn read, void* read_ctx) {
+    if (width <= 0 || height <= 0 || x < 0 || y < 0 || x + width > LCD_LOGICAL_WIDTH || y + height > LCD_LOGICAL_HEIGHT) {
+        Logger.logMessagef("RawImage", "ERROR: %dx%d at %d,%d does not fit the panel", width, height, x, y);
+        return false;
+    }
+
+    const size_t band_pixels = (size_t)width * RAW_IMAGE_BAND_ROWS;
+    uint16_t* bands[2];
+    bands[0] = (uint16_t*)heap_caps_malloc(band_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+    bands[1] = (uint16_t*)heap_caps_malloc(band_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+    RleInput* in = rle ? (RleInput*)calloc(1, sizeof(RleInput)) : nullptr;
+    if (!bands[0] || !bands[1] || (rle && !in)) {
+        Logger.logMessage("RawImage", "ERROR: Band buffer allocation failed");
+        heap_caps_free(bands[0]);
+        heap_caps_free(bands[1]);
+        free(in);
+        return false;
+    }
+    if (in) {
+        in->read = read;
+        in->ctx = read_ctx;
+    }
+
+    const unsigned long start_us = micros();
+    const size_t total = (size_t)width * height;
+    bool ok = true;
+    int cur = 0;
+
+    for (int row = 0; row < height; row += RAW_IMAGE_BAND_ROWS) {
+        const int rows = min(RAW_IMAGE_BAND_ROWS, height - row);
+        const size_t count = (size_t)width * rows;
+        uint16_t* band = bands[cur];
+
+        // Fill one band while the other is still on the bus; the async push
+        // below waits for that transfer before queueing this one
+        ok = rle ? rle_decode(*in, band, count, total - (size_t)width * row)
+                 : read_full(read, read_ctx, (uint8_t*)band, count * sizeof(uint16_t));
+        if (!ok) {
+            Logger.logMessagef("RawImage", "ERROR: %s data ends or is corrupt at row %d",
+                               rle ? "rle565" : "rgb565", row);
+            break;
+        }
+
+        lcd_push_pixels_async(x, y + row, x + width - 1, y + row + rows - 1, band, count, nullptr, nullptr);
+        cur ^= 1;
+    }
+    lcd_wait_idle();
+
+    heap_caps_free(bands[0]);
+    heap_caps_free(bands[1]);
+    free(in);
+
+    LOG_DEBUGF(LOG_MODULE_IMAGE, "Raw %s %dx%d at %d,%d: %lu us",
+               rle ? "rle565" : "rgb565", width, height, x, y, micros() - start_us);
+    return ok;
+}
@@ -0,0 +1,38 @@
+/*
+ * Raw RGB565 Image Drawing
+ *
+ * Draws uncompressed or run-length encoded RGB565 straight to an LCD window,
+ * for server-rendered graphics (dashboards, text cards) where JPEG is lossy and
+ * the TJpgDec decode is the expensive part. Pixels are already in panel byte
+ * order, so drawing is a copy into a band buffer and a DMA push; no color
+ * conversion.
+ *
+ * Formats (row-major, top to bottom):
+ *   rgb565   width * height pixels, 2 bytes each, high byte first
+ *   rle565   stream of 16-bit little-endian header words, each followed by pixels
+ *            (high byte first) - the image cache frame encoding:
+ *              0x8000 | n, pixel         run of n identical pixels (n = 1..32767)
+ *              n, pixel_1 ... pixel_n    n literal pixels (n = 1..32767)
+ *            Runs and literals may cross row boundaries.
+ *
+ * Memory: two band buffers of width x RAW_IMAGE_BAND_ROWS pixels (one fills
+ * while the other is on the SPI bus), allocated per call.
+ */
+
+#ifndef RAW_IMAGE_H
+#define RAW_IMAGE_H
+
+#include <Arduino.h>
+
+#define RAW_IMAGE_BAND_ROWS 8
+
+// Byte source: copy up to len bytes into buf and return the count (0 = end of
+// data or error). Same contract as StripReadFn.
+typedef size_t (*RawImageReadFn)(void* ctx, uint8_t* buf, size_t len);
+
+// Draw a width x height image at LCD (x, y), pulling the encoded bytes through
+// read(). rle selects rle565, otherwise rgb565. False on short or corrupt data
+// (rows already drawn stay on screen) or if the buffers cannot be allocated.
+bool raw_image_draw(bool rle, int x, int y, int width, int height, RawImageReadFn read, void* read_ctx);
+
+#endif // RAW_IMAGE_H
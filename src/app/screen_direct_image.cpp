@@ -7,6 +7,7 @@
 
 #include "screen_direct_image.h"
 #include "log_manager.h"
+#include "board_config.h"
 #include <Arduino.h>
 
 DirectImageScreen::DirectImageScreen() {
@@ -70,6 +71,7 @@ void DirectImageScreen::show() {
     // This sets visible = true which blocks PowerScreen rendering
     lv_scr_load(screen_obj);
     visible = true;
+    invalidate();
     
     // Set timeout start time if not already set
     if (display_start_time == 0) {
@@ -96,25 +98,29 @@ void DirectImageScreen::hide() {
     Logger.logEnd();
 }
 
-void DirectImageScreen::begin_strip_session(int width, int height) {
+bool DirectImageScreen::begin_strip_session(int width, int height, uint8_t scale) {
     Logger.logBegin("Strip Session");
-    Logger.logLinef("Image: %dx%d", width, height);
+    Logger.logLinef("Image: %dx%d%s", width, height, scale ? " (scaled decode)" : "");
     
-    // Initialize decoder
-    decoder.begin(width, height);
-    session_active = true;
+    // Initialize decoder (allocates the per-session decode buffers)
+    session_active = decoder.begin(width, height);
+    if (session_active) {
+        decoder.set_scale(scale);
+    }
+    invalidate();
     
-    Logger.logEnd();
+    Logger.logEnd(session_active ? nullptr : "ERROR: decoder init failed");
+    return session_active;
 }
 
-bool DirectImageScreen::decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, int strip_index, bool output_bgr565) {
+bool DirectImageScreen::decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, int strip_index) {
     if (!session_active) {
         Logger.logMessage("DirectImageScreen", "ERROR: No active strip session");
         return false;
     }
     
     // Decode strip and write directly to LCD
-    bool success = decoder.decode_strip(jpeg_data, jpeg_size, strip_index, output_bgr565);
+    bool success = decoder.decode_strip(jpeg_data, jpeg_size, strip_index);
     
     if (!success) {
         Logger.logMessagef("DirectImageScreen", "ERROR: Strip %d decode failed", strip_index);
@@ -123,6 +129,38 @@ bool DirectImageScreen::decode_strip(const uint8_t* jpeg_data, size_t jpeg_size,
     return success;
 }
 
+bool DirectImageScreen::decode_stream(StripReadFn read, void* read_ctx) {
+    if (!session_active) {
+        Logger.logMessage("DirectImageScreen", "ERROR: No active strip session");
+        return false;
+    }
+
+    bool success = decoder.decode_stream(read, read_ctx, 0);
+
+    if (!success) {
+        Logger.logMessage("DirectImageScreen", "ERROR: Stream decode failed");
+    }
+
+    return success;
+}
+
+bool DirectImageScreen::decode_tile(const uint8_t* jpeg_data, size_t jpeg_size, int x, int y) {
+    // Session bounds: everything right of / below the origin
+    if (!tile_decoder.begin(LCD_LOGICAL_WIDTH - x, LCD_LOGICAL_HEIGHT - y)) {
+        return false;
+    }
+    tile_decoder.set_origin(x, y);
+
+    bool success = tile_decoder.decode_strip(jpeg_data, jpeg_size, 0);
+    tile_decoder.end();
+
+    if (!success) {
+        Logger.logMessagef("DirectImageScreen", "ERROR: Tile decode at %d,%d failed", x, y);
+    }
+
+    return success;
+}
+
 void DirectImageScreen::end_strip_session() {
     if (!session_active) return;
     
@@ -28,12 +28,21 @@ public:
     // Start strip upload session
     // width: image width in pixels
     // height: image height in pixels
-    void begin_strip_session(int width, int height);
+    // scale: strips are decoded at 1/2^scale (0..3, see StripDecoder::set_scale)
+    // Returns: false if decoder buffers could not be allocated
+    bool begin_strip_session(int width, int height, uint8_t scale = 0);
     
     // Decode and display a single strip
     // Returns: true on success, false on failure
-    bool decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, int strip_index, bool output_bgr565 = true);
+    bool decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, int strip_index);
+
+    // Decode a whole JPEG pulled through read() (streaming upload)
+    bool decode_stream(StripReadFn read, void* read_ctx);
     
+    // Decode a small JPEG with its top-left corner at LCD (x, y), over whatever
+    // is on screen. Independent of the strip session (own decoder and buffers).
+    bool decode_tile(const uint8_t* jpeg_data, size_t jpeg_size, int x, int y);
+
     // End strip upload session
     void end_strip_session();
     
@@ -48,9 +57,15 @@ public:
     
     // Get strip decoder for progress tracking
     StripDecoder* get_decoder() { return &decoder; }
+
+    // Changes whenever the picture on the panel is replaced or may have been lost
+    // (show(), a new strip session, invalidate()); partial updates keep it
+    uint32_t get_content_epoch() const { return content_epoch; }
+    void invalidate() { content_epoch++; }
     
 private:
     StripDecoder decoder;
+    StripDecoder tile_decoder;  // buffers only allocated during decode_tile()
     
     // Timeout tracking
     unsigned long display_start_time = 0;
@@ -58,6 +73,8 @@ private:
     
     // Session state
     bool session_active = false;
+
+    uint32_t content_epoch = 0;
 };
 
 #endif // SCREEN_DIRECT_IMAGE_H
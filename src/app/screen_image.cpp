@@ -4,6 +4,7 @@
 
 #include "screen_image.h"
 #include "log_manager.h"
+#include "mem_placement.h"
 #include <Arduino.h>
 #include <stdlib.h>
 
@@ -159,6 +160,36 @@ void ImageScreen::set_start_time(unsigned long start_time) {
 }
 
 bool ImageScreen::load_image(const uint8_t* jpeg_data, size_t jpeg_size) {
+    bool is_sjpg = false;
+    if (!begin_load(jpeg_data, jpeg_size, &is_sjpg)) {
+        return false;
+    }
+
+    // Allocate buffer for image data (PSRAM when present: SJPG reads it sequentially)
+    uint8_t* copy = (uint8_t*)mem_alloc_large(jpeg_size);
+    if (!copy) {
+        vfs_busy = false;
+        Logger.logEnd("ERROR: Out of memory");
+        return false;
+    }
+    memcpy(copy, jpeg_data, jpeg_size);
+
+    finish_load(copy, jpeg_size, is_sjpg);
+    return true;
+}
+
+bool ImageScreen::adopt_image(uint8_t* jpeg_data, size_t jpeg_size) {
+    bool is_sjpg = false;
+    if (!begin_load(jpeg_data, jpeg_size, &is_sjpg)) {
+        free(jpeg_data);
+        return false;
+    }
+
+    finish_load(jpeg_data, jpeg_size, is_sjpg);
+    return true;
+}
+
+bool ImageScreen::begin_load(const uint8_t* jpeg_data, size_t jpeg_size, bool* is_sjpg) {
     if (!jpeg_data || jpeg_size == 0) {
         Logger.logMessage("ImageScreen", "ERROR: Invalid image data");
         return false;
@@ -168,9 +199,9 @@ bool ImageScreen::load_image(const uint8_t* jpeg_data, size_t jpeg_size) {
     // We support both, but LVGL must be given the correct "filename" so it picks
     // the right decoder.
     const bool is_jpeg = (jpeg_size >= 3 && jpeg_data[0] == 0xFF && jpeg_data[1] == 0xD8 && jpeg_data[2] == 0xFF);
-    const bool is_sjpg = (jpeg_size >= 4 && jpeg_data[0] == '_' && jpeg_data[1] == 'S' && jpeg_data[2] == 'J' && jpeg_data[3] == 'P');
+    *is_sjpg = (jpeg_size >= 4 && jpeg_data[0] == '_' && jpeg_data[1] == 'S' && jpeg_data[2] == 'J' && jpeg_data[3] == 'P');
 
-    if (!is_jpeg && !is_sjpg) {
+    if (!is_jpeg && !*is_sjpg) {
         Logger.logMessage("ImageScreen", "ERROR: Unsupported image format (expected JPEG or SJPG)");
         return false;
     }
@@ -193,22 +224,16 @@ bool ImageScreen::load_image(const uint8_t* jpeg_data, size_t jpeg_size) {
     
     // Mark VFS as busy
     vfs_busy = true;
-    
-    // Allocate buffer for image data
-    image_buffer = (uint8_t*)malloc(jpeg_size);
-    if (!image_buffer) {
-        vfs_busy = false;
-        Logger.logEnd("ERROR: Out of memory");
-        return false;
-    }
-    
-    // Copy image data
-    memcpy(image_buffer, jpeg_data, jpeg_size);
-    buffer_size = jpeg_size;
+    return true;
+}
+
+void ImageScreen::finish_load(uint8_t* buffer, size_t size, bool is_sjpg) {
+    image_buffer = buffer;
+    buffer_size = size;
     
     // Set up virtual file system pointers
     vfs_jpeg_data = image_buffer;
-    vfs_jpeg_size = jpeg_size;
+    vfs_jpeg_size = size;
     vfs_jpeg_pos = 0;
     
     // Load image from virtual "file"
@@ -238,8 +263,6 @@ bool ImageScreen::load_image(const uint8_t* jpeg_data, size_t jpeg_size) {
     
     // Keep vfs_busy = true while image is displayed
     // Will be cleared in clear_image()
-    
-    return true;
 }
 
 void ImageScreen::clear_image() {
@@ -22,9 +22,14 @@ public:
     void show() override;
     void hide() override;
     
-    // Load JPEG image from memory buffer
+    // Load JPEG image from memory buffer (copied; the caller keeps jpeg_data)
     bool load_image(const uint8_t* jpeg_data, size_t jpeg_size);
     
+    // Load JPEG image and take ownership of the buffer (no copy): the LVGL decoder
+    // reads it in place and clear_image() frees it. jpeg_data must come from
+    // malloc()/mem_alloc_large() and is freed here on failure too.
+    bool adopt_image(uint8_t* jpeg_data, size_t jpeg_size);
+    
     // Clear current image
     void clear_image();
     
@@ -40,7 +45,12 @@ public:
 private:
     lv_obj_t* img_obj = nullptr;
     
-    // Image data buffer (allocated on heap)
+    // load_image/adopt_image steps: validate and release the previous image,
+    // then point the VFS and the image object at the new buffer
+    bool begin_load(const uint8_t* jpeg_data, size_t jpeg_size, bool* is_sjpg);
+    void finish_load(uint8_t* buffer, size_t size, bool is_sjpg);
+    
+    // Image data buffer (copied or adopted; owned here)
     uint8_t* image_buffer = nullptr;
     size_t buffer_size = 0;
     
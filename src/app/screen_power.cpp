@@ -5,220 +5,84 @@
  */
 
 #include "screen_power.h"
+#include "board_config.h"
 #include "config_manager.h"
 #include "icons.h"
+#include "numeric_label.h"
+#include "power_statistics.h"
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 // External reference to global configuration
 extern DeviceConfig device_config;
 
-// Color definitions for power state visualization
-// 
-// Display hardware is BGR mode, and we swap RGB→BGR in flush callback to fix anti-aliasing
-// Therefore, we define colors in BGR format here so they display correctly after the swap
-// 
-// BGR color mapping (what we define → what displays):
-//   Define BLUE 0x0000FF   → displays as RED (after RGB→BGR swap)
-//   Define GREEN 0x00FF00  → displays as GREEN (G channel unaffected)
-//   Define RED 0xFF0000    → displays as BLUE (after RGB→BGR swap)
-//   Define 0x00A5FF        → displays as ORANGE (BGR for orange)
-//
-const lv_color_t COLOR_BRIGHT_GREEN = lv_color_hex(0x00FF00);  // Green (unaffected by swap)
-const lv_color_t COLOR_WHITE        = lv_color_hex(0xFFFFFF);  // White (unaffected)
-const lv_color_t COLOR_ORANGE       = lv_color_hex(0x00A5FF);  // BGR for orange (displays as RGB 255,165,0)
-const lv_color_t COLOR_RED          = lv_color_hex(0x0000FF);  // BGR for red (displays as RGB 255,0,0)
+// Color definitions for power state visualization (true RGB, as displayed)
+const lv_color_t COLOR_BRIGHT_GREEN = lv_color_hex(0x00FF00);  // Green
+const lv_color_t COLOR_WHITE        = lv_color_hex(0xFFFFFF);  // White
+const lv_color_t COLOR_ORANGE       = lv_color_hex(0xFFA500);  // Orange (255,165,0)
+const lv_color_t COLOR_RED          = lv_color_hex(0xFF0000);  // Red
 
 #define TEXT_COLOR lv_color_hex(0xFFFFFF)
 
+// Value label width: one column (107px) minus a small gap
+#define VALUE_WIDTH 100
+
 // ============================================================================
-// PowerStatistics Class - Rolling Window Statistics
+// Rolling Window Statistics
 // ============================================================================
+// One window per series, statically allocated (single PowerScreen instance):
+// POWER_STATS_WINDOW_SAMPLES at the 1-second update rate (default 600 = 10 min).
 
-class PowerStatistics {
-public:
-    PowerStatistics(size_t buffer_size = 600) : buffer_size(buffer_size) {
-        buffer.reserve(buffer_size);
-    }
-    
-    void addSample(float value) {
-        if (isnan(value)) return;  // Ignore invalid samples
-        
-        if (buffer.size() < buffer_size) {
-            // Buffer not full yet
-            buffer.push_back(value);
-            running_sum += value;
-        } else {
-            // Circular buffer - replace oldest
-            running_sum -= buffer[head];
-            buffer[head] = value;
-            running_sum += value;
-            head = (head + 1) % buffer_size;
-        }
-        
-        // Recalculate min/max (could optimize with heap, but 120 samples is fast enough)
-        recalculate();
-    }
-    
-    float getMin() const { return cached_min; }
-    float getMax() const { return cached_max; }
-    float getAvg() const { return cached_avg; }
-    
-    bool hasData() const { return !buffer.empty(); }
-    size_t getSampleCount() const { return buffer.size(); }
-    
-    void clear() {
-        buffer.clear();
-        head = 0;
-        running_sum = 0.0f;
-        cached_min = NAN;
-        cached_max = NAN;
-        cached_avg = NAN;
-    }
-    
-private:
-    std::vector<float> buffer;
-    size_t buffer_size;
-    size_t head = 0;
-    float running_sum = 0.0f;
-    
-    // Cached statistics
-    float cached_min = NAN;
-    float cached_max = NAN;
-    float cached_avg = NAN;
-    
-    void recalculate() {
-        if (buffer.empty()) {
-            cached_min = cached_max = cached_avg = NAN;
-            return;
-        }
-        
-        // Calculate min/max
-        cached_min = buffer[0];
-        cached_max = buffer[0];
-        for (const float& val : buffer) {
-            if (val < cached_min) cached_min = val;
-            if (val > cached_max) cached_max = val;
-        }
-        
-        // Calculate average from running sum
-        cached_avg = running_sum / buffer.size();
-    }
-};
+typedef PowerStatistics<POWER_STATS_WINDOW_SAMPLES> PowerWindow;
+
+static PowerWindow solar_window;
+static PowerWindow home_window;
+static PowerWindow grid_window;
 
 PowerScreen::PowerScreen() {
-    // Initialize statistics trackers (10 minutes @ 1-second sampling = 600 samples)
-    solar_stats = static_cast<void*>(new PowerStatistics(600));
-    home_stats = static_cast<void*>(new PowerStatistics(600));
-    grid_stats = static_cast<void*>(new PowerStatistics(600));
+    solar_stats = static_cast<void*>(&solar_window);
+    home_stats = static_cast<void*>(&home_window);
+    grid_stats = static_cast<void*>(&grid_window);
 }
 
 PowerScreen::~PowerScreen() {
     destroy();
     
-    // Clean up statistics
-    delete static_cast<PowerStatistics*>(solar_stats);
-    delete static_cast<PowerStatistics*>(home_stats);
-    delete static_cast<PowerStatistics*>(grid_stats);
+    // Statistics storage is static; just detach
     solar_stats = nullptr;
     home_stats = nullptr;
     grid_stats = nullptr;
 }
 
-// Helper: Convert RGB to BGR for display hardware compatibility
-lv_color_t PowerScreen::rgb_to_bgr(uint32_t rgb) {
-    uint8_t r = (rgb >> 16) & 0xFF;
-    uint8_t g = (rgb >> 8) & 0xFF;
-    uint8_t b = rgb & 0xFF;
-    return lv_color_hex((b << 16) | (g << 8) | r);
-}
-
 // Unified color determination based on configurable thresholds
-lv_color_t PowerScreen::get_power_color(float value, float thresholds[3]) {
+uint32_t PowerScreen::get_power_color(float value, const float thresholds[3]) {
     if (isnan(value)) {
         // No data - use "ok" color (typically white)
-        return rgb_to_bgr(device_config.color_ok);
+        return device_config.color_ok;
     }
     
-    uint32_t rgb;
     if (value < thresholds[0]) {
-        rgb = device_config.color_good;
+        return device_config.color_good;
     } else if (value < thresholds[1]) {
-        rgb = device_config.color_ok;
+        return device_config.color_ok;
     } else if (value < thresholds[2]) {
-        rgb = device_config.color_attention;
-    } else {
-        rgb = device_config.color_warning;
+        return device_config.color_attention;
     }
-    
-    return rgb_to_bgr(rgb);
-}
-
-// Convenience wrappers for each power type
-lv_color_t PowerScreen::get_grid_color(float kw) {
-    return get_power_color(kw, device_config.grid_threshold);
-}
-
-lv_color_t PowerScreen::get_home_color(float kw) {
-    return get_power_color(kw, device_config.home_threshold);
-}
-
-lv_color_t PowerScreen::get_solar_color(float kw) {
-    return get_power_color(kw, device_config.solar_threshold);
+    return device_config.color_warning;
 }
 
-void PowerScreen::update_power_colors() {
-    // Calculate colors based on current values
-    lv_color_t solar_color = get_solar_color(solar_kw);
-    lv_color_t grid_color = get_grid_color(grid_kw);
-    
-    float home_kw = NAN;
-    if (!isnan(solar_kw) && !isnan(grid_kw)) {
-        home_kw = solar_kw + grid_kw;
-    }
-    lv_color_t home_color = get_home_color(home_kw);
-    
-    // Apply colors to solar widgets
-    if (solar_icon) {
-        lv_obj_set_style_img_recolor(solar_icon, solar_color, LV_PART_MAIN);
-    }
-    if (solar_value) {
-        lv_obj_set_style_text_color(solar_value, solar_color, LV_PART_MAIN);
-    }
-    if (solar_unit) {
-        lv_obj_set_style_text_color(solar_unit, solar_color, LV_PART_MAIN);
-    }
-    if (arrow1) {
-        lv_obj_set_style_text_color(arrow1, solar_color, LV_PART_MAIN);
-    }
-    
-    // Apply colors to home widgets
-    if (home_icon) {
-        lv_obj_set_style_img_recolor(home_icon, home_color, LV_PART_MAIN);
-    }
-    if (home_value) {
-        lv_obj_set_style_text_color(home_value, home_color, LV_PART_MAIN);
-    }
-    if (home_unit) {
-        lv_obj_set_style_text_color(home_unit, home_color, LV_PART_MAIN);
-    }
-    
-    // Apply colors to grid widgets
-    if (grid_icon) {
-        lv_obj_set_style_img_recolor(grid_icon, grid_color, LV_PART_MAIN);
-    }
-    if (grid_value) {
-        lv_obj_set_style_text_color(grid_value, grid_color, LV_PART_MAIN);
-    }
-    if (grid_unit) {
-        lv_obj_set_style_text_color(grid_unit, grid_color, LV_PART_MAIN);
-    }
-    if (arrow2) {
-        lv_obj_set_style_text_color(arrow2, grid_color, LV_PART_MAIN);
-    }
-    
-    // Update bar charts with matching colors
-    update_bar_charts();
+void PowerScreen::invalidate() {
+    ColumnState* states[] = {&solar_state, &home_state, &grid_state};
+    for (ColumnState* state : states) {
+        state->text[0] = '\0';
+        state->color = 0xFFFFFFFFu;  // not a 24-bit RGB value: always differs
+        state->bar_value = -1;
+        state->line_min_y = INT32_MIN;
+        state->line_max_y = INT32_MIN;
+    }
+    arrow1_hidden = -1;
+    arrow2_import = -1;
 }
 
 void PowerScreen::create() {
@@ -274,26 +138,20 @@ void PowerScreen::create() {
     lv_obj_set_style_img_recolor_opa(grid_icon, LV_OPA_COVER, 0);
     lv_obj_align(grid_icon, LV_ALIGN_TOP_MID, 107, 15);
     
-    // Values row at Y=90px
+    // Values row at Y=90px (glyph atlas labels, see numeric_label.h)
     // Solar value
-    solar_value = lv_label_create(background);
-    lv_label_set_text(solar_value, "--");
-    lv_obj_set_style_text_font(solar_value, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(solar_value, COLOR_WHITE, 0);
+    solar_value = numeric_label_create(background, VALUE_WIDTH);
+    numeric_label_set_text(solar_value, "--");
     lv_obj_align(solar_value, LV_ALIGN_TOP_MID, -107, 80);
     
     // Home value
-    home_value = lv_label_create(background);
-    lv_label_set_text(home_value, "--");
-    lv_obj_set_style_text_font(home_value, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(home_value, COLOR_WHITE, 0);
+    home_value = numeric_label_create(background, VALUE_WIDTH);
+    numeric_label_set_text(home_value, "--");
     lv_obj_align(home_value, LV_ALIGN_TOP_MID, 0, 80);
     
     // Grid value
-    grid_value = lv_label_create(background);
-    lv_label_set_text(grid_value, "--");
-    lv_obj_set_style_text_font(grid_value, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(grid_value, COLOR_WHITE, 0);
+    grid_value = numeric_label_create(background, VALUE_WIDTH);
+    numeric_label_set_text(grid_value, "--");
     lv_obj_align(grid_value, LV_ALIGN_TOP_MID, 107, 80);
     
     // Units row at Y=105px
@@ -380,6 +238,25 @@ void PowerScreen::create() {
     // Grid min/max lines
     grid_line_min = create_line();
     grid_line_max = create_line();
+    
+    /* LVGL line positioning: Points are RELATIVE to line object position.
+     * The points never change (span the bar width, 2px left + 5px right of the
+     * bar center); refresh only moves the line objects.
+     */
+    const int32_t bar_width = 12;
+    lv_point_t* point_sets[] = {solar_min_points, solar_max_points, home_min_points,
+                                home_max_points, grid_min_points, grid_max_points};
+    lv_obj_t* lines[] = {solar_line_min, solar_line_max, home_line_min,
+                         home_line_max, grid_line_min, grid_line_max};
+    for (int i = 0; i < 6; i++) {
+        point_sets[i][0].x = -(bar_width/2 + 2);
+        point_sets[i][0].y = 0;
+        point_sets[i][1].x = bar_width/2 + 5;
+        point_sets[i][1].y = 0;
+        lv_line_set_points(lines[i], point_sets[i], 2);
+    }
+    
+    invalidate();
 }
 
 void PowerScreen::destroy() {
@@ -407,6 +284,7 @@ void PowerScreen::show() {
     if (screen_obj) {
         lv_scr_load(screen_obj);
         visible = true;
+        refresh();  // catch up on values received while hidden
     }
 }
 
@@ -414,233 +292,166 @@ void PowerScreen::hide() {
     visible = false;
 }
 
-void PowerScreen::set_solar_power(float kw) {
-    solar_kw = kw;  // Always update internal state for statistics
+void PowerScreen::set_power(float solar, float grid) {
+    solar_kw = solar;
+    grid_kw = grid;
     
-    // Skip widget updates if screen is not visible (prevents race conditions)
-    if (!visible) {
-        // Still update statistics even when not visible
-        update_statistics();
-        return;
-    }
-    
-    if (solar_value) {
-        if (isnan(kw)) {
-            lv_label_set_text(solar_value, "--");
-        } else {
-            char buf[16];
-            snprintf(buf, sizeof(buf), "%.2f", kw);
-            lv_label_set_text(solar_value, buf);
-        }
-    }
-    
-    // Hide/show arrow1 based on solar power
-    if (arrow1) {
-        if (!isnan(kw) && kw >= 0.01) {
-            lv_obj_clear_flag(arrow1, LV_OBJ_FLAG_HIDDEN);
-        } else {
-            lv_obj_add_flag(arrow1, LV_OBJ_FLAG_HIDDEN);
-        }
-    }
-    
-    update_home_value();
-    update_power_colors();
+    // Statistics are sampled even when not visible
     update_statistics();
+    refresh();
+}
+
+void PowerScreen::set_values(float solar, float grid) {
+    solar_kw = solar;
+    grid_kw = grid;
+    refresh();
+}
+
+void PowerScreen::set_solar_power(float kw) {
+    solar_kw = kw;
+    refresh();
 }
 
 void PowerScreen::set_grid_power(float kw) {
-    grid_kw = kw;  // Always update internal state for statistics
-    
-    // Skip widget updates if screen is not visible (prevents race conditions)
-    if (!visible) {
-        // Still update statistics even when not visible
-        update_statistics();
-        return;
-    }
-    
-    if (grid_value) {
-        if (isnan(kw)) {
-            lv_label_set_text(grid_value, "--");
-        } else {
-            char buf[16];
-            snprintf(buf, sizeof(buf), "%.2f", kw);
-            lv_label_set_text(grid_value, buf);
-        }
-    }
-    
-    // Update arrow direction based on grid power
-    if (arrow2) {
-        if (!isnan(kw) && kw > 0) {
-            lv_label_set_text(arrow2, LV_SYMBOL_LEFT);  // Drawing from grid (import)
-        } else {
-            lv_label_set_text(arrow2, LV_SYMBOL_RIGHT);  // Sending to grid (export)
-        }
-    }
-    
-    update_home_value();
-    update_power_colors();
-    update_statistics();
+    grid_kw = kw;
+    refresh();
 }
 
-void PowerScreen::update_home_value() {
-    if (!home_value) return;
-    if (!visible) return;  // Skip widget updates if screen is not visible
+void PowerScreen::refresh() {
+    // Skip widget updates if screen is not visible (prevents race conditions);
+    // show() refreshes once it is
+    if (!visible || !screen_obj) return;
     
-    // Calculate home consumption: home = grid + solar
+    float home_kw = NAN;
     if (!isnan(solar_kw) && !isnan(grid_kw)) {
-        float home_kw = grid_kw + solar_kw;
-        char buf[16];
-        snprintf(buf, sizeof(buf), "%.2f", home_kw);
-        lv_label_set_text(home_value, buf);
-    } else {
-        lv_label_set_text(home_value, "--");
-    }
-    update_power_colors();
-}
-
-void PowerScreen::update_bar_charts() {
-    if (!visible) return;  // Skip widget updates if screen is not visible
-    
-    // Update solar bar (0-3kW range, show absolute value)
-    if (solar_bar) {
-        if (!isnan(solar_kw)) {
-            int32_t value = (int32_t)(fabs(solar_kw) * 1000.0f);  // Convert to watts
-            if (value > 3000) value = 3000;  // Cap at max
-            lv_bar_set_value(solar_bar, value, LV_ANIM_OFF);
-            lv_obj_set_style_bg_color(solar_bar, get_solar_color(solar_kw), LV_PART_INDICATOR);
-        } else {
-            lv_bar_set_value(solar_bar, 0, LV_ANIM_OFF);
-        }
+        home_kw = solar_kw + grid_kw;
     }
     
-    // Update home bar (0-3kW range, show absolute value)
-    if (home_bar) {
-        if (!isnan(solar_kw) && !isnan(grid_kw)) {
-            float home_kw = grid_kw + solar_kw;
-            int32_t value = (int32_t)(fabs(home_kw) * 1000.0f);
-            if (value > 3000) value = 3000;
-            lv_bar_set_value(home_bar, value, LV_ANIM_OFF);
-            lv_obj_set_style_bg_color(home_bar, get_home_color(home_kw), LV_PART_INDICATOR);
+    apply_column(solar_state, solar_kw, device_config.solar_threshold,
+                 solar_icon, solar_value, solar_unit, arrow1, solar_bar);
+    apply_column(home_state, home_kw, device_config.home_threshold,
+                 home_icon, home_value, home_unit, nullptr, home_bar);
+    apply_column(grid_state, grid_kw, device_config.grid_threshold,
+                 grid_icon, grid_value, grid_unit, arrow2, grid_bar);
+    
+    // Hide/show arrow1 based on solar power
+    const int8_t hide_arrow1 = (!isnan(solar_kw) && solar_kw >= 0.01) ? 0 : 1;
+    if (arrow1 && hide_arrow1 != arrow1_hidden) {
+        if (hide_arrow1) {
+            lv_obj_add_flag(arrow1, LV_OBJ_FLAG_HIDDEN);
         } else {
-            lv_bar_set_value(home_bar, 0, LV_ANIM_OFF);
+            lv_obj_clear_flag(arrow1, LV_OBJ_FLAG_HIDDEN);
         }
+        arrow1_hidden = hide_arrow1;
     }
     
-    // Update grid bar (0-3kW range, show absolute value)
-    if (grid_bar) {
-        if (!isnan(grid_kw)) {
-            int32_t value = (int32_t)(fabs(grid_kw) * 1000.0f);
-            if (value > 3000) value = 3000;
-            lv_bar_set_value(grid_bar, value, LV_ANIM_OFF);
-            lv_obj_set_style_bg_color(grid_bar, get_grid_color(grid_kw), LV_PART_INDICATOR);
-        } else {
-            lv_bar_set_value(grid_bar, 0, LV_ANIM_OFF);
-        }
+    // Arrow direction based on grid power
+    const int8_t import = (!isnan(grid_kw) && grid_kw > 0) ? 1 : 0;
+    if (arrow2 && import != arrow2_import) {
+        // LEFT = drawing from grid (import), RIGHT = sending to grid (export)
+        lv_label_set_text(arrow2, import ? LV_SYMBOL_LEFT : LV_SYMBOL_RIGHT);
+        arrow2_import = import;
     }
+    
+    // Min/max overlays (x offsets match the bar columns)
+    apply_overlay(solar_state, solar_stats, solar_line_min, solar_line_max, -107);
+    apply_overlay(home_state, home_stats, home_line_min, home_line_max, 0);
+    apply_overlay(grid_state, grid_stats, grid_line_min, grid_line_max, 107);
 }
 
-void PowerScreen::update_statistics() {
-    unsigned long current_time = millis();
-    
-    // Sample on every display update (1 second) to catch all MQTT updates
-    // MQTT updates arrive at max 2× per second (500ms), display updates every 1000ms
-    // This ensures we never miss significant min/max values
-    
-    // Add samples to statistics buffers
-    if (solar_stats) {
-        PowerStatistics* stats = static_cast<PowerStatistics*>(solar_stats);
-        stats->addSample(solar_kw);
+void PowerScreen::apply_column(ColumnState& state, float kw, const float thresholds[3],
+                               lv_obj_t* icon, lv_obj_t* value, lv_obj_t* unit, lv_obj_t* arrow, lv_obj_t* bar) {
+    // Value label: compare the formatted text, not the float
+    char text[sizeof(state.text)];
+    if (isnan(kw)) {
+        snprintf(text, sizeof(text), "--");
+    } else {
+        snprintf(text, sizeof(text), "%.2f", kw);
+    }
+    if (value && strcmp(text, state.text) != 0) {
+        numeric_label_set_text(value, text);
+        memcpy(state.text, text, sizeof(text));
     }
     
-    if (grid_stats) {
-        PowerStatistics* stats = static_cast<PowerStatistics*>(grid_stats);
-        stats->addSample(grid_kw);
+    // Color bucket shared by every widget of the column
+    const uint32_t rgb = get_power_color(kw, thresholds);
+    if (rgb != state.color) {
+        const lv_color_t color = lv_color_hex(rgb);
+        if (icon) lv_obj_set_style_img_recolor(icon, color, LV_PART_MAIN);
+        if (value) numeric_label_set_color(value, color);
+        if (unit) lv_obj_set_style_text_color(unit, color, LV_PART_MAIN);
+        if (arrow) lv_obj_set_style_text_color(arrow, color, LV_PART_MAIN);
+        if (bar) lv_obj_set_style_bg_color(bar, color, LV_PART_INDICATOR);
+        state.color = rgb;
     }
     
-    // Calculate home consumption and add to home stats
-    float home_kw = NAN;
-    if (!isnan(solar_kw) && !isnan(grid_kw)) {
-        home_kw = solar_kw + grid_kw;
+    // Bar (0-3kW range, show absolute value in watts)
+    int32_t bar_value = 0;
+    if (!isnan(kw)) {
+        bar_value = (int32_t)(fabs(kw) * 1000.0f);
+        if (bar_value > 3000) bar_value = 3000;  // Cap at max
     }
-    if (home_stats) {
-        PowerStatistics* stats = static_cast<PowerStatistics*>(home_stats);
-        stats->addSample(home_kw);
+    if (bar && bar_value != state.bar_value) {
+        lv_bar_set_value(bar, bar_value, LV_ANIM_OFF);
+        state.bar_value = bar_value;
     }
-    
-    // Update overlay lines
-    update_stat_overlays();
 }
 
-void PowerScreen::update_stat_overlays() {
-    if (!visible) return;  // Skip widget updates if screen is not visible
+void PowerScreen::apply_overlay(ColumnState& state, void* stats_ptr, lv_obj_t* line_min, lv_obj_t* line_max, int32_t bar_x_offset) {
+    PowerWindow* stats = static_cast<PowerWindow*>(stats_ptr);
+    if (!stats) return;
     
     // Bar positioning constants
     const float bar_max_kw = 3.0f;
     const int32_t bar_y = 140;
     const int32_t bar_height = 100;
-    const int32_t bar_width = 12;
-    const int32_t screen_center_x = 120;
     
-    // Helper: Calculate Y position from kW value (inverted, 0=bottom)
+    // Y position from kW value (inverted, 0=bottom); LINE_HIDDEN without data
     auto kw_to_y = [&](float kw) -> int32_t {
+        if (!stats->hasData() || isnan(kw)) return LINE_HIDDEN;
         float ratio = kw / bar_max_kw;
         if (ratio > 1.0f) ratio = 1.0f;
         if (ratio < 0.0f) ratio = 0.0f;
         return bar_y + bar_height - (int32_t)(ratio * bar_height);
     };
     
-    // Helper: Position a horizontal line across the top of the bar
-    auto position_line = [&](lv_obj_t* line, lv_point_t* points, int32_t bar_x_offset, float value_kw, const char* label) {
-        if (!line || isnan(value_kw)) {
-            if (line) lv_obj_add_flag(line, LV_OBJ_FLAG_HIDDEN);
-            return;
+    auto place_line = [&](lv_obj_t* line, int32_t y_pos, int32_t& applied_y) {
+        if (!line || y_pos == applied_y) return;
+        if (y_pos == LINE_HIDDEN) {
+            lv_obj_add_flag(line, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            // Same alignment as the bar, shifted 1px right
+            lv_obj_align(line, LV_ALIGN_TOP_MID, bar_x_offset + 1, y_pos);
+            if (applied_y == LINE_HIDDEN || applied_y == INT32_MIN) {
+                lv_obj_clear_flag(line, LV_OBJ_FLAG_HIDDEN);
+            }
         }
-        
-        int32_t y_pos = kw_to_y(value_kw);
-        
-        /* LVGL line positioning: Points are RELATIVE to line object position.
-         * We must position the line object itself, then use local coordinates.
-         * Match the bar positioning exactly: LV_ALIGN_TOP_MID with bar_x_offset.
-         */
-        
-        // Position line object exactly like the bar (same alignment), shifted 1px right
-        lv_obj_align(line, LV_ALIGN_TOP_MID, bar_x_offset + 1, y_pos);
-        
-        // Use local coordinates - span bar width from center
-        // Extend: 2px left + 5px right for proper coverage
-        points[0].x = -(bar_width/2 + 2);
-        points[0].y = 0;
-        points[1].x = bar_width/2 + 5;
-        points[1].y = 0;
-        
-        lv_line_set_points(line, points, 2);
-        lv_obj_clear_flag(line, LV_OBJ_FLAG_HIDDEN);
+        applied_y = y_pos;
     };
     
-    // Update solar min/max (x=-107)
+    place_line(line_min, kw_to_y(stats->getMin()), state.line_min_y);
+    place_line(line_max, kw_to_y(stats->getMax()), state.line_max_y);
+}
+
+void PowerScreen::update_statistics() {
+    // Sampled once per display update (1 second) to catch all MQTT updates
+    // MQTT updates arrive at max 2× per second (500ms), display updates every 1000ms
+    // This ensures we never miss significant min/max values
+    
     if (solar_stats) {
-        PowerStatistics* stats = static_cast<PowerStatistics*>(solar_stats);
-        if (stats->hasData()) {
-            position_line(solar_line_min, solar_min_points, -107, stats->getMin(), "Solar MIN");
-            position_line(solar_line_max, solar_max_points, -107, stats->getMax(), "Solar MAX");
-        }
+        static_cast<PowerWindow*>(solar_stats)->addSample(solar_kw);
     }
     
-    // Update home min/max (x=0)
-    if (home_stats) {
-        PowerStatistics* stats = static_cast<PowerStatistics*>(home_stats);
-        if (stats->hasData()) {
-            position_line(home_line_min, home_min_points, 0, stats->getMin(), "Home MIN");
-            position_line(home_line_max, home_max_points, 0, stats->getMax(), "Home MAX");
-        }
+    if (grid_stats) {
+        static_cast<PowerWindow*>(grid_stats)->addSample(grid_kw);
     }
     
-    // Update grid min/max (x=107)
-    if (grid_stats) {
-        PowerStatistics* stats = static_cast<PowerStatistics*>(grid_stats);
-        if (stats->hasData()) {
-            position_line(grid_line_min, grid_min_points, 107, stats->getMin(), "Grid MIN");
-            position_line(grid_line_max, grid_max_points, 107, stats->getMax(), "Grid MAX");
-        }
+    // Calculate home consumption and add to home stats
+    float home_kw = NAN;
+    if (!isnan(solar_kw) && !isnan(grid_kw)) {
+        home_kw = solar_kw + grid_kw;
+    }
+    if (home_stats) {
+        static_cast<PowerWindow*>(home_stats)->addSample(home_kw);
     }
 }
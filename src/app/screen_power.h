@@ -4,6 +4,10 @@
  * Displays solar and grid power in 3-column layout.
  * Layout: Solar → Home ← Grid
  * Home consumption calculated as: home = grid + solar
+ *
+ * Widgets are only touched when what they show changes: every column remembers
+ * the text, color, bar value and overlay positions it last applied, so an idle
+ * dashboard invalidates (and redraws) nothing per update tick.
  */
 
 #ifndef SCREEN_POWER_H
@@ -23,7 +27,14 @@ public:
     void show() override;
     void hide() override;
     
-    // Update power values (in kW)
+    // Periodic update (in kW): records one statistics sample per series and
+    // refreshes the widgets whose content changed
+    void set_power(float solar_kw, float grid_kw);
+
+    // Update both values (in kW) without recording statistics samples
+    void set_values(float solar_kw, float grid_kw);
+
+    // Update a single value (in kW) without recording statistics samples
     void set_solar_power(float kw);
     void set_grid_power(float kw);
 
@@ -67,27 +78,41 @@ private:
     float solar_kw = NAN;
     float grid_kw = NAN;
     
-    // Rolling statistics (10 minutes @ 5-second sampling = 120 samples)
-    // Using void* to avoid exposing implementation details in header
+    // Rolling statistics (POWER_STATS_WINDOW_SAMPLES @ 1-second updates, see
+    // power_statistics.h). Using void* to avoid exposing implementation details in header
     void* solar_stats = nullptr;
     void* home_stats = nullptr;
     void* grid_stats = nullptr;
     
-    // Helper to update calculated home value
-    void update_home_value();
-    
-    // Color calculation helpers (unified algorithm with configurable thresholds)
-    lv_color_t rgb_to_bgr(uint32_t rgb);  // Convert RGB to BGR for display
-    lv_color_t get_power_color(float value, float thresholds[3]);  // Unified threshold logic
-    lv_color_t get_grid_color(float kw);   // Wrapper for grid thresholds
-    lv_color_t get_home_color(float kw);   // Wrapper for home thresholds
-    lv_color_t get_solar_color(float kw);  // Wrapper for solar thresholds
-    
-    // Widget update helpers
-    void update_power_colors();
-    void update_bar_charts();
+    // What each column currently shows (last values pushed to its widgets)
+    struct ColumnState {
+        char text[16];        // value label text
+        uint32_t color;       // RGB of icon/value/unit/bar indicator
+        int32_t bar_value;    // bar value in watts
+        int32_t line_min_y;   // overlay line positions (LINE_HIDDEN = hidden)
+        int32_t line_max_y;
+    };
+    ColumnState solar_state;
+    ColumnState home_state;
+    ColumnState grid_state;
+    int8_t arrow1_hidden = -1;  // -1 = not applied yet
+    int8_t arrow2_import = -1;
+
+    static const int32_t LINE_HIDDEN = -1;
+
+    // Color for a value (unified algorithm with configurable thresholds)
+    uint32_t get_power_color(float value, const float thresholds[3]);
+
+    // Forget the applied state so the next refresh() pushes everything
+    void invalidate();
+
+    // Push current values to the widgets (only where they differ)
+    void refresh();
+    void apply_column(ColumnState& state, float kw, const float thresholds[3],
+                      lv_obj_t* icon, lv_obj_t* value, lv_obj_t* unit, lv_obj_t* arrow, lv_obj_t* bar);
+    void apply_overlay(ColumnState& state, void* stats, lv_obj_t* line_min, lv_obj_t* line_max, int32_t bar_x_offset);
+
     void update_statistics();
-    void update_stat_overlays();
 };
 
 #endif // SCREEN_POWER_H
@@ -0,0 +1,313 @@
+/*
+ * Trend Screen Implementation
+ *
+ * LVGL draws the black screen and the header labels once; after that every
+ * plot column goes straight to the LCD at the same (logical) coordinates; the
+ * panel applies LCD_ROTATION to both.
+ */
+
+#include "screen_trend.h"
+#include "lcd_driver.h"
+#include "log_manager.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Series colors (true RGB, as displayed)
+static const uint32_t SERIES_RGB[ENERGY_SERIES_COUNT] = {
+    0xFFC000,  // ENERGY_SOLAR: amber
+    0xFF5050,  // ENERGY_GRID: red
+    0x40A0FF,  // ENERGY_HOME: blue
+};
+static const uint32_t GRID_LINE_RGB = 0x202020;
+static const uint32_t ZERO_LINE_RGB = 0x505050;
+static const uint32_t CURSOR_RGB    = 0x303030;
+
+// Home first, so solar and grid stay on top where the lines overlap
+static const EnergySeries DRAW_ORDER[] = {ENERGY_HOME, ENERGY_GRID, ENERGY_SOLAR};
+
+// New seconds drawn column by column; falling further behind means a repaint
+static const size_t MAX_INCREMENTAL = 8;
+
+// RGB888 -> RGB565 in panel byte order
+static uint16_t panel_color(uint32_t rgb) {
+    const uint16_t c = (uint16_t)(((rgb >> 8) & 0xF800) | ((rgb >> 5) & 0x07E0) | ((rgb >> 3) & 0x001F));
+    return lcd_swap16(c);
+}
+
+// Smallest "nice" full-scale value >= kw
+static float nice_ceil(float kw) {
+    static const float steps[] = {0.5f, 1.0f, 2.0f, 3.0f, 5.0f, 8.0f, 10.0f, 15.0f, 20.0f, 30.0f, 50.0f};
+    for (float s : steps) {
+        if (kw <= s) return s;
+    }
+    return ceilf(kw / 10.0f) * 10.0f;
+}
+
+static float grid_step(float range_kw) {
+    if (range_kw <= 2.0f) return 0.5f;
+    if (range_kw <= 5.0f) return 1.0f;
+    if (range_kw <= 10.0f) return 2.0f;
+    if (range_kw <= 25.0f) return 5.0f;
+    return 10.0f;
+}
+
+TrendScreen::TrendScreen() {
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        label_text[s][0] = '\0';
+        last_y[s] = NO_Y;
+    }
+}
+
+TrendScreen::~TrendScreen() {
+    destroy();
+}
+
+void TrendScreen::create() {
+    if (screen_obj) return;  // Already created
+
+    screen_obj = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(screen_obj, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(screen_obj, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(screen_obj, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Header: current value per series, in the series color
+    lv_obj_t** labels[ENERGY_SERIES_COUNT] = {&solar_label, &grid_label, &home_label};
+    const lv_align_t aligns[ENERGY_SERIES_COUNT] = {LV_ALIGN_TOP_LEFT, LV_ALIGN_TOP_RIGHT, LV_ALIGN_TOP_MID};
+    const lv_coord_t x_offsets[ENERGY_SERIES_COUNT] = {8, -8, 0};
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        lv_obj_t* label = lv_label_create(screen_obj);
+        lv_label_set_text(label, "--");
+        lv_obj_set_style_text_font(label, &lv_font_montserrat_16, 0);
+        lv_obj_set_style_text_color(label, lv_color_hex(SERIES_RGB[s]), 0);
+        lv_obj_align(label, aligns[s], x_offsets[s], 10);
+        *labels[s] = label;
+    }
+
+    // Plot: everything below the header (logical size, after rotation)
+    plot_w = LV_HOR_RES;
+    plot_h = LV_VER_RES - HEADER_HEIGHT;
+    if (plot_w > MAX_PLOT_DIM) plot_w = MAX_PLOT_DIM;
+    if (plot_h > MAX_PLOT_DIM) plot_h = MAX_PLOT_DIM;
+
+    set_scale(0.0f, 1.0f);
+    needs_full_redraw = true;
+}
+
+void TrendScreen::destroy() {
+    if (screen_obj) {
+        lv_obj_del(screen_obj);
+        screen_obj = nullptr;
+        solar_label = nullptr;
+        home_label = nullptr;
+        grid_label = nullptr;
+    }
+}
+
+void TrendScreen::show() {
+    if (!screen_obj) {
+        create();
+    }
+    lv_scr_load(screen_obj);
+    visible = true;
+    needs_full_redraw = true;  // LVGL repaints the whole screen black first
+}
+
+void TrendScreen::hide() {
+    visible = false;
+    needs_full_redraw = true;
+}
+
+void TrendScreen::update() {
+    if (!plot_ready()) return;
+
+    const uint32_t revision = energy_history_revision(ENERGY_TIER_1S);
+    const uint32_t fresh = revision - drawn_revision;
+
+    if (needs_full_redraw || fresh > MAX_INCREMENTAL) {
+        full_redraw(true);
+        return;
+    }
+    if (columns_since_full + (int)fresh >= plot_w) {
+        full_redraw(false);  // one lap done: let the scale shrink if it can
+        return;
+    }
+    if (fresh == 0) return;
+
+    EnergyHistoryPoint points[ENERGY_SERIES_COUNT][MAX_INCREMENTAL];
+    size_t count = fresh;
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        const size_t n = energy_history_read(ENERGY_TIER_1S, (EnergySeries)s, points[s], fresh);
+        if (n < count) count = n;
+    }
+    if (count == 0) return;
+
+    // A value off the current scale needs a rescaled repaint
+    for (size_t i = 0; i < count; i++) {
+        for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+            if (points[s][i].has_data && !in_scale(points[s][i].avg_kw)) {
+                full_redraw(true);
+                return;
+            }
+        }
+    }
+
+    float kw[ENERGY_SERIES_COUNT];
+    for (size_t i = 0; i < count; i++) {
+        for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+            kw[s] = points[s][i].has_data ? points[s][i].avg_kw : NAN;
+        }
+        draw_sample((int)(points[0][i].start % (uint32_t)plot_w), kw);
+    }
+    draw_cursor((int)((points[0][count - 1].start + 1) % (uint32_t)plot_w));
+
+    drawn_revision = revision;
+    columns_since_full += (int)count;
+    update_labels(kw);
+}
+
+bool TrendScreen::plot_ready() {
+    if (!screen_obj || lv_scr_act() != screen_obj) {
+        needs_full_redraw = true;
+        return false;
+    }
+
+    // Wait until LVGL has painted what it invalidated, or it would draw over the plot
+    lv_disp_t* disp = lv_disp_get_default();
+    if (!disp || disp->inv_p != 0) return false;
+
+    lcd_wait_idle();
+    return true;
+}
+
+void TrendScreen::full_redraw(bool force) {
+    const uint32_t revision = energy_history_revision(ENERGY_TIER_1S);
+    const size_t max_points = (size_t)plot_w < energy_history_capacity(ENERGY_TIER_1S)
+                            ? (size_t)plot_w : energy_history_capacity(ENERGY_TIER_1S);
+
+    // Transient: one series of points plus the averages of all three
+    uint8_t* scratch = (uint8_t*)malloc(max_points * (sizeof(EnergyHistoryPoint) + ENERGY_SERIES_COUNT * sizeof(float)));
+    if (!scratch) return;  // retry on the next update
+    EnergyHistoryPoint* points = (EnergyHistoryPoint*)scratch;
+    float* values = (float*)(scratch + max_points * sizeof(EnergyHistoryPoint));
+
+    size_t count = 0;
+    uint32_t newest = 0;
+    float lo = 0.0f;
+    float hi = 0.0f;
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        count = energy_history_read(ENERGY_TIER_1S, (EnergySeries)s, points, max_points);
+        for (size_t i = 0; i < count; i++) {
+            const float v = points[i].has_data ? points[i].avg_kw : NAN;
+            values[s * max_points + i] = v;
+            if (!isnan(v)) {
+                if (v < lo) lo = v;
+                if (v > hi) hi = v;
+            }
+        }
+        if (count) newest = points[count - 1].start;
+    }
+
+    const float new_hi = nice_ceil(hi < 0.5f ? 0.5f : hi);
+    const float new_lo = lo < 0.0f ? -nice_ceil(-lo) : 0.0f;
+    const bool rescale = new_hi != scale_hi_kw || new_lo != scale_lo_kw;
+
+    if (force || rescale) {
+        set_scale(new_lo, new_hi);
+
+        // Oldest to newest, so each column connects to the one before it
+        float kw[ENERGY_SERIES_COUNT];
+        for (int s = 0; s < ENERGY_SERIES_COUNT; s++) last_y[s] = NO_Y;
+        for (int k = plot_w - 2; k >= 0; k--) {
+            const int x = (int)((newest % (uint32_t)plot_w + (uint32_t)plot_w - (uint32_t)k) % (uint32_t)plot_w);
+            for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+                kw[s] = ((size_t)k < count) ? values[s * max_points + (count - 1 - k)] : NAN;
+            }
+            draw_sample(x, kw);
+        }
+        draw_cursor((int)((newest + 1) % (uint32_t)plot_w));
+        update_labels(kw);
+    }
+
+    free(scratch);
+    drawn_revision = revision;
+    columns_since_full = 0;
+    needs_full_redraw = false;
+}
+
+void TrendScreen::draw_sample(int x, const float kw[ENERGY_SERIES_COUNT]) {
+    memcpy(column, background, (size_t)plot_h * sizeof(uint16_t));
+
+    for (EnergySeries s : DRAW_ORDER) {
+        if (isnan(kw[s])) {
+            last_y[s] = NO_Y;
+            continue;
+        }
+        // Vertical segment from the previous sample's row: a connected line
+        const int16_t y = row_for(kw[s]);
+        int16_t from = (last_y[s] == NO_Y) ? y : last_y[s];
+        int16_t to = y;
+        if (from > to) { const int16_t t = from; from = to; to = t; }
+        if (to == from && to < plot_h - 1) to++;  // at least 2 px thick
+
+        const uint16_t color = panel_color(SERIES_RGB[s]);
+        for (int r = from; r <= to; r++) column[r] = color;
+        last_y[s] = y;
+    }
+
+    blit_column(x);
+}
+
+void TrendScreen::draw_cursor(int x) {
+    const uint16_t color = panel_color(CURSOR_RGB);
+    for (int r = 0; r < plot_h; r++) column[r] = color;
+    blit_column(x);
+}
+
+void TrendScreen::set_scale(float lo_kw, float hi_kw) {
+    scale_lo_kw = lo_kw;
+    scale_hi_kw = hi_kw;
+
+    // Empty column: black with a faint line per grid step and a brighter zero line
+    const uint16_t black = panel_color(0x000000);
+    for (int r = 0; r < plot_h; r++) background[r] = black;
+
+    const float step = grid_step(hi_kw - lo_kw);
+    const uint16_t grid_color = panel_color(GRID_LINE_RGB);
+    for (float v = ceilf(lo_kw / step) * step; v <= hi_kw; v += step) {
+        background[row_for(v)] = grid_color;
+    }
+    background[row_for(0.0f)] = panel_color(ZERO_LINE_RGB);
+}
+
+bool TrendScreen::in_scale(float kw) const {
+    return kw >= scale_lo_kw && kw <= scale_hi_kw;
+}
+
+int16_t TrendScreen::row_for(float kw) const {
+    if (kw > scale_hi_kw) kw = scale_hi_kw;
+    if (kw < scale_lo_kw) kw = scale_lo_kw;
+    return (int16_t)lroundf((scale_hi_kw - kw) / (scale_hi_kw - scale_lo_kw) * (plot_h - 1));
+}
+
+// Logical column x, rows plot_y.. of the plot
+void TrendScreen::blit_column(int x) {
+    lcd_push_pixels_at(x, plot_y, 1, plot_h, column);
+}
+
+void TrendScreen::update_labels(const float kw[ENERGY_SERIES_COUNT]) {
+    lv_obj_t* labels[ENERGY_SERIES_COUNT] = {solar_label, grid_label, home_label};
+    for (int s = 0; s < ENERGY_SERIES_COUNT; s++) {
+        char text[16];
+        if (isnan(kw[s])) {
+            snprintf(text, sizeof(text), "--");
+        } else {
+            snprintf(text, sizeof(text), "%.2f kW", kw[s]);
+        }
+        if (labels[s] && strcmp(text, label_text[s]) != 0) {
+            lv_label_set_text(labels[s], text);
+            strncpy(label_text[s], text, sizeof(label_text[s]));
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Trend Screen
+ *
+ * Live solar / home / grid trend of the last few minutes (1-second tier of the
+ * energy history, one plot column per second).
+ *
+ * The plot is not an LVGL widget: LVGL only draws the header labels, and the
+ * plot area is written straight to the LCD one column at a time (like
+ * DirectImageScreen does with strips). The plot runs as a sweep: each new
+ * sample paints exactly one column at x = time % width, followed by a cursor
+ * column marking the oldest data, so a tick costs one column blit instead of a
+ * chart re-render. The whole plot is only repainted when the screen is shown,
+ * when the Y scale has to change, or once per lap so the scale can shrink back.
+ */
+
+#ifndef SCREEN_TREND_H
+#define SCREEN_TREND_H
+
+#include "screen_base.h"
+#include "board_config.h"
+#include "energy_history.h"
+
+class TrendScreen : public ScreenBase {
+public:
+    TrendScreen();
+    ~TrendScreen();
+
+    void create() override;
+    void destroy() override;
+    void update() override;
+    void show() override;
+    void hide() override;
+
+private:
+    static const int MAX_PLOT_DIM = (LCD_WIDTH > LCD_HEIGHT) ? LCD_WIDTH : LCD_HEIGHT;
+    static const int HEADER_HEIGHT = 36;
+    static const int16_t NO_Y = -1;
+
+    lv_obj_t* solar_label = nullptr;
+    lv_obj_t* home_label = nullptr;
+    lv_obj_t* grid_label = nullptr;
+    char label_text[ENERGY_SERIES_COUNT][16];
+
+    // Plot geometry in LVGL (logical, rotated) coordinates
+    int plot_y = HEADER_HEIGHT;
+    int plot_w = 0;
+    int plot_h = 0;
+
+    // Y scale (kW at the top and bottom row)
+    float scale_hi_kw = 1.0f;
+    float scale_lo_kw = 0.0f;
+
+    bool needs_full_redraw = true;
+    uint32_t drawn_revision = 0;   // 1s tier revision the plot shows
+    int columns_since_full = 0;
+    int16_t last_y[ENERGY_SERIES_COUNT];  // row of the newest drawn sample (NO_Y = none)
+
+    uint16_t background[MAX_PLOT_DIM];  // empty column with grid lines (panel byte order)
+    uint16_t column[MAX_PLOT_DIM];
+
+    bool plot_ready();
+    void full_redraw(bool force);  // force = repaint even if the scale is unchanged
+    void draw_sample(int x, const float kw[ENERGY_SERIES_COUNT]);
+    void draw_cursor(int x);
+    void set_scale(float lo_kw, float hi_kw);
+    bool in_scale(float kw) const;
+    int16_t row_for(float kw) const;
+    void blit_column(int x);
+    void update_labels(const float kw[ENERGY_SERIES_COUNT]);
+};
+
+#endif // SCREEN_TREND_H
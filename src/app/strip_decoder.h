@@ -2,48 +2,111 @@
  * Strip Decoder for Memory-Efficient Image Display
  * 
  * Decodes individual JPEG strips and writes directly to LCD hardware.
- * Uses TJpgDec/tjpgd for baseline JPEG decode.
+ * The JPEG decode itself is done by a backend (jpeg_decoder.h): the target's
+ * hardware/SIMD decoder when it has one, TJpgDec in ROM otherwise and for
+ * anything the accelerated backend does not take.
  * 
- * Memory usage: ~20KB constant regardless of image size
- *   - Strip buffer: ~2KB (temporary per strip)
- *   - Decode buffer: ~13KB for 280px width × 16px height
- *   - TJpgDec work area: ~3KB
+ * Memory usage (TJpgDec): constant regardless of image size, allocated once per
+ * session in begin() and released in end() (decode_strip() does no heap allocation)
+ *   - TJpgDec work area: 4KB
+ *   - Pixel buffer: one MCU band, width × 16 × 2 bytes (BAND) or 512 bytes (BLOCK)
+ * Accelerated backends decode a whole strip at a time; their buffers grow to the
+ * largest strip of the session and are also released in end().
  */
 
 #ifndef STRIP_DECODER_H
 #define STRIP_DECODER_H
 
 #include <Arduino.h>
+#include "jpeg_decoder.h"
+
+// Stream source for decode_stream() (same contract as JpegReadFn)
+typedef JpegReadFn StripReadFn;
+
+// Band observer: called after each full band has been pushed to the LCD, with
+// the pixels as sent (panel byte order). BAND output mode only.
+typedef void (*StripBandTap)(void* ctx, int y, int width, int height, const uint16_t* pixels);
+
+// How decoded pixels are written to the LCD
+enum StripOutputMode {
+    STRIP_OUTPUT_BLOCK,  // One LCD window per TJpgDec output block (MCU); TJpgDec only
+    STRIP_OUTPUT_BAND    // Collect a full-width MCU-row band (or the whole strip with
+                         // an accelerated backend), push it with one window
+};
 
 class StripDecoder {
 public:
     StripDecoder();
     ~StripDecoder();
+    StripDecoder(const StripDecoder&) = delete;
+    StripDecoder& operator=(const StripDecoder&) = delete;
     
-    // Initialize decoder for new image session
+    // Initialize decoder for new image session and allocate decode buffers
     // image_width: total image width in pixels
     // image_height: total image height in pixels
-    void begin(int image_width, int image_height);
+    // output_mode: BAND (default) sends one window per MCU row; BLOCK needs
+    //              less RAM but sends one window per MCU (and never uses the
+    //              accelerated backend)
+    // Returns: false if the decode buffers could not be allocated
+    bool begin(int image_width, int image_height, StripOutputMode output_mode = STRIP_OUTPUT_BAND);
     
     // Decode and display a single JPEG strip
     // jpeg_data: pointer to JPEG data for this strip
     // jpeg_size: size of JPEG data in bytes
     // strip_index: index of this strip (0-based)
-    // output_bgr565: true to pack pixels as BGR565 (legacy strip behavior),
-    //               false to pack pixels as RGB565 (useful when LCD is in RGB mode)
     // Returns: true on success, false on failure
-    bool decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, int strip_index, bool output_bgr565 = true);
+    bool decode_strip(const uint8_t* jpeg_data, size_t jpeg_size, int strip_index);
+
+    // Same as decode_strip(), but TJpgDec pulls the JPEG through read() as it
+    // decodes, so the compressed image never has to be buffered whole
+    bool decode_stream(StripReadFn read, void* read_ctx, int strip_index);
     
-    // Complete image session and cleanup
+    // Place the image's top-left corner at LCD (x, y) instead of (0, 0); strips
+    // then stack downwards from y. Call after begin(); end() resets it.
+    void set_origin(int x, int y);
+
+    // Decode at 1/2^scale (0 = 1:1, 1 = 1:2, 2 = 1:4, 3 = 1:8; TJpgDec's own
+    // scaling, which skips IDCT work). Strips are then scale-times the session
+    // size; begin() arguments stay in output pixels. Call after begin(); end() resets it.
+    void set_scale(uint8_t scale);
+
+    // Observe decoded bands (e.g. to capture the frame); nullptr detaches.
+    // Persists across sessions until changed. Not called for an origin x != 0.
+    void set_band_tap(StripBandTap tap, void* ctx);
+
+    // Complete image session and release decode buffers
     void end();
     
     // Get current Y position (for progress tracking)
     int get_current_y() const { return current_y; }
+
+    // Backend that decoded the last strip ("TJpgDec" before the first one)
+    const char* get_backend_name() const { return last_backend; }
+
+    // Tallest MCU supported (4:2:0 subsampling = 16 lines)
+    static const int MAX_MCU_LINES = TjpgdDecoder::MAX_MCU_LINES;
+
+    // Largest jd_decomp() scale factor (1:8)
+    static const uint8_t MAX_SCALE = 3;
     
 private:
     int width;       // Image width
     int height;      // Image height
+    int origin_x;    // LCD column of the image's left edge
     int current_y;   // Current Y position in image
+    uint8_t scale;   // jd_decomp() scale factor (output = source / 2^scale)
+    StripOutputMode mode;
+
+    TjpgdDecoder tjpgd;              // always available (fallback)
+    JpegDecoderBackend* accel;       // target's accelerated backend, or nullptr
+    bool active;                     // between begin() and end()
+    const char* last_backend;
+    StripBandTap band_tap;
+    void* band_tap_ctx;
+
+    void release_buffers();
+    bool decode(const JpegDecodeJob& job, int strip_index);
+    static bool push_pixels(void* ctx, int x, int y, int w, int h, const uint16_t* pixels);
     
     // Note: Strip height is auto-detected from JPEG during decode (not hardcoded)
     // Typical values: 8, 16, 32, or 64 pixels (configurable in encoder)
@@ -465,6 +465,7 @@ async function loadConfig() {
         setValueIfExists('mqtt_topic_grid', config.mqtt_topic_grid);
         setValueIfExists('mqtt_solar_value_path', config.mqtt_solar_value_path);
         setValueIfExists('mqtt_grid_value_path', config.mqtt_grid_value_path);
+        setValueIfExists('mqtt_channels', config.mqtt_channels);
         
         // LCD brightness - use config value (saved brightness)
         // This shows the persisted value, not necessarily the current runtime value
@@ -532,7 +533,7 @@ function extractFormFields(formData) {
                     'subnet_mask', 'gateway', 'dns1', 'dns2',
                     'mqtt_broker', 'mqtt_port', 'mqtt_username', 'mqtt_password',
                     'mqtt_topic_solar', 'mqtt_topic_grid', 
-                    'mqtt_solar_value_path', 'mqtt_grid_value_path',
+                    'mqtt_solar_value_path', 'mqtt_grid_value_path', 'mqtt_channels',
                     'lcd_brightness',
                     'grid_threshold_0', 'grid_threshold_1', 'grid_threshold_2',
                     'home_threshold_0', 'home_threshold_1', 'home_threshold_2',
@@ -828,13 +829,13 @@ function handleFileSelect(event) {
     selectedFile = event.target.files[0];
     const uploadBtn = document.getElementById('upload-btn');
     
-    if (selectedFile && selectedFile.name.endsWith('.bin')) {
+    if (selectedFile && (selectedFile.name.endsWith('.bin') || selectedFile.name.endsWith('.bin.gz'))) {
         uploadBtn.disabled = false;
         showMessage(`Selected: ${selectedFile.name} (${(selectedFile.size / 1024).toFixed(1)} KB)`, 'info');
     } else {
         uploadBtn.disabled = true;
         if (selectedFile) {
-            showMessage('Please select a .bin file', 'error');
+            showMessage('Please select a .bin or .bin.gz file', 'error');
             selectedFile = null;
         }
     }
@@ -1127,7 +1128,7 @@ document.addEventListener('DOMContentLoaded', () => {
     if (solarT1) solarT1.addEventListener('input', () => updateThresholdRanges('solar'));
     if (solarT2) solarT2.addEventListener('input', () => updateThresholdRanges('solar'));
     
-    // LCD brightness slider - real-time updates (no save until button clicked)
+    // LCD brightness slider - real-time updates (the device persists it once the slider stops)
     const brightnessSlider = document.getElementById('lcd_brightness');
     if (brightnessSlider) {
         brightnessSlider.addEventListener('input', async (event) => {
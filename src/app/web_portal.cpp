@@ -10,14 +10,21 @@
 #define CONFIG_ASYNC_TCP_STACK_SIZE 16384
 
 #include "web_portal.h"
+#include "bench.h"
 #include "config_manager.h"
 #include "display_manager.h"
 #include "log_manager.h"
+#include "mem_placement.h"
 
 #include "image_api.h"
+#include "image_cache.h"
 #include "web_portal_api_brightness.h"
 #include "web_portal_api_config.h"
+#include "web_portal_api_display.h"
+#include "web_portal_api_logs.h"
+#include "web_portal_api_metrics.h"
 #include "web_portal_api_ota.h"
+#include "web_portal_api_power.h"
 #include "web_portal_api_system.h"
 #include "web_portal_pages.h"
 #include "web_portal_state.h"
@@ -73,7 +80,11 @@ void web_portal_init(DeviceConfig *config) {
     web_portal_system_register_routes(server);
     web_portal_config_register_routes(server);
     web_portal_brightness_register_routes(server);
+    web_portal_display_register_routes(server);
     web_portal_ota_register_routes(server);
+    web_portal_logs_register_routes(server);
+    web_portal_metrics_register_routes(server);
+    web_portal_power_register_routes(server);
 
     // Image API module (port-friendly adapter)
     ImageApiBackend backend;
@@ -81,17 +92,56 @@ void web_portal_init(DeviceConfig *config) {
         display_hide_strip_image();
         display_hide_image();
     };
-    backend.start_strip_session = [](int width, int height, unsigned long timeout_ms, unsigned long start_time) -> bool {
-        return display_start_strip_upload(width, height, timeout_ms, start_time);
+    backend.start_strip_session = [](int width, int height, uint8_t scale, unsigned long timeout_ms, unsigned long start_time) -> bool {
+        return display_start_strip_upload(width, height, timeout_ms, start_time, scale);
     };
-    backend.decode_strip = [](const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index, bool output_bgr565) -> bool {
-        return display_decode_strip_ex(jpeg_data, jpeg_size, strip_index, output_bgr565);
+    backend.decode_strip = [](const uint8_t* jpeg_data, size_t jpeg_size, uint8_t strip_index) -> bool {
+        return display_decode_strip_ex(jpeg_data, jpeg_size, strip_index);
     };
+    backend.decode_stream = [](ImageStreamReadFn read, void* read_ctx) -> bool {
+        return display_decode_stream(read, read_ctx);
+    };
+    backend.decode_tile = [](const uint8_t* jpeg_data, size_t jpeg_size, int x, int y,
+                             unsigned long timeout_ms, unsigned long start_time) -> bool {
+        return display_decode_tile(jpeg_data, jpeg_size, x, y, timeout_ms, start_time);
+    };
+    backend.screen_epoch = []() -> uint32_t {
+        return display_direct_image_epoch();
+    };
+    backend.draw_raw = [](bool rle, int x, int y, int width, int height, ImageStreamReadFn read, void* read_ctx,
+                          unsigned long timeout_ms, unsigned long start_time) -> bool {
+        return display_draw_raw(rle, x, y, width, height, read, read_ctx, timeout_ms, start_time);
+    };
+#if HAS_IMAGE_CACHE
+    if (image_cache_init()) {
+        backend.cache_begin = []() -> bool {
+            return display_cache_capture_begin();
+        };
+        backend.cache_end = [](uint32_t id, bool commit) -> bool {
+            return display_cache_capture_end(id, commit);
+        };
+        backend.show_cached = [](uint32_t id, unsigned long timeout_ms, unsigned long start_time) -> bool {
+            return display_show_cached_image(id, timeout_ms, start_time);
+        };
+    }
+#endif
 
     ImageApiConfig image_cfg;
-    image_cfg.lcd_width = LCD_WIDTH;
-    image_cfg.lcd_height = LCD_HEIGHT;
+    image_cfg.lcd_width = LCD_LOGICAL_WIDTH;
+    image_cfg.lcd_height = LCD_LOGICAL_HEIGHT;
     image_cfg.max_image_size_bytes = 100 * 1024;
+    if (mem_has_psram()) {
+        // A quarter of the largest free PSRAM block (the cache and strip slots share it)
+        const size_t psram_limit = min((size_t)IMAGE_UPLOAD_MAX_BYTES_PSRAM, mem_large_max_alloc() / 4);
+        image_cfg.max_image_size_bytes = max(image_cfg.max_image_size_bytes, psram_limit);
+    }
+    Logger.logMessagef("Portal", "Image upload limit: %u KB", (unsigned)(image_cfg.max_image_size_bytes / 1024));
+    image_cfg.max_strip_size_bytes = IMAGE_STRIP_MAX_BYTES;
+    image_cfg.strip_queue_depth = IMAGE_STRIP_SLOTS;
+    image_cfg.arena_bytes = IMAGE_ARENA_BYTES;
+    if (mem_has_psram()) {
+        image_cfg.arena_bytes += image_cfg.max_image_size_bytes;
+    }
     image_cfg.decode_headroom_bytes = 50 * 1024;
     image_cfg.default_timeout_ms = 10000;
     image_cfg.max_timeout_ms = 86400UL * 1000UL;
@@ -180,4 +230,8 @@ bool web_portal_ota_in_progress() {
 // Process pending image operations (call from main loop)
 void web_portal_process_pending() {
     image_api_process_pending(g_web_portal_state.ota_in_progress);
+    web_portal_display_process_pending();
+#if ENABLE_BENCHMARK
+    bench_process_pending();
+#endif
 }
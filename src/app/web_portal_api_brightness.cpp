@@ -44,6 +44,12 @@ static void handlePostBrightness(AsyncWebServerRequest *request, uint8_t *data,
 
     Logger.logMessagef("Portal", "Brightness set to %d%%", g_web_portal_state.current_brightness);
 
+    // Persist once the slider stops moving (one flash write per drag)
+    if (g_web_portal_state.current_config) {
+        g_web_portal_state.current_config->lcd_brightness = g_web_portal_state.current_brightness;
+        config_manager_save_deferred(g_web_portal_state.current_config);
+    }
+
     JsonDocument response_doc;
     response_doc["brightness"] = g_web_portal_state.current_brightness;
 
@@ -69,6 +69,7 @@ static void handleGetConfig(AsyncWebServerRequest *request) {
     doc["mqtt_topic_grid"] = cfg->mqtt_topic_grid;
     doc["mqtt_solar_value_path"] = cfg->mqtt_solar_value_path;
     doc["mqtt_grid_value_path"] = cfg->mqtt_grid_value_path;
+    doc["mqtt_channels"] = cfg->mqtt_channels;
 
     doc["lcd_brightness"] = cfg->lcd_brightness;
 
@@ -156,6 +157,7 @@ static void handlePostConfig(AsyncWebServerRequest *request, uint8_t *data, size
     if (doc.containsKey("mqtt_topic_grid")) strlcpy(cfg->mqtt_topic_grid, doc["mqtt_topic_grid"] | "", CONFIG_MQTT_TOPIC_MAX_LEN);
     if (doc.containsKey("mqtt_solar_value_path")) strlcpy(cfg->mqtt_solar_value_path, doc["mqtt_solar_value_path"] | "", 32);
     if (doc.containsKey("mqtt_grid_value_path")) strlcpy(cfg->mqtt_grid_value_path, doc["mqtt_grid_value_path"] | "", 32);
+    if (doc.containsKey("mqtt_channels")) strlcpy(cfg->mqtt_channels, doc["mqtt_channels"] | "", CONFIG_MQTT_CHANNELS_MAX_LEN);
 
     if (doc.containsKey("lcd_brightness")) {
         int brightness = doc["lcd_brightness"] | 100;
@@ -209,6 +211,7 @@ static void handlePostConfig(AsyncWebServerRequest *request, uint8_t *data, size
         if (!request->hasParam("no_reboot")) {
             Logger.logMessage("Portal", "Rebooting device");
             delay(100);
+            Logger.flush();
             ESP.restart();
         }
     } else {
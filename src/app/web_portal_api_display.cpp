@@ -0,0 +1,79 @@
+#include "web_portal_api_display.h"
+
+#include "display_manager.h"
+#include "log_manager.h"
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+
+enum PendingScreen : uint8_t {
+    PENDING_SCREEN_NONE = 0,
+    PENDING_SCREEN_POWER,
+    PENDING_SCREEN_TREND
+};
+
+static volatile PendingScreen pending_screen = PENDING_SCREEN_NONE;
+
+static void handleGetScreen(AsyncWebServerRequest *request) {
+    JsonDocument doc;
+    doc["screen"] = display_get_screen_name();
+
+    String response;
+    serializeJson(doc, response);
+
+    request->send(200, "application/json", response);
+}
+
+static void handlePostScreen(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    (void)index;
+    (void)total;
+
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+
+    if (error) {
+        Logger.logMessagef("Portal", "Screen JSON parse error: %s", error.c_str());
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    const char* screen = doc["screen"] | "";
+    if (strcmp(screen, "power") == 0) {
+        pending_screen = PENDING_SCREEN_POWER;
+    } else if (strcmp(screen, "trend") == 0) {
+        pending_screen = PENDING_SCREEN_TREND;
+    } else {
+        request->send(400, "application/json", "{\"error\":\"screen must be 'power' or 'trend'\"}");
+        return;
+    }
+
+    Logger.logMessagef("Portal", "Screen switch requested: %s", screen);
+    request->send(200, "application/json", "{\"success\":true}");
+}
+
+void web_portal_display_register_routes(AsyncWebServer* server) {
+    server->on("/api/display/screen", HTTP_GET, handleGetScreen);
+    server->on(
+        "/api/display/screen",
+        HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        NULL,
+        handlePostScreen
+    );
+}
+
+void web_portal_display_process_pending() {
+    const PendingScreen screen = pending_screen;
+    if (screen == PENDING_SCREEN_NONE) return;
+
+    // An image (and possibly its decode session) owns the panel: switch once it is dismissed
+    if (strcmp(display_get_screen_name(), "image") == 0) return;
+
+    pending_screen = PENDING_SCREEN_NONE;
+
+    if (screen == PENDING_SCREEN_TREND) {
+        display_show_trend_screen();
+    } else {
+        display_show_power_screen();
+    }
+}
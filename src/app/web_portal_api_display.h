@@ -0,0 +1,9 @@
+#pragma once
+
+class AsyncWebServer;
+
+void web_portal_display_register_routes(AsyncWebServer* server);
+
+// Apply a screen switch requested over HTTP (call from the main loop: handlers
+// only record the request, the AsyncTCP task must not wait for the display lock)
+void web_portal_display_process_pending();
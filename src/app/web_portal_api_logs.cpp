@@ -0,0 +1,206 @@
+#include "web_portal_api_logs.h"
+
+#include "log_manager.h"
+#include "board_config.h"
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <memory>
+#include <string.h>
+#include <strings.h>
+
+// Idle streams get an SSE comment this often so proxies keep the connection
+#define LOG_STREAM_KEEPALIVE_MS 15000
+
+// Raw bytes taken from the ring per read (longer lines are split)
+#define LOG_STREAM_READ_BYTES 256
+
+static const char* const level_names[] = { "error", "warn", "info", "debug" };
+
+static int stream_clients = 0;          // AsyncTCP task only
+static uint32_t stream_dropped = 0;     // bytes lost by slow stream clients, all streams
+
+// One connected client. The chunked response filler reads the ring at its own
+// cursor: producers never wait for it, and if it falls LOG_BUFFER_BYTES behind
+// the overwritten lines are skipped and reported as a "dropped" event.
+struct LogStream {
+    uint32_t cursor;
+    bool skip_partial;                  // cursor may point into the middle of a line
+    uint32_t lost = 0;
+    uint32_t lost_reported = 0;
+    unsigned long last_send_ms = 0;
+
+    LogStream(uint32_t start, bool mid_line) : cursor(start), skip_partial(mid_line) { stream_clients++; }
+    ~LogStream() { stream_clients--; }
+
+    size_t fill(uint8_t* buffer, size_t max_len);
+};
+
+size_t LogStream::fill(uint8_t* buffer, size_t max_len) {
+    size_t out = 0;
+
+    if (lost != lost_reported) {
+        const int n = snprintf((char*)buffer, max_len, "event: dropped\ndata: %lu\n\n", (unsigned long)lost);
+        if (n > 0 && (size_t)n < max_len) {
+            out = n;
+            lost_reported = lost;
+        }
+    }
+
+    const uint32_t lost_before = lost;
+    char raw[LOG_STREAM_READ_BYTES];
+    for (;;) {
+        uint32_t pos = cursor;
+        const size_t n = Logger.read(&pos, raw, sizeof(raw), &lost);
+        if (n == 0) break;
+        const uint32_t start = pos - n;   // read() may have skipped ahead
+
+        size_t used = 0;
+        bool full = false;
+        while (used < n) {
+            const char* line = raw + used;
+            const char* nl = (const char*)memchr(line, '\n', n - used);
+            size_t len;
+            if (nl) {
+                len = nl - line + 1;
+            } else if (used == 0 && n == sizeof(raw)) {
+                len = n;                  // longer than the read buffer: send as is
+            } else {
+                break;                    // incomplete line, wait for the rest
+            }
+
+            if (skip_partial) {
+                skip_partial = false;
+                used += len;
+                continue;
+            }
+
+            size_t text = len;
+            while (text > 0 && (line[text - 1] == '\n' || line[text - 1] == '\r')) text--;
+            if (out + 6 + text + 2 > max_len) {
+                full = true;
+                break;
+            }
+            memcpy(buffer + out, "data: ", 6);
+            memcpy(buffer + out + 6, line, text);
+            buffer[out + 6 + text] = '\n';
+            buffer[out + 7 + text] = '\n';
+            out += 8 + text;
+            used += len;
+        }
+
+        cursor = start + used;
+        if (full || used < n) break;
+    }
+    stream_dropped += lost - lost_before;
+
+    const unsigned long now = millis();
+    if (out == 0 && now - last_send_ms >= LOG_STREAM_KEEPALIVE_MS && max_len >= 3) {
+        memcpy(buffer, ":\n\n", 3);
+        out = 3;
+    }
+    if (out == 0) {
+        return RESPONSE_TRY_AGAIN;        // polled again by AsyncTCP
+    }
+    last_send_ms = now;
+    return out;
+}
+
+static void handleLogStream(AsyncWebServerRequest *request) {
+    if (stream_clients >= LOG_STREAM_MAX_CLIENTS) {
+        request->send(503, "application/json", "{\"error\":\"Too many log stream clients\"}");
+        return;
+    }
+
+    uint32_t backlog = LOG_STREAM_BACKLOG_BYTES;
+    if (request->hasParam("backlog")) {
+        backlog = (uint32_t)request->getParam("backlog")->value().toInt();
+    }
+    if (backlog > LOG_BUFFER_BYTES) backlog = LOG_BUFFER_BYTES;
+
+    const uint32_t head = Logger.headCursor();
+    const uint32_t oldest = Logger.oldestCursor();
+    const uint32_t start = (head - oldest > backlog) ? head - backlog : oldest;
+
+    // Start at a line boundary: skip the partial first line unless the byte
+    // before the start position is a newline
+    bool mid_line = false;
+    if (start != 0 && start != head) {
+        uint32_t prev_pos = start - 1;
+        char prev = 0;
+        mid_line = !(Logger.read(&prev_pos, &prev, 1) == 1 && prev == '\n');
+    }
+
+    std::shared_ptr<LogStream> stream = std::make_shared<LogStream>(start, mid_line);
+    AsyncWebServerResponse *response = request->beginChunkedResponse("text/event-stream",
+        [stream](uint8_t *buffer, size_t max_len, size_t index) -> size_t {
+            (void)index;
+            return stream->fill(buffer, max_len);
+        });
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+static void handleGetLogs(AsyncWebServerRequest *request) {
+    JsonDocument doc;
+    doc["buffer_bytes"] = LOG_BUFFER_BYTES;
+    doc["uart_dropped_bytes"] = Logger.droppedBytes();
+    doc["stream_clients"] = stream_clients;
+    doc["stream_dropped_bytes"] = stream_dropped;
+    doc["max_level"] = level_names[LOG_MAX_LEVEL];
+
+    JsonObject levels = doc["levels"].to<JsonObject>();
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        levels[LogManager::moduleName((LogModule)i)] = level_names[Logger.getLevel((LogModule)i)];
+    }
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// Body: {"levels": {"MQTT": "debug", "StripDecoder": "info"}}
+static void handlePostLogs(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (index != 0) return;
+    if (len != total) {
+        request->send(400, "application/json", "{\"error\":\"Body too large\"}");
+        return;
+    }
+
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    if (error) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    for (JsonPair kv : doc["levels"].as<JsonObject>()) {
+        const int module = LogManager::moduleFromName(kv.key().c_str());
+        const char* name = kv.value().as<const char*>();
+        int level = -1;
+        for (int l = 0; name && l <= LOG_LEVEL_DEBUG; l++) {
+            if (strcasecmp(name, level_names[l]) == 0) level = l;
+        }
+        if (module < 0 || level < 0) {
+            request->send(400, "application/json", "{\"error\":\"Unknown module or level\"}");
+            return;
+        }
+        Logger.setLevel((LogModule)module, (uint8_t)level);
+        Logger.logMessagef("Portal", "Log level %s = %s", kv.key().c_str(), level_names[level]);
+    }
+
+    handleGetLogs(request);
+}
+
+void web_portal_logs_register_routes(AsyncWebServer* server) {
+    // Before /api/logs (handlers also match sub-paths)
+    server->on("/api/logs/stream", HTTP_GET, handleLogStream);
+    server->on("/api/logs", HTTP_GET, handleGetLogs);
+    server->on(
+        "/api/logs",
+        HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        NULL,
+        handlePostLogs
+    );
+}
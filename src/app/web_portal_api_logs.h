@@ -0,0 +1,6 @@
+#pragma once
+
+class AsyncWebServer;
+
+// GET /api/logs/stream (Server-Sent Events), GET/POST /api/logs (levels, counters)
+void web_portal_logs_register_routes(AsyncWebServer* server);
@@ -0,0 +1,330 @@
+#include "web_portal_api_metrics.h"
+
+#include "health_sampler.h"
+#include "image_api.h"
+#include "image_arena.h"
+#include "image_multicast.h"
+#include "mqtt_manager.h"
+#include "perf_counters.h"
+#include "power_ingest.h"
+#include "wifi_manager.h"
+#include "../version.h"
+
+#include <ESPAsyncWebServer.h>
+#include <esp_timer.h>
+#include <memory>
+
+// A chunked response filler walks the sections and prints straight from the
+// counters into each send buffer: no JsonDocument, no String, no copy of the
+// whole body. Output is cut into items (a metric family's header with its
+// samples, or one sample of a loop); an item that does not fit the buffer is
+// printed again in full into the next one.
+
+#define METRIC_PREFIX "energymon_"
+
+// Print into one send buffer, skipping the items a previous buffer already
+// carried. Items are counted by item() calls, which must not depend on the
+// values, so every pass numbers them the same way.
+class MetricsChunk : public Print {
+public:
+    MetricsChunk(uint8_t* buf, size_t cap, uint32_t first) : buf(buf), cap(cap), first(first) {}
+
+    void item() {
+        if (full) return;
+        committed = len;
+        current++;
+    }
+
+    size_t write(uint8_t c) override {
+        if (full || current < first) return 1;
+        if (len == cap) {
+            // Drop the partial item; the next buffer starts with it
+            full = true;
+            len = committed;
+            return 1;
+        }
+        buf[len++] = c;
+        return 1;
+    }
+
+    size_t length() const { return len; }
+    bool is_full() const { return full; }
+    uint32_t resume_item() const { return current; }  // valid once full
+
+private:
+    uint8_t* buf;
+    size_t cap;
+    uint32_t first;
+    size_t len = 0;
+    size_t committed = 0;
+    uint32_t current = 0;  // 1-based: item() is called before each item's output
+    bool full = false;
+};
+
+static void metric_header(MetricsChunk& out, const char* name, const char* type, const char* help) {
+    out.item();
+    out.print("# HELP " METRIC_PREFIX);
+    out.print(name);
+    out.print(' ');
+    out.print(help);
+    out.print("\n# TYPE " METRIC_PREFIX);
+    out.print(name);
+    out.print(' ');
+    out.print(type);
+    out.print('\n');
+}
+
+// Label values are escaped per the text format (backslash, quote, newline)
+static void print_label_value(MetricsChunk& out, const char* value) {
+    out.print('"');
+    for (const char* p = value; *p; p++) {
+        if (*p == '\\' || *p == '"') {
+            out.print('\\');
+            out.print(*p);
+        } else if (*p == '\n') {
+            out.print("\\n");
+        } else {
+            out.print(*p);
+        }
+    }
+    out.print('"');
+}
+
+// name{label="value"} (label == nullptr: no labels); the value follows
+static void metric_begin(MetricsChunk& out, const char* name, const char* label, const char* value) {
+    out.print(METRIC_PREFIX);
+    out.print(name);
+    if (label) {
+        out.print('{');
+        out.print(label);
+        out.print('=');
+        print_label_value(out, value);
+        out.print('}');
+    }
+    out.print(' ');
+}
+
+static void metric_u64(MetricsChunk& out, const char* name, uint64_t value,
+                       const char* label = nullptr, const char* label_value = nullptr) {
+    metric_begin(out, name, label, label_value);
+    out.print(value);
+    out.print('\n');
+}
+
+static void metric_float(MetricsChunk& out, const char* name, float value, int digits,
+                         const char* label = nullptr, const char* label_value = nullptr) {
+    metric_begin(out, name, label, label_value);
+    out.print(value, digits);
+    out.print('\n');
+}
+
+static void print_health(MetricsChunk& out) {
+    metric_header(out, "info", "gauge", "Firmware version");
+    metric_u64(out, "info", 1, "version", FIRMWARE_VERSION);
+
+    metric_header(out, "uptime_seconds", "counter", "Seconds since boot");
+    metric_u64(out, "uptime_seconds", (uint64_t)(esp_timer_get_time() / 1000000));
+
+    HealthSample s;
+    if (!health_sampler_latest(&s)) return;
+
+    metric_header(out, "cpu_usage_percent", "gauge", "CPU usage over the last health sample period, all cores");
+    metric_u64(out, "cpu_usage_percent", s.cpu_usage);
+    metric_header(out, "idle_paced_percent", "gauge", "Share of the last health sample period the render task was idle-paced");
+    metric_u64(out, "idle_paced_percent", s.idle_pct);
+    metric_header(out, "heap_free_bytes", "gauge", "Free internal heap");
+    metric_u64(out, "heap_free_bytes", s.heap_free);
+    metric_header(out, "heap_min_free_bytes", "gauge", "Lowest free internal heap since boot");
+    metric_u64(out, "heap_min_free_bytes", s.heap_min);
+    metric_header(out, "heap_largest_block_bytes", "gauge", "Largest allocatable internal heap block");
+    metric_u64(out, "heap_largest_block_bytes", s.heap_largest);
+    metric_header(out, "heap_fragmentation_percent", "gauge", "1 - largest block / free heap");
+    metric_u64(out, "heap_fragmentation_percent", s.fragmentation);
+    // Headers stay put when a value is missing, so the item count does not change
+    metric_header(out, "temperature_celsius", "gauge", "Chip temperature");
+    if (!isnan(s.temperature)) metric_float(out, "temperature_celsius", s.temperature, 1);
+    metric_header(out, "wifi_rssi_dbm", "gauge", "WiFi signal strength");
+    if (s.rssi) metric_float(out, "wifi_rssi_dbm", s.rssi, 0);
+}
+
+static void print_network(MetricsChunk& out) {
+    metric_header(out, "wifi_connects_total", "counter", "WiFi connections since boot");
+    metric_u64(out, "wifi_connects_total", wifi_manager_connects());
+    metric_header(out, "wifi_connect_failures_total", "counter", "Failed WiFi connection attempts since boot");
+    metric_u64(out, "wifi_connect_failures_total", wifi_manager_total_failures());
+
+    MqttStats mqtt;
+    mqtt_manager_get_stats(&mqtt);
+    metric_header(out, "mqtt_connected", "gauge", "1 while connected to the broker");
+    metric_u64(out, "mqtt_connected", mqtt_manager_is_connected() ? 1 : 0);
+    metric_header(out, "mqtt_messages_total", "counter", "MQTT payloads received");
+    metric_u64(out, "mqtt_messages_total", mqtt.messages);
+    metric_header(out, "mqtt_parse_failures_total", "counter", "Channel updates without a number at the value path");
+    metric_u64(out, "mqtt_parse_failures_total", mqtt.parse_failures);
+    metric_header(out, "mqtt_connects_total", "counter", "Broker connections since boot");
+    metric_u64(out, "mqtt_connects_total", mqtt.connects);
+    metric_header(out, "mqtt_connect_failures_total", "counter", "Failed broker connection attempts");
+    metric_u64(out, "mqtt_connect_failures_total", mqtt.connect_failures);
+
+    PowerIngestStats ingest;
+    power_ingest_get_stats(&ingest);
+    metric_header(out, "ingest_udp_packets_total", "counter", "Direct ingest UDP datagrams received");
+    metric_u64(out, "ingest_udp_packets_total", ingest.udp_packets);
+    metric_header(out, "ingest_udp_malformed_total", "counter", "Direct ingest UDP datagrams dropped for size or magic");
+    metric_u64(out, "ingest_udp_malformed_total", ingest.udp_malformed);
+    metric_header(out, "ingest_http_requests_total", "counter", "POST /api/power requests parsed");
+    metric_u64(out, "ingest_http_requests_total", ingest.http_requests);
+    metric_header(out, "ingest_values_total", "counter", "Directly pushed values by outcome");
+    metric_u64(out, "ingest_values_total", ingest.accepted, "result", "accepted");
+    metric_u64(out, "ingest_values_total", ingest.stale, "result", "stale");
+    metric_u64(out, "ingest_values_total", ingest.unknown, "result", "unknown");
+}
+
+static void print_channels(MetricsChunk& out) {
+    const size_t count = mqtt_manager_channel_count();
+    const unsigned long now = millis();
+
+    metric_header(out, "channel_value", "gauge", "Last value per MQTT channel, in the channel unit (absent until received)");
+    for (size_t i = 0; i < count; i++) {
+        out.item();
+        MqttChannelInfo info;
+        if (!mqtt_manager_get_channel((int)i, &info) || isnan(info.value)) continue;
+        metric_float(out, "channel_value", info.value, 3, "channel", info.name);
+    }
+    metric_header(out, "channel_age_seconds", "gauge", "Seconds since the last valid value per MQTT channel");
+    for (size_t i = 0; i < count; i++) {
+        out.item();
+        MqttChannelInfo info;
+        if (!mqtt_manager_get_channel((int)i, &info) || info.updated_ms == 0) continue;
+        metric_float(out, "channel_age_seconds", (now - info.updated_ms) / 1000.0f, 1, "channel", info.name);
+    }
+}
+
+// One Prometheus histogram per timer: cumulative buckets in seconds
+static void print_perf(MetricsChunk& out) {
+    PerfSnapshot perf;
+    perf_counters_snapshot(&perf);
+
+    metric_header(out, "perf_duration_seconds", "histogram",
+                  "Render timings: flush, lvgl_handler, strip_decode");
+    for (int t = 0; t < PERF_TIMER_COUNT; t++) {
+        const PerfTimerStats& stats = perf.timers[t];
+        const char* timer = perf_timer_name((PerfTimer)t);
+        uint32_t cumulative = 0;
+        for (int b = 0; b < PERF_HIST_BUCKETS; b++) {
+            out.item();
+            cumulative += stats.hist[b];
+            out.print(METRIC_PREFIX "perf_duration_seconds_bucket{timer=\"");
+            out.print(timer);
+            out.print("\",le=\"");
+            if (b < PERF_HIST_BUCKETS - 1) {
+                out.print(PERF_HIST_BOUND_US(b) / 1e6, 6);
+            } else {
+                out.print("+Inf");
+            }
+            out.print("\"} ");
+            out.print(cumulative);
+            out.print('\n');
+        }
+        out.item();
+        metric_float(out, "perf_duration_seconds_sum", stats.total_us / 1e6, 6, "timer", timer);
+        metric_u64(out, "perf_duration_seconds_count", stats.count, "timer", timer);
+    }
+    metric_header(out, "perf_duration_max_seconds", "gauge", "Longest render timing since boot");
+    for (int t = 0; t < PERF_TIMER_COUNT; t++) {
+        out.item();
+        metric_float(out, "perf_duration_max_seconds", perf.timers[t].max_us / 1e6, 6,
+                     "timer", perf_timer_name((PerfTimer)t));
+    }
+
+    metric_header(out, "flush_pixels_total", "counter", "Pixels sent by LVGL flushes");
+    metric_u64(out, "flush_pixels_total", perf.flush_pixels);
+    metric_header(out, "spi_bytes_total", "counter", "Bytes sent to the panel");
+    metric_u64(out, "spi_bytes_total", perf.spi_bytes);
+    metric_header(out, "spi_bytes_per_second", "gauge", "Panel bytes over the last second");
+    metric_u64(out, "spi_bytes_per_second", perf.spi_bytes_per_sec);
+}
+
+static void print_uploads(MetricsChunk& out) {
+    ImageApiStats stats;
+    image_api_get_stats(&stats);
+
+    metric_header(out, "image_upload_requests_total", "counter", "Image upload requests per endpoint");
+    for (int k = 0; k < IMAGE_UPLOAD_KIND_COUNT; k++) {
+        out.item();
+        metric_u64(out, "image_upload_requests_total", stats.requests[k],
+                   "kind", image_api_upload_kind_name((ImageUploadKind)k));
+    }
+    metric_header(out, "image_upload_bytes_total", "counter", "Image upload body bytes per endpoint");
+    for (int k = 0; k < IMAGE_UPLOAD_KIND_COUNT; k++) {
+        out.item();
+        metric_u64(out, "image_upload_bytes_total", stats.bytes[k],
+                   "kind", image_api_upload_kind_name((ImageUploadKind)k));
+    }
+
+    ImageArenaStats arena;
+    image_arena_get_stats(&arena);
+    metric_header(out, "image_arena_used_bytes", "gauge", "Upload/strip arena bytes in use");
+    metric_u64(out, "image_arena_used_bytes", arena.used);
+    metric_header(out, "image_arena_high_water_bytes", "gauge", "Upload/strip arena peak use");
+    metric_u64(out, "image_arena_high_water_bytes", arena.high_water);
+    metric_header(out, "image_arena_fallbacks_total", "counter", "Buffers served from the heap because the arena was full");
+    metric_u64(out, "image_arena_fallbacks_total", arena.fallbacks);
+
+    ImageMulticastStats mcast;
+    image_multicast_get_stats(&mcast);
+    metric_header(out, "multicast_packets_total", "counter", "Datagrams received on the image multicast group");
+    metric_u64(out, "multicast_packets_total", mcast.packets);
+    metric_header(out, "multicast_malformed_total", "counter", "Multicast datagrams dropped as malformed");
+    metric_u64(out, "multicast_malformed_total", mcast.malformed);
+    metric_header(out, "multicast_frames_started_total", "counter", "Multicast frames seen");
+    metric_u64(out, "multicast_frames_started_total", mcast.frames);
+    metric_header(out, "multicast_frames_total", "counter", "Multicast frames by outcome");
+    metric_u64(out, "multicast_frames_total", mcast.frames_shown, "result", "shown");
+    metric_u64(out, "multicast_frames_total", mcast.frames_dropped, "result", "dropped");
+    metric_header(out, "multicast_nacks_total", "counter", "NACKs sent for missing multicast strips");
+    metric_u64(out, "multicast_nacks_total", mcast.nacks_sent);
+}
+
+typedef void (*MetricsSection)(MetricsChunk& out);
+static const MetricsSection metrics_sections[] = {print_health, print_network, print_channels, print_perf, print_uploads};
+static const size_t METRICS_SECTION_COUNT = sizeof(metrics_sections) / sizeof(metrics_sections[0]);
+
+// Where the next send buffer picks up
+struct MetricsCursor {
+    size_t section = 0;
+    uint32_t item = 1;
+
+    size_t fill(uint8_t* buffer, size_t max_len) {
+        size_t out = 0;
+        while (section < METRICS_SECTION_COUNT) {
+            MetricsChunk chunk(buffer + out, max_len - out, item);
+            metrics_sections[section](chunk);
+            out += chunk.length();
+            if (chunk.is_full()) {
+                item = chunk.resume_item();
+                break;
+            }
+            section++;
+            item = 1;
+        }
+        if (out == 0 && section < METRICS_SECTION_COUNT) {
+            return RESPONSE_TRY_AGAIN;  // not even one item fit; polled again by AsyncTCP
+        }
+        return out;
+    }
+};
+
+static void handleGetMetrics(AsyncWebServerRequest *request) {
+    std::shared_ptr<MetricsCursor> cursor = std::make_shared<MetricsCursor>();
+    AsyncWebServerResponse *response = request->beginChunkedResponse("text/plain; version=0.0.4",
+        [cursor](uint8_t *buffer, size_t max_len, size_t index) -> size_t {
+            (void)index;
+            return cursor->fill(buffer, max_len);
+        });
+    request->send(response);
+}
+
+void web_portal_metrics_register_routes(AsyncWebServer* server) {
+    server->on("/metrics", HTTP_GET, handleGetMetrics);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+class AsyncWebServer;
+
+// GET /metrics (Prometheus text format 0.0.4)
+void web_portal_metrics_register_routes(AsyncWebServer* server);
@@ -1,76 +1,274 @@
 #include "web_portal_api_ota.h"
 
+#include "board_config.h"
 #include "log_manager.h"
+#include "mem_placement.h"
 #include "web_portal_state.h"
 
 #include <Update.h>
 #include <ESPAsyncWebServer.h>
+#include <esp_rom_crc.h>
+
+#if __has_include(<rom/miniz.h>)
+#include <rom/miniz.h>
+#define OTA_HAS_INFLATE 1
+#else
+#define OTA_HAS_INFLATE 0
+#endif
+
+// Compressed images (app.ino.bin.gz, recognized by the gzip magic) are inflated
+// with the ROM tinfl decoder as they arrive: about half the bytes over WiFi.
+// Output collects in the 32KB inflate window and goes to Update in whole flash
+// sectors. The CRC32 and size in the gzip trailer are checked before the image
+// is activated; Update.end() then verifies the image itself as usual.
+// Targets without the ROM decoder accept raw images only.
+
+#if OTA_HAS_INFLATE
+static const size_t OTA_WRITE_BLOCK = 4096;  // flash sector
+static_assert(TINFL_LZ_DICT_SIZE % OTA_WRITE_BLOCK == 0, "window must hold whole sectors");
+
+struct OtaInflate {
+    tinfl_decompressor decomp;
+    uint8_t window[TINFL_LZ_DICT_SIZE];
+    size_t window_pos;      // next output byte
+    size_t window_written;  // bytes handed to Update (whole sectors until the end)
+    bool done;              // deflate stream finished, trailer follows
+    uint8_t trailer[8];     // CRC32 + ISIZE, little-endian
+    size_t trailer_len;
+    uint32_t crc;
+    uint32_t size;
+};
+
+static OtaInflate* ota_inflate = nullptr;
+
+static void ota_inflate_free() {
+    free(ota_inflate);
+    ota_inflate = nullptr;
+}
+
+// gzip member header (RFC 1952): its length, 0 if malformed or not all in buf
+static size_t gzip_header_len(const uint8_t* p, size_t len) {
+    if (len < 10 || p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || (p[3] & 0xE0)) return 0;
+    const uint8_t flags = p[3];
+    size_t pos = 10;
+    if (flags & 0x04) {  // FEXTRA
+        if (pos + 2 > len) return 0;
+        pos += 2 + (p[pos] | (p[pos + 1] << 8));
+    }
+    for (uint8_t field = 0x08; field <= 0x10; field <<= 1) {  // FNAME, FCOMMENT
+        if (!(flags & field)) continue;
+        while (pos < len && p[pos]) pos++;
+        pos++;
+    }
+    if (flags & 0x02) pos += 2;  // FHCRC
+    return pos <= len ? pos : 0;
+}
+
+// Hand finished sectors (all = everything left) to Update
+static bool ota_inflate_flush(bool all) {
+    OtaInflate& z = *ota_inflate;
+    while (z.window_pos - z.window_written >= OTA_WRITE_BLOCK || (all && z.window_pos > z.window_written)) {
+        const size_t n = min(OTA_WRITE_BLOCK, z.window_pos - z.window_written);
+        if (Update.write(z.window + z.window_written, n) != n) return false;
+        z.crc = esp_rom_crc32_le(z.crc, z.window + z.window_written, n);
+        z.size += n;
+        z.window_written += n;
+    }
+    if (z.window_pos == TINFL_LZ_DICT_SIZE) {
+        z.window_pos = 0;
+        z.window_written = 0;
+    }
+    return true;
+}
+
+static bool ota_inflate_feed(const uint8_t* data, size_t len) {
+    OtaInflate& z = *ota_inflate;
+    while (!z.done) {
+        size_t in_bytes = len;
+        size_t out_bytes = TINFL_LZ_DICT_SIZE - z.window_pos;
+        const tinfl_status status = tinfl_decompress(&z.decomp, data, &in_bytes, z.window,
+                                                     z.window + z.window_pos, &out_bytes, TINFL_FLAG_HAS_MORE_INPUT);
+        data += in_bytes;
+        len -= in_bytes;
+        z.window_pos += out_bytes;
+        if (!ota_inflate_flush(false)) return false;
+
+        if (status == TINFL_STATUS_DONE) {
+            z.done = true;
+        } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+            break;  // chunk used up
+        } else if (status < 0) {
+            Logger.logLinef("Inflate error %d", (int)status);
+            return false;
+        }
+        // TINFL_STATUS_HAS_MORE_OUTPUT: the window has room again, continue
+    }
+    while (z.done && len > 0 && z.trailer_len < sizeof(z.trailer)) {
+        z.trailer[z.trailer_len++] = *data++;
+        len--;
+    }
+    return true;
+}
+
+static bool ota_inflate_finish() {
+    OtaInflate& z = *ota_inflate;
+    if (!z.done || z.trailer_len != sizeof(z.trailer)) {
+        Logger.logLine("Compressed image truncated");
+        return false;
+    }
+    if (!ota_inflate_flush(true)) return false;
+    uint32_t crc, size;
+    memcpy(&crc, z.trailer, 4);
+    memcpy(&size, z.trailer + 4, 4);
+    if (crc != z.crc || size != z.size) {
+        Logger.logLinef("gzip check failed (CRC %08lx/%08lx, size %lu/%lu)", (unsigned long)z.crc,
+                        (unsigned long)crc, (unsigned long)z.size, (unsigned long)size);
+        return false;
+    }
+    Logger.logLinef("Inflated: %lu bytes", (unsigned long)z.size);
+    return true;
+}
+
+#else
+struct OtaInflate;
+static OtaInflate* ota_inflate = nullptr;
+static void ota_inflate_free() {}
+static bool ota_inflate_feed(const uint8_t*, size_t) { return false; }
+static bool ota_inflate_finish() { return false; }
+#endif // OTA_HAS_INFLATE
+
+static uint8_t ota_last_percent = 0;
+static AsyncWebServerRequest* ota_request = nullptr;  // upload currently writing to Update
+
+// Drop a partial update and let rendering, MQTT and uploads resume
+static void ota_reset() {
+    if (Update.isRunning()) Update.abort();
+    ota_inflate_free();
+    ota_request = nullptr;
+    g_web_portal_state.ota_in_progress = false;
+}
+
+static void ota_fail(AsyncWebServerRequest *request, int code, const char *end_msg, const char *json) {
+    Logger.logEnd(end_msg);
+    request->send(code, "application/json", json);
+    ota_reset();
+}
 
 static void handleOTAUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
     if (index == 0) {
+        if (ota_request) {
+            request->send(409, "application/json", "{\"success\":false,\"message\":\"Update already in progress\"}");
+            return;
+        }
+
         Logger.logBegin("OTA Update");
         Logger.logLinef("File: %s", filename.c_str());
         Logger.logLinef("Size: %d bytes", request->contentLength());
 
+        // Rendering, MQTT and image processing pause while this is set
         g_web_portal_state.ota_in_progress = true;
+        ota_request = request;
         g_web_portal_state.ota_progress = 0;
         g_web_portal_state.ota_total = request->contentLength();
+        ota_last_percent = 0;
+        ota_inflate_free();
+
+        // Client gone mid-body, or silent for OTA_STALL_TIMEOUT_S (AsyncTCP closes
+        // the connection): abort instead of staying paused until a reboot
+        request->onDisconnect([request]() {
+            if (ota_request != request) return;
+            Logger.logEnd("ERROR: Client disconnected");
+            ota_reset();
+        });
+        request->client()->setRxTimeout(OTA_STALL_TIMEOUT_S);
 
-        if (!filename.endsWith(".bin")) {
-            Logger.logEnd("Not a .bin file");
-            request->send(400, "application/json", "{\"success\":false,\"message\":\"Only .bin files are supported\"}");
-            g_web_portal_state.ota_in_progress = false;
+        if (!filename.endsWith(".bin") && !filename.endsWith(".bin.gz")) {
+            ota_fail(request, 400, "Not a .bin file", "{\"success\":false,\"message\":\"Only .bin and .bin.gz files are supported\"}");
             return;
         }
 
+        const bool compressed = len >= 2 && data[0] == 0x1f && data[1] == 0x8b;
         size_t updateSize = (g_web_portal_state.ota_total > 0) ? g_web_portal_state.ota_total : UPDATE_SIZE_UNKNOWN;
         size_t freeSpace = ESP.getFreeSketchSpace();
 
         Logger.logLinef("Free space: %d bytes", freeSpace);
 
         if (g_web_portal_state.ota_total > 0 && g_web_portal_state.ota_total > freeSpace) {
-            Logger.logEnd("Firmware too large");
-            request->send(400, "application/json", "{\"success\":false,\"message\":\"Firmware too large\"}");
-            g_web_portal_state.ota_in_progress = false;
+            ota_fail(request, 400, "Firmware too large", "{\"success\":false,\"message\":\"Firmware too large\"}");
+            return;
+        }
+
+        if (compressed) {
+#if OTA_HAS_INFLATE
+            // The inflated size is only known from the trailer
+            updateSize = UPDATE_SIZE_UNKNOWN;
+            const size_t header = gzip_header_len(data, len);
+            if (header == 0) {
+                ota_fail(request, 400, "Bad gzip header", "{\"success\":false,\"message\":\"Invalid gzip file\"}");
+                return;
+            }
+            ota_inflate = (OtaInflate*)mem_alloc_large(sizeof(OtaInflate));
+            if (!ota_inflate) {
+                ota_fail(request, 507, "No memory for inflate", "{\"success\":false,\"message\":\"Not enough memory for a compressed update\"}");
+                return;
+            }
+            memset(ota_inflate, 0, sizeof(OtaInflate));
+            tinfl_init(&ota_inflate->decomp);
+            Logger.logLine("Compressed image (gzip)");
+            data += header;
+            len -= header;
+            g_web_portal_state.ota_progress = header;
+#else
+            ota_fail(request, 415, "No inflate support", "{\"success\":false,\"message\":\"Compressed updates are not supported on this chip\"}");
             return;
+#endif
         }
 
         if (!Update.begin(updateSize, U_FLASH)) {
-            Logger.logEnd("Begin failed");
             Update.printError(Serial);
-            request->send(500, "application/json", "{\"success\":false,\"message\":\"OTA begin failed\"}");
-            g_web_portal_state.ota_in_progress = false;
+            ota_fail(request, 500, "Begin failed", "{\"success\":false,\"message\":\"OTA begin failed\"}");
             return;
         }
     }
 
+    // An earlier chunk failed and answered already, or another upload owns Update
+    if (request != ota_request) return;
+
     if (len) {
-        if (Update.write(data, len) != len) {
-            Logger.logEnd("Write failed");
+        const bool ok = ota_inflate ? ota_inflate_feed(data, len) : (Update.write(data, len) == len);
+        if (!ok) {
             Update.printError(Serial);
-            request->send(500, "application/json", "{\"success\":false,\"message\":\"Write failed\"}");
-            g_web_portal_state.ota_in_progress = false;
+            ota_fail(request, 500, "Write failed", "{\"success\":false,\"message\":\"Write failed\"}");
             return;
         }
 
         g_web_portal_state.ota_progress += len;
 
-        static uint8_t last_percent = 0;
-        uint8_t percent = (g_web_portal_state.ota_progress * 100) / g_web_portal_state.ota_total;
-        if (percent >= last_percent + 10) {
-            Logger.logLinef("Progress: %d%%", percent);
-            last_percent = percent;
+        if (g_web_portal_state.ota_total > 0) {
+            uint8_t percent = (g_web_portal_state.ota_progress * 100) / g_web_portal_state.ota_total;
+            if (percent >= ota_last_percent + 10) {
+                Logger.logLinef("Progress: %d%%", percent);
+                ota_last_percent = percent;
+            }
         }
     }
 
     if (final) {
+        if (ota_inflate && !ota_inflate_finish()) {
+            ota_fail(request, 500, "Update failed", "{\"success\":false,\"message\":\"Compressed image corrupt or incomplete\"}");
+            return;
+        }
+        ota_inflate_free();
+
         if (Update.end(true)) {
-            Logger.logLinef("Written: %d bytes", g_web_portal_state.ota_progress);
+            Logger.logLinef("Written: %u bytes", (unsigned)Update.progress());
             Logger.logEnd("Success - rebooting");
 
             request->send(200, "application/json", "{\"success\":true,\"message\":\"Update successful! Rebooting...\"}");
 
             delay(500);
+            config_manager_flush();
+            Logger.flush();
             ESP.restart();
         } else {
             Logger.logEnd("Update failed");
@@ -78,6 +276,7 @@ static void handleOTAUpload(AsyncWebServerRequest *request, String filename, siz
             request->send(500, "application/json", "{\"success\":false,\"message\":\"Update failed\"}");
         }
 
+        ota_request = nullptr;
         g_web_portal_state.ota_in_progress = false;
     }
 }
@@ -0,0 +1,81 @@
+#include "web_portal_api_power.h"
+
+#include "log_manager.h"
+#include "mqtt_manager.h"
+#include "power_ingest.h"
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+
+// Bodies are a handful of name/value pairs; anything larger is a client bug
+#define POWER_BODY_MAX_BYTES 1024
+
+// {"seq": 42, "values": {"solar": 1.25, "grid": -0.4}}: values in the channel
+// unit, seq optional (without it every value applies)
+static void handlePostPower(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    // Answer once, on the first chunk; later chunks of a body that was
+    // already rejected are ignored
+    if (index != 0) return;
+    if (total > POWER_BODY_MAX_BYTES) {
+        request->send(413, "application/json", "{\"error\":\"Body too large\"}");
+        return;
+    }
+    // Small bodies arrive in one chunk
+    if (len != total) {
+        request->send(400, "application/json", "{\"error\":\"Body too large\"}");
+        return;
+    }
+
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    if (error) {
+        Logger.logMessagef("Portal", "Power JSON parse error: %s", error.c_str());
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    JsonObject values = doc["values"];
+    if (values.isNull()) {
+        request->send(400, "application/json", "{\"error\":\"Missing values object\"}");
+        return;
+    }
+    power_ingest_count_http();
+
+    const bool has_seq = doc["seq"].is<uint32_t>();
+    const uint32_t seq = doc["seq"] | 0u;
+
+    int accepted = 0;
+    int stale = 0;
+    int unknown = 0;
+    for (JsonPair kv : values) {
+        const int id = mqtt_manager_find_channel(kv.key().c_str());
+        const float value = kv.value().is<float>() ? kv.value().as<float>() : NAN;
+        switch (power_ingest_push(id, value, has_seq, seq)) {
+            case MQTT_PUSH_OK:    accepted++; break;
+            case MQTT_PUSH_STALE: stale++; break;
+            default:              unknown++; break;
+        }
+    }
+
+    JsonDocument response_doc;
+    response_doc["success"] = accepted > 0 || stale > 0;
+    response_doc["accepted"] = accepted;
+    response_doc["stale"] = stale;
+    response_doc["unknown"] = unknown;
+
+    String response;
+    serializeJson(response_doc, response);
+
+    // Nothing matched a channel: most likely a naming mismatch, say so
+    request->send(accepted > 0 || stale > 0 ? 200 : 400, "application/json", response);
+}
+
+void web_portal_power_register_routes(AsyncWebServer* server) {
+    server->on(
+        "/api/power",
+        HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        NULL,
+        handlePostPower
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+class AsyncWebServer;
+
+// POST /api/power (direct value ingest, see power_ingest.h)
+void web_portal_power_register_routes(AsyncWebServer* server);
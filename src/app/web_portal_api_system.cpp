@@ -1,6 +1,9 @@
 #include "web_portal_api_system.h"
 
 #include "log_manager.h"
+#include "mqtt_manager.h"
+#include "health_sampler.h"
+#include "bench.h"
 #include "web_portal_state.h"
 #include "board_config.h"
 #include "web_assets.h"  // PROJECT_NAME / PROJECT_DISPLAY_NAME
@@ -11,11 +14,6 @@
 #include <WiFi.h>
 #include <freertos/FreeRTOS.h>
 
-// Temperature sensor support (ESP32-C3, ESP32-S2, ESP32-S3, ESP32-C2, ESP32-C6, ESP32-H2)
-#if SOC_TEMP_SENSOR_SUPPORTED
-#include "driver/temperature_sensor.h"
-#endif
-
 static void handleGetMode(AsyncWebServerRequest *request) {
     AsyncResponseStream *response = request->beginResponseStream("application/json");
     response->print("{\"mode\":\"");
@@ -64,128 +62,103 @@ static void handleGetVersion(AsyncWebServerRequest *request) {
     response->print(PROJECT_NAME);
     response->print("\",\"project_display_name\":\"");
     response->print(PROJECT_DISPLAY_NAME);
-    response->print("\"}");
+    response->print("\",\"display_width\":");
+    response->print(LCD_LOGICAL_WIDTH);
+    response->print(",\"display_height\":");
+    response->print(LCD_LOGICAL_HEIGHT);
+    response->print(",\"display_rotation\":");
+    response->print(LCD_ROTATION);
+    response->print("}");
     request->send(response);
 }
 
+// Served from the sampler's cache: no probing on the AsyncTCP task
 static void handleGetHealth(AsyncWebServerRequest *request) {
-    JsonDocument doc;
-
-    // System
-    uint64_t uptime_us = esp_timer_get_time();
-    doc["uptime_seconds"] = uptime_us / 1000000;
-
-    // Reset reason
-    esp_reset_reason_t reset_reason = esp_reset_reason();
-    const char* reset_str = "Unknown";
-    switch (reset_reason) {
-        case ESP_RST_POWERON:   reset_str = "Power On"; break;
-        case ESP_RST_SW:        reset_str = "Software"; break;
-        case ESP_RST_PANIC:     reset_str = "Panic"; break;
-        case ESP_RST_INT_WDT:   reset_str = "Interrupt WDT"; break;
-        case ESP_RST_TASK_WDT:  reset_str = "Task WDT"; break;
-        case ESP_RST_WDT:       reset_str = "WDT"; break;
-        case ESP_RST_DEEPSLEEP: reset_str = "Deep Sleep"; break;
-        case ESP_RST_BROWNOUT:  reset_str = "Brownout"; break;
-        case ESP_RST_SDIO:      reset_str = "SDIO"; break;
-        default: break;
-    }
-    doc["reset_reason"] = reset_str;
-
-    // CPU
-    doc["cpu_freq"] = ESP.getCpuFreqMHz();
-
-    // CPU usage via IDLE task delta calculation
-    TaskStatus_t task_stats[16];
-    uint32_t total_runtime;
-    int task_count = uxTaskGetSystemState(task_stats, 16, &total_runtime);
-
-    uint32_t idle_runtime = 0;
-    for (int i = 0; i < task_count; i++) {
-        if (strstr(task_stats[i].pcTaskName, "IDLE") != nullptr) {
-            idle_runtime += task_stats[i].ulRunTimeCounter;
-        }
-    }
-
-    unsigned long now = millis();
-    int cpu_usage = 0;
+    request->send(health_sampler_json_response(request));
+}
 
-    if (g_web_portal_state.last_cpu_check > 0 && (now - g_web_portal_state.last_cpu_check) > 100) {
-        uint32_t idle_delta = idle_runtime - g_web_portal_state.last_idle_runtime;
-        uint32_t total_delta = total_runtime - g_web_portal_state.last_total_runtime;
+static void handleGetHealthHistory(AsyncWebServerRequest *request) {
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    health_sampler_print_history(response);
+    request->send(response);
+}
 
-        if (total_delta > 0) {
-            float idle_percent = ((float)idle_delta / total_delta) * 100.0f;
-            cpu_usage = (int)(100.0f - idle_percent);
-            if (cpu_usage < 0) cpu_usage = 0;
-            if (cpu_usage > 100) cpu_usage = 100;
+static void handleGetMqttChannels(AsyncWebServerRequest *request) {
+    JsonDocument doc;
+    doc["connected"] = mqtt_manager_is_connected();
+    JsonArray list = doc["channels"].to<JsonArray>();
+
+    const unsigned long now = millis();
+    for (size_t i = 0; i < mqtt_manager_channel_count(); i++) {
+        MqttChannelInfo info;
+        if (!mqtt_manager_get_channel((int)i, &info)) continue;
+
+        JsonObject ch = list.add<JsonObject>();
+        ch["name"] = info.name;
+        ch["topic"] = info.topic;
+        ch["unit"] = info.unit;
+        ch["scale"] = info.scale;
+        if (isnan(info.value)) {
+            ch["value"] = nullptr;
+        } else {
+            ch["value"] = info.value;
         }
-    }
-
-    g_web_portal_state.last_idle_runtime = idle_runtime;
-    g_web_portal_state.last_total_runtime = total_runtime;
-    g_web_portal_state.last_cpu_check = now;
-
-    doc["cpu_usage"] = cpu_usage;
-
-#if SOC_TEMP_SENSOR_SUPPORTED
-    float temp_celsius = 0;
-    temperature_sensor_handle_t temp_sensor = NULL;
-    temperature_sensor_config_t temp_sensor_config = TEMPERATURE_SENSOR_CONFIG_DEFAULT(-10, 80);
-
-    if (temperature_sensor_install(&temp_sensor_config, &temp_sensor) == ESP_OK) {
-        if (temperature_sensor_enable(temp_sensor) == ESP_OK) {
-            if (temperature_sensor_get_celsius(temp_sensor, &temp_celsius) == ESP_OK) {
-                doc["temperature"] = (int)temp_celsius;
-            } else {
-                doc["temperature"] = nullptr;
-            }
-            temperature_sensor_disable(temp_sensor);
+        if (info.updated_ms) {
+            ch["age_ms"] = now - info.updated_ms;
         } else {
-            doc["temperature"] = nullptr;
+            ch["age_ms"] = nullptr;
         }
-        temperature_sensor_uninstall(temp_sensor);
-    } else {
-        doc["temperature"] = nullptr;
     }
-#else
-    doc["temperature"] = nullptr;
-#endif
 
-    // Memory
-    doc["heap_free"] = ESP.getFreeHeap();
-    doc["heap_min"] = ESP.getMinFreeHeap();
-    doc["heap_size"] = ESP.getHeapSize();
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
 
-    size_t largest_block = ESP.getMaxAllocHeap();
-    size_t free_heap = ESP.getFreeHeap();
-    float fragmentation = 0;
-    if (free_heap > 0) {
-        fragmentation = (1.0f - ((float)largest_block / free_heap)) * 100.0f;
+#if ENABLE_BENCHMARK
+// Queue a benchmark run; it executes on the loop task (display locked)
+static void handlePostBench(AsyncWebServerRequest *request) {
+    int runs = 10;
+    if (request->hasParam("runs")) {
+        runs = request->getParam("runs")->value().toInt();
+    }
+    if (!bench_request(runs)) {
+        request->send(409, "application/json", "{\"error\":\"Benchmark already running\"}");
+        return;
     }
-    doc["heap_fragmentation"] = (int)fragmentation;
-
-    // Flash usage
-    doc["flash_used"] = ESP.getSketchSize();
-    doc["flash_total"] = ESP.getSketchSize() + ESP.getFreeSketchSpace();
-
-    // WiFi stats
-    if (WiFi.status() == WL_CONNECTED) {
-        doc["wifi_rssi"] = WiFi.RSSI();
-        doc["wifi_channel"] = WiFi.channel();
-        doc["ip_address"] = WiFi.localIP().toString();
-        doc["hostname"] = WiFi.getHostname();
-    } else {
-        doc["wifi_rssi"] = nullptr;
-        doc["wifi_channel"] = nullptr;
-        doc["ip_address"] = nullptr;
-        doc["hostname"] = nullptr;
+    Logger.logMessagef("API", "POST /api/bench (runs=%d)", runs);
+    request->send(202, "application/json", "{\"state\":\"pending\"}");
+}
+
+static void handleGetBench(AsyncWebServerRequest *request) {
+    JsonDocument doc;
+    doc["state"] = bench_state_name();
+    doc["chip_model"] = ESP.getChipModel();
+    doc["cpu_mhz"] = ESP.getCpuFreqMHz();
+    doc["firmware"] = FIRMWARE_VERSION;
+
+    if (bench_get_state() == BENCH_DONE) {
+        const uint32_t mhz = ESP.getCpuFreqMHz();
+        doc["runs"] = bench_runs();
+        JsonArray list = doc["results"].to<JsonArray>();
+        for (int i = 0; i < bench_result_count(); i++) {
+            const BenchResult* r = bench_get_result(i);
+            JsonObject item = list.add<JsonObject>();
+            item["name"] = r->name;
+            item["ok"] = r->ok;
+            item["runs"] = r->runs;
+            item["min_cycles"] = r->min_cycles;
+            item["median_cycles"] = r->median_cycles;
+            item["max_cycles"] = r->max_cycles;
+            item["median_us"] = r->median_cycles / mhz;
+        }
     }
 
     String response;
     serializeJson(doc, response);
     request->send(200, "application/json", response);
 }
+#endif
 
 static void handleReboot(AsyncWebServerRequest *request) {
     Logger.logMessage("API", "POST /api/reboot");
@@ -193,13 +166,21 @@ static void handleReboot(AsyncWebServerRequest *request) {
     request->send(200, "application/json", "{\"success\":true,\"message\":\"Rebooting device...\"}");
 
     delay(100);
+    config_manager_flush();
     Logger.logMessage("Portal", "Rebooting");
+    Logger.flush();
     ESP.restart();
 }
 
 void web_portal_system_register_routes(AsyncWebServer* server) {
     server->on("/api/mode", HTTP_GET, handleGetMode);
     server->on("/api/info", HTTP_GET, handleGetVersion);
+    server->on("/api/health/history", HTTP_GET, handleGetHealthHistory);
     server->on("/api/health", HTTP_GET, handleGetHealth);
+    server->on("/api/mqtt/channels", HTTP_GET, handleGetMqttChannels);
     server->on("/api/reboot", HTTP_POST, handleReboot);
+#if ENABLE_BENCHMARK
+    server->on("/api/bench", HTTP_GET, handleGetBench);
+    server->on("/api/bench", HTTP_POST, handlePostBench);
+#endif
 }
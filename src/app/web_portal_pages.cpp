@@ -5,6 +5,42 @@
 
 #include <ESPAsyncWebServer.h>
 
+// Caching: every asset carries an ETag (content hash from minify-web-assets.sh)
+// and a matching If-None-Match gets an empty 304. Pages revalidate on each load
+// (the AP-mode redirects still run); CSS/JS requested through the ?v=<hash>
+// URL the pages link never change and may be kept for a year.
+static const char CACHE_REVALIDATE[] = "no-cache";
+static const char CACHE_IMMUTABLE[] = "public, max-age=31536000, immutable";
+
+// etag is quoted; ?v= carries the bare hash
+static bool version_matches(AsyncWebServerRequest *request, const char *etag) {
+    if (!request->hasParam("v")) return false;
+    const String &v = request->getParam("v")->value();
+    const size_t hash_len = strlen(etag) - 2;
+    return v.length() == hash_len && strncmp(v.c_str(), etag + 1, hash_len) == 0;
+}
+
+static bool etag_matches(AsyncWebServerRequest *request, const char *etag) {
+    if (!request->hasHeader("If-None-Match")) return false;
+    const String &tags = request->header("If-None-Match");
+    return tags == "*" || tags.indexOf(etag) >= 0;
+}
+
+static void send_asset(AsyncWebServerRequest *request, const char *content_type,
+                       const uint8_t *data, size_t len, const char *etag) {
+    const char *cache_control = version_matches(request, etag) ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+    AsyncWebServerResponse *response;
+    if (etag_matches(request, etag)) {
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse(200, content_type, data, len);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", cache_control);
+    request->send(response);
+}
+
 static void handleRoot(AsyncWebServerRequest *request) {
     if (g_web_portal_state.ap_mode_active) {
         request->redirect("/network.html");
@@ -18,15 +54,11 @@ static void handleHome(AsyncWebServerRequest *request) {
         request->redirect("/network.html");
         return;
     }
-    AsyncWebServerResponse *response = request->beginResponse(200, "text/html", home_html_gz, home_html_gz_len);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    send_asset(request, "text/html", home_html_gz, home_html_gz_len, home_html_etag);
 }
 
 static void handleNetwork(AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(200, "text/html", network_html_gz, network_html_gz_len);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    send_asset(request, "text/html", network_html_gz, network_html_gz_len, network_html_etag);
 }
 
 static void handleFirmware(AsyncWebServerRequest *request) {
@@ -34,21 +66,15 @@ static void handleFirmware(AsyncWebServerRequest *request) {
         request->send(403, "text/plain", "Not available in AP mode");
         return;
     }
-    AsyncWebServerResponse *response = request->beginResponse(200, "text/html", firmware_html_gz, firmware_html_gz_len);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    send_asset(request, "text/html", firmware_html_gz, firmware_html_gz_len, firmware_html_etag);
 }
 
 static void handleCSS(AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(200, "text/css", portal_css_gz, portal_css_gz_len);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    send_asset(request, "text/css", portal_css_gz, portal_css_gz_len, portal_css_etag);
 }
 
 static void handleJS(AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(200, "application/javascript", portal_js_gz, portal_js_gz_len);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    send_asset(request, "application/javascript", portal_js_gz, portal_js_gz_len, portal_js_etag);
 }
 
 void web_portal_pages_register_routes(AsyncWebServer* server) {
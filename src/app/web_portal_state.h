@@ -14,11 +14,6 @@ struct WebPortalState {
 
     // LCD brightness (current runtime value, may differ from saved)
     uint8_t current_brightness = 100;
-
-    // CPU usage tracking (health endpoint)
-    uint32_t last_idle_runtime = 0;
-    uint32_t last_total_runtime = 0;
-    unsigned long last_cpu_check = 0;
 };
 
 extern WebPortalState g_web_portal_state;
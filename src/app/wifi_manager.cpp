@@ -0,0 +1,372 @@
+/*
+ * WiFi Manager Implementation
+ *
+ * Driver events only set flags; all WiFi calls happen in wifi_manager_loop()
+ * on the network task. Every call used here returns immediately (begin,
+ * disconnect without erase, mode switch); waits are deadlines, not delays.
+ *
+ * FAST_BOOT: the BSSID and channel of the last successful connection are kept
+ * in NVS ("wifi_cache"), and the first attempt goes straight to that AP without
+ * a channel scan. If it fails, the cache is dropped and a normal scan follows
+ * immediately (not counted as a failure).
+ */
+
+#include "wifi_manager.h"
+#include "board_config.h"
+#include "log_manager.h"
+#include "boot_timing.h"
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_wifi.h>
+
+static const DeviceConfig* wifi_config = nullptr;
+static WifiState state = WIFI_STATE_IDLE;
+static unsigned long state_deadline = 0;  // millis() when the current state times out
+static uint32_t failures = 0;
+static uint32_t total_failures = 0;
+static uint32_t connects = 0;
+static bool station_config_ok = false;
+static bool connected_event = false;
+
+// Set by the driver event handlers (WiFi event task)
+static volatile bool got_ip_flag = false;
+static volatile bool disconnect_flag = false;
+static volatile uint8_t disconnect_reason = 0;
+
+// Radio reset timing (the old blocking reset used the same 1 s off / 0.5 s on)
+static const unsigned long RADIO_OFF_MS = 1000;
+static const unsigned long RADIO_ON_MS = 500;
+
+// Last AP (FAST_BOOT)
+#define WIFI_CACHE_NAMESPACE "wifi_cache"
+struct ApCache {
+    bool valid;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+static ApCache ap_cache = {};
+static bool fast_attempt = false;  // current attempt uses ap_cache
+
+// Association with a known BSSID/channel takes well under a second
+static const unsigned long FAST_CONNECT_TIMEOUT_MS = 3000;
+
+static void enter(WifiState next, unsigned long duration_ms) {
+    state = next;
+    state_deadline = millis() + duration_ms;
+}
+
+static bool deadline_passed() {
+    return (long)(millis() - state_deadline) >= 0;
+}
+
+// Disconnect reasons that end an attempt right away instead of at its timeout
+static bool reason_is_final(uint8_t reason) {
+    return reason == WIFI_REASON_NO_AP_FOUND ||
+           reason == WIFI_REASON_AUTH_FAIL ||
+           reason == WIFI_REASON_ASSOC_FAIL ||
+           reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT ||
+           reason == WIFI_REASON_HANDSHAKE_TIMEOUT;
+}
+
+static const char* status_text(wl_status_t status) {
+    return (status == WL_NO_SSID_AVAIL) ? "SSID not found" :
+           (status == WL_CONNECT_FAILED) ? "Connect failed (wrong password?)" :
+           (status == WL_CONNECTION_LOST) ? "Connection lost" :
+           (status == WL_DISCONNECTED) ? "Disconnected" :
+           "Timeout";
+}
+
+// Hostname and optional fixed IP (station mode must be on)
+static bool apply_station_config() {
+    // Prepare sanitized hostname
+    char sanitized[CONFIG_DEVICE_NAME_MAX_LEN];
+    config_manager_sanitize_device_name(wifi_config->device_name, sanitized, CONFIG_DEVICE_NAME_MAX_LEN);
+
+    // NOTE: ESP32's lwIP stack has limited DHCP Option 12 (hostname) support
+    // The hostname may not always appear in router DHCP tables due to ESP-IDF/lwIP limitations
+    // Use mDNS (.local) or NetBIOS for reliable device discovery instead
+    if (strlen(sanitized) > 0) {
+        WiFi.setHostname(sanitized);
+
+        // Also set via esp_netif API (for compatibility)
+        esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+        if (netif != NULL) {
+            esp_netif_set_hostname(netif, sanitized);
+        }
+    }
+
+    if (strlen(wifi_config->fixed_ip) == 0) {
+        return true;
+    }
+
+    IPAddress local_ip, gateway, subnet, dns1, dns2;
+    if (!local_ip.fromString(wifi_config->fixed_ip)) {
+        Logger.logMessage("WiFi", "ERROR: Invalid fixed IP address");
+        return false;
+    }
+    if (!subnet.fromString(wifi_config->subnet_mask)) {
+        Logger.logMessage("WiFi", "ERROR: Invalid subnet mask");
+        return false;
+    }
+    if (!gateway.fromString(wifi_config->gateway)) {
+        Logger.logMessage("WiFi", "ERROR: Invalid gateway");
+        return false;
+    }
+
+    // DNS1: use provided, or default to gateway; DNS2: optional
+    if (strlen(wifi_config->dns1) == 0 || !dns1.fromString(wifi_config->dns1)) {
+        dns1 = gateway;
+    }
+    if (strlen(wifi_config->dns2) == 0 || !dns2.fromString(wifi_config->dns2)) {
+        dns2 = IPAddress(0, 0, 0, 0);
+    }
+
+    if (!WiFi.config(local_ip, gateway, subnet, dns1, dns2)) {
+        Logger.logMessage("WiFi", "ERROR: Fixed IP configuration failed");
+        return false;
+    }
+    return true;
+}
+
+static void ap_cache_load() {
+    ap_cache = {};
+    Preferences prefs;
+    if (!prefs.begin(WIFI_CACHE_NAMESPACE, true)) return;
+    const String ssid = prefs.getString("ssid", "");
+    ap_cache.channel = prefs.getUChar("chan", 0);
+    ap_cache.valid = ssid == wifi_config->wifi_ssid && ap_cache.channel != 0 &&
+                     prefs.getBytes("bssid", ap_cache.bssid, sizeof(ap_cache.bssid)) == sizeof(ap_cache.bssid);
+    prefs.end();
+}
+
+// Remember the AP we are connected to (written only when it changed)
+static void ap_cache_store() {
+    const uint8_t* bssid = WiFi.BSSID();
+    const uint8_t channel = (uint8_t)WiFi.channel();
+    if (!bssid || channel == 0) return;
+    if (ap_cache.valid && ap_cache.channel == channel && memcmp(ap_cache.bssid, bssid, 6) == 0) return;
+
+    Preferences prefs;
+    if (!prefs.begin(WIFI_CACHE_NAMESPACE, false)) return;
+    prefs.putString("ssid", wifi_config->wifi_ssid);
+    prefs.putBytes("bssid", bssid, 6);
+    prefs.putUChar("chan", channel);
+    prefs.end();
+
+    memcpy(ap_cache.bssid, bssid, 6);
+    ap_cache.channel = channel;
+    ap_cache.valid = true;
+}
+
+static void ap_cache_clear() {
+    ap_cache.valid = false;
+    Preferences prefs;
+    if (!prefs.begin(WIFI_CACHE_NAMESPACE, false)) return;
+    prefs.clear();
+    prefs.end();
+}
+
+static void start_attempt();
+
+static void attempt_failed(const char* why) {
+    // Cached AP gone or moved: forget it and scan right away
+    if (fast_attempt) {
+        fast_attempt = false;
+        WiFi.disconnect();
+        ap_cache_clear();
+        Logger.logMessagef("WiFi", "Cached AP failed: %s - scanning", why);
+        start_attempt();
+        return;
+    }
+
+    failures++;
+    total_failures++;
+    WiFi.disconnect();  // stop the driver's attempt (no erase, returns immediately)
+
+    // Repeated failures: the radio may be in a bad state, power-cycle it
+    if (failures % WIFI_MAX_ATTEMPTS == 0) {
+        Logger.logMessagef("WiFi", "Attempt %u failed: %s - resetting radio", (unsigned)failures, why);
+        WiFi.mode(WIFI_OFF);
+        enter(WIFI_STATE_RADIO_OFF, RADIO_OFF_MS);
+        return;
+    }
+
+    const uint32_t shift = failures - 1 < 16 ? failures - 1 : 16;
+    unsigned long backoff = (unsigned long)WIFI_BACKOFF_BASE_MS << shift;
+    if (backoff > WIFI_BACKOFF_MAX_MS) backoff = WIFI_BACKOFF_MAX_MS;
+
+    Logger.logMessagef("WiFi", "Attempt %u failed: %s - retry in %lu ms", (unsigned)failures, why, backoff);
+    enter(WIFI_STATE_BACKOFF, backoff);
+}
+
+static void start_attempt() {
+    if (!station_config_ok) {
+        attempt_failed("invalid IP configuration");
+        return;
+    }
+
+    got_ip_flag = false;
+    disconnect_flag = false;
+
+    if (fast_attempt) {
+        WiFi.begin(wifi_config->wifi_ssid, wifi_config->wifi_password, ap_cache.channel, ap_cache.bssid);
+        Logger.logMessagef("WiFi", "Connecting to %s via cached AP (channel %u)",
+                          wifi_config->wifi_ssid, (unsigned)ap_cache.channel);
+        enter(WIFI_STATE_CONNECTING, FAST_CONNECT_TIMEOUT_MS);
+        return;
+    }
+
+    WiFi.begin(wifi_config->wifi_ssid, wifi_config->wifi_password);
+
+    Logger.logMessagef("WiFi", "Connecting to %s (attempt %u, timeout %lus)",
+                      wifi_config->wifi_ssid, (unsigned)failures + 1, (unsigned long)(WIFI_CONNECT_TIMEOUT_MS / 1000));
+    enter(WIFI_STATE_CONNECTING, WIFI_CONNECT_TIMEOUT_MS);
+}
+
+static void on_connected() {
+    failures = 0;
+    connects++;
+    got_ip_flag = false;
+    disconnect_flag = false;
+    connected_event = true;
+    enter(WIFI_STATE_CONNECTED, 0);
+
+    if (boot_timing_get(BOOT_PHASE_WIFI) == 0) {
+        boot_timing_set_fast_wifi(fast_attempt);
+        boot_timing_mark(BOOT_PHASE_WIFI);
+    }
+    fast_attempt = false;
+#if FAST_BOOT
+    ap_cache_store();
+#endif
+
+    Logger.logBegin("WiFi Connection");
+    Logger.logLinef("SSID: %s", wifi_config->wifi_ssid);
+    Logger.logLinef("IP: %s", WiFi.localIP().toString().c_str());
+    Logger.logLinef("Hostname: %s", WiFi.getHostname());
+    Logger.logLinef("MAC: %s", WiFi.macAddress().c_str());
+    Logger.logLinef("Signal: %d dBm", WiFi.RSSI());
+    Logger.logLine("");
+    Logger.logLine("Access via:");
+    Logger.logLinef("  http://%s", WiFi.localIP().toString().c_str());
+    Logger.logLinef("  http://%s.local", WiFi.getHostname());
+    Logger.logEnd("Connected");
+}
+
+// ===== Public API =====
+
+void wifi_manager_begin(const DeviceConfig* config) {
+    wifi_config = config;
+    failures = 0;
+    connected_event = false;
+
+    // We manage credentials (NVS) and reconnects (backoff, radio reset) ourselves
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+
+    station_config_ok = apply_station_config();
+#if FAST_BOOT
+    ap_cache_load();
+    fast_attempt = ap_cache.valid;
+#endif
+    start_attempt();
+}
+
+void wifi_manager_stop() {
+    if (state == WIFI_STATE_IDLE) return;
+    state = WIFI_STATE_IDLE;
+    WiFi.disconnect();
+}
+
+void wifi_manager_loop() {
+    switch (state) {
+        case WIFI_STATE_IDLE:
+            break;
+
+        case WIFI_STATE_CONNECTING:
+            if (got_ip_flag || WiFi.status() == WL_CONNECTED) {
+                on_connected();
+            } else if (disconnect_flag && reason_is_final(disconnect_reason)) {
+                disconnect_flag = false;
+                char why[24];
+                snprintf(why, sizeof(why), "reason %u", (unsigned)disconnect_reason);
+                attempt_failed(why);
+            } else if (deadline_passed()) {
+                attempt_failed(status_text(WiFi.status()));
+            }
+            break;
+
+        case WIFI_STATE_CONNECTED:
+            if (disconnect_flag || WiFi.status() != WL_CONNECTED) {
+                Logger.logMessagef("WiFi", "Connection lost (reason %u) - reconnecting", (unsigned)disconnect_reason);
+                fast_attempt = ap_cache.valid;  // most drops come back on the same AP
+                start_attempt();
+            }
+            break;
+
+        case WIFI_STATE_BACKOFF:
+            if (deadline_passed()) start_attempt();
+            break;
+
+        case WIFI_STATE_RADIO_OFF:
+            if (deadline_passed()) {
+                WiFi.mode(WIFI_STA);
+                enter(WIFI_STATE_RADIO_ON, RADIO_ON_MS);
+            }
+            break;
+
+        case WIFI_STATE_RADIO_ON:
+            if (deadline_passed()) {
+                station_config_ok = apply_station_config();
+                start_attempt();
+            }
+            break;
+    }
+}
+
+void wifi_manager_on_got_ip() {
+    got_ip_flag = true;
+}
+
+void wifi_manager_on_disconnected(uint8_t reason) {
+    disconnect_reason = reason;
+    disconnect_flag = true;
+}
+
+WifiState wifi_manager_get_state() {
+    return state;
+}
+
+const char* wifi_manager_state_name() {
+    switch (state) {
+        case WIFI_STATE_CONNECTING: return "connecting";
+        case WIFI_STATE_CONNECTED: return "connected";
+        case WIFI_STATE_BACKOFF: return "backoff";
+        case WIFI_STATE_RADIO_OFF:
+        case WIFI_STATE_RADIO_ON: return "radio_reset";
+        default: return "idle";
+    }
+}
+
+bool wifi_manager_is_connected() {
+    return state == WIFI_STATE_CONNECTED;
+}
+
+uint32_t wifi_manager_failures() {
+    return failures;
+}
+
+uint32_t wifi_manager_connects() {
+    return connects;
+}
+
+uint32_t wifi_manager_total_failures() {
+    return total_failures;
+}
+
+bool wifi_manager_take_connected_event() {
+    if (!connected_event) return false;
+    connected_event = false;
+    return true;
+}
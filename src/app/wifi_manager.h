@@ -0,0 +1,62 @@
+/*
+ * WiFi Manager
+ *
+ * Non-blocking station connection as a state machine, driven from the network
+ * task and the WiFi driver events (got IP / disconnected). Nothing in here
+ * waits: every step sets a deadline and wifi_manager_loop() moves on when it
+ * passes, so rendering and the portal keep running through a reconnect.
+ *
+ *   CONNECTING  --got IP-->        CONNECTED  --disconnect-->  CONNECTING
+ *       |  timeout / auth or no-AP failure
+ *       v
+ *   BACKOFF (WIFI_BACKOFF_BASE_MS, doubling up to WIFI_BACKOFF_MAX_MS) --> CONNECTING
+ *       |  every WIFI_MAX_ATTEMPTS consecutive failures
+ *       v
+ *   RADIO_OFF (1 s) --> RADIO_ON (0.5 s) --> CONNECTING   (hard radio reset)
+ *
+ * With FAST_BOOT the first attempt (and the first one after a drop) targets the
+ * cached BSSID/channel of the last AP, skipping the channel scan. With a fixed
+ * IP there is no DHCP round trip either, so the IP follows association directly.
+ *
+ * USAGE:
+ *   wifi_manager_begin(&device_config);           // start connecting
+ *   wifi_manager_loop();                          // call periodically
+ *   if (wifi_manager_take_connected_event()) {    // once per new connection
+ *       start_mdns(); ...
+ *   }
+ */
+
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include "config_manager.h"
+
+enum WifiState {
+    WIFI_STATE_IDLE = 0,     // not started (or stopped for AP mode)
+    WIFI_STATE_CONNECTING,
+    WIFI_STATE_CONNECTED,
+    WIFI_STATE_BACKOFF,
+    WIFI_STATE_RADIO_OFF,
+    WIFI_STATE_RADIO_ON
+};
+
+void wifi_manager_begin(const DeviceConfig* config);  // Configure station mode and start connecting
+void wifi_manager_loop();                             // Advance the state machine (never blocks)
+void wifi_manager_stop();                             // Stop connecting (before switching to AP mode)
+
+// Driver event hooks (call from the ARDUINO_EVENT_WIFI_STA_* handlers)
+void wifi_manager_on_got_ip();
+void wifi_manager_on_disconnected(uint8_t reason);
+
+WifiState wifi_manager_get_state();
+const char* wifi_manager_state_name();
+bool wifi_manager_is_connected();
+uint32_t wifi_manager_failures();                     // Consecutive failed attempts (0 once connected)
+uint32_t wifi_manager_connects();                     // Connections since boot (reconnects = connects - 1)
+uint32_t wifi_manager_total_failures();               // Failed attempts since boot
+
+// True once after each transition to CONNECTED (start mDNS, MQTT, ...)
+bool wifi_manager_take_connected_event();
+
+#endif // WIFI_MANAGER_H
@@ -30,8 +30,8 @@
 // The ESP32-C3 does not have the same default SPI pins as the classic ESP32.
 
 // Display rotation: 0=portrait(0°), 1=landscape(90°), 2=portrait(180°), 3=landscape(270°)
-// Note: Using LVGL software rotation, panel stays in portrait mode
-#define LCD_ROTATION 1  // Landscape mode (90° clockwise via LVGL)
+// Applied by the panel (MADCTL); LVGL and the image API see a 280x240 screen
+#define LCD_ROTATION 1  // Landscape mode (90° clockwise)
 // These overrides ensure the LCD wiring uses valid ESP32-C3 GPIOs.
 #define HAS_DISPLAY true
 
@@ -48,6 +48,14 @@
 #define LCD_RST_PIN 20
 #define LCD_BL_PIN 1
 
+// ============================================================================
+// Image Uploads
+// ============================================================================
+// No PSRAM: the strip ring stays in internal RAM for good, so keep it small
+// (280x32 strips at typical JPEG quality are well under 12KB)
+#define IMAGE_STRIP_SLOTS 2
+#define IMAGE_STRIP_MAX_BYTES (12 * 1024)
+
 // ============================================================================
 // Example: Additional Board-Specific Hardware
 // ============================================================================
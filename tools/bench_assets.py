@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Generate the benchmark image assets (src/app/bench_assets.h).
+
+The on-device benchmark (ENABLE_BENCHMARK) decodes a fixed test image: the
+JPEG itself for the LVGL image screen, and the same picture re-encoded as
+horizontal strips of several heights for the strip decoder.
+
+Usage:
+    python3 bench_assets.py <input_jpg> <output_h> [strip heights...]
+
+Example:
+    python3 bench_assets.py tools/test240x280.jpg src/app/bench_assets.h 16 32 64
+"""
+
+import io
+import os
+import sys
+from PIL import Image
+
+DEFAULT_HEIGHTS = [16, 32, 64]
+STRIP_QUALITY = 90
+
+
+def c_array(name, data):
+    lines = [f"static const uint8_t {name}[] = {{"]
+    for i in range(0, len(data), 16):
+        chunk = ", ".join(f"0x{b:02X}" for b in data[i:i + 16])
+        lines.append(f"    {chunk},")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def encode_strips(img, strip_height):
+    strips = []
+    for y in range(0, img.height, strip_height):
+        strip = img.crop((0, y, img.width, min(y + strip_height, img.height)))
+        buf = io.BytesIO()
+        # Baseline 4:2:0, like tools/upload_image.py
+        strip.save(buf, "JPEG", quality=STRIP_QUALITY, subsampling=2, progressive=False, optimize=False)
+        strips.append(buf.getvalue())
+    return strips
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+
+    input_path = sys.argv[1]
+    output_path = sys.argv[2]
+    heights = [int(h) for h in sys.argv[3:]] or DEFAULT_HEIGHTS
+
+    with open(input_path, "rb") as f:
+        jpeg = f.read()
+    img = Image.open(io.BytesIO(jpeg)).convert("RGB")
+
+    out = []
+    out.append("// Generated by tools/bench_assets.py from " + os.path.basename(input_path) + " - do not edit")
+    out.append("#ifndef BENCH_ASSETS_H")
+    out.append("#define BENCH_ASSETS_H")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append(f"#define BENCH_IMAGE_WIDTH {img.width}")
+    out.append(f"#define BENCH_IMAGE_HEIGHT {img.height}")
+    out.append("")
+    out.append("struct BenchStrip { const uint8_t* data; uint32_t size; };")
+    out.append("struct BenchStripSet { uint16_t strip_height; uint16_t count; const BenchStrip* strips; };")
+    out.append("")
+    out.append(c_array("bench_image_jpeg", jpeg))
+    out.append("")
+
+    total = len(jpeg)
+    for h in heights:
+        strips = encode_strips(img, h)
+        for i, data in enumerate(strips):
+            out.append(c_array(f"bench_strip_{h}_{i}", data))
+            total += len(data)
+        out.append(f"static const BenchStrip bench_strips_{h}[] = {{")
+        for i in range(len(strips)):
+            out.append(f"    {{bench_strip_{h}_{i}, sizeof(bench_strip_{h}_{i})}},")
+        out.append("};")
+        out.append("")
+
+    out.append("static const BenchStripSet bench_strip_sets[] = {")
+    for h in heights:
+        out.append(f"    {{{h}, sizeof(bench_strips_{h}) / sizeof(BenchStrip), bench_strips_{h}}},")
+    out.append("};")
+    out.append(f"#define BENCH_STRIP_SET_COUNT {len(heights)}")
+    out.append("")
+    out.append("#endif // BENCH_ASSETS_H")
+    out.append("")
+
+    with open(output_path, "w") as f:
+        f.write("\n".join(out))
+
+    print(f"  {output_path}: {img.width}x{img.height}, strip heights {heights}, {total} bytes")
+
+
+if __name__ == "__main__":
+    main()
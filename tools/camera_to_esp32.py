@@ -13,6 +13,8 @@ How it works (high-level):
     5) Upload via either:
          - single: POST /api/display/image (multipart)
          - strip:  POST /api/display/image/strips (multiple requests)
+         - delta:  POST /api/display/image/delta (only the tiles that changed
+                   since the previous frame; see "Delta mode" below)
 
 Installation:
   1. Copy this file to: /addon_configs/a0d7b954_appdaemon/apps/
@@ -27,7 +29,7 @@ Usage (from automation):
       camera_entity: camera.front_door
       esp32_ip: "192.168.1.111"
             # Optional knobs:
-            # mode: single|strip        (default: single)
+            # mode: single|strip|delta  (default: single)
                         # rotate_degrees: null|0|90|180|270 (default: null = auto)
                         #   - null / omitted: auto-rotate landscape->portrait when targeting a portrait panel
                         #   - 0: no rotation
@@ -36,6 +38,20 @@ Usage (from automation):
             # timeout: seconds          (default: 10; 0 = permanent)
             # jpeg_quality: 60-95       (default: apps.yaml setting or 80)
             # dismiss: true             (optional: just dismiss current image)
+            # Delta mode only:
+            # frames: N                 (default: 1; snapshots to stream back to back)
+            # frame_interval: seconds   (default: 0; extra pause between snapshots)
+            # tile_size: pixels         (default: 40; change detection grid)
+            # change_threshold: 0-255   (default: 16; per-channel difference that counts as a change)
+            # keyframe_interval: N      (default: 30; full frame every N frames)
+
+Delta mode:
+  The first frame (keyframe) is sent whole, as full-width tiles. Later frames
+  carry only the grid cells that changed since the previous frame sent to that
+  device; the device leaves the rest as it is and acknowledges each frame, which
+  paces the stream. When the device no longer shows the previous frame (timeout,
+  another upload), it answers 409 and the frame is resent as a keyframe. Frames
+  without changes are not sent, so use a long timeout (or 0) for streams.
 
 Requirements:
   - Pillow (add to AppDaemon python_packages)
@@ -44,7 +60,9 @@ Requirements:
 import appdaemon.plugins.hass.hassapi as hass
 import os
 import io
-from PIL import Image
+import struct
+import time
+from PIL import Image, ImageChops
 import requests
 
 class CameraToESP32(hass.Hass):
@@ -71,6 +89,14 @@ class CameraToESP32(hass.Hass):
         # Default strip height for strip uploads
         self.default_strip_height = int(self.args.get("strip_height", 32))
 
+        # Delta mode defaults
+        self.default_tile_size = int(self.args.get("tile_size", 40))
+        self.default_change_threshold = int(self.args.get("change_threshold", 16))
+        self.default_keyframe_interval = int(self.args.get("keyframe_interval", 30))
+
+        # Delta mode: last frame sent per device, {ip: {"seq", "image", "since_key"}}
+        self.delta_state = {}
+
         # Rotation control (unified):
         #   - None: auto-rotate landscape->portrait when targeting a portrait panel
         #   - 0: no rotation
@@ -101,6 +127,13 @@ class CameraToESP32(hass.Hass):
         strip_height = int(data.get("strip_height", self.default_strip_height))
         jpeg_quality = int(data.get("jpeg_quality", self.jpeg_quality))
         dismiss = bool(data.get("dismiss", False))
+        frames = int(data.get("frames", 1))
+        frame_interval = float(data.get("frame_interval", 0))
+        delta_opts = {
+            "tile_size": int(data.get("tile_size", self.default_tile_size)),
+            "change_threshold": int(data.get("change_threshold", self.default_change_threshold)),
+            "keyframe_interval": int(data.get("keyframe_interval", self.default_keyframe_interval)),
+        }
 
         if "rotate_degrees" not in data and "rotate" in data:
             if not bool(data.get("rotate")):
@@ -130,8 +163,8 @@ class CameraToESP32(hass.Hass):
             self.error("Missing required parameter: esp32_ip (or set default_esp32_ip in apps.yaml)")
             return
 
-        if mode not in ("single", "strip"):
-            self.error(f"Invalid mode '{mode}'. Expected 'single' or 'strip'.")
+        if mode not in ("single", "strip", "delta"):
+            self.error(f"Invalid mode '{mode}'. Expected 'single', 'strip' or 'delta'.")
             return
 
         if rotate_degrees is not None:
@@ -151,6 +184,19 @@ class CameraToESP32(hass.Hass):
             f"(mode={mode}, rotate_degrees={rotate_desc}, strip_height={strip_height}, timeout={timeout}s)"
         )
         
+        if mode == "delta":
+            self.stream_delta_frames(
+                camera_entity,
+                esp32_ip,
+                frames=frames,
+                frame_interval=frame_interval,
+                timeout=timeout,
+                rotate_degrees=rotate_degrees,
+                jpeg_quality=jpeg_quality,
+                **delta_opts,
+            )
+            return
+
         # Process and send snapshot
         self.process_camera_snapshot(
             camera_entity,
@@ -227,6 +273,136 @@ class CameraToESP32(hass.Hass):
         except Exception as e:
             self.error(f"Error processing camera snapshot: {e}", level="ERROR")
     
+    def stream_delta_frames(
+        self,
+        camera_entity,
+        esp32_ip,
+        frames=1,
+        frame_interval=0,
+        timeout=10,
+        rotate_degrees=None,
+        jpeg_quality=80,
+        tile_size=40,
+        change_threshold=16,
+        keyframe_interval=30,
+    ):
+        """Fetch snapshots and send each as a delta frame; the device ack paces the loop."""
+        sent = 0
+        skipped = 0
+        start = time.monotonic()
+
+        for _ in range(max(1, frames)):
+            try:
+                jpeg_data = self.get_camera_snapshot(camera_entity)
+                if not jpeg_data:
+                    self.error(f"Failed to fetch camera snapshot from {camera_entity}")
+                    return
+                img = self.prepare_image(
+                    jpeg_data,
+                    target_width=self.display_width,
+                    target_height=self.display_height,
+                    rotate_degrees=rotate_degrees,
+                )
+                if img is None:
+                    self.error("Failed to prepare image")
+                    return
+
+                result = self.send_delta_frame(
+                    img, esp32_ip, timeout, jpeg_quality, tile_size, change_threshold, keyframe_interval
+                )
+                if result is None:
+                    self.error("Delta frame upload failed!")
+                    return
+                if result:
+                    sent += 1
+                else:
+                    skipped += 1
+            except Exception as e:
+                self.error(f"Error streaming delta frames: {e}", level="ERROR")
+                return
+
+            if frame_interval > 0:
+                time.sleep(frame_interval)
+
+        elapsed = time.monotonic() - start
+        fps = (sent + skipped) / elapsed if elapsed > 0 else 0
+        self.log(f"[OK] Delta stream done: {sent} frames sent, {skipped} unchanged, {fps:.1f} frames/s")
+
+    def changed_tiles(self, prev, img, tile_size=40, threshold=16):
+        """Grid cells that differ from prev, merged into horizontal runs: [(x, y, w, h)]."""
+        width, height = img.size
+        diff = ImageChops.difference(prev, img)
+        boxes = []
+        for y in range(0, height, tile_size):
+            h = min(tile_size, height - y)
+            run_x = None
+            for x in range(0, width + tile_size, tile_size):
+                changed = False
+                if x < width:
+                    cell = diff.crop((x, y, min(x + tile_size, width), y + h))
+                    changed = max(hi for _, hi in cell.getextrema()) > threshold
+                if changed and run_x is None:
+                    run_x = x
+                elif not changed and run_x is not None:
+                    boxes.append((run_x, y, min(x, width) - run_x, h))
+                    run_x = None
+        return boxes
+
+    def send_delta_frame(self, img, esp32_ip, timeout=10, quality=80, tile_size=40, threshold=16,
+                         keyframe_interval=30):
+        """Send one frame. Returns True if sent, False if unchanged (nothing sent), None on error."""
+        state = self.delta_state.get(esp32_ip)
+        width, height = img.size
+        key = state is None or state["image"].size != img.size or state["since_key"] + 1 >= keyframe_interval
+
+        for attempt in range(2):
+            if key:
+                boxes = [(0, y, width, min(tile_size, height - y)) for y in range(0, height, tile_size)]
+            else:
+                boxes = self.changed_tiles(state["image"], img, tile_size, threshold)
+                if not boxes:
+                    return False
+
+            seq = (state["seq"] + 1) if state else 1
+            body = bytearray()
+            for (x, y, w, h) in boxes:
+                tile = self.encode_baseline_jpeg(img.crop((x, y, x + w, y + h)), quality=quality)
+                body += struct.pack('<HHI', x, y, len(tile)) + tile
+
+            params = {'seq': seq, 'timeout': timeout}
+            if not key:
+                params['base'] = state["seq"]
+            try:
+                response = requests.post(
+                    f"http://{esp32_ip}/api/display/image/delta",
+                    params=params,
+                    data=bytes(body),
+                    headers={'Content-Type': 'application/octet-stream'},
+                    timeout=15,
+                )
+            except Exception as e:
+                self.error(f"Delta upload error: {e}")
+                return None
+
+            if response.status_code == 409 and not key:
+                self.log(f"Device lost frame {state['seq']}, resending as keyframe")
+                key = True
+                continue
+            if response.status_code != 200 or '"success":true' not in response.text:
+                self.error(f"Delta frame {seq} failed: HTTP {response.status_code} {response.text}")
+                self.delta_state.pop(esp32_ip, None)
+                return None
+
+            self.delta_state[esp32_ip] = {
+                "seq": seq,
+                "image": img,
+                "since_key": 0 if key else state["since_key"] + 1,
+            }
+            self.log(f"Frame {seq}: {'key, ' if key else ''}{len(boxes)} tiles, {len(body)} bytes")
+            return True
+
+        return None
+
     def get_camera_snapshot(self, camera_entity):
         """Fetch camera snapshot from Home Assistant"""
         try:
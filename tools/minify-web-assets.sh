@@ -117,6 +117,14 @@ declare -A JS_GZIP_CONTENTS
 declare -A ORIGINAL_SIZES
 declare -A PROCESSED_SIZES
 declare -A GZIPPED_SIZES
+declare -A ASSET_HASHES
+
+# Content hash used for ETags and ?v= asset URLs: first 16 hex digits of the
+# SHA-256 of the minified text (the gzip stream embeds a timestamp, so it is
+# not hashed)
+asset_hash() {
+    echo -n "$1" | sha256sum | cut -c1-16
+}
 
 # Helper function to gzip content and generate C byte array
 gzip_to_c_array() {
@@ -135,59 +143,6 @@ gzip_to_c_array() {
     rm -f "$temp_file" "$temp_gz"
 }
 
-# Process HTML files (template substitution + minification)
-for html_file in "${HTML_FILES[@]}"; do
-    filename=$(basename "$html_file" .html)
-    echo "Processing HTML: $filename.html..."
-    content=$(cat "$html_file")
-    original_size=$(echo -n "$content" | wc -c)
-    
-    # Template substitution and minification
-    minified=$(python3 -c "
-import re
-import sys
-
-# Read template fragments from environment or files
-header_template = '''$HEADER_TEMPLATE'''
-nav_template = '''$NAV_TEMPLATE'''
-footer_template = '''$FOOTER_TEMPLATE'''
-
-with open('$html_file', 'r') as f:
-    html = f.read()
-    
-    # Replace template placeholders with actual content
-    html = html.replace('{{HEADER}}', header_template)
-    html = html.replace('{{NAV}}', nav_template)
-    html = html.replace('{{FOOTER}}', footer_template)
-    
-    # Project name substitution
-    html = html.replace('{{PROJECT_NAME}}', '$PROJECT_NAME')
-    html = html.replace('{{PROJECT_DISPLAY_NAME}}', '$PROJECT_DISPLAY_NAME')
-    
-    # Remove HTML comments
-    html = re.sub(r'<!--.*?-->', '', html, flags=re.DOTALL)
-    # Collapse multiple spaces/newlines to single space
-    html = re.sub(r'\s+', ' ', html)
-    # Remove spaces around tags
-    html = re.sub(r'>\s+<', '><', html)
-    # Trim
-    html = html.strip()
-    print(html, end='')
-")
-    
-    HTML_CONTENTS["$filename"]="$minified"
-    minified_size=$(echo -n "$minified" | wc -c)
-    
-    # Gzip compress
-    gzipped=$(gzip_to_c_array "$minified")
-    HTML_GZIP_CONTENTS["$filename"]="$gzipped"
-    gzipped_size=$(echo -n "$minified" | gzip -9 -c | wc -c)
-    
-    ORIGINAL_SIZES["html_$filename"]=$original_size
-    PROCESSED_SIZES["html_$filename"]=$minified_size
-    GZIPPED_SIZES["html_$filename"]=$gzipped_size
-done
-
 # Process CSS files (minify)
 for css_file in "${CSS_FILES[@]}"; do
     filename=$(basename "$css_file" .css)
@@ -204,6 +159,7 @@ with open('$css_file', 'r') as f:
 ")
     
     CSS_CONTENTS["$filename"]="$minified"
+    ASSET_HASHES["css_$filename"]=$(asset_hash "$minified")
     minified_size=$(echo -n "$minified" | wc -c)
     
     # Gzip compress
@@ -232,6 +188,7 @@ with open('$js_file', 'r') as f:
 ")
     
     JS_CONTENTS["$filename"]="$minified"
+    ASSET_HASHES["js_$filename"]=$(asset_hash "$minified")
     minified_size=$(echo -n "$minified" | wc -c)
     
     # Gzip compress
@@ -244,6 +201,73 @@ with open('$js_file', 'r') as f:
     GZIPPED_SIZES["js_$filename"]=$gzipped_size
 done
 
+# Process HTML files (template substitution + minification). Runs after CSS/JS:
+# {{VERSION:portal.js}} placeholders become that asset's hash, so a page links
+# /portal.js?v=<hash> and the URL changes whenever the file does.
+ASSET_VERSIONS=""
+for key in "${!ASSET_HASHES[@]}"; do
+    ASSET_VERSIONS="$ASSET_VERSIONS ${key#*_}.${key%%_*}=${ASSET_HASHES[$key]}"
+done
+
+for html_file in "${HTML_FILES[@]}"; do
+    filename=$(basename "$html_file" .html)
+    echo "Processing HTML: $filename.html..."
+    content=$(cat "$html_file")
+    original_size=$(echo -n "$content" | wc -c)
+    
+    # Template substitution and minification
+    minified=$(ASSET_VERSIONS="$ASSET_VERSIONS" python3 -c "
+import os
+import re
+import sys
+
+# Read template fragments from environment or files
+header_template = '''$HEADER_TEMPLATE'''
+nav_template = '''$NAV_TEMPLATE'''
+footer_template = '''$FOOTER_TEMPLATE'''
+
+with open('$html_file', 'r') as f:
+    html = f.read()
+    
+    # Replace template placeholders with actual content
+    html = html.replace('{{HEADER}}', header_template)
+    html = html.replace('{{NAV}}', nav_template)
+    html = html.replace('{{FOOTER}}', footer_template)
+    
+    # Project name substitution
+    html = html.replace('{{PROJECT_NAME}}', '$PROJECT_NAME')
+    html = html.replace('{{PROJECT_DISPLAY_NAME}}', '$PROJECT_DISPLAY_NAME')
+
+    # Asset versions (cache busting for the immutable CSS/JS responses)
+    for entry in os.environ.get('ASSET_VERSIONS', '').split():
+        name, version = entry.split('=', 1)
+        html = html.replace('{{VERSION:' + name + '}}', version)
+    
+    # Remove HTML comments
+    html = re.sub(r'<!--.*?-->', '', html, flags=re.DOTALL)
+    # Collapse multiple spaces/newlines to single space
+    html = re.sub(r'\s+', ' ', html)
+    # Remove spaces around tags
+    html = re.sub(r'>\s+<', '><', html)
+    # Trim
+    html = html.strip()
+    print(html, end='')
+")
+    
+    HTML_CONTENTS["$filename"]="$minified"
+    ASSET_HASHES["html_$filename"]=$(asset_hash "$minified")
+    minified_size=$(echo -n "$minified" | wc -c)
+    
+    # Gzip compress
+    gzipped=$(gzip_to_c_array "$minified")
+    HTML_GZIP_CONTENTS["$filename"]="$gzipped"
+    gzipped_size=$(echo -n "$minified" | gzip -9 -c | wc -c)
+    
+    ORIGINAL_SIZES["html_$filename"]=$original_size
+    PROCESSED_SIZES["html_$filename"]=$minified_size
+    GZIPPED_SIZES["html_$filename"]=$gzipped_size
+done
+
 echo
 
 # Generate the header file
@@ -266,6 +290,9 @@ cat > "$OUTPUT_FILE" << 'HEADER_START'
  * 
  * All assets are stored in gzipped format with Content-Encoding: gzip headers.
  * This reduces flash storage and bandwidth by 60-80%.
+ *
+ * Each asset has an ETag (<name>_<ext>_etag, content hash in quotes). Pages
+ * link CSS/JS as /portal.js?v=<hash>, so those URLs can be cached as immutable.
  * 
  * To modify web assets:
  *   1. Edit source files in src/app/web/
@@ -339,6 +366,16 @@ for filename in "${!JS_CONTENTS[@]}"; do
     echo "const size_t ${filename}_js_gz_len = sizeof(${filename}_js_gz);" >> "$OUTPUT_FILE"
 done
 
+# Add ETags (content hashes, quoted as sent in the header)
+cat >> "$OUTPUT_FILE" << 'ETAG_CONSTANTS'
+
+// ETags (hash of the minified content)
+ETAG_CONSTANTS
+
+for key in $(echo "${!ASSET_HASHES[@]}" | tr ' ' '\n' | sort); do
+    echo "const char ${key#*_}_${key%%_*}_etag[] = \"\\\"${ASSET_HASHES[$key]}\\\"\";" >> "$OUTPUT_FILE"
+done
+
 # Close header file
 cat >> "$OUTPUT_FILE" << 'HEADER_END'
 
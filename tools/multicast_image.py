@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""ESP32 Multicast Image Sender
+
+Sends one image to every display in the multicast group at once. The strips
+are multicast once; each device unicasts a NACK for what it lost and the tool
+re-multicasts just those fragments, so the cost stays about the same for one
+display or a dozen. Devices ACK once the frame is on screen.
+
+Protocol: src/app/image_multicast.h (group and port: IMAGE_MULTICAST_GROUP /
+IMAGE_MULTICAST_PORT in board_config.h).
+
+Usage:
+    # JPEG strips to every display on the default group
+    python3 multicast_image.py status.png
+
+    # Lossless rle565 bands, stay until replaced, wait for 12 ACKs
+    python3 multicast_image.py dashboard.png --format rle565 --timeout 0 --expect 12
+
+Requirements:
+    - Python 3.6+
+    - Pillow (PIL): pip3 install Pillow
+    - requests: pip3 install requests (imported with upload_image.py's helpers)
+"""
+
+import argparse
+import os
+import socket
+import struct
+import sys
+import time
+from typing import Dict, List, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from upload_image import (  # noqa: E402
+    _load_rgb_image,
+    encode_rle565,
+    image_to_jpeg_strips,
+    image_to_rgb565,
+)
+
+DEFAULT_GROUP = '239.255.71.1'
+DEFAULT_PORT = 4711
+
+MAGIC = b'EI'
+VERSION = 1
+TYPE_DATA = 1
+TYPE_NACK = 2
+TYPE_END = 3
+TYPE_ACK = 4
+
+DATA_HEADER = struct.Struct('<2sBBIIHHBBBBIIIHBBHH')  # 40 bytes
+FRAGMENT_PAYLOAD = 1400  # keeps datagrams under a 1500-byte MTU
+MAX_FRAGMENTS = 32
+MAX_STRIPS = 64
+
+
+# ============================================================================
+# Frame building
+# ============================================================================
+
+class Strip:
+    def __init__(self, data: bytes, y: int = 0, rows: int = 0):
+        self.data = data
+        self.y = y
+        self.rows = rows
+        self.offset = 0
+
+
+def rle565_strips(path: str, strip_height: int) -> Tuple[int, int, List[Strip]]:
+    img = _load_rgb_image(path)
+    width, height = img.size
+    strips = []
+    for y in range(0, height, strip_height):
+        band = img.crop((0, y, width, min(y + strip_height, height)))
+        strips.append(Strip(encode_rle565(image_to_rgb565(band)), y, band.size[1]))
+    return width, height, strips
+
+
+def build_packets(frame_id: int, width: int, height: int, strips: List[Strip], fmt: int, scale_log2: int,
+                  timeout_s: int) -> Dict[Tuple[int, int], bytes]:
+    """DATA datagrams keyed by (strip index, fragment index)."""
+    offset = 0
+    for strip in strips:
+        strip.offset = offset
+        offset += len(strip.data)
+    frame_size = offset
+
+    packets = {}
+    for index, strip in enumerate(strips):
+        frag_count = max(1, -(-len(strip.data) // FRAGMENT_PAYLOAD))
+        if frag_count > MAX_FRAGMENTS:
+            raise ValueError(f"strip {index} is {len(strip.data)} bytes; use a smaller --strip-height")
+        for frag in range(frag_count):
+            start = frag * FRAGMENT_PAYLOAD
+            header = DATA_HEADER.pack(MAGIC, VERSION, TYPE_DATA, frame_id, frame_size, width, height,
+                                      index, len(strips), frag, frag_count, strip.offset, len(strip.data),
+                                      start, timeout_s, fmt, scale_log2, strip.y, strip.rows)
+            packets[(index, frag)] = header + strip.data[start:start + FRAGMENT_PAYLOAD]
+    return packets
+
+
+def end_packet(frame_id: int) -> bytes:
+    return struct.pack('<2sBBI', MAGIC, VERSION, TYPE_END, frame_id)
+
+
+# ============================================================================
+# Transmission
+# ============================================================================
+
+def send_frame(sock, dest, packets, frame_id, strip_frags, linger_s, pace_s, expect, rounds):
+    """Multicast every packet, then serve NACKs until ACKs or quiet. Returns {ip: ok}."""
+    def blast(keys):
+        for key in keys:
+            sock.sendto(packets[key], dest)
+            if pace_s:
+                time.sleep(pace_s)
+        sock.sendto(end_packet(frame_id), dest)
+
+    blast(sorted(packets))
+    acks: Dict[str, bool] = {}
+    resent = 0
+    deadline = time.monotonic() + linger_s
+
+    while time.monotonic() < deadline and (expect == 0 or len(acks) < expect):
+        sock.settimeout(max(0.01, deadline - time.monotonic()))
+        try:
+            data, addr = sock.recvfrom(1024)
+        except socket.timeout:
+            break
+        if len(data) < 8 or data[:2] != MAGIC or data[2] != VERSION:
+            continue
+        msg_type = data[3]
+        (msg_frame,) = struct.unpack_from('<I', data, 4)
+        if msg_frame != frame_id:
+            continue
+
+        if msg_type == TYPE_ACK and len(data) >= 9:
+            acks[addr[0]] = data[8] == 0
+        elif msg_type == TYPE_NACK and len(data) >= 10:
+            if rounds <= 0:
+                continue
+            rounds -= 1
+            count = data[8]
+            if count == 0:
+                keys = sorted(packets)  # device saw nothing of the frame
+            else:
+                keys = []
+                for i in range(count):
+                    if len(data) < 10 + 6 * (i + 1):
+                        break
+                    strip, _, missing = struct.unpack_from('<BBI', data, 10 + 6 * i)
+                    keys += [(strip, f) for f in range(strip_frags.get(strip, 0)) if missing & (1 << f)]
+            resent += len(keys)
+            blast(keys)  # to the group: other displays may have lost the same fragments
+            deadline = time.monotonic() + linger_s
+
+    return acks, resent
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='ESP32 Multicast Image Sender - one transmission for every display in the group',
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    parser.add_argument('image', help='Image file (any Pillow-supported format)')
+    parser.add_argument('--group', default=DEFAULT_GROUP, help=f'Multicast group (default: {DEFAULT_GROUP})')
+    parser.add_argument('--port', type=int, default=DEFAULT_PORT, help=f'UDP port (default: {DEFAULT_PORT})')
+    parser.add_argument('--format', choices=['jpeg', 'rle565'], default='jpeg', help='Strip format (default: jpeg)')
+    parser.add_argument('--strip-height', type=int, default=16, help='Strip height in pixels (default: 16)')
+    parser.add_argument('--jpeg-quality', type=int, default=90, help='JPEG quality (default: 90)')
+    parser.add_argument('--scale', type=int, choices=[1, 2, 4, 8], default=1,
+                        help='Device-side JPEG downscale; the image must be scale times the panel size (default: 1)')
+    parser.add_argument('--timeout', type=int, default=10, help='Display timeout in seconds (0=permanent, default: 10)')
+    parser.add_argument('--expect', type=int, default=0, help='Stop once this many displays ACKed (default: wait out --linger)')
+    parser.add_argument('--linger', type=float, default=0.5, help='Seconds of quiet before giving up (default: 0.5)')
+    parser.add_argument('--pace-us', type=int, default=300,
+                        help='Gap between datagrams in microseconds; APs drop multicast bursts (default: 300)')
+    parser.add_argument('--ttl', type=int, default=1, help='Multicast TTL (default: 1, local network)')
+    parser.add_argument('--interface', default='', help='Local IP of the interface to send on (default: OS choice)')
+    args = parser.parse_args()
+
+    if not os.path.exists(args.image):
+        print(f"Error: Image file not found: {args.image}")
+        sys.exit(1)
+    if args.scale > 1 and args.format != 'jpeg':
+        print("Error: --scale requires --format jpeg")
+        sys.exit(1)
+
+    if args.format == 'jpeg':
+        width, height, _, jpegs = image_to_jpeg_strips(args.image, args.strip_height * args.scale, args.jpeg_quality)
+        strips = [Strip(j) for j in jpegs]
+        width //= args.scale
+        height //= args.scale
+    else:
+        width, height, strips = rle565_strips(args.image, args.strip_height)
+    if len(strips) > MAX_STRIPS:
+        print(f"Error: {len(strips)} strips (max {MAX_STRIPS}); use a larger --strip-height")
+        sys.exit(1)
+
+    frame_id = int(time.time() * 1000) & 0xFFFFFFFF  # only moves forward, across sender restarts
+    try:
+        packets = build_packets(frame_id, width, height, strips, 1 if args.format == 'rle565' else 0,
+                                args.scale.bit_length() - 1, args.timeout)
+    except ValueError as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+    strip_frags: Dict[int, int] = {}
+    for strip, _ in packets:
+        strip_frags[strip] = strip_frags.get(strip, 0) + 1
+
+    total = sum(len(s.data) for s in strips)
+    print(f"Input: {args.image} ({width}×{height}, {args.format})")
+    print(f"  Frame {frame_id:08x}: {len(strips)} strips, {total} bytes, {len(packets)} datagrams")
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, args.ttl)
+    if args.interface:
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_IF, socket.inet_aton(args.interface))
+    sock.bind(('', 0))  # NACKs and ACKs come back to this port
+
+    start = time.monotonic()
+    acks, resent = send_frame(sock, (args.group, args.port), packets, frame_id, strip_frags,
+                              args.linger, args.pace_us / 1e6, args.expect, rounds=64)
+    elapsed = time.monotonic() - start
+
+    ok = sorted(ip for ip, good in acks.items() if good)
+    failed = sorted(ip for ip, good in acks.items() if not good)
+    print(f"  {len(ok)} displays showed the frame, {len(failed)} failed, {resent} datagrams resent, {elapsed:.2f}s")
+    for ip in failed:
+        print(f"    failed: {ip}")
+
+    if args.expect and len(ok) < args.expect:
+        sys.exit(1)
+    sys.exit(0 if not failed else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -26,7 +26,8 @@ def png_to_lvgl_rgba(img_path, symbol_name):
     pixels = list(img.getdata())
     
     # Generate pixel data
-    # LVGL TRUE_COLOR_ALPHA stores each pixel as RGB565 (2 bytes) + Alpha (1 byte)
+    # LVGL TRUE_COLOR_ALPHA stores each pixel as RGB565 (2 bytes) + Alpha (1 byte);
+    # the RGB565 bytes follow lv_color_t's in-memory order
     # Total: 3 bytes per pixel
     byte_array = []
     
@@ -37,9 +38,9 @@ def png_to_lvgl_rgba(img_path, symbol_name):
         b5 = (b >> 3) & 0x1F
         rgb565 = (r5 << 11) | (g6 << 5) | b5
         
-        # Store as little-endian RGB565 + alpha
-        byte_array.append(rgb565 & 0xFF)        # Low byte of RGB565
+        # Store as RGB565 + alpha, high byte first (lv_conf.h: LV_COLOR_16_SWAP 1)
         byte_array.append((rgb565 >> 8) & 0xFF) # High byte of RGB565
+        byte_array.append(rgb565 & 0xFF)        # Low byte of RGB565
         byte_array.append(a)                     # Alpha
     
     return width, height, byte_array
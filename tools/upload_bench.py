@@ -0,0 +1,369 @@
+#!/usr/bin/env python3
+"""ESP32 Upload Throughput Harness
+
+Drives the image endpoints of a device and measures them, for comparing
+firmware releases built by build.sh.
+
+For every combination of the sweep parameters, N frames are uploaded and the
+harness records end-to-end frames/sec, per-frame and per-strip latency
+percentiles, busy (503) retries, and the device-side timings of that run read
+back from GET /api/health (perf counters, before/after delta).
+
+Sweep parameters:
+  --mode           single, strip, batch (strips via /strips/batch)
+  --strip-heights  strip heights for strip/batch modes
+  --qualities      JPEG qualities
+  --concurrency    parallel uploaders (single mode; strip sessions are
+                   exclusive on the device, so strip/batch always run with 1)
+
+Output is one JSON document (stdout or --output). --compare BASELINE.json
+matches configurations against an earlier run and exits 1 when frames/sec
+dropped by more than --tolerance percent.
+
+Usage:
+    python3 upload_bench.py 192.168.1.111 test240x280.jpg --output v1.5.0.json
+    python3 upload_bench.py 192.168.1.111 test240x280.jpg --mode strip --strip-heights 16 32 \\
+        --qualities 70 90 --frames 10 --compare v1.5.0.json
+
+Requirements:
+    - Python 3.7+
+    - Pillow (PIL): pip3 install Pillow
+    - requests: pip3 install requests
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import threading
+import time
+from typing import Dict, List, Optional
+
+import requests
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from upload_image import (  # noqa: E402
+    BUSY_BACKOFF_S,
+    MAX_BUSY_RETRIES,
+    image_to_jpeg_bytes,
+    image_to_jpeg_strips,
+)
+
+PERF_TIMERS = ("flush", "lvgl_handler", "strip_decode")
+
+
+# ============================================================================
+# Statistics
+# ============================================================================
+
+def percentile(values: List[float], pct: float) -> Optional[float]:
+    if not values:
+        return None
+    ordered = sorted(values)
+    k = (len(ordered) - 1) * pct / 100.0
+    lo = int(k)
+    hi = min(lo + 1, len(ordered) - 1)
+    return ordered[lo] + (ordered[hi] - ordered[lo]) * (k - lo)
+
+
+def latency_summary(values_s: List[float]) -> Dict[str, Optional[float]]:
+    ms = [v * 1000.0 for v in values_s]
+
+    def r(v):
+        return round(v, 2) if v is not None else None
+
+    return {
+        "count": len(ms),
+        "p50_ms": r(percentile(ms, 50)),
+        "p90_ms": r(percentile(ms, 90)),
+        "p99_ms": r(percentile(ms, 99)),
+        "max_ms": r(max(ms)) if ms else None,
+    }
+
+
+# ============================================================================
+# Device
+# ============================================================================
+
+def get_json(base_url: str, path: str) -> Optional[dict]:
+    try:
+        response = requests.get(base_url + path, timeout=5)
+        if response.status_code == 200:
+            return response.json()
+    except (requests.RequestException, ValueError):
+        pass
+    return None
+
+
+def perf_delta(before: Optional[dict], after: Optional[dict]) -> Optional[dict]:
+    """Device-side timings of the run: perf counters from /api/health, after - before."""
+    if not before or not after or "perf" not in before or "perf" not in after:
+        return None
+    a, b = after["perf"], before["perf"]
+    out = {}
+    for name in PERF_TIMERS:
+        if name not in a or name not in b:
+            continue
+        count = a[name]["count"] - b[name]["count"]
+        total_us = a[name]["avg_us"] * a[name]["count"] - b[name]["avg_us"] * b[name]["count"]
+        out[name] = {
+            "count": count,
+            "avg_us": round(total_us / count) if count > 0 else None,
+            "max_us_since_boot": a[name]["max_us"],
+        }
+    out["spi_bytes"] = a.get("spi_bytes", 0) - b.get("spi_bytes", 0)
+    out["heap_min"] = after.get("heap_min")
+    return out
+
+
+# ============================================================================
+# Uploads (one frame each; return per-request latencies, raise on failure)
+# ============================================================================
+
+class UploadError(Exception):
+    pass
+
+
+def post_with_retry(session, url, params, body, stats):
+    retries = 0
+    while True:
+        start = time.perf_counter()
+        response = session.post(url, params=params, data=body,
+                                headers={"Content-Type": "application/octet-stream"}, timeout=30)
+        elapsed = time.perf_counter() - start
+        if response.status_code == 503 and retries < MAX_BUSY_RETRIES:
+            retries += 1
+            stats["busy_retries"] += 1
+            time.sleep(min(BUSY_BACKOFF_S * retries, 0.5))
+            continue
+        if response.status_code != 200:
+            raise UploadError(f"HTTP {response.status_code}: {response.text[:120]}")
+        return elapsed
+
+
+def upload_frame_single(session, base_url, jpeg, stats) -> List[float]:
+    start = time.perf_counter()
+    response = session.post(base_url + "/api/display/image",
+                            files={"image": ("image.jpg", jpeg, "image/jpeg")},
+                            params={"timeout": 1}, timeout=30)
+    if response.status_code == 409:
+        stats["busy_rejects"] += 1
+        raise UploadError("busy (409)")
+    if response.status_code != 200:
+        raise UploadError(f"HTTP {response.status_code}: {response.text[:120]}")
+    return [time.perf_counter() - start]
+
+
+def upload_frame_strips(session, base_url, width, height, strips, stats) -> List[float]:
+    url = base_url + "/api/display/image/strips"
+    latencies = []
+    for i, strip in enumerate(strips):
+        params = {"strip_index": i, "strip_count": len(strips), "width": width, "height": height, "timeout": 1}
+        latencies.append(post_with_retry(session, url, params, strip, stats))
+    return latencies
+
+
+def upload_frame_batch(session, base_url, width, height, strips, batch_size, stats) -> List[float]:
+    url = base_url + "/api/display/image/strips/batch"
+    latencies = []
+    first = 0
+    retries = 0
+    while first < len(strips):
+        chunk = strips[first:first + batch_size]
+        body = b"".join(struct.pack("<I", len(s)) + s for s in chunk)
+        params = {"strip_start": first, "strip_count": len(strips), "width": width, "height": height, "timeout": 1}
+        start = time.perf_counter()
+        response = session.post(url, params=params, data=body,
+                                headers={"Content-Type": "application/octet-stream"}, timeout=30)
+        elapsed = time.perf_counter() - start
+        # Strip ring full: the device queued strips_received strips, resend the rest
+        if response.status_code == 503 and retries < MAX_BUSY_RETRIES:
+            retries += 1
+            stats["busy_retries"] += 1
+            queued = response.json().get("strips_received", 0)
+            if queued:
+                latencies.extend([elapsed / queued] * queued)
+                first += queued
+            time.sleep(min(BUSY_BACKOFF_S * retries, 0.5))
+            continue
+        if response.status_code != 200:
+            raise UploadError(f"HTTP {response.status_code}: {response.text[:120]}")
+        retries = 0
+        # Spread the request time over its strips
+        latencies.extend([elapsed / len(chunk)] * len(chunk))
+        first += len(chunk)
+    return latencies
+
+
+# ============================================================================
+# Runs
+# ============================================================================
+
+def run_config(base_url, image, mode, strip_height, quality, concurrency, frames, batch_size):
+    stats = {"busy_retries": 0, "busy_rejects": 0, "errors": []}
+    frame_times: List[float] = []
+    request_times: List[float] = []
+    lock = threading.Lock()
+
+    if mode == "single":
+        width, height, jpeg = image_to_jpeg_bytes(image, quality=quality)
+        payload_bytes = len(jpeg)
+        strip_count = 1
+    else:
+        width, height, _, strips = image_to_jpeg_strips(image, strip_height=strip_height, quality=quality)
+        payload_bytes = sum(len(s) for s in strips)
+        strip_count = len(strips)
+
+    def worker(count):
+        session = requests.Session()
+        for _ in range(count):
+            start = time.perf_counter()
+            try:
+                if mode == "single":
+                    lat = upload_frame_single(session, base_url, jpeg, stats)
+                elif mode == "strip":
+                    lat = upload_frame_strips(session, base_url, width, height, strips, stats)
+                else:
+                    lat = upload_frame_batch(session, base_url, width, height, strips, batch_size, stats)
+            except (UploadError, requests.RequestException) as e:
+                with lock:
+                    stats["errors"].append(str(e))
+                continue
+            with lock:
+                frame_times.append(time.perf_counter() - start)
+                request_times.extend(lat)
+
+    before = get_json(base_url, "/api/health")
+    wall_start = time.perf_counter()
+    per_worker = [frames // concurrency + (1 if i < frames % concurrency else 0) for i in range(concurrency)]
+    threads = [threading.Thread(target=worker, args=(n,)) for n in per_worker if n > 0]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    wall = time.perf_counter() - wall_start
+    after = get_json(base_url, "/api/health")
+
+    return {
+        "config": {
+            "mode": mode,
+            "strip_height": strip_height if mode != "single" else None,
+            "batch": batch_size if mode == "batch" else None,
+            "quality": quality,
+            "concurrency": concurrency,
+        },
+        "image": {"width": width, "height": height, "strips": strip_count, "bytes": payload_bytes},
+        "frames": frames,
+        "frames_ok": len(frame_times),
+        "wall_s": round(wall, 3),
+        "fps": round(len(frame_times) / wall, 3) if wall > 0 else None,
+        "throughput_kbps": round(payload_bytes * len(frame_times) * 8 / 1000 / wall, 1) if wall > 0 else None,
+        "frame_latency": latency_summary(frame_times),
+        "strip_latency": latency_summary(request_times) if mode != "single" else None,
+        "busy_retries": stats["busy_retries"],
+        "busy_rejects": stats["busy_rejects"],
+        "errors": stats["errors"][:10],
+        "device": perf_delta(before, after),
+    }
+
+
+def config_key(result) -> str:
+    c = result["config"]
+    return f'{c["mode"]}/h{c["strip_height"]}/b{c["batch"]}/q{c["quality"]}/c{c["concurrency"]}'
+
+
+def compare(results, baseline_path, tolerance) -> List[dict]:
+    with open(baseline_path) as f:
+        baseline = {config_key(r): r for r in json.load(f).get("results", [])}
+    regressions = []
+    for r in results:
+        old = baseline.get(config_key(r))
+        if not old or not old.get("fps") or r.get("fps") is None:
+            continue
+        change = (r["fps"] - old["fps"]) / old["fps"] * 100.0
+        r["fps_change_pct"] = round(change, 1)
+        if change < -tolerance:
+            regressions.append({"config": config_key(r), "baseline_fps": old["fps"], "fps": r["fps"],
+                                "change_pct": round(change, 1)})
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="ESP32 upload throughput harness (JSON output)",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    parser.add_argument("esp32_ip", help="ESP32 IP address or hostname")
+    parser.add_argument("image", help="Image file (re-encoded as baseline JPEG per quality)")
+    parser.add_argument("--mode", nargs="+", choices=["single", "strip", "batch"], default=["single", "strip"],
+                        help="Upload modes to sweep (default: single strip)")
+    parser.add_argument("--strip-heights", nargs="+", type=int, default=[16, 32, 64],
+                        help="Strip heights for strip/batch modes (default: 16 32 64)")
+    parser.add_argument("--qualities", nargs="+", type=int, default=[90],
+                        help="JPEG qualities (default: 90)")
+    parser.add_argument("--concurrency", nargs="+", type=int, default=[1],
+                        help="Parallel uploaders for single mode (default: 1)")
+    parser.add_argument("--batch", type=int, default=6, help="Strips per request in batch mode (default: 6)")
+    parser.add_argument("--frames", type=int, default=5, help="Frames per configuration (default: 5)")
+    parser.add_argument("--output", help="Write JSON here instead of stdout")
+    parser.add_argument("--compare", help="Baseline JSON from an earlier run")
+    parser.add_argument("--tolerance", type=float, default=10.0,
+                        help="Allowed frames/sec drop vs. baseline in percent (default: 10)")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.image):
+        print(f"Error: Image file not found: {args.image}", file=sys.stderr)
+        sys.exit(2)
+
+    base_url = f"http://{args.esp32_ip}"
+    info = get_json(base_url, "/api/info")
+    if info is None:
+        print(f"Error: device not reachable at {base_url}", file=sys.stderr)
+        sys.exit(2)
+
+    results = []
+    for mode in args.mode:
+        heights = [None] if mode == "single" else args.strip_heights
+        levels = args.concurrency if mode == "single" else [1]
+        for height in heights:
+            for quality in args.qualities:
+                for concurrency in levels:
+                    result = run_config(base_url, args.image, mode, height, quality, max(1, concurrency),
+                                        args.frames, args.batch)
+                    print(f"{config_key(result)}: {result['fps']} fps, "
+                          f"p50 {result['frame_latency']['p50_ms']} ms, "
+                          f"{result['frames_ok']}/{result['frames']} ok", file=sys.stderr)
+                    results.append(result)
+                    time.sleep(1.5)  # let the device return to the power screen
+
+    report = {
+        "tool": "upload_bench",
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        "device": info,
+        "image": os.path.basename(args.image),
+        "frames_per_config": args.frames,
+        "results": results,
+    }
+
+    regressions = []
+    if args.compare:
+        regressions = compare(results, args.compare, args.tolerance)
+        report["baseline"] = os.path.basename(args.compare)
+        report["regressions"] = regressions
+
+    text = json.dumps(report, indent=2)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+
+    for r in regressions:
+        print(f"REGRESSION {r['config']}: {r['baseline_fps']} -> {r['fps']} fps ({r['change_pct']}%)",
+              file=sys.stderr)
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,11 +1,13 @@
 #!/usr/bin/env python3
 """ESP32 Image Upload Tool
 
-Uploads a plain baseline JPEG to the device.
+Uploads a plain baseline JPEG to the device, or (single mode) raw pixels that
+the firmware draws without decoding.
 
 Endpoints:
   - POST /api/display/image          (single upload via multipart)
     - POST /api/display/image/strips   (strip uploads via raw body)
+    - POST /api/display/image/strips/batch (several length-prefixed strips per request)
 
 Notes:
   - Firmware expects normal RGB JPEG input; no client-side BGR swapping.
@@ -16,9 +18,20 @@ Usage:
     # Strip upload (memory efficient)
     python3 upload_image.py 192.168.1.111 photo.jpg --mode strip --strip-height 32
 
+    # Batched strip upload (several strips per HTTP request)
+    python3 upload_image.py 192.168.1.111 photo.jpg --mode strip --strip-height 16 --batch 6
+
     # Single-file upload
     python3 upload_image.py 192.168.1.111 photo.jpg --mode single
 
+    # Lossless, no decode on the device: run-length encoded RGB565 (image must
+    # match the panel size, e.g. 240x280)
+    python3 upload_image.py 192.168.1.111 dashboard.png --mode single --format rle565
+
+    # Full-resolution source, downscaled while decoding on the device (image
+    # must be exactly 2, 4 or 8 times the panel size, e.g. 960x1120 for 1/4)
+    python3 upload_image.py 192.168.1.111 snapshot.jpg --mode strip --scale 4
+
 Requirements:
     - Python 3.6+
     - Pillow (PIL): pip3 install Pillow
@@ -29,6 +42,8 @@ import argparse
 import sys
 import os
 import math
+import struct
+import time
 import requests
 from typing import List, Tuple
 
@@ -87,32 +102,103 @@ def image_to_jpeg_strips(input_path: str, strip_height: int, quality: int = 90)
     return width, height, strip_height, strips
 
 
+# ============================================================================
+# Raw RGB565 helpers (firmware: src/app/raw_image.h)
+# ============================================================================
+
+RLE_RUN_FLAG = 0x8000
+RLE_MAX_COUNT = 0x7FFF
+RLE_MAX_LITERALS = 128
+RLE_MIN_RUN = 3  # shorter runs are cheaper as literals
+
+
+def image_to_rgb565(img: Image.Image) -> List[int]:
+    """RGB565 pixel values, row-major."""
+    return [((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3) for r, g, b in img.getdata()]
+
+
+def encode_rgb565(pixels: List[int]) -> bytes:
+    """rgb565: 2 bytes per pixel, high byte first (panel byte order)."""
+    return b''.join(struct.pack('>H', px) for px in pixels)
+
+
+def encode_rle565(pixels: List[int]) -> bytes:
+    """rle565: little-endian header words (0x8000|n run, n literals), pixels high byte first."""
+    out = bytearray()
+    literals: List[int] = []
+
+    def flush_literals():
+        if literals:
+            out.extend(struct.pack('<H', len(literals)))
+            for px in literals:
+                out.extend(struct.pack('>H', px))
+            literals.clear()
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and pixels[i + run] == pixels[i] and run < RLE_MAX_COUNT:
+            run += 1
+        if run >= RLE_MIN_RUN:
+            flush_literals()
+            out.extend(struct.pack('<H', RLE_RUN_FLAG | run))
+            out.extend(struct.pack('>H', pixels[i]))
+        else:
+            for px in pixels[i:i + run]:
+                literals.append(px)
+                if len(literals) == RLE_MAX_LITERALS:
+                    flush_literals()
+        i += run
+    flush_literals()
+    return bytes(out)
+
+
+def image_to_raw_bytes(input_path: str, fmt: str) -> Tuple[int, int, bytes]:
+    img = _load_rgb_image(input_path)
+    width, height = img.size
+    pixels = image_to_rgb565(img)
+    data = encode_rle565(pixels) if fmt == 'rle565' else encode_rgb565(pixels)
+    return width, height, data
+
+
 # ============================================================================
 # Upload Functions
 # ============================================================================
 
-def upload_single_file(esp32_ip, jpeg_data, timeout=10):
+# Strip ring full (HTTP 503): retry the same strip with a growing backoff
+MAX_BUSY_RETRIES = 200
+BUSY_BACKOFF_S = 0.01
+
+def upload_single_file(esp32_ip, jpeg_data, timeout=10, fmt='jpeg', scale=1):
     """
-    Upload a single baseline JPEG via multipart.
+    Upload a single baseline JPEG (or rgb565 / rle565 pixels) via multipart.
     
     Args:
         esp32_ip: ESP32 IP address
-        jpeg_data: JPEG file data (bytes)
+        jpeg_data: JPEG file data (bytes), or encoded pixels for raw formats
         timeout: Display timeout in seconds
+        fmt: 'jpeg', 'rgb565' or 'rle565'
+        scale: JPEG only; device decodes at 1/scale (1, 2, 4 or 8)
         
     Returns:
         bool: Success
     """
     url = f"http://{esp32_ip}/api/display/image"
     
-    print(f"\n=== Single-File Upload (JPEG) ===")
+    print(f"\n=== Single-File Upload ({fmt.upper()}) ===")
     print(f"URL: {url}")
     print(f"Size: {len(jpeg_data)} bytes")
     print(f"Timeout: {timeout}s")
     
     try:
-        files = {'image': ('image.jpg', jpeg_data, 'image/jpeg')}
-        params = {'timeout': timeout}
+        if fmt == 'jpeg':
+            files = {'image': ('image.jpg', jpeg_data, 'image/jpeg')}
+            params = {'timeout': timeout}
+            if scale > 1:
+                params['scale'] = scale
+        else:
+            files = {'image': (f'image.{fmt}', jpeg_data, 'application/octet-stream')}
+            params = {'timeout': timeout, 'format': fmt}
         
         response = requests.post(url, files=files, params=params, timeout=30)
         
@@ -129,15 +215,17 @@ def upload_single_file(esp32_ip, jpeg_data, timeout=10):
         return False
 
 
-def upload_strips(esp32_ip, width, height, strips, timeout=10, start_strip=None, end_strip=None):
+def upload_strips(esp32_ip, width, height, strips, timeout=10, start_strip=None, end_strip=None, scale=1):
     """
     Upload the image as individual JPEG fragments (memory-efficient API).
     
     Args:
         esp32_ip: ESP32 IP address
+        width, height: On-screen image size (strips are scale times larger)
         timeout: Display timeout in seconds
         start_strip: First strip to upload (None = 0)
         end_strip: Last strip to upload (None = all)
+        scale: Device decodes at 1/scale (1, 2, 4 or 8)
         
     Returns:
         bool: Success
@@ -152,12 +240,15 @@ def upload_strips(esp32_ip, width, height, strips, timeout=10, start_strip=None,
     print(f"Range: {first} to {last}")
     print(f"Timeout: {timeout}s")
     
-    # Upload each strip
+    # Upload each strip back-to-back over one keep-alive session. The device
+    # queues strips for decode and answers 503 (Retry-After) while its strip
+    # ring is full; retry the same strip after a short backoff.
+    url = f"http://{esp32_ip}/api/display/image/strips"
+    session = requests.Session()
     for i in range(first, last + 1):
         strip_data = strips[i]
         
         # Build URL with metadata
-        url = f"http://{esp32_ip}/api/display/image/strips"
         params = {
             'strip_index': i,
             'strip_count': len(strips),
@@ -165,27 +256,105 @@ def upload_strips(esp32_ip, width, height, strips, timeout=10, start_strip=None,
             'height': height,
             'timeout': timeout
         }
+        if scale > 1:
+            params['scale'] = scale
         
+        retries = 0
+        while True:
+            try:
+                response = session.post(
+                    url,
+                    params=params,
+                    data=strip_data,
+                    headers={'Content-Type': 'application/octet-stream'},
+                    timeout=10
+                )
+            except Exception as e:
+                print(f"  Strip {i}: ✗ {e}")
+                return False
+
+            if response.status_code == 503 and retries < MAX_BUSY_RETRIES:
+                retries += 1
+                time.sleep(min(BUSY_BACKOFF_S * retries, 0.5))
+                continue
+            break
+
+        if response.status_code == 200:
+            busy = f", {retries} busy retries" if retries else ""
+            print(f"  Strip {i}/{len(strips)-1}: ✓ ({len(strip_data)} bytes{busy})")
+        else:
+            print(f"  Strip {i}: ✗ HTTP {response.status_code}")
+            print(f"    Response: {response.text}")
+            return False
+    
+    print(f"\n✓ All strips uploaded successfully!")
+    return True
+
+
+def upload_strip_batches(esp32_ip, width, height, strips, batch_size, timeout=10, start_strip=None, end_strip=None,
+                         scale=1):
+    """
+    Upload strips several at a time: one request body carries consecutive
+    [uint32 LE length][JPEG] entries (one TCP/HTTP round trip per batch).
+
+    Returns:
+        bool: Success
+    """
+    first = start_strip if start_strip is not None else 0
+    last = end_strip if end_strip is not None else len(strips) - 1
+
+    print(f"\n=== Batched Strip Upload (JPEG fragments) ===")
+    print(f"Image: {width}×{height} pixels")
+    print(f"Strips: {len(strips)} total, {batch_size} per request")
+    print(f"Range: {first} to {last}")
+    print(f"Timeout: {timeout}s")
+
+    url = f"http://{esp32_ip}/api/display/image/strips/batch"
+    session = requests.Session()
+    batch_first = first
+    retries = 0
+    while batch_first <= last:
+        batch_last = min(batch_first + batch_size - 1, last)
+        body = b''.join(struct.pack('<I', len(strips[i])) + strips[i]
+                        for i in range(batch_first, batch_last + 1))
+        params = {
+            'strip_start': batch_first,
+            'strip_count': len(strips),
+            'width': width,
+            'height': height,
+            'timeout': timeout
+        }
+        if scale > 1:
+            params['scale'] = scale
+
         try:
-            response = requests.post(
+            response = session.post(
                 url,
                 params=params,
-                data=strip_data,
+                data=body,
                 headers={'Content-Type': 'application/octet-stream'},
-                timeout=10
+                timeout=30
             )
-            
-            if response.status_code == 200:
-                print(f"  Strip {i}/{len(strips)-1}: ✓ ({len(strip_data)} bytes)")
-            else:
-                print(f"  Strip {i}: ✗ HTTP {response.status_code}")
-                print(f"    Response: {response.text}")
-                return False
-                
         except Exception as e:
-            print(f"  Strip {i}: ✗ {e}")
+            print(f"  Strips {batch_first}-{batch_last}: ✗ {e}")
             return False
-    
+
+        # Strip ring full: the device queued strips_received strips, resend the rest
+        if response.status_code == 503 and retries < MAX_BUSY_RETRIES:
+            retries += 1
+            batch_first += response.json().get('strips_received', 0)
+            time.sleep(min(BUSY_BACKOFF_S * retries, 0.5))
+            continue
+
+        retries = 0
+        batch_first = batch_last + 1
+        if response.status_code == 200:
+            print(f"  Strips {batch_first}-{batch_last}/{len(strips)-1}: ✓ ({len(body)} bytes)")
+        else:
+            print(f"  Strips {batch_first}-{batch_last}: ✗ HTTP {response.status_code}")
+            print(f"    Response: {response.text}")
+            return False
+
     print(f"\n✓ All strips uploaded successfully!")
     return True
 
@@ -223,8 +392,14 @@ Examples:
                        help='First strip to upload (debug mode)')
     parser.add_argument('--end', type=int, default=None,
                        help='Last strip to upload (debug mode)')
+    parser.add_argument('--batch', type=int, default=0,
+                       help='Strips per request via /strips/batch (strip mode; default: 0 = one request per strip)')
     parser.add_argument('--jpeg-quality', type=int, default=90,
                        help='JPEG quality for (re)encoding (default: 90)')
+    parser.add_argument('--format', choices=['jpeg', 'rgb565', 'rle565'], default='jpeg',
+                       help='Wire format (single mode; raw formats must match the panel size, default: jpeg)')
+    parser.add_argument('--scale', type=int, choices=[1, 2, 4, 8], default=1,
+                       help='Device-side JPEG downscale; the image must be scale times the panel size (default: 1)')
     
     args = parser.parse_args()
     
@@ -239,23 +414,53 @@ Examples:
         strip_height = 32
     
     # Upload
+    if args.format != 'jpeg' and args.mode != 'single':
+        print("Error: --format rgb565/rle565 requires --mode single")
+        sys.exit(1)
+    if args.scale > 1 and args.format != 'jpeg':
+        print("Error: --scale requires --format jpeg")
+        sys.exit(1)
+
     if args.mode == 'single':
-        width, height, jpeg_data = image_to_jpeg_bytes(args.image, quality=args.jpeg_quality)
+        if args.format == 'jpeg':
+            width, height, jpeg_data = image_to_jpeg_bytes(args.image, quality=args.jpeg_quality)
+        else:
+            width, height, jpeg_data = image_to_raw_bytes(args.image, args.format)
         print(f"  Image: {width}×{height} pixels")
-        success = upload_single_file(args.esp32_ip, jpeg_data, args.timeout)
+        success = upload_single_file(args.esp32_ip, jpeg_data, args.timeout, args.format, args.scale)
     else:  # strip
-        width, height, _, strips = image_to_jpeg_strips(args.image, strip_height=strip_height, quality=args.jpeg_quality)
+        # Strips are cut from the full-size source; heights stay multiples of scale
+        width, height, _, strips = image_to_jpeg_strips(args.image, strip_height=strip_height * args.scale,
+                                                        quality=args.jpeg_quality)
         print(f"  Image: {width}×{height} pixels")
         print(f"  Strips: {len(strips)} total ({strip_height}px target)")
-        success = upload_strips(
-            args.esp32_ip,
-            width,
-            height,
-            strips,
-            args.timeout,
-            args.start,
-            args.end,
-        )
+        if args.scale > 1:
+            width //= args.scale
+            height //= args.scale
+            print(f"  Decoded at 1/{args.scale}: {width}×{height} pixels")
+        if args.batch > 0:
+            success = upload_strip_batches(
+                args.esp32_ip,
+                width,
+                height,
+                strips,
+                args.batch,
+                args.timeout,
+                args.start,
+                args.end,
+                args.scale,
+            )
+        else:
+            success = upload_strips(
+                args.esp32_ip,
+                width,
+                height,
+                strips,
+                args.timeout,
+                args.start,
+                args.end,
+                args.scale,
+            )
     
     sys.exit(0 if success else 1)
 